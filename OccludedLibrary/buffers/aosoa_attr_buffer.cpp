@@ -0,0 +1,315 @@
+#include "aosoa_attr_buffer.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define OCCLUDED_AOSOA_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace occluded { namespace buffers {
+
+const unsigned int aosoa_attr_buffer::DEFAULT_BLOCK_WIDTH = 8;
+const std::size_t aosoa_attr_buffer::ALIGNMENT = 64;
+
+aosoa_attr_buffer::aosoa_attr_buffer( const attributes::attribute_map& map, const unsigned int blockWidth, storage::storage_allocator& allocator ):
+	m_allocator( allocator ),
+	m_blockWidth( blockWidth ),
+	m_numRows( 0 ),
+	m_memory( NULL ),
+	m_blocks( NULL ),
+	m_numValues( 0 ),
+	m_capacity( 0 )
+{
+	init_rows( map );
+}
+
+aosoa_attr_buffer::aosoa_attr_buffer( const attribute_buffer& source, const unsigned int blockWidth, storage::storage_allocator& allocator ):
+	m_allocator( allocator ),
+	m_blockWidth( blockWidth ),
+	m_numRows( 0 ),
+	m_memory( NULL ),
+	m_blocks( NULL ),
+	m_numValues( 0 ),
+	m_capacity( 0 )
+{
+	const attributes::attribute_map& map = source.get_attribute_map();
+
+	init_rows( map );
+
+	if( source.get_num_values() == 0 )
+		return;
+
+	reserve_blocks( source.get_num_values() );
+	m_numValues = source.get_num_values();
+
+	const std::vector<const attributes::attribute>& attribs = map.get_attributes();
+	const std::vector<unsigned int>& sections = map.get_attribute_sections();
+	const std::vector<unsigned int>& strides = map.get_section_strides();
+	const std::vector<unsigned int>& dataOffsets = source.get_attribute_data_offsets();
+	const char* data = source.get_data();
+
+	// Gather each row from its section, so the values are read in the order they are stored whatever the layout of the source
+	for( unsigned int i = 0; i < attribs.size(); ++i ) {
+		const unsigned int stride = strides[sections[i]];
+		const char* attribStart = data + dataOffsets[i];
+
+		for( unsigned int j = 0; j < attribs[i].get_arity(); ++j ) {
+			for( unsigned int value = 0; value < m_numValues; ++value ) {
+				memcpy( get_lane( value, m_firstRows[i] + j ), attribStart + value * stride + j * sizeof( float ), sizeof( float ) );
+			}
+		}
+	}
+}
+
+aosoa_attr_buffer::~aosoa_attr_buffer()
+{
+	if( m_memory != NULL )
+		m_allocator.deallocate( m_memory, m_capacity * m_numRows * sizeof( float ) + ALIGNMENT );
+}
+
+const unsigned int aosoa_attr_buffer::insert_values( const void* values, const unsigned int numValues ) {
+	if( values == NULL || numValues == 0 ) {
+		throw std::runtime_error( "aosoa_attr_buffer.insert_values: Failed to insert values because no values were passed." );
+	}
+
+	const attributes::attribute_map& map = *m_map;
+	const std::vector<const attributes::attribute>& attribs = map.get_attributes();
+	const std::vector<unsigned int>& offsets = map.get_attribute_offsets();
+	const std::size_t byteSize = map.get_byte_size();
+	const char* source = static_cast<const char*>( values );
+	const unsigned int firstValue = m_numValues;
+
+	reserve_blocks( m_numValues + numValues );
+
+	for( unsigned int value = 0; value < numValues; ++value ) {
+		const char* valueStart = source + value * byteSize;
+
+		for( unsigned int i = 0; i < attribs.size(); ++i ) {
+			for( unsigned int j = 0; j < attribs[i].get_arity(); ++j ) {
+				memcpy( get_lane( firstValue + value, m_firstRows[i] + j ), valueStart + offsets[i] + j * sizeof( float ), sizeof( float ) );
+			}
+		}
+	}
+
+	m_numValues += numValues;
+
+	return firstValue;
+}
+
+void aosoa_attr_buffer::read_values( const unsigned int firstValue, const unsigned int numValues, void* dest ) const {
+	if( dest == NULL ) {
+		throw std::runtime_error( "aosoa_attr_buffer.read_values: Failed to read values because the destination was null." );
+	}
+
+	if( static_cast<boost::uint64_t>( firstValue ) + numValues > m_numValues ) {
+		throw std::runtime_error( "aosoa_attr_buffer.read_values: Failed to read values(" + boost::lexical_cast<std::string>( firstValue ) + ", "
+			+ boost::lexical_cast<std::string>( numValues ) + ") because the buffer only has " + boost::lexical_cast<std::string>( m_numValues )
+			+ " values." );
+	}
+
+	const attributes::attribute_map& map = *m_map;
+	const std::vector<const attributes::attribute>& attribs = map.get_attributes();
+	const std::vector<unsigned int>& offsets = map.get_attribute_offsets();
+	const std::size_t byteSize = map.get_byte_size();
+	char* destValues = static_cast<char*>( dest );
+
+	for( unsigned int value = 0; value < numValues; ++value ) {
+		char* valueStart = destValues + value * byteSize;
+
+		for( unsigned int i = 0; i < attribs.size(); ++i ) {
+			for( unsigned int j = 0; j < attribs[i].get_arity(); ++j ) {
+				memcpy( valueStart + offsets[i] + j * sizeof( float ), get_lane( firstValue + value, m_firstRows[i] + j ), sizeof( float ) );
+			}
+		}
+	}
+}
+
+std::auto_ptr<attribute_buffer> aosoa_attr_buffer::create_interleaved_buffer( storage::storage_allocator& allocator ) const {
+	const std::vector<const attributes::attribute>& attribs = m_map->get_attributes();
+	attributes::attribute_map interleavedMap( attributes::layout_interleaved );
+
+	for( unsigned int i = 0; i < attribs.size(); ++i ) {
+		interleavedMap.add_attribute( attribs[i] );
+	}
+
+	interleavedMap.end_definition();
+
+	std::auto_ptr<attribute_buffer> newBuffer = attribute_buffer_factory::create_attribute_buffer( interleavedMap, allocator );
+
+	if( m_numValues == 0 )
+		return newBuffer;
+
+	// Size the storage once, so the values can be written straight into the place they are stored
+	newBuffer->append_values( m_numValues );
+	read_values( 0, m_numValues, &newBuffer->m_data[newBuffer->m_bufferPointers[0]] );
+
+	return newBuffer;
+}
+
+void aosoa_attr_buffer::transform_points( const unsigned int attrib, const float* matrix ) {
+	if( matrix == NULL ) {
+		throw std::runtime_error( "aosoa_attr_buffer.transform_points: Failed to transform points because the matrix was null." );
+	}
+
+	const std::vector<const attributes::attribute>& attribs = m_map->get_attributes();
+
+	if( attrib >= attribs.size() || attribs[attrib].get_type() != attributes::attrib_float || attribs[attrib].get_arity() < 3 ) {
+		throw std::runtime_error( "aosoa_attr_buffer.transform_points: Failed to transform attribute(" + boost::lexical_cast<std::string>( attrib )
+			+ ") because it is not a float attribute with at least three components." );
+	}
+
+	if( m_numValues == 0 )
+		return;
+
+	const unsigned int numBlocks = get_num_blocks(), blockSize = m_numRows * m_blockWidth;
+	float* x = get_lane( 0, m_firstRows[attrib] );
+
+#ifdef OCCLUDED_AOSOA_SSE2
+	const __m128 m0 = _mm_set1_ps( matrix[0] ), m1 = _mm_set1_ps( matrix[1] ), m2 = _mm_set1_ps( matrix[2] );
+	const __m128 m4 = _mm_set1_ps( matrix[4] ), m5 = _mm_set1_ps( matrix[5] ), m6 = _mm_set1_ps( matrix[6] );
+	const __m128 m8 = _mm_set1_ps( matrix[8] ), m9 = _mm_set1_ps( matrix[9] ), m10 = _mm_set1_ps( matrix[10] );
+	const __m128 m12 = _mm_set1_ps( matrix[12] ), m13 = _mm_set1_ps( matrix[13] ), m14 = _mm_set1_ps( matrix[14] );
+#endif
+
+	for( unsigned int block = 0; block < numBlocks; ++block, x += blockSize ) {
+		float* y = x + m_blockWidth;
+		float* z = y + m_blockWidth;
+		unsigned int lane = 0;
+
+#ifdef OCCLUDED_AOSOA_SSE2
+		// Every row is aligned to at least 16 bytes and the block width is a multiple of 4, so whole registers are always loaded
+		for( ; lane < m_blockWidth; lane += 4 ) {
+			const __m128 inX = _mm_load_ps( x + lane ), inY = _mm_load_ps( y + lane ), inZ = _mm_load_ps( z + lane );
+
+			_mm_store_ps( x + lane, _mm_add_ps( _mm_add_ps( _mm_mul_ps( m0, inX ), _mm_mul_ps( m4, inY ) ), _mm_add_ps( _mm_mul_ps( m8, inZ ), m12 ) ) );
+			_mm_store_ps( y + lane, _mm_add_ps( _mm_add_ps( _mm_mul_ps( m1, inX ), _mm_mul_ps( m5, inY ) ), _mm_add_ps( _mm_mul_ps( m9, inZ ), m13 ) ) );
+			_mm_store_ps( z + lane, _mm_add_ps( _mm_add_ps( _mm_mul_ps( m2, inX ), _mm_mul_ps( m6, inY ) ), _mm_add_ps( _mm_mul_ps( m10, inZ ), m14 ) ) );
+		}
+#endif
+
+		for( ; lane < m_blockWidth; ++lane ) {
+			const float inX = x[lane], inY = y[lane], inZ = z[lane];
+
+			x[lane] = matrix[0] * inX + matrix[4] * inY + matrix[8] * inZ + matrix[12];
+			y[lane] = matrix[1] * inX + matrix[5] * inY + matrix[9] * inZ + matrix[13];
+			z[lane] = matrix[2] * inX + matrix[6] * inY + matrix[10] * inZ + matrix[14];
+		}
+	}
+
+	// The translation was added to the empty lanes of the last block as well
+	clear_tail();
+}
+
+float* aosoa_attr_buffer::get_lanes( const unsigned int block, const unsigned int attrib, const unsigned int component ) {
+	return const_cast<float*>( static_cast<const aosoa_attr_buffer&>( *this ).get_lanes( block, attrib, component ) );
+}
+
+const float* aosoa_attr_buffer::get_lanes( const unsigned int block, const unsigned int attrib, const unsigned int component ) const {
+	if( block >= get_num_blocks() ) {
+		throw std::runtime_error( "aosoa_attr_buffer.get_lanes: Failed to get block(" + boost::lexical_cast<std::string>( block )
+			+ ") because the buffer only has " + boost::lexical_cast<std::string>( get_num_blocks() ) + " blocks." );
+	}
+
+	if( attrib >= m_firstRows.size() || component >= m_map->get_attributes()[attrib].get_arity() ) {
+		throw std::runtime_error( "aosoa_attr_buffer.get_lanes: Failed to get component(" + boost::lexical_cast<std::string>( component )
+			+ ") of attribute(" + boost::lexical_cast<std::string>( attrib ) + ") because it does not exist." );
+	}
+
+	return get_lane( block * m_blockWidth, m_firstRows[attrib] + component );
+}
+
+const unsigned int aosoa_attr_buffer::get_num_values() const {
+	return m_numValues;
+}
+
+const unsigned int aosoa_attr_buffer::get_num_blocks() const {
+	return ( m_numValues + m_blockWidth - 1 ) / m_blockWidth;
+}
+
+const unsigned int aosoa_attr_buffer::get_block_width() const {
+	return m_blockWidth;
+}
+
+const attributes::attribute_map& aosoa_attr_buffer::get_attribute_map() const {
+	return *m_map;
+}
+
+// Private Member Functions
+
+void aosoa_attr_buffer::init_rows( const attributes::attribute_map& map ) {
+	if( map.being_defined() ) {
+		throw std::runtime_error( "aosoa_attr_buffer: Failed to initialize buffer because the attribute map is still being defined." );
+	}
+
+	if( m_blockWidth != 4 && m_blockWidth != 8 && m_blockWidth != 16 ) {
+		throw std::runtime_error( "aosoa_attr_buffer: Failed to initialize buffer because the block width(" + boost::lexical_cast<std::string>( m_blockWidth )
+			+ ") is not 4, 8 or 16." );
+	}
+
+	const std::vector<const attributes::attribute>& attribs = map.get_attributes();
+
+	if( attribs.empty() ) {
+		throw std::runtime_error( "aosoa_attr_buffer: Failed to initialize buffer because the attribute map has no attributes." );
+	}
+
+	for( unsigned int i = 0; i < attribs.size(); ++i ) {
+		const attributes::attribute_t type = attribs[i].get_type();
+
+		if( type != attributes::attrib_float && type != attributes::attrib_int && type != attributes::attrib_uint ) {
+			throw std::runtime_error( "aosoa_attr_buffer: Failed to initialize buffer because attribute(" + attribs[i].get_name()
+				+ ") does not have 4 byte components." );
+		}
+
+		m_firstRows.push_back( m_numRows );
+		m_numRows += attribs[i].get_arity();
+	}
+
+	m_map = attributes::attribute_map_registry::get_registry().intern( map );
+}
+
+void aosoa_attr_buffer::reserve_blocks( const unsigned int numValues ) {
+	if( numValues <= m_capacity )
+		return;
+
+	// Grow geometrically so that repeatedly inserting values only moves the blocks a logarithmic number of times
+	unsigned int newCapacity = std::max( numValues, 2 * m_capacity );
+	newCapacity = ( newCapacity + m_blockWidth - 1 ) / m_blockWidth * m_blockWidth;
+
+	const std::size_t oldBytes = m_capacity * m_numRows * sizeof( float ), newBytes = newCapacity * m_numRows * sizeof( float );
+	char* newMemory = static_cast<char*>( m_allocator.allocate( newBytes + ALIGNMENT ) );
+	float* newBlocks = reinterpret_cast<float*>( newMemory + ( ALIGNMENT - reinterpret_cast<std::size_t>( newMemory ) % ALIGNMENT ) % ALIGNMENT );
+
+	// Blocks are stored one after another, so the existing blocks keep their place and the new ones start empty
+	if( m_memory != NULL ) {
+		memcpy( newBlocks, m_blocks, oldBytes );
+		m_allocator.deallocate( m_memory, oldBytes + ALIGNMENT );
+	}
+
+	memset( reinterpret_cast<char*>( newBlocks ) + oldBytes, 0, newBytes - oldBytes );
+
+	m_memory = newMemory;
+	m_blocks = newBlocks;
+	m_capacity = newCapacity;
+}
+
+void aosoa_attr_buffer::clear_tail() {
+	const unsigned int firstEmpty = m_numValues % m_blockWidth;
+
+	if( firstEmpty == 0 )
+		return;
+
+	for( unsigned int row = 0; row < m_numRows; ++row ) {
+		memset( get_lane( m_numValues, row ), 0, ( m_blockWidth - firstEmpty ) * sizeof( float ) );
+	}
+}
+
+float* aosoa_attr_buffer::get_lane( const unsigned int value, const unsigned int row ) const {
+	return m_blocks + ( ( value / m_blockWidth ) * m_numRows + row ) * m_blockWidth + value % m_blockWidth;
+}
+
+} // end of buffers namespace
+} // end of occluded namespace
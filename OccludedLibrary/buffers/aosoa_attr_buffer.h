@@ -0,0 +1,224 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <stdexcept>
+
+#include <boost/lexical_cast.hpp>
+
+#include "attribute_buffer_factory.h"
+
+namespace occluded { namespace buffers {
+
+/**
+ * \class aosoa_attr_buffer
+ * \brief Stores values in blocks so that each component can be processed several values at a time with SIMD instructions.
+ *
+ * Stores the values of an attribute map as an array of structures of arrays. The values are split into blocks of a fixed number of values,
+ * the block width, and within a block every component of every attribute is stored as a row of block width lanes, one lane per value. A row
+ * can therefore be loaded straight into SIMD registers: a block width of 8 fills one AVX register or two SSE registers, while the rows of a
+ * block are still next to each other in memory, which an attribute_buffer with a segregated layout can not provide.
+ *
+ * The blocks start on an ALIGNMENT byte boundary and each row is aligned to its own size, so rows can be loaded with aligned loads. Lanes
+ * after the last value of the last block are always 0, so loops can process whole blocks without reading memory that is not part of the
+ * buffer. Every component must be 4 bytes, since each lane holds one component of one value.
+ *
+ * The blocks can not be passed to OpenGL directly, so the buffer is meant for processing on the CPU. create_interleaved_buffer converts the
+ * values into an interleaved attribute buffer that can be uploaded.
+ */
+class aosoa_attr_buffer
+{
+public:
+	/**
+	 * The number of values in a block if no block width is passed to the constructor.
+	 */
+	static const unsigned int DEFAULT_BLOCK_WIDTH;
+
+	/**
+	 * The alignment, in bytes, of the first block.
+	 */
+	static const std::size_t ALIGNMENT;
+
+private:
+	attributes::attribute_map_handle m_map;
+	storage::storage_allocator& m_allocator;
+	unsigned int m_blockWidth;
+	unsigned int m_numRows;
+	std::vector<unsigned int> m_firstRows;
+	char* m_memory;
+	float* m_blocks;
+	unsigned int m_numValues;
+	unsigned int m_capacity;
+
+public:
+	/**
+	 * \brief Initializes an empty buffer.
+	 *
+	 * \param map A reference to the attribute map describing the values.
+	 * \param blockWidth An unsigned int representing the number of values in a block, which must be 4, 8 or 16.
+	 * \param allocator A reference to the storage allocator the blocks are stored in, which must outlive the buffer.
+	 *
+	 * The layout of the map only decides how values are organized when the buffer is converted, not how they are stored. An exception is thrown
+	 * if the map is still being defined, has no attributes or has an attribute whose components are not 4 bytes, or if the block width is not
+	 * supported.
+	 */
+	aosoa_attr_buffer( const attributes::attribute_map& map, const unsigned int blockWidth = DEFAULT_BLOCK_WIDTH,
+		storage::storage_allocator& allocator = storage::storage_allocator::get_default_allocator() );
+
+	/**
+	 * \brief Initializes the buffer with the values of an attribute buffer.
+	 *
+	 * \param source A reference to the attribute buffer whose values are copied, which may use any layout.
+	 * \param blockWidth An unsigned int representing the number of values in a block, which must be 4, 8 or 16.
+	 * \param allocator A reference to the storage allocator the blocks are stored in, which must outlive the buffer.
+	 *
+	 * Copies every value of the source, including erased values, so that the index of each value stays the same. An exception is thrown for
+	 * the same reasons as the other constructor.
+	 */
+	explicit aosoa_attr_buffer( const attribute_buffer& source, const unsigned int blockWidth = DEFAULT_BLOCK_WIDTH,
+		storage::storage_allocator& allocator = storage::storage_allocator::get_default_allocator() );
+	~aosoa_attr_buffer();
+
+	/**
+	 * \fn insert_values
+	 * \brief Adds values to the end of the buffer.
+	 *
+	 * \param values A pointer to the values, each containing every attribute in the order they were added and without padding between them.
+	 * \param numValues An unsigned int representing the number of values that values points to.
+	 * \return An unsigned int representing the index of the first value added.
+	 *
+	 * Each value is a single structure, which is how a single value is laid out in every attribute buffer. An exception is thrown if values is
+	 * null or numValues is 0.
+	 */
+	const unsigned int insert_values( const void* values, const unsigned int numValues );
+
+	/**
+	 * \fn read_values
+	 * \brief Copies values out of the buffer as interleaved structures.
+	 *
+	 * \param firstValue An unsigned int representing the index of the first value to be copied.
+	 * \param numValues An unsigned int representing the number of values to be copied.
+	 * \param dest A pointer to the memory the values are written to, which must be numValues times the byte size of the map long.
+	 *
+	 * Writes the values in the form insert_values takes, so they can be passed to gl_attribute_buffer::update_values after being processed. An
+	 * exception is thrown if dest is null or if the values are not all in the buffer.
+	 */
+	void read_values( const unsigned int firstValue, const unsigned int numValues, void* dest ) const;
+
+	/**
+	 * \fn create_interleaved_buffer
+	 * \brief Converts the values into an interleaved attribute buffer.
+	 *
+	 * \param allocator A reference to the storage allocator the values of the new buffer are stored in, which must outlive the new buffer.
+	 * \return An interleaved attribute buffer with the attributes of the map and every value of the buffer.
+	 *
+	 * The values are written straight into the storage of the new buffer, which is sized once.
+	 */
+	std::auto_ptr<attribute_buffer> create_interleaved_buffer(
+		storage::storage_allocator& allocator = storage::storage_allocator::get_default_allocator() ) const;
+
+	/**
+	 * \fn transform_points
+	 * \brief Transforms the first three components of an attribute as points.
+	 *
+	 * \param attrib An unsigned int representing the index of the attribute in the map.
+	 * \param matrix A pointer to 16 floats representing a column-major 4 by 4 matrix, the order OpenGL uses.
+	 *
+	 * Multiplies each point by the upper 3 by 4 part of the matrix, treating its w as 1. Four lanes are transformed at a time when SSE2 is
+	 * available. An exception is thrown if matrix is null or if the attribute does not exist or does not have at least three float components.
+	 */
+	void transform_points( const unsigned int attrib, const float* matrix );
+
+	/**
+	 * \fn get_lanes
+	 * \brief Gets a row of a block.
+	 *
+	 * \param block An unsigned int representing the index of the block.
+	 * \param attrib An unsigned int representing the index of the attribute in the map.
+	 * \param component An unsigned int representing the component of the attribute.
+	 * \return A pointer to the block width lanes of the row, aligned to 4 times the block width bytes. Lane i holds the component of value
+	 * block * block width + i.
+	 *
+	 * Components that are not floats are stored with their bits unchanged, so the pointer can be cast to the type of the attribute. An exception
+	 * is thrown if the block, attribute or component does not exist.
+	 */
+	float* get_lanes( const unsigned int block, const unsigned int attrib, const unsigned int component );
+
+	/**
+	 * \fn get_lanes
+	 * \brief Gets a row of a block that can not be changed.
+	 *
+	 * \see { occluded::buffers::aosoa_attr_buffer::get_lanes }
+	 */
+	const float* get_lanes( const unsigned int block, const unsigned int attrib, const unsigned int component ) const;
+
+	/**
+	 * \fn get_num_values
+	 * \brief Gets the number of values in the buffer.
+	 *
+	 * \return An unsigned int representing the number of values in the buffer.
+	 */
+	const unsigned int get_num_values() const;
+
+	/**
+	 * \fn get_num_blocks
+	 * \brief Gets the number of blocks that contain values.
+	 *
+	 * \return An unsigned int representing the number of values divided by the block width, rounded up.
+	 */
+	const unsigned int get_num_blocks() const;
+
+	/**
+	 * \fn get_block_width
+	 * \brief Gets the number of values in a block.
+	 *
+	 * \return An unsigned int representing the block width passed to the constructor.
+	 */
+	const unsigned int get_block_width() const;
+
+	/**
+	 * \fn get_attribute_map
+	 * \brief Gets the attribute map of the buffer.
+	 *
+	 * \return A reference to the attribute map describing the values.
+	 */
+	const attributes::attribute_map& get_attribute_map() const;
+
+private:
+	aosoa_attr_buffer( const aosoa_attr_buffer& other );
+	aosoa_attr_buffer& operator=( const aosoa_attr_buffer& other );
+
+	/**
+	 * \fn init_rows
+	 * \brief Checks the map and block width and computes the first row of every attribute.
+	 */
+	void init_rows( const attributes::attribute_map& map );
+
+	/**
+	 * \fn reserve_blocks
+	 * \brief Makes sure the storage can hold a number of values, moving the blocks to new storage if it can not.
+	 *
+	 * \param numValues An unsigned int representing the number of values the storage should be able to hold.
+	 *
+	 * The capacity grows geometrically, and the lanes of new storage are set to 0.
+	 */
+	void reserve_blocks( const unsigned int numValues );
+
+	/**
+	 * \fn clear_tail
+	 * \brief Sets the lanes after the last value of the last block to 0.
+	 */
+	void clear_tail();
+
+	/**
+	 * \fn get_lane
+	 * \brief Gets the lane of a value in a row.
+	 *
+	 * \param value An unsigned int representing the index of the value.
+	 * \param row An unsigned int representing the index of the row within a block.
+	 */
+	float* get_lane( const unsigned int value, const unsigned int row ) const;
+};
+
+} // end of buffers namespace
+} // end of occluded namespace
@@ -1,16 +1,22 @@
 #include "attribute_buffer.h"
+#include "attributes/attribute_encoder.h"
 
 namespace occluded { namespace buffers {
 
-attribute_buffer::attribute_buffer( const attributes::attribute_map& map ):
-	m_map( map ),
-	m_data( 0 ),
+const unsigned int attribute_buffer::ERASED_VALUE = 0xffffffff;
+
+attribute_buffer::attribute_buffer( const attributes::attribute_map& map, storage::storage_allocator& allocator ):
+	m_data( storage::allocator_adapter<char>( allocator ) ),
 	m_numValues( 0 ),
-	m_pointersSet( false )
+	m_pointersSet( false ),
+	m_allDirty( true ),
+	m_numFreeValues( 0 )
 {
-	if( m_map.being_defined() )
+	if( map.being_defined() )
 		throw std::runtime_error( "attribute_buffer: Failed to create attribute buffer because attribute map is still being defined." );
 
+	m_map = attributes::attribute_map_registry::get_registry().intern( map );
+
 	init_buffer();
 }
 
@@ -21,13 +27,227 @@ attribute_buffer::~attribute_buffer()
 	m_data.clear();
 }
 
+void attribute_buffer::insert_values( const std::vector<char>& values ) {
+	if( m_map->get_byte_size() == 0 ) {
+		throw std::runtime_error( "attribute_buffer.insert_values: Failed to insert values because the attribute map contained no attributes.");
+	}
+
+	if( values.size() == 0 ) {
+		throw std::runtime_error( "attribute_buffer.insert_values: Failed to insert values because an empty vector was passed to function.");
+	}
+
+	if( values.size() % m_map->get_byte_size() != 0 ) {
+		throw std::runtime_error( "attribute_buffer.insert_values: Failed to insert values because the size of values vector(" + 
+			boost::lexical_cast<std::string>( values.size() ) + ") is not a valid size." ); 
+	}
+
+	insert_values( static_cast<const void*>( &values[0] ), static_cast<unsigned int>( values.size() / m_map->get_byte_size() ) );
+}
+
+void attribute_buffer::insert_values( const void* values, const unsigned int numValues ) {
+	const char* bytes = static_cast<const char*>( values );
+	unsigned int numInserted = 0;
+
+	if( m_map->get_byte_size() == 0 ) {
+		throw std::runtime_error( "attribute_buffer.insert_values: Failed to insert values because the attribute map contained no attributes.");
+	}
+
+	if( values == NULL || numValues == 0 ) {
+		throw std::runtime_error( "attribute_buffer.insert_values: Failed to insert values because no values were passed to function.");
+	}
+
+	const unsigned int numReused = std::min( numValues, m_numFreeValues );
+	const unsigned int firstAppended = m_numValues;
+
+	// Grow the buffer before the free ranges are consumed, so the buffer is left unchanged if growing it fails
+	if( numReused < numValues )
+		append_values( numValues - numReused );
+
+	// Reuse the erased values first, starting with the lowest indices
+	while( numInserted < numValues && !m_freeRanges.empty() ) {
+		value_range& freeRange = m_freeRanges.front();
+		const unsigned int numReused = std::min( freeRange.second, numValues - numInserted );
+
+		overwrite_values( freeRange.first, numReused, bytes, numInserted, numValues );
+
+		freeRange.first += numReused;
+		freeRange.second -= numReused;
+		m_numFreeValues -= numReused;
+		numInserted += numReused;
+
+		if( freeRange.second == 0 )
+			m_freeRanges.erase( m_freeRanges.begin() );
+	}
+
+	if( numInserted < numValues )
+		overwrite_values( firstAppended, numValues - numInserted, bytes, numInserted, numValues );
+}
+
+void attribute_buffer::insert_encoded_values( const float* values, const unsigned int numValues ) {
+	if( m_map->get_byte_size() == 0 ) {
+		throw std::runtime_error( "attribute_buffer.insert_encoded_values: Failed to insert values because the attribute map contained no attributes.");
+	}
+
+	if( values == NULL || numValues == 0 ) {
+		throw std::runtime_error( "attribute_buffer.insert_encoded_values: Failed to insert values because no values were passed to function.");
+	}
+
+	const std::vector<const attributes::attribute>& attributes = m_map->get_attributes();
+	const std::vector<unsigned int>& sections = m_map->get_attribute_sections();
+	const std::vector<unsigned int>& strides = m_map->get_section_strides();
+	const std::vector<unsigned int> blockOffsets = m_map->get_block_offsets( numValues );
+	std::vector<char> block( numValues * m_map->get_byte_size() ), encoded;
+	const float* source = values;
+
+	for( unsigned int i = 0; i < attributes.size(); ++i ) {
+		const std::size_t attribSize = attributes[i].get_attrib_size();
+		const std::size_t stride = strides[sections[i]];
+
+		encoded.resize( numValues * attribSize );
+		attributes::attribute_encoder::encode_values( attributes[i], source, numValues, &encoded[0] );
+
+		// An attribute with a section of its own is already laid out the way the block stores it
+		if( stride == attribSize ) {
+			memcpy( &block[blockOffsets[i]], &encoded[0], encoded.size() );
+		} else {
+			for( unsigned int value = 0; value < numValues; ++value ) {
+				memcpy( &block[blockOffsets[i] + value * stride], &encoded[value * attribSize], attribSize );
+			}
+		}
+
+		source += static_cast<std::size_t>( numValues ) * attributes[i].get_arity();
+	}
+
+	insert_values( static_cast<const void*>( &block[0] ), numValues );
+}
+
+void attribute_buffer::update_values( const unsigned int firstValue, const unsigned int numValues, const void* values ) {
+	if( values == NULL || numValues == 0 ) {
+		throw std::runtime_error( "attribute_buffer.update_values: Failed to update values because no values were passed to function." );
+	}
+
+	if( firstValue > m_numValues || numValues > m_numValues - firstValue ) {
+		throw std::runtime_error( "attribute_buffer.update_values: Failed to update values because the range starting at value(" +
+			boost::lexical_cast<std::string>( firstValue ) + ") goes past the end of the buffer." );
+	}
+
+	overwrite_values( firstValue, numValues, static_cast<const char*>( values ), 0, numValues );
+}
+
+void attribute_buffer::erase_values( const unsigned int firstValue, const unsigned int numValues ) {
+	if( numValues == 0 ) {
+		throw std::runtime_error( "attribute_buffer.erase_values: Failed to erase values because no values were specified." );
+	}
+
+	if( firstValue > m_numValues || numValues > m_numValues - firstValue ) {
+		throw std::runtime_error( "attribute_buffer.erase_values: Failed to erase values because the range starting at value(" +
+			boost::lexical_cast<std::string>( firstValue ) + ") goes past the end of the buffer." );
+	}
+
+	// Only the free ranges on either side of firstValue can overlap the range, since the free ranges are sorted and do not overlap
+	std::vector<value_range>::const_iterator next = std::upper_bound( m_freeRanges.begin(), m_freeRanges.end(), firstValue,
+		&attribute_buffer::starts_before_range );
+
+	if( ( next != m_freeRanges.end() && next->first < firstValue + numValues )
+		|| ( next != m_freeRanges.begin() && ( next - 1 )->first + ( next - 1 )->second > firstValue ) ) {
+		throw std::runtime_error( "attribute_buffer.erase_values: Failed to erase values because the range starting at value(" +
+			boost::lexical_cast<std::string>( firstValue ) + ") contains a value that has already been erased." );
+	}
+
+	add_range( m_freeRanges, firstValue, numValues );
+	m_numFreeValues += numValues;
+}
+
+const std::vector<unsigned int> attribute_buffer::compact() {
+	std::vector<unsigned int> remap( m_numValues, ERASED_VALUE );
+	unsigned int currValue = 0, nextIndex = 0;
+
+	// Move each run of values between the free ranges down to the end of the values that have already been moved
+	for( unsigned int i = 0; i <= m_freeRanges.size(); ++i ) {
+		const unsigned int runEnd = i < m_freeRanges.size() ? m_freeRanges[i].first : m_numValues;
+		const unsigned int runSize = runEnd - currValue;
+
+		if( runSize > 0 && nextIndex != currValue )
+			move_values( nextIndex, currValue, runSize );
+
+		for( unsigned int value = currValue; value < runEnd; ++value ) {
+			remap[value] = nextIndex++;
+		}
+
+		if( i < m_freeRanges.size() )
+			currValue = m_freeRanges[i].first + m_freeRanges[i].second;
+	}
+
+	if( nextIndex != m_numValues ) {
+		truncate_values( nextIndex );
+		mark_all_dirty();
+	}
+
+	m_freeRanges.clear();
+	m_numFreeValues = 0;
+
+	return remap;
+}
+
+void attribute_buffer::reorder_values( const std::vector<unsigned int>& remap ) {
+	std::vector<bool> used( m_numValues, false );
+
+	if( m_numFreeValues > 0 ) {
+		throw std::runtime_error( "attribute_buffer.reorder_values: Failed to reorder values because the buffer contains erased values." );
+	}
+
+	if( remap.size() != m_numValues ) {
+		throw std::runtime_error( "attribute_buffer.reorder_values: Failed to reorder values because the size of remap(" +
+			boost::lexical_cast<std::string>( remap.size() ) + ") does not match the number of values in the buffer." );
+	}
+
+	for( std::vector<unsigned int>::const_iterator it = remap.begin(); it != remap.end(); ++it ) {
+		if( *it >= m_numValues || used[*it] ) {
+			throw std::runtime_error( "attribute_buffer.reorder_values: Failed to reorder values because index(" + boost::lexical_cast<std::string>( *it )
+				+ ") in remap is out of range or appears more than once." );
+		}
+
+		used[*it] = true;
+	}
+
+	if( m_numValues > 0 ) {
+		permute_values( remap );
+		mark_all_dirty();
+	}
+}
+
+const std::vector<unsigned int> attribute_buffer::get_next_indices( const unsigned int numValues ) const {
+	std::vector<unsigned int> indices;
+
+	indices.reserve( numValues );
+
+	for( std::vector<value_range>::const_iterator it = m_freeRanges.begin(); it != m_freeRanges.end() && indices.size() < numValues; ++it ) {
+		for( unsigned int value = it->first; value < it->first + it->second && indices.size() < numValues; ++value ) {
+			indices.push_back( value );
+		}
+	}
+
+	for( unsigned int value = m_numValues; indices.size() < numValues; ++value ) {
+		indices.push_back( value );
+	}
+
+	return indices;
+}
+
+void attribute_buffer::reserve( const unsigned int numValues ) {
+	m_data.reserve( numValues * m_map->get_byte_size() );
+}
+
 void attribute_buffer::clear_buffer() {
 	m_numValues = 0;
 	m_data.clear();
 	m_pointersSet = false;
+	m_freeRanges.clear();
+	m_numFreeValues = 0;
+	mark_all_dirty();
 
-	if( m_map.get_attrib_count() > 0 )
-		memset( &m_bufferPointers[0], 0, m_map.get_attrib_count() * sizeof( unsigned int ) );
+	if( m_map->get_attrib_count() > 0 )
+		memset( &m_bufferPointers[0], 0, m_map->get_attrib_count() * sizeof( unsigned int ) );
 }
 
 const std::size_t attribute_buffer::get_byte_size() const {
@@ -38,26 +258,153 @@ const unsigned int attribute_buffer::get_num_values() const {
 	return m_numValues;
 }
 
-const std::vector<char>& attribute_buffer::get_all_data() const {
+const unsigned int attribute_buffer::get_num_free_values() const {
+	return m_numFreeValues;
+}
+
+const std::vector<attribute_buffer::value_range>& attribute_buffer::get_free_ranges() const {
+	return m_freeRanges;
+}
+
+const bool attribute_buffer::is_value_erased( const unsigned int index ) const {
+	std::vector<value_range>::const_iterator next = std::upper_bound( m_freeRanges.begin(), m_freeRanges.end(), index,
+		&attribute_buffer::starts_before_range );
+
+	return next != m_freeRanges.begin() && ( next - 1 )->first + ( next - 1 )->second > index;
+}
+
+const unsigned int attribute_buffer::get_capacity() const {
+	if( m_map->get_byte_size() == 0 )
+		return 0;
+
+	return static_cast<unsigned int>( m_data.capacity() / m_map->get_byte_size() );
+}
+
+const attribute_buffer::data_vector& attribute_buffer::get_all_data() const {
 	return m_data;
 }
 
+const char* attribute_buffer::get_data() const {
+	return m_data.empty() ? NULL : &m_data[0];
+}
+
+storage::storage_allocator& attribute_buffer::get_storage_allocator() const {
+	return m_data.get_allocator().get_storage_allocator();
+}
+
 const attributes::attribute_map& attribute_buffer::get_attribute_map() const {
-	return m_map;
+	return *m_map;
 }
 
 const std::vector<unsigned int>& attribute_buffer::get_attribute_data_offsets() const {
 	return m_bufferPointers;
 }
 
+const std::vector<attribute_buffer::dirty_range> attribute_buffer::get_used_ranges() const {
+	const std::vector<unsigned int>& strides = m_map->get_section_strides();
+	std::vector<dirty_range> ranges;
+
+	if( m_numValues == 0 )
+		return ranges;
+
+	// Section i starts with attribute i, so its offset is the offset of that attribute
+	for( unsigned int i = 0; i < strides.size(); ++i ) {
+		const std::size_t offset = m_bufferPointers[i], size = static_cast<std::size_t>( m_numValues ) * strides[i];
+
+		if( !ranges.empty() && ranges.back().first + ranges.back().second == offset )
+			ranges.back().second += size;
+		else
+			ranges.push_back( dirty_range( offset, size ) );
+	}
+
+	return ranges;
+}
+
+const std::vector<attribute_buffer::dirty_range>& attribute_buffer::get_dirty_ranges() const {
+	return m_dirtyRanges;
+}
+
+const bool attribute_buffer::is_all_dirty() const {
+	return m_allDirty;
+}
+
+void attribute_buffer::clear_dirty_ranges() {
+	m_dirtyRanges.clear();
+	m_allDirty = false;
+}
+
+// Protected Member Functions
+
+void attribute_buffer::mark_dirty( const std::size_t offset, const std::size_t size ) {
+	// Once the whole buffer is dirty there is no need to track individual ranges
+	if( m_allDirty || size == 0 )
+		return;
+
+	add_range( m_dirtyRanges, offset, size );
+}
+
+void attribute_buffer::mark_all_dirty() {
+	m_dirtyRanges.clear();
+	m_allDirty = true;
+}
+
 // Private Member Functions
 
 void attribute_buffer::init_buffer() {
-	m_bufferPointers.resize( m_map.get_attrib_count() );
+	m_bufferPointers.resize( m_map->get_attrib_count() );
 
-	if( m_map.get_attrib_count() > 0 )
+	if( m_map->get_attrib_count() > 0 )
 		memset( &m_bufferPointers[0], 0, m_bufferPointers.size() * sizeof( unsigned int ) );
 }
 
+const unsigned int attribute_buffer::take_free_value() {
+	value_range& freeRange = m_freeRanges.front();
+	const unsigned int value = freeRange.first;
+
+	++freeRange.first;
+	--freeRange.second;
+	--m_numFreeValues;
+
+	if( freeRange.second == 0 )
+		m_freeRanges.erase( m_freeRanges.begin() );
+
+	return value;
+}
+
+void attribute_buffer::check_structure_size( const std::size_t structureSize ) const {
+	if( structureSize != m_map->get_byte_size() ) {
+		throw std::runtime_error( "attribute_buffer.insert_values: Failed to insert values because the size of the vertex structure(" +
+			boost::lexical_cast<std::string>( structureSize ) + ") does not match the byte size of the attribute map." );
+	}
+}
+
+// Static Functions
+
+template<typename T>
+void attribute_buffer::add_range( std::vector< std::pair<T, T> >& ranges, const T offset, const T size ) {
+	T rangeStart = offset, rangeEnd = offset + size;
+
+	// The ranges are sorted and do not touch, so the ones to merge with are the consecutive ranges starting at the first that does not end before offset
+	typename std::vector< std::pair<T, T> >::iterator first = std::lower_bound( ranges.begin(), ranges.end(), offset, &attribute_buffer::range_ends_before<T> );
+	typename std::vector< std::pair<T, T> >::iterator last = first;
+
+	for( ; last != ranges.end() && last->first <= rangeEnd; ++last ) {
+		rangeStart = std::min( rangeStart, last->first );
+		rangeEnd = std::max( rangeEnd, last->first + last->second );
+	}
+
+	first = ranges.erase( first, last );
+	ranges.insert( first, std::pair<T, T>( rangeStart, rangeEnd - rangeStart ) );
+}
+
+template<typename T>
+const bool attribute_buffer::range_ends_before( const std::pair<T, T>& range, const T offset ) {
+	return range.first + range.second < offset;
+}
+
+const bool attribute_buffer::starts_before_range( const unsigned int offset, const value_range& range ) {
+	return offset < range.first;
+}
+
 } // end of buffers namespace
 } // end of occluded namespace
\ No newline at end of file
@@ -1,6 +1,11 @@
 #pragma once
 
-#include "attributes/attribute_map.h"
+#include <iterator>
+#include <algorithm>
+#include <utility>
+
+#include "attributes/attribute_map_registry.h"
+#include "storage/allocator_adapter.h"
 
 namespace occluded { namespace buffers {
 
@@ -8,26 +13,71 @@ namespace occluded { namespace buffers {
  * \class attribute_buffer
  * \brief Provides contiguous storage for values associated with attributes.
  *
- * Provides contiguous storage for values associated with attributes in an attribute map.
+ * Provides contiguous storage for values associated with attributes in an attribute map. The buffer keeps track of which bytes have changed
+ * since the last time they were uploaded, so that only the changed bytes have to be uploaded again. Overwriting values records the bytes
+ * written as dirty ranges, while anything that changes the size or layout of the storage makes the whole buffer dirty.
+ *
+ * Values can be erased without moving the values after them. The indices of erased values are kept in a free list and are reused by the
+ * next values inserted, so a buffer whose values are repeatedly erased and inserted does not keep growing. compact can be called to remove
+ * the erased values from the storage completely.
+ *
+ * The memory the values are stored in comes from a storage allocator, which defaults to the heap. Buffers that share a lifetime can use an
+ * arena_allocator or a pool_allocator to avoid an independent heap allocation for every buffer, and very large buffers can use a
+ * huge_page_allocator.
  */ 
 class attribute_buffer {
+	friend class attribute_buffer_serializer;
+	friend class attribute_buffer_builder;
+	friend class attribute_buffer_factory;
+	friend class aosoa_attr_buffer;
+
+public:
+	/**
+	 * \typedef dirty_range
+	 * \brief A range of bytes in the buffer, stored as an offset and a size.
+	 */
+	typedef std::pair<std::size_t, std::size_t> dirty_range;
+
+	/**
+	 * \typedef value_range
+	 * \brief A range of values in the buffer, stored as the index of the first value and the number of values.
+	 */
+	typedef std::pair<unsigned int, unsigned int> value_range;
+
+	/**
+	 * \typedef data_vector
+	 * \brief The vector the values are stored in, which allocates its memory from a storage allocator.
+	 */
+	typedef std::vector< char, storage::allocator_adapter<char> > data_vector;
+
+	/**
+	 * The index compact maps an erased value to.
+	 */
+	static const unsigned int ERASED_VALUE;
+
 protected:
-	attributes::attribute_map m_map;
-	std::vector<char> m_data;
+	attributes::attribute_map_handle m_map;
+	data_vector m_data;
 	std::vector<unsigned int> m_bufferPointers;
 	unsigned int m_numValues;
 	bool m_pointersSet;
+	std::vector<dirty_range> m_dirtyRanges;
+	bool m_allDirty;
+	std::vector<value_range> m_freeRanges;
+	unsigned int m_numFreeValues;
 
 public:
 	/**
 	 * \brief Initializes the attribute buffer.
 	 *
 	 * \param map A reference to an attribute map.
+	 * \param allocator A reference to the storage allocator the values are stored in, which must outlive the buffer.
 	 *
-	 * Intializes the attribute buffer using the provided attribute map.
+	 * Intializes the attribute buffer using the provided attribute map. The values are stored in memory from the default storage allocator
+	 * if no allocator is provided.
 	 */
-	attribute_buffer( const attributes::attribute_map& map );
-	~attribute_buffer();
+	attribute_buffer( const attributes::attribute_map& map, storage::storage_allocator& allocator = storage::storage_allocator::get_default_allocator() );
+	virtual ~attribute_buffer();
 
 	/**
 	 * \fn insert_values
@@ -39,43 +89,226 @@ public:
 	 * is preserved. The values in the vector parameter are assumed to be organized in the same way as the attributes in the attribute map.
 	 * If inserting a single value, a single value must be inserted for every attribute in the attribute map.
 	 */
-	virtual void insert_values( const std::vector<char>& values ) = 0;
+	void insert_values( const std::vector<char>& values );
+
+	/**
+	 * \fn insert_values
+	 * \brief Inserts values into the attribute buffer without an intermediate copy.
+	 *
+	 * \param values A pointer to the memory containing the values to be inserted.
+	 * \param numValues An unsigned int representing the number of values that values points to.
+	 *
+	 * Inserts numValues values, read directly from the memory pointed to by values, into the attribute buffer. The memory is assumed to be
+	 * organized in the same way as the vector passed to the other insert_values function and must be numValues times the byte size of the
+	 * attribute map long. Erased values are reused first, starting with the lowest index, and the rest of the values are appended to the end
+	 * of the buffer. get_next_indices returns the indices the values will be stored at. An exception is thrown if values is null or numValues
+	 * is 0.
+	 */
+	void insert_values( const void* values, const unsigned int numValues );
+
+	/**
+	 * \fn insert_values
+	 * \brief Inserts a range of vertex structures into the attribute buffer.
+	 *
+	 * \param first A forward iterator to the first vertex structure to be inserted.
+	 * \param last A forward iterator to the position after the last vertex structure to be inserted.
+	 *
+	 * Inserts each vertex structure in the range [first, last) into the attribute buffer. Each structure must contain a single value of every
+	 * attribute in the attribute map, in the order the attributes were added and without padding between them. Erased values are reused and
+	 * the rest are appended in a single step, then each structure is written straight into the storage of the buffer. An exception is thrown
+	 * if the size of the structure does not match the byte size of the attribute map.
+	 */
+	template<typename ForwardIterator>
+	void insert_values( ForwardIterator first, ForwardIterator last );
+
+	/**
+	 * \fn insert_values
+	 * \brief Inserts an array of vertex structures into the attribute buffer.
+	 *
+	 * \param first A pointer to the first vertex structure to be inserted.
+	 * \param last A pointer to the position after the last vertex structure to be inserted.
+	 *
+	 * Behaves like the iterator version, but the structures of an interleaved buffer are copied from the array with a single insert.
+	 */
+	template<typename T>
+	void insert_values( T* first, T* last );
+
+	/**
+	 * \fn insert_encoded_values
+	 * \brief Converts floating point values into the storage format of each attribute and inserts them into the attribute buffer.
+	 *
+	 * \param values A pointer to the floating point components of the values, holding every value of the first attribute followed by every
+	 * value of the next, arity components for each value.
+	 * \param numValues An unsigned int representing the number of values to be inserted.
+	 *
+	 * Converts all the values of each attribute with a single call to attribute_encoder::encode_values, so compact attributes such as half
+	 * floats, normalized bytes and packed vectors can be filled from floats, then inserts them the same way as insert_values. An exception is
+	 * thrown if values is null or numValues is 0.
+	 */
+	void insert_encoded_values( const float* values, const unsigned int numValues );
+
+	/**
+	 * \fn update_values
+	 * \brief Overwrites values that are already in the attribute buffer.
+	 *
+	 * \param firstValue An unsigned int representing the index of the first value to be overwritten.
+	 * \param numValues An unsigned int representing the number of values to be overwritten.
+	 * \param values A pointer to the memory containing the new values.
+	 *
+	 * Overwrites the values in the range [firstValue, firstValue + numValues) in place. The memory is organized the same way as the memory
+	 * passed to insert_values, and the bytes written are recorded as dirty ranges. An exception is thrown if values is null, numValues is 0 or
+	 * the range goes past the end of the buffer.
+	 */
+	void update_values( const unsigned int firstValue, const unsigned int numValues, const void* values );
+
+	/**
+	 * \fn erase_values
+	 * \brief Erases values from the attribute buffer.
+	 *
+	 * \param firstValue An unsigned int representing the index of the first value to be erased.
+	 * \param numValues An unsigned int representing the number of values to be erased.
+	 *
+	 * Adds the values in the range [firstValue, firstValue + numValues) to the free list, so they are reused by the next values inserted. The
+	 * storage and the indices of the other values do not change. An exception is thrown if numValues is 0, the range goes past the end of the
+	 * buffer, or the range contains a value that has already been erased.
+	 */
+	virtual void erase_values( const unsigned int firstValue, const unsigned int numValues );
+
+	/**
+	 * \fn compact
+	 * \brief Removes the erased values from the storage of the attribute buffer.
+	 *
+	 * \return A vector of unsigned ints containing the new index of every value, indexed by its old index. Erased values map to ERASED_VALUE.
+	 *
+	 * Moves the values that have not been erased towards the start of the buffer, keeping their order, and shrinks the buffer to the number of
+	 * values that remain. Anything that refers to values by index must be updated using the vector returned.
+	 */
+	const std::vector<unsigned int> compact();
+
+	/**
+	 * \fn reorder_values
+	 * \brief Moves every value in the attribute buffer to a new index.
+	 *
+	 * \param remap A reference to a vector containing the new index of every value, indexed by its old index.
+	 *
+	 * Moves each value to the index given by remap, which must contain every index in the buffer exactly once. Anything that refers to values
+	 * by index must be updated using remap. An exception is thrown if remap is not a permutation of the indices of the buffer or if the buffer
+	 * contains erased values, which should be compacted first.
+	 */
+	void reorder_values( const std::vector<unsigned int>& remap );
+
+	/**
+	 * \fn get_next_indices
+	 * \brief Gets the indices that the next values inserted will be stored at.
+	 *
+	 * \param numValues An unsigned int representing the number of values that will be inserted.
+	 * \return A vector of unsigned ints containing the index each of the values will be stored at, in the order they are inserted.
+	 */
+	const std::vector<unsigned int> get_next_indices( const unsigned int numValues ) const;
+
+	/**
+	 * \fn reserve
+	 * \brief Reserves storage for a number of values.
+	 *
+	 * \param numValues An unsigned int representing the number of values the buffer should be able to hold without reallocating.
+	 *
+	 * Reserves enough storage for the buffer to hold numValues values, so that inserting values up to that number does not cause the
+	 * storage of the buffer to be reallocated. If the buffer can already hold numValues values, nothing is done.
+	 */
+	virtual void reserve( const unsigned int numValues );
 
 	/**
 	 * \fn clear_buffer
 	 * \brief Removes all the values from the buffer.
 	 */
-	void clear_buffer();
+	virtual void clear_buffer();
 
 	/**
 	 * \fn get_byte_size
 	 * \brief Gets the size in bytes of the buffer.
 	 *
 	 * \return A std::size_t representing the size of the attribute buffer in bytes.
+	 *
+	 * Buffers with more than one section leave room for the capacity of the buffer at the end of every section, so the size includes those
+	 * gaps. get_used_ranges returns the bytes that actually hold values.
 	 */
-	const std::size_t get_byte_size() const;
+	virtual const std::size_t get_byte_size() const;
 
 	/**
 	 * \fn get_num_values
 	 * \brief Get the number of values in the buffer.
 	 *
-	 * \return An unsigned int representing the number of values in the buffer.
+	 * \return An unsigned int representing the number of values in the buffer, including the values that have been erased but not compacted.
 	 */
 	const unsigned int get_num_values() const;
 
+	/**
+	 * \fn get_num_free_values
+	 * \brief Gets the number of erased values in the buffer.
+	 *
+	 * \return An unsigned int representing the number of values that have been erased and not yet reused or compacted.
+	 */
+	const unsigned int get_num_free_values() const;
+
+	/**
+	 * \fn get_free_ranges
+	 * \brief Gets the ranges of values that have been erased.
+	 *
+	 * \return A reference to a vector of value ranges, sorted by index. Ranges that touch are merged into a single range.
+	 */
+	const std::vector<value_range>& get_free_ranges() const;
+
+	/**
+	 * \fn is_value_erased
+	 * \brief Checks whether a value has been erased.
+	 *
+	 * \param index An unsigned int representing the index of the value.
+	 * \return Returns true if the value has been erased and not yet reused, otherwise false.
+	 */
+	const bool is_value_erased( const unsigned int index ) const;
+
+	/**
+	 * \fn get_capacity
+	 * \brief Gets the number of values the buffer can hold before its storage is reallocated.
+	 *
+	 * \return An unsigned int representing the number of values the buffer can hold without reallocating.
+	 */
+	virtual const unsigned int get_capacity() const;
+
 	/**
 	 * \fn get_all_data
 	 * \brief Gets the data in the attribute buffer.
 	 *
 	 * \return A reference to a vector of character representing the values stored in the attribute buffer.
 	 */
-	const std::vector<char>& get_all_data() const;
+	const data_vector& get_all_data() const;
+
+	/**
+	 * \fn get_data
+	 * \brief Gets a pointer to the data in the attribute buffer.
+	 *
+	 * \return A pointer to the first byte of the values stored in the attribute buffer, or NULL if the buffer has no storage.
+	 *
+	 * Unlike get_all_data, this works for buffers whose values are not stored in a vector, so it should be used by code that only needs to read
+	 * get_byte_size bytes of values.
+	 */
+	virtual const char* get_data() const;
+
+	/**
+	 * \fn get_storage_allocator
+	 * \brief Gets the storage allocator the values are stored in.
+	 *
+	 * \return A reference to the storage allocator that was passed to the constructor.
+	 */
+	storage::storage_allocator& get_storage_allocator() const;
 
 	/**
 	 * \fn get_attribute_map
 	 * \brief Gets the attribute map of the attribute buffer.
 	 *
 	 * \return A reference to the attribute map of the attribute buffer.
+	 *
+	 * The map is interned by the attribute_map_registry, so buffers whose maps are equal return references to the same map.
 	 */
 	const attributes::attribute_map& get_attribute_map() const;
 
@@ -88,13 +321,213 @@ public:
 	 */
 	const std::vector<unsigned int>& get_attribute_data_offsets() const;
 
+	/**
+	 * \fn get_used_ranges
+	 * \brief Gets the ranges of bytes that hold values.
+	 *
+	 * \return A vector of ranges, sorted by offset, covering the values stored in every section of the buffer. Sections that follow each other
+	 * without a gap are merged into a single range.
+	 *
+	 * Everything in the first get_byte_size bytes outside of these ranges is unused capacity.
+	 */
+	const std::vector<dirty_range> get_used_ranges() const;
+
+	/**
+	 * \fn get_dirty_ranges
+	 * \brief Gets the ranges of bytes that have been overwritten.
+	 *
+	 * \return A reference to a vector of dirty ranges, sorted by offset. Ranges that overlap or touch are merged into a single range.
+	 *
+	 * Gets the ranges of bytes that have been overwritten since the dirty ranges were last cleared. The ranges are only meaningful if
+	 * is_all_dirty returns false.
+	 */
+	const std::vector<dirty_range>& get_dirty_ranges() const;
+
+	/**
+	 * \fn is_all_dirty
+	 * \brief Checks whether the whole buffer needs to be uploaded again.
+	 *
+	 * \return Returns true if the size or layout of the storage has changed since the dirty ranges were last cleared, otherwise false.
+	 */
+	const bool is_all_dirty() const;
+
+	/**
+	 * \fn clear_dirty_ranges
+	 * \brief Marks the whole buffer as clean.
+	 *
+	 * Should be called once the contents of the buffer have been uploaded.
+	 */
+	void clear_dirty_ranges();
+
+protected:
+	/**
+	 * \fn overwrite_values
+	 * \brief Overwrites values that are already in the attribute buffer.
+	 *
+	 * \param firstValue An unsigned int representing the index of the first value to be overwritten.
+	 * \param numValues An unsigned int representing the number of values to be overwritten.
+	 * \param values A pointer to the memory containing the new values, organized the same way as the memory passed to insert_values.
+	 * \param firstSource An unsigned int representing the index of the first value in values to be copied.
+	 * \param numSource An unsigned int representing the total number of values that values points to.
+	 *
+	 * Copies numValues values, starting with value firstSource of the numSource values pointed to by values, into the buffer starting at
+	 * firstValue. Subclasses copy the values into their storage and mark the bytes written as dirty.
+	 */
+	virtual void overwrite_values( const unsigned int firstValue, const unsigned int numValues, const char* values, const unsigned int firstSource,
+		const unsigned int numSource ) = 0;
+
+	/**
+	 * \fn append_values
+	 * \brief Adds values to the end of the attribute buffer.
+	 *
+	 * \param numValues An unsigned int representing the number of values to be added.
+	 *
+	 * Grows the storage so that it holds numValues more values. The contents of the new values are written afterwards using overwrite_values.
+	 */
+	virtual void append_values( const unsigned int numValues ) = 0;
+
+	/**
+	 * \fn move_values
+	 * \brief Moves values towards the start of the attribute buffer.
+	 *
+	 * \param destValue An unsigned int representing the index the first value is moved to, which is less than sourceValue.
+	 * \param sourceValue An unsigned int representing the index of the first value to be moved.
+	 * \param numValues An unsigned int representing the number of values to be moved.
+	 */
+	virtual void move_values( const unsigned int destValue, const unsigned int sourceValue, const unsigned int numValues ) = 0;
+
+	/**
+	 * \fn truncate_values
+	 * \brief Removes values from the end of the attribute buffer.
+	 *
+	 * \param numValues An unsigned int representing the number of values the buffer should contain.
+	 */
+	virtual void truncate_values( const unsigned int numValues ) = 0;
+
+	/**
+	 * \fn permute_values
+	 * \brief Moves every value in the attribute buffer to a new index.
+	 *
+	 * \param remap A reference to a vector containing the new index of every value, which has already been checked to be a permutation.
+	 */
+	virtual void permute_values( const std::vector<unsigned int>& remap ) = 0;
+
+	/**
+	 * \fn mark_dirty
+	 * \brief Records a range of bytes as dirty.
+	 *
+	 * \param offset A std::size_t representing the offset of the first byte that changed.
+	 * \param size A std::size_t representing the number of bytes that changed.
+	 *
+	 * Records the range, merging it with any dirty range it overlaps or touches so that the ranges stay sorted and as few as possible.
+	 */
+	void mark_dirty( const std::size_t offset, const std::size_t size );
+
+	/**
+	 * \fn mark_all_dirty
+	 * \brief Records the whole buffer as dirty.
+	 */
+	void mark_all_dirty();
+
 private:
 	/**
 	 * \fn init_buffer
 	 * \brief Initializes the attribute buffer.
 	 */
 	void init_buffer();
+
+	/**
+	 * \fn write_structures
+	 * \brief Writes a range of vertex structures into the attribute buffer.
+	 *
+	 * \param first A forward iterator to the first vertex structure to be written.
+	 * \param last A forward iterator to the position after the last vertex structure to be written.
+	 *
+	 * A single value is laid out the same way in every layout, so each structure is passed to overwrite_values as is. The structures fill the
+	 * erased values first, and the values needed for the rest are appended before any of them is written.
+	 */
+	template<typename ForwardIterator>
+	void write_structures( ForwardIterator first, ForwardIterator last );
+
+	/**
+	 * \fn take_free_value
+	 * \brief Removes the lowest erased value from the free ranges.
+	 *
+	 * \return An unsigned int representing the index of the value, which must be overwritten by the caller.
+	 */
+	const unsigned int take_free_value();
+
+	/**
+	 * \fn check_structure_size
+	 * \brief Throws an exception if the size of a vertex structure does not match the byte size of the attribute map.
+	 */
+	void check_structure_size( const std::size_t structureSize ) const;
+
+	/**
+	 * \fn add_range
+	 * \brief Adds a range to a sorted vector of ranges.
+	 *
+	 * \param ranges A reference to a vector of ranges, sorted by offset and without any ranges that overlap or touch.
+	 * \param offset The offset of the range to be added.
+	 * \param size The size of the range to be added.
+	 *
+	 * Adds the range, merging it with any range it overlaps or touches so that the ranges stay sorted and as few as possible.
+	 */
+	template<typename T>
+	static void add_range( std::vector< std::pair<T, T> >& ranges, const T offset, const T size );
+
+	/**
+	 * \fn range_ends_before
+	 * \brief Checks whether a range ends before an offset, so that a range starting at the offset can not be merged with it.
+	 */
+	template<typename T>
+	static const bool range_ends_before( const std::pair<T, T>& range, const T offset );
+
+	/**
+	 * \fn starts_before_range
+	 * \brief Checks whether an offset is before the start of a range.
+	 */
+	static const bool starts_before_range( const unsigned int offset, const value_range& range );
 };
 
+template<typename ForwardIterator>
+void attribute_buffer::insert_values( ForwardIterator first, ForwardIterator last ) {
+	typedef typename std::iterator_traits<ForwardIterator>::value_type structure_type;
+
+	check_structure_size( sizeof( structure_type ) );
+	write_structures( first, last );
+}
+
+template<typename T>
+void attribute_buffer::insert_values( T* first, T* last ) {
+	check_structure_size( sizeof( T ) );
+
+	if( first != last && m_map->is_interleaved() )
+		insert_values( static_cast<const void*>( first ), static_cast<unsigned int>( last - first ) );
+	else
+		write_structures( first, last );
+}
+
+template<typename ForwardIterator>
+void attribute_buffer::write_structures( ForwardIterator first, ForwardIterator last ) {
+	const unsigned int numValues = static_cast<unsigned int>( std::distance( first, last ) );
+
+	if( numValues == 0 )
+		return;
+
+	const unsigned int firstAppended = m_numValues;
+
+	if( numValues > m_numFreeValues )
+		append_values( numValues - m_numFreeValues );
+
+	for( ; first != last && !m_freeRanges.empty(); ++first ) {
+		overwrite_values( take_free_value(), 1, reinterpret_cast<const char*>( &*first ), 0, 1 );
+	}
+
+	for( unsigned int value = firstAppended; first != last; ++first, ++value ) {
+		overwrite_values( value, 1, reinterpret_cast<const char*>( &*first ), 0, 1 );
+	}
+}
+
 } // end of buffers namespace
 } // end of occluded namespace
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "attribute_buffer_builder.h"
+#include "attribute_transcoder.h"
+
+#include <boost/cstdint.hpp>
+
+namespace occluded { namespace buffers {
+
+attribute_buffer_builder::attribute_buffer_builder( const attributes::attribute_map& map, const unsigned int numChunks ):
+	m_map( map )
+{
+	if( numChunks == 0 ) {
+		throw std::runtime_error( "attribute_buffer_builder: Failed to create builder because the number of chunks was 0." );
+	}
+
+	m_chunks.reserve( numChunks );
+
+	for( unsigned int i = 0; i < numChunks; ++i ) {
+		m_chunks.push_back( boost::shared_ptr<attribute_buffer_chunk>( new attribute_buffer_chunk( m_map ) ) );
+	}
+}
+
+attribute_buffer_builder::~attribute_buffer_builder()
+{
+}
+
+attribute_buffer_chunk& attribute_buffer_builder::get_chunk( const unsigned int chunk ) {
+	if( chunk >= m_chunks.size() ) {
+		throw std::runtime_error( "attribute_buffer_builder.get_chunk: Failed to get chunk(" + boost::lexical_cast<std::string>( chunk )
+			+ ") because the builder only has " + boost::lexical_cast<std::string>( m_chunks.size() ) + " chunks." );
+	}
+
+	return *m_chunks[chunk];
+}
+
+const unsigned int attribute_buffer_builder::get_num_chunks() const {
+	return static_cast<unsigned int>( m_chunks.size() );
+}
+
+const unsigned int attribute_buffer_builder::get_num_values() const {
+	unsigned int numValues = 0;
+
+	for( unsigned int i = 0; i < m_chunks.size(); ++i ) {
+		numValues += m_chunks[i]->get_num_values();
+	}
+
+	return numValues;
+}
+
+std::auto_ptr<attribute_buffer> attribute_buffer_builder::build( std::vector<unsigned int>& indices, storage::storage_allocator& allocator ) {
+	std::auto_ptr<attribute_buffer> newBuffer = attribute_buffer_factory::create_attribute_buffer( m_map, allocator );
+	boost::uint64_t numValues = 0;
+	std::size_t numIndices = 0;
+	unsigned int i = 0;
+
+	// Everything is checked before anything is copied, so that a failed build leaves the chunks as they were
+	for( i = 0; i < m_chunks.size(); ++i ) {
+		const std::vector<unsigned int>& chunkIndices = m_chunks[i]->get_indices();
+
+		for( std::size_t j = 0; j < chunkIndices.size(); ++j ) {
+			if( chunkIndices[j] >= m_chunks[i]->get_num_values() ) {
+				throw std::runtime_error( "attribute_buffer_builder.build: Failed to build buffer because index(" + boost::lexical_cast<std::string>( j )
+					+ ") of chunk(" + boost::lexical_cast<std::string>( i ) + ") refers to a value that is not in the chunk." );
+			}
+		}
+
+		numValues += m_chunks[i]->get_num_values();
+		numIndices += chunkIndices.size();
+	}
+
+	if( numValues > 0xffffffffu ) {
+		throw std::runtime_error( "attribute_buffer_builder.build: Failed to build buffer because the chunks contained " +
+			boost::lexical_cast<std::string>( numValues ) + " values, which is more than can be indexed." );
+	}
+
+	indices.clear();
+	indices.reserve( numIndices );
+
+	if( numValues == 0 )
+		return newBuffer;
+
+	// Size the storage once, so every chunk can be copied straight into the place it is stored
+	newBuffer->append_values( static_cast<unsigned int>( numValues ) );
+
+	const std::vector<unsigned int>& sections = m_map.get_attribute_sections();
+	const std::vector<unsigned int>& strides = m_map.get_section_strides();
+	std::vector<unsigned int> sectionOffsets( newBuffer->m_bufferPointers );
+	unsigned int firstValue = 0;
+
+	for( i = 0; i < m_chunks.size(); ++i ) {
+		attribute_buffer_chunk& chunk = *m_chunks[i];
+		const std::vector<unsigned int>& chunkIndices = chunk.get_indices();
+
+		if( chunk.get_num_values() > 0 ) {
+			if( m_map.is_interleaved() ) {
+				memcpy( &newBuffer->m_data[firstValue * m_map.get_byte_size()], &chunk.get_values()[0], chunk.get_values().size() );
+			} else {
+				for( unsigned int j = 0; j < sections.size(); ++j ) {
+					sectionOffsets[j] = newBuffer->m_bufferPointers[j] + firstValue * strides[sections[j]];
+				}
+
+				attribute_transcoder::deinterleave( m_map, &chunk.get_values()[0], chunk.get_num_values(), &newBuffer->m_data[0], sectionOffsets );
+			}
+		}
+
+		for( std::size_t j = 0; j < chunkIndices.size(); ++j ) {
+			indices.push_back( chunkIndices[j] + firstValue );
+		}
+
+		firstValue += chunk.get_num_values();
+		chunk.clear();
+	}
+
+	return newBuffer;
+}
+
+} // end of buffers namespace
+} // end of occluded namespace
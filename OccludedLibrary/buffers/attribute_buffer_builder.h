@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include <boost/shared_ptr.hpp>
+
+#include "attribute_buffer_chunk.h"
+#include "attribute_buffer_factory.h"
+
+namespace occluded { namespace buffers {
+
+/**
+ * \class attribute_buffer_builder
+ * \brief Builds an attribute buffer from chunks that are filled in parallel.
+ *
+ * Owns a fixed number of attribute_buffer_chunks, which are meant to be handed to worker threads so that each thread fills its own chunk
+ * without sharing any state with the others. The builder does not create threads itself, so it can be used with whatever threading the
+ * application already has. Each chunk is allocated separately, so that threads growing different chunks do not write to the same cache lines.
+ *
+ * Once every worker is finished, build merges the chunks in order into a single attribute buffer with the layout of the map. The storage of
+ * the buffer is sized once from the number of values in the chunks, and each chunk is copied straight into its place, so the merge reads and
+ * writes every value a single time. The indices of each chunk are offset by the index of the chunk's first value in the buffer.
+ */
+class attribute_buffer_builder
+{
+private:
+	attributes::attribute_map m_map;
+	std::vector< boost::shared_ptr<attribute_buffer_chunk> > m_chunks;
+
+public:
+	/**
+	 * \brief Initializes the builder with empty chunks.
+	 *
+	 * \param map A reference to the attribute map describing the values, which also decides whether the buffer built is interleaved.
+	 * \param numChunks An unsigned int representing the number of chunks, which is usually the number of worker threads.
+	 *
+	 * An exception is thrown if numChunks is 0, or if the map is still being defined or has no attributes.
+	 */
+	attribute_buffer_builder( const attributes::attribute_map& map, const unsigned int numChunks );
+	~attribute_buffer_builder();
+
+	/**
+	 * \fn get_chunk
+	 * \brief Gets one of the chunks of the builder.
+	 *
+	 * \param chunk An unsigned int representing the index of the chunk.
+	 * \return A reference to the chunk. Chunks with lower indices are merged first.
+	 *
+	 * Getting a chunk does not change the builder, so different threads can get their chunks at the same time. An exception is thrown if chunk
+	 * is not less than the number of chunks.
+	 */
+	attribute_buffer_chunk& get_chunk( const unsigned int chunk );
+
+	/**
+	 * \fn get_num_chunks
+	 * \brief Gets the number of chunks of the builder.
+	 *
+	 * \return An unsigned int representing the number of chunks passed to the constructor.
+	 */
+	const unsigned int get_num_chunks() const;
+
+	/**
+	 * \fn get_num_values
+	 * \brief Gets the number of values in every chunk.
+	 *
+	 * \return An unsigned int representing the number of values the buffer built will contain.
+	 */
+	const unsigned int get_num_values() const;
+
+	/**
+	 * \fn build
+	 * \brief Merges the chunks into a single attribute buffer.
+	 *
+	 * \param indices A reference to a vector of unsigned ints that is replaced by the indices of every chunk, offset to refer to the buffer.
+	 * \param allocator A reference to the storage allocator the values of the buffer are stored in, which must outlive the buffer.
+	 * \return The attribute buffer containing the values of every chunk, in the order of the chunks.
+	 *
+	 * Must not be called while any chunk is being filled. Each chunk is cleared once it has been copied, so the values are only held twice for
+	 * one chunk at a time. An exception is thrown if an index of a chunk is not less than the number of values in the chunk, in which case
+	 * the chunks are left unchanged, or if the total number of values does not fit in an unsigned int.
+	 */
+	std::auto_ptr<attribute_buffer> build( std::vector<unsigned int>& indices,
+		storage::storage_allocator& allocator = storage::storage_allocator::get_default_allocator() );
+};
+
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,74 @@
+#include "attribute_buffer_chunk.h"
+
+namespace occluded { namespace buffers {
+
+attribute_buffer_chunk::attribute_buffer_chunk( const attributes::attribute_map& map ):
+	m_map( map ),
+	m_numValues( 0 )
+{
+	if( m_map.being_defined() ) {
+		throw std::runtime_error( "attribute_buffer_chunk: Failed to create chunk because the attribute map is still being defined." );
+	}
+
+	if( m_map.get_byte_size() == 0 ) {
+		throw std::runtime_error( "attribute_buffer_chunk: Failed to create chunk because the attribute map contained no attributes." );
+	}
+}
+
+attribute_buffer_chunk::~attribute_buffer_chunk()
+{
+}
+
+const unsigned int attribute_buffer_chunk::add_values( const void* values, const unsigned int numValues ) {
+	const unsigned int firstValue = m_numValues;
+
+	if( values == NULL ) {
+		throw std::runtime_error( "attribute_buffer_chunk.add_values: Failed to add values because the pointer to the values was null." );
+	}
+
+	if( numValues == 0 ) {
+		throw std::runtime_error( "attribute_buffer_chunk.add_values: Failed to add values because the number of values was 0." );
+	}
+
+	const char* bytes = static_cast<const char*>( values );
+
+	m_values.insert( m_values.end(), bytes, bytes + numValues * m_map.get_byte_size() );
+	m_numValues += numValues;
+
+	return firstValue;
+}
+
+void attribute_buffer_chunk::add_indices( const std::vector<unsigned int>& indices ) {
+	m_indices.insert( m_indices.end(), indices.begin(), indices.end() );
+}
+
+void attribute_buffer_chunk::reserve( const unsigned int numValues, const unsigned int numIndices ) {
+	m_values.reserve( numValues * m_map.get_byte_size() );
+	m_indices.reserve( numIndices );
+}
+
+void attribute_buffer_chunk::clear() {
+	// Swapping with empty vectors frees the storage, which clear alone does not
+	std::vector<char>().swap( m_values );
+	std::vector<unsigned int>().swap( m_indices );
+	m_numValues = 0;
+}
+
+const unsigned int attribute_buffer_chunk::get_num_values() const {
+	return m_numValues;
+}
+
+const std::vector<char>& attribute_buffer_chunk::get_values() const {
+	return m_values;
+}
+
+const std::vector<unsigned int>& attribute_buffer_chunk::get_indices() const {
+	return m_indices;
+}
+
+const attributes::attribute_map& attribute_buffer_chunk::get_attribute_map() const {
+	return m_map;
+}
+
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+#include <boost/lexical_cast.hpp>
+
+#include "attributes/attribute_map.h"
+
+namespace occluded { namespace buffers {
+
+/**
+ * \class attribute_buffer_chunk
+ * \brief Collects values and indices for part of an attribute buffer.
+ *
+ * Stores a block of values and the indices that refer to them, so that parts of a mesh can be generated independently and later merged into
+ * a single attribute buffer by an attribute_buffer_builder. Each value is stored as a single structure containing every attribute in the order
+ * they were added, which is how a single value is laid out in both interleaved and segregated buffers. Indices are relative to the first value
+ * of the chunk.
+ *
+ * A chunk does not share any state with other chunks, so different chunks can be filled by different threads at the same time without any
+ * locking. A single chunk must not be used by more than one thread at a time.
+ */
+class attribute_buffer_chunk
+{
+private:
+	attributes::attribute_map m_map;
+	std::vector<char> m_values;
+	unsigned int m_numValues;
+	std::vector<unsigned int> m_indices;
+
+public:
+	/**
+	 * \brief Initializes an empty chunk.
+	 *
+	 * \param map A reference to the attribute map describing the values.
+	 *
+	 * An exception is thrown if the map is still being defined or has no attributes.
+	 */
+	attribute_buffer_chunk( const attributes::attribute_map& map );
+	~attribute_buffer_chunk();
+
+	/**
+	 * \fn add_values
+	 * \brief Adds values to the end of the chunk.
+	 *
+	 * \param values A pointer to the values, each containing every attribute in the order they were added and without padding between them.
+	 * \param numValues An unsigned int representing the number of values that values points to.
+	 * \return An unsigned int representing the index, relative to the chunk, of the first value added.
+	 *
+	 * An exception is thrown if values is null or numValues is 0.
+	 */
+	const unsigned int add_values( const void* values, const unsigned int numValues );
+
+	/**
+	 * \fn add_indices
+	 * \brief Adds indices to the end of the chunk.
+	 *
+	 * \param indices A reference to a vector of unsigned ints containing indices relative to the first value of the chunk.
+	 *
+	 * The indices may refer to values that have not been added yet. They are checked when the chunk is merged.
+	 */
+	void add_indices( const std::vector<unsigned int>& indices );
+
+	/**
+	 * \fn reserve
+	 * \brief Reserves storage for a number of values and indices.
+	 *
+	 * \param numValues An unsigned int representing the number of values the chunk should be able to hold without reallocating.
+	 * \param numIndices An unsigned int representing the number of indices the chunk should be able to hold without reallocating.
+	 */
+	void reserve( const unsigned int numValues, const unsigned int numIndices = 0 );
+
+	/**
+	 * \fn clear
+	 * \brief Removes every value and index from the chunk and frees its storage.
+	 */
+	void clear();
+
+	/**
+	 * \fn get_num_values
+	 * \brief Gets the number of values in the chunk.
+	 *
+	 * \return An unsigned int representing the number of values that have been added.
+	 */
+	const unsigned int get_num_values() const;
+
+	/**
+	 * \fn get_values
+	 * \brief Gets the values in the chunk.
+	 *
+	 * \return A reference to a vector of characters containing the values, one structure after another.
+	 */
+	const std::vector<char>& get_values() const;
+
+	/**
+	 * \fn get_indices
+	 * \brief Gets the indices in the chunk.
+	 *
+	 * \return A reference to a vector of unsigned ints containing the indices, relative to the first value of the chunk.
+	 */
+	const std::vector<unsigned int>& get_indices() const;
+
+	/**
+	 * \fn get_attribute_map
+	 * \brief Gets the attribute map of the chunk.
+	 *
+	 * \return A reference to the attribute map passed to the constructor.
+	 */
+	const attributes::attribute_map& get_attribute_map() const;
+};
+
+} // end of buffers namespace
+} // end of occluded namespace
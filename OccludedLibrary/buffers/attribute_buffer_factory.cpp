@@ -2,15 +2,60 @@
 
 namespace occluded { namespace buffers {
 
-std::auto_ptr<attribute_buffer> attribute_buffer_factory::create_attribute_buffer( const attributes::attribute_map& map ) {
+std::auto_ptr<attribute_buffer> attribute_buffer_factory::create_attribute_buffer( const attributes::attribute_map& map, storage::storage_allocator& allocator ) {
 	std::auto_ptr<attribute_buffer> newBuffer;
 	
-	if( map.is_interleaved() ) {
-		newBuffer.reset( new interleaved_attr_buffer( map ) );
+	switch( map.get_layout() ) {
+	case attributes::layout_interleaved:
+		newBuffer.reset( new interleaved_attr_buffer( map, allocator ) );
+		break;
+	case attributes::layout_hybrid:
+		newBuffer.reset( new hybrid_attr_buffer( map, allocator ) );
+		break;
+	case attributes::layout_segregated:
+	default:
+		newBuffer.reset( new segregated_attr_buffer( map, allocator ) );
+		break;
+	}
+
+	return newBuffer;
+}
+
+std::auto_ptr<attribute_buffer> attribute_buffer_factory::create_transcoded_buffer( const attribute_buffer& buffer ) {
+	std::auto_ptr<attribute_buffer> newBuffer;
+
+	if( const interleaved_attr_buffer* interleaved = dynamic_cast<const interleaved_attr_buffer*>( &buffer ) ) {
+		newBuffer.reset( new segregated_attr_buffer( *interleaved ) );
+	} else if( const segregated_attr_buffer* segregated = dynamic_cast<const segregated_attr_buffer*>( &buffer ) ) {
+		newBuffer.reset( new interleaved_attr_buffer( *segregated ) );
 	} else {
-		newBuffer.reset( new segregated_attr_buffer( map ) );
+		throw std::runtime_error( "attribute_buffer_factory.create_transcoded_buffer: Failed to transcode buffer because it is neither an interleaved"
+			+ std::string( " nor a segregated attribute buffer." ) );
+	}
+
+	return newBuffer;
+}
+
+std::auto_ptr<attribute_buffer> attribute_buffer_factory::create_copy( const attribute_buffer& buffer, storage::storage_allocator& allocator ) {
+	const attributes::attribute_map& map = buffer.get_attribute_map();
+	std::auto_ptr<attribute_buffer> newBuffer = create_attribute_buffer( map, allocator );
+	const unsigned int numValues = buffer.get_num_values();
+
+	if( numValues > 0 ) {
+		const std::vector<unsigned int>& strides = map.get_section_strides();
+
+		newBuffer->append_values( numValues );
+
+		// Section i starts with attribute i, so the offset of attribute i is the offset of the section
+		for( unsigned int i = 0; i < strides.size(); ++i ) {
+			memcpy( &newBuffer->m_data[newBuffer->m_bufferPointers[i]], buffer.get_data() + buffer.get_attribute_data_offsets()[i],
+				numValues * strides[i] );
+		}
 	}
 
+	newBuffer->m_freeRanges = buffer.m_freeRanges;
+	newBuffer->m_numFreeValues = buffer.m_numFreeValues;
+
 	return newBuffer;
 }
 
@@ -2,13 +2,41 @@
 
 #include "interleaved_attr_buffer.h"
 #include "segregated_attr_buffer.h"
+#include "hybrid_attr_buffer.h"
 
 namespace occluded { namespace buffers {
 
 class attribute_buffer_factory
 {
 public:
-	static std::auto_ptr<attribute_buffer> create_attribute_buffer( const attributes::attribute_map& map );
+	static std::auto_ptr<attribute_buffer> create_attribute_buffer( const attributes::attribute_map& map,
+		storage::storage_allocator& allocator = storage::storage_allocator::get_default_allocator() );
+
+	/**
+	 * \fn create_transcoded_buffer
+	 * \brief Creates a copy of an attribute buffer with the other organization.
+	 *
+	 * \param buffer A reference to the attribute buffer to be copied.
+	 * \return A segregated copy of the buffer if it is interleaved, otherwise an interleaved copy.
+	 *
+	 * Creates a copy of the buffer whose values are organized the other way, so values can be kept segregated for processing on the CPU and
+	 * interleaved for rendering. An exception is thrown if the buffer is neither an interleaved_attr_buffer nor a segregated_attr_buffer.
+	 */
+	static std::auto_ptr<attribute_buffer> create_transcoded_buffer( const attribute_buffer& buffer );
+
+	/**
+	 * \fn create_copy
+	 * \brief Creates a copy of an attribute buffer with the same organization.
+	 *
+	 * \param buffer A reference to the attribute buffer to be copied.
+	 * \param allocator A reference to the storage allocator the values of the copy are stored in, which must outlive the copy.
+	 * \return A copy of the buffer, including its erased values, whose whole storage is marked as dirty.
+	 *
+	 * Copies each section of the buffer with a single copy. The copy is always stored in memory from the allocator, so a buffer whose values
+	 * are mapped from a file is copied into a buffer that can be changed.
+	 */
+	static std::auto_ptr<attribute_buffer> create_copy( const attribute_buffer& buffer,
+		storage::storage_allocator& allocator = storage::storage_allocator::get_default_allocator() );
 
 private:
 	attribute_buffer_factory();
@@ -0,0 +1,260 @@
+#include "attribute_buffer_header.h"
+
+namespace occluded { namespace buffers {
+
+// The bytes "OCAB" read as a little endian integer
+const boost::uint32_t attribute_buffer_header::MAGIC = 0x4241434f;
+const boost::uint32_t attribute_buffer_header::MAX_NAME_LENGTH = 1024;
+const boost::uint32_t attribute_buffer_header::CHECKSUM_FLAG = 0x1;
+const boost::uint32_t attribute_buffer_header::COMPRESSED_FLAG = 0x2;
+const boost::uint32_t attribute_buffer_header::HYBRID_LAYOUT = 2;
+const boost::uint32_t attribute_buffer_header::VERSION = 3;
+const std::size_t attribute_buffer_header::SECTION_ALIGNMENT = 64;
+
+attribute_buffer_header::attribute_buffer_header( const attributes::attribute_map& map, const unsigned int numValues, const std::size_t sectionAlignment ):
+	m_map( map ),
+	m_numValues( numValues ),
+	m_checksum( 0 ),
+	m_hasChecksum( false ),
+	m_compressed( false )
+{
+	if( m_map.being_defined() ) {
+		throw std::runtime_error( "attribute_buffer_header: Failed to create header because the attribute map is still being defined." );
+	}
+
+	if( sectionAlignment == 0 || ( sectionAlignment & ( sectionAlignment - 1 ) ) != 0 ) {
+		throw std::runtime_error( "attribute_buffer_header: Failed to create header because the section alignment(" +
+			boost::lexical_cast<std::string>( sectionAlignment ) + ") is not a power of two." );
+	}
+
+	const unsigned int numSections = m_map.get_num_sections();
+	boost::uint64_t currOffset = 0;
+
+	// The offsets have to be stored before the size of the header is known
+	m_sectionOffsets.resize( numSections );
+	currOffset = get_header_size();
+
+	for( unsigned int i = 0; i < numSections; ++i ) {
+		currOffset = ( currOffset + sectionAlignment - 1 ) & ~static_cast<boost::uint64_t>( sectionAlignment - 1 );
+		m_sectionOffsets[i] = currOffset;
+		currOffset += get_section_size( i );
+	}
+}
+
+attribute_buffer_header attribute_buffer_header::read( std::istream& stream ) {
+	if( read_uint32( stream ) != MAGIC ) {
+		throw std::runtime_error( "attribute_buffer_header.read: Failed to read header because the stream does not start with an attribute buffer header." );
+	}
+
+	const boost::uint32_t version = read_uint32( stream );
+
+	// Version 2 only lacks the compressed flag, so its files are read the same way
+	if( version < 2 || version > VERSION ) {
+		throw std::runtime_error( "attribute_buffer_header.read: Failed to read header because its version(" + boost::lexical_cast<std::string>( version )
+			+ ") is not supported." );
+	}
+
+	const boost::uint32_t layout = read_uint32( stream );
+
+	if( layout > HYBRID_LAYOUT ) {
+		throw std::runtime_error( "attribute_buffer_header.read: Failed to read header because its layout(" + boost::lexical_cast<std::string>( layout )
+			+ ") is not supported." );
+	}
+
+	attributes::attribute_map map( layout == HYBRID_LAYOUT ? attributes::layout_hybrid : layout != 0 ? attributes::layout_interleaved
+		: attributes::layout_segregated );
+	const boost::uint32_t flags = read_uint32( stream );
+	const unsigned int numValues = read_uint32( stream );
+	const unsigned int numAttribs = read_uint32( stream );
+
+	for( unsigned int i = 0; i < numAttribs; ++i ) {
+		const boost::uint32_t type = read_uint32( stream );
+		const boost::uint32_t arity = read_uint32( stream );
+		const bool normalized = read_uint32( stream ) != 0;
+		const boost::uint32_t nameLength = read_uint32( stream );
+
+		if( type >= attributes::attrib_invalid || nameLength > MAX_NAME_LENGTH ) {
+			throw std::runtime_error( "attribute_buffer_header.read: Failed to read header because attribute(" + boost::lexical_cast<std::string>( i )
+				+ ") is not valid." );
+		}
+
+		std::string name( nameLength, '\0' );
+
+		if( nameLength > 0 && !stream.read( &name[0], nameLength ) ) {
+			throw std::runtime_error( "attribute_buffer_header.read: Failed to read header because the stream ended before the end of the header." );
+		}
+
+		map.add_attribute( attributes::attribute( name, arity, static_cast<attributes::attribute_t>( type ), normalized ) );
+	}
+
+	map.end_definition();
+
+	std::vector<boost::uint64_t> sectionOffsets( map.get_num_sections() );
+
+	for( unsigned int i = 0; i < sectionOffsets.size(); ++i ) {
+		sectionOffsets[i] = read_uint64( stream );
+	}
+
+	attribute_buffer_header header( map, numValues, sectionOffsets );
+	const boost::uint32_t checksum = read_uint32( stream );
+	boost::uint64_t sectionEnd = header.get_header_size();
+
+	// The sections have to be in order, so that each one can be checked against the end of the previous one
+	for( unsigned int i = 0; i < sectionOffsets.size(); ++i ) {
+		if( sectionOffsets[i] < sectionEnd ) {
+			throw std::runtime_error( "attribute_buffer_header.read: Failed to read header because section(" + boost::lexical_cast<std::string>( i )
+				+ ") overlaps the data before it." );
+		}
+
+		sectionEnd = sectionOffsets[i] + header.get_section_size( i );
+	}
+
+	if( ( flags & CHECKSUM_FLAG ) != 0 )
+		header.set_checksum( checksum );
+
+	if( ( flags & COMPRESSED_FLAG ) != 0 )
+		header.set_compressed();
+
+	return header;
+}
+
+void attribute_buffer_header::write( std::ostream& stream ) const {
+	const std::vector<const attributes::attribute>& attributes = m_map.get_attributes();
+
+	write_uint32( stream, MAGIC );
+	write_uint32( stream, VERSION );
+	write_uint32( stream, m_map.get_layout() == attributes::layout_hybrid ? HYBRID_LAYOUT : m_map.is_interleaved() ? 1 : 0 );
+	write_uint32( stream, ( m_hasChecksum ? CHECKSUM_FLAG : 0 ) | ( m_compressed ? COMPRESSED_FLAG : 0 ) );
+	write_uint32( stream, m_numValues );
+	write_uint32( stream, m_map.get_attrib_count() );
+
+	for( std::vector<const attributes::attribute>::const_iterator it = attributes.begin(); it != attributes.end(); ++it ) {
+		write_uint32( stream, it->get_type() );
+		write_uint32( stream, it->get_arity() );
+		write_uint32( stream, it->is_normalized() ? 1 : 0 );
+		write_uint32( stream, static_cast<boost::uint32_t>( it->get_name().size() ) );
+		stream.write( it->get_name().c_str(), it->get_name().size() );
+	}
+
+	for( std::vector<boost::uint64_t>::const_iterator it = m_sectionOffsets.begin(); it != m_sectionOffsets.end(); ++it ) {
+		write_uint64( stream, *it );
+	}
+
+	write_uint32( stream, m_checksum );
+
+	for( boost::uint64_t i = get_header_size(); i < get_data_offset(); ++i ) {
+		stream.put( '\0' );
+	}
+
+	if( !stream ) {
+		throw std::runtime_error( "attribute_buffer_header.write: Failed to write header because there was an error writing to the stream." );
+	}
+}
+
+const attributes::attribute_map& attribute_buffer_header::get_attribute_map() const {
+	return m_map;
+}
+
+const unsigned int attribute_buffer_header::get_num_values() const {
+	return m_numValues;
+}
+
+const std::vector<boost::uint64_t>& attribute_buffer_header::get_section_offsets() const {
+	return m_sectionOffsets;
+}
+
+void attribute_buffer_header::set_checksum( const boost::uint32_t checksum ) {
+	m_checksum = checksum;
+	m_hasChecksum = true;
+}
+
+const bool attribute_buffer_header::has_checksum() const {
+	return m_hasChecksum;
+}
+
+const boost::uint32_t attribute_buffer_header::get_checksum() const {
+	return m_checksum;
+}
+
+void attribute_buffer_header::set_compressed() {
+	m_compressed = true;
+}
+
+const bool attribute_buffer_header::is_compressed() const {
+	return m_compressed;
+}
+
+const boost::uint64_t attribute_buffer_header::get_section_size( const unsigned int section ) const {
+	const std::size_t valueSize = m_map.get_section_strides()[section];
+
+	return static_cast<boost::uint64_t>( m_numValues ) * valueSize;
+}
+
+const boost::uint64_t attribute_buffer_header::get_header_size() const {
+	// The magic number, version, layout flag, flags, number of values, number of attributes and checksum
+	boost::uint64_t size = 7 * sizeof( boost::uint32_t );
+	const std::vector<const attributes::attribute>& attributes = m_map.get_attributes();
+
+	for( std::vector<const attributes::attribute>::const_iterator it = attributes.begin(); it != attributes.end(); ++it ) {
+		size += 4 * sizeof( boost::uint32_t ) + it->get_name().size();
+	}
+
+	return size + m_sectionOffsets.size() * sizeof( boost::uint64_t );
+}
+
+const boost::uint64_t attribute_buffer_header::get_data_offset() const {
+	return m_sectionOffsets.empty() ? get_header_size() : m_sectionOffsets.front();
+}
+
+const boost::uint64_t attribute_buffer_header::get_file_size() const {
+	if( m_sectionOffsets.empty() )
+		return get_header_size();
+
+	return m_sectionOffsets.back() + get_section_size( static_cast<unsigned int>( m_sectionOffsets.size() - 1 ) );
+}
+
+// Private Member Functions
+
+attribute_buffer_header::attribute_buffer_header( const attributes::attribute_map& map, const unsigned int numValues,
+	const std::vector<boost::uint64_t>& sectionOffsets ):
+	m_map( map ),
+	m_numValues( numValues ),
+	m_sectionOffsets( sectionOffsets ),
+	m_checksum( 0 ),
+	m_hasChecksum( false ),
+	m_compressed( false )
+{
+}
+
+// Static Functions
+
+void attribute_buffer_header::write_uint32( std::ostream& stream, const boost::uint32_t value ) {
+	const char bytes[4] = { static_cast<char>( value ), static_cast<char>( value >> 8 ), static_cast<char>( value >> 16 ), static_cast<char>( value >> 24 ) };
+
+	stream.write( bytes, sizeof( bytes ) );
+}
+
+void attribute_buffer_header::write_uint64( std::ostream& stream, const boost::uint64_t value ) {
+	write_uint32( stream, static_cast<boost::uint32_t>( value ) );
+	write_uint32( stream, static_cast<boost::uint32_t>( value >> 32 ) );
+}
+
+const boost::uint32_t attribute_buffer_header::read_uint32( std::istream& stream ) {
+	unsigned char bytes[4];
+
+	if( !stream.read( reinterpret_cast<char*>( bytes ), sizeof( bytes ) ) ) {
+		throw std::runtime_error( "attribute_buffer_header.read: Failed to read header because the stream ended before the end of the header." );
+	}
+
+	return static_cast<boost::uint32_t>( bytes[0] ) | ( static_cast<boost::uint32_t>( bytes[1] ) << 8 ) | ( static_cast<boost::uint32_t>( bytes[2] ) << 16 )
+		| ( static_cast<boost::uint32_t>( bytes[3] ) << 24 );
+}
+
+const boost::uint64_t attribute_buffer_header::read_uint64( std::istream& stream ) {
+	const boost::uint64_t low = read_uint32( stream );
+
+	return low | ( static_cast<boost::uint64_t>( read_uint32( stream ) ) << 32 );
+}
+
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+
+#include <boost/cstdint.hpp>
+
+#include "attributes/attribute_map.h"
+
+namespace occluded { namespace buffers {
+
+/**
+ * \class attribute_buffer_header
+ * \brief Describes the layout of attribute buffer values stored in a file.
+ *
+ * Describes a file that stores the values of an attribute buffer exactly as the attribute map lays them out in memory. The header stores the
+ * structural description of the attribute map (its layout flag and the name, type, arity and normalization of each attribute), the number of
+ * values and the offset of each data section from the start of the file. An interleaved map has a single section containing every value,
+ * a segregated map has a section for each attribute and a hybrid map has a section for its first attribute and a section for the rest. Each
+ * section starts on a multiple of the section alignment, so the sections can be used in place once the file is mapped into memory.
+ *
+ * The header is stored as a magic number, a version, the layout flag (0 for segregated, 1 for interleaved and 2 for hybrid), a set of flags,
+ * the number of values and the number of attributes, followed by each attribute, the offset of each section and a checksum of the sections.
+ * Every integer is stored as a little endian 32-bit integer, except for the section offsets which are 64-bit integers. The checksum is a
+ * CRC-32 of the bytes of every section in order, and is only meaningful if the header says it is present.
+ *
+ * If the compressed flag is set, the section offsets still describe where each section would be stored uncompressed, but the sections are
+ * instead stored one after another from the first section offset as blocks compressed by stream_codec, so the file can not be mapped.
+ */
+class attribute_buffer_header
+{
+private:
+	attributes::attribute_map m_map;
+	unsigned int m_numValues;
+	std::vector<boost::uint64_t> m_sectionOffsets;
+	boost::uint32_t m_checksum;
+	bool m_hasChecksum;
+	bool m_compressed;
+
+	static const boost::uint32_t MAGIC;
+	static const boost::uint32_t MAX_NAME_LENGTH;
+	static const boost::uint32_t CHECKSUM_FLAG;
+	static const boost::uint32_t COMPRESSED_FLAG;
+	static const boost::uint32_t HYBRID_LAYOUT;
+
+public:
+	/**
+	 * The version of the file format written by the header.
+	 */
+	static const boost::uint32_t VERSION;
+
+	/**
+	 * The alignment in bytes of each section when none is passed to the constructor.
+	 */
+	static const std::size_t SECTION_ALIGNMENT;
+
+	/**
+	 * \brief Initializes the header for a file storing values with the layout of an attribute map.
+	 *
+	 * \param map A reference to the attribute map describing the values.
+	 * \param numValues An unsigned int representing the number of values stored in the file.
+	 * \param sectionAlignment A std::size_t representing the alignment in bytes of each section, which must be a power of two.
+	 *
+	 * Places each section after the header on the next multiple of sectionAlignment. An exception is thrown if the map is still being defined
+	 * or if sectionAlignment is not a power of two.
+	 */
+	attribute_buffer_header( const attributes::attribute_map& map, const unsigned int numValues, const std::size_t sectionAlignment = SECTION_ALIGNMENT );
+
+	/**
+	 * \fn read
+	 * \brief Reads a header from a stream.
+	 *
+	 * \param stream A reference to the stream, which must be positioned at the start of the header.
+	 * \return The header that was read.
+	 *
+	 * Reads the header and leaves the stream positioned at the end of it, before the padding up to the first section. An exception is thrown if
+	 * the stream does not contain a valid header, if it was written by a version that is not supported, or if its sections overlap.
+	 */
+	static attribute_buffer_header read( std::istream& stream );
+
+	/**
+	 * \fn write
+	 * \brief Writes the header to a stream.
+	 *
+	 * \param stream A reference to the stream, which must be positioned at the start of the file.
+	 *
+	 * Writes the header followed by the padding up to the first section, so the data of the first section can be written straight after it.
+	 */
+	void write( std::ostream& stream ) const;
+
+	/**
+	 * \fn get_attribute_map
+	 * \brief Gets the attribute map describing the values in the file.
+	 *
+	 * \return A reference to the attribute map.
+	 */
+	const attributes::attribute_map& get_attribute_map() const;
+
+	/**
+	 * \fn get_num_values
+	 * \brief Gets the number of values stored in the file.
+	 *
+	 * \return An unsigned int representing the number of values.
+	 */
+	const unsigned int get_num_values() const;
+
+	/**
+	 * \fn get_section_offsets
+	 * \brief Gets the offsets of the data sections.
+	 *
+	 * \return A reference to a vector containing the offset in bytes of each section from the start of the file.
+	 */
+	const std::vector<boost::uint64_t>& get_section_offsets() const;
+
+	/**
+	 * \fn set_checksum
+	 * \brief Sets the checksum of the sections, which marks the checksum as present.
+	 *
+	 * \param checksum A 32-bit unsigned integer representing the CRC-32 of the bytes of every section in order.
+	 */
+	void set_checksum( const boost::uint32_t checksum );
+
+	/**
+	 * \fn has_checksum
+	 * \brief Gets whether the header contains a checksum of the sections.
+	 *
+	 * \return Returns true if set_checksum was called or the header that was read contained a checksum, otherwise false.
+	 */
+	const bool has_checksum() const;
+
+	/**
+	 * \fn get_checksum
+	 * \brief Gets the checksum of the sections.
+	 *
+	 * \return A 32-bit unsigned integer representing the checksum, which is 0 if the header does not contain one.
+	 */
+	const boost::uint32_t get_checksum() const;
+
+	/**
+	 * \fn set_compressed
+	 * \brief Marks the sections as stored in compressed blocks rather than as they are laid out in memory.
+	 */
+	void set_compressed();
+
+	/**
+	 * \fn is_compressed
+	 * \brief Gets whether the sections are stored in compressed blocks.
+	 *
+	 * \return Returns true if set_compressed was called or the header that was read had the compressed flag set, otherwise false.
+	 */
+	const bool is_compressed() const;
+
+	/**
+	 * \fn get_section_size
+	 * \brief Gets the size of a data section.
+	 *
+	 * \param section An unsigned int representing the index of the section.
+	 * \return A 64-bit unsigned integer representing the size of the section in bytes.
+	 */
+	const boost::uint64_t get_section_size( const unsigned int section ) const;
+
+	/**
+	 * \fn get_header_size
+	 * \brief Gets the size of the header.
+	 *
+	 * \return A 64-bit unsigned integer representing the number of bytes written by write, not counting the padding after the header.
+	 */
+	const boost::uint64_t get_header_size() const;
+
+	/**
+	 * \fn get_data_offset
+	 * \brief Gets the offset of the first data section.
+	 *
+	 * \return A 64-bit unsigned integer representing the offset in bytes of the first section from the start of the file, or the size of the
+	 * header if there are no sections.
+	 */
+	const boost::uint64_t get_data_offset() const;
+
+	/**
+	 * \fn get_file_size
+	 * \brief Gets the size of the file described by the header.
+	 *
+	 * \return A 64-bit unsigned integer representing the offset in bytes of the end of the last section, which is only the size of the file if it
+	 * is not compressed.
+	 */
+	const boost::uint64_t get_file_size() const;
+
+private:
+	attribute_buffer_header( const attributes::attribute_map& map, const unsigned int numValues, const std::vector<boost::uint64_t>& sectionOffsets );
+
+	/**
+	 * \fn write_uint32
+	 * \brief Writes a 32-bit unsigned integer to a stream in little endian byte order.
+	 */
+	static void write_uint32( std::ostream& stream, const boost::uint32_t value );
+
+	/**
+	 * \fn write_uint64
+	 * \brief Writes a 64-bit unsigned integer to a stream in little endian byte order.
+	 */
+	static void write_uint64( std::ostream& stream, const boost::uint64_t value );
+
+	/**
+	 * \fn read_uint32
+	 * \brief Reads a 32-bit unsigned integer in little endian byte order from a stream, throwing an exception if the stream ends.
+	 */
+	static const boost::uint32_t read_uint32( std::istream& stream );
+
+	/**
+	 * \fn read_uint64
+	 * \brief Reads a 64-bit unsigned integer in little endian byte order from a stream, throwing an exception if the stream ends.
+	 */
+	static const boost::uint64_t read_uint64( std::istream& stream );
+};
+
+} // end of buffers namespace
+} // end of occluded namespace
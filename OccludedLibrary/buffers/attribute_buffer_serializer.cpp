@@ -0,0 +1,288 @@
+#include "attribute_buffer_serializer.h"
+
+#include <fstream>
+#include <algorithm>
+#include <limits>
+
+#include <boost/crc.hpp>
+
+namespace occluded { namespace buffers {
+
+const unsigned int attribute_buffer_serializer::COMPRESSED_BLOCK_VALUES = 0x4000;
+
+void attribute_buffer_serializer::save( std::ostream& stream, const attribute_buffer& buffer, const bool writeChecksum, const bool compress ) {
+	if( buffer.get_num_free_values() > 0 ) {
+		throw std::runtime_error( "attribute_buffer_serializer.save: Failed to save buffer because it contains erased values, which must be compacted"
+			+ std::string( " first." ) );
+	}
+
+	attribute_buffer_header header( buffer.get_attribute_map(), buffer.get_num_values() );
+	const std::vector<boost::uint64_t>& sectionOffsets = header.get_section_offsets();
+
+	if( writeChecksum )
+		header.set_checksum( compute_checksum( buffer ) );
+
+	if( compress )
+		header.set_compressed();
+
+	header.write( stream );
+
+	for( unsigned int i = 0; i < sectionOffsets.size(); ++i ) {
+		// Compressed sections have no fixed size, so they are stored one after another with no padding
+		if( compress ) {
+			save_compressed_section( stream, buffer, i );
+			continue;
+		}
+
+		const boost::uint64_t sectionEnd = i > 0 ? sectionOffsets[i - 1] + header.get_section_size( i - 1 ) : sectionOffsets[0];
+
+		// The header writes the padding up to the first section, so only the padding between sections is written here
+		for( boost::uint64_t j = sectionEnd; j < sectionOffsets[i]; ++j ) {
+			stream.put( '\0' );
+		}
+
+		if( header.get_section_size( i ) > 0 )
+			stream.write( get_section_data( buffer, i ), static_cast<std::streamsize>( header.get_section_size( i ) ) );
+	}
+
+	if( !stream ) {
+		throw std::runtime_error( "attribute_buffer_serializer.save: Failed to save buffer because there was an error writing to the stream." );
+	}
+}
+
+void attribute_buffer_serializer::save( const std::string& filePath, const attribute_buffer& buffer, const bool writeChecksum, const bool compress ) {
+	std::ofstream fileStream( filePath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+
+	if( !fileStream.is_open() ) {
+		throw std::runtime_error( "attribute_buffer_serializer.save: Failed to save buffer to file(" + filePath + ") because there was an error opening"
+			+ std::string( " the file." ) );
+	}
+
+	save( fileStream, buffer, writeChecksum, compress );
+}
+
+std::auto_ptr<attribute_buffer> attribute_buffer_serializer::load( std::istream& stream, storage::storage_allocator& allocator ) {
+	const attribute_buffer_header header = attribute_buffer_header::read( stream );
+	const std::vector<boost::uint64_t>& sectionOffsets = header.get_section_offsets();
+	std::auto_ptr<attribute_buffer> newBuffer = attribute_buffer_factory::create_attribute_buffer( header.get_attribute_map(), allocator );
+	boost::uint64_t currOffset = header.get_header_size();
+
+	if( header.get_num_values() == 0 || sectionOffsets.empty() )
+		return newBuffer;
+
+	check_section_sizes( stream, header );
+
+	// Size the storage once, so every section can be read straight into the place it is stored
+	newBuffer->append_values( header.get_num_values() );
+
+	std::vector<char> block;
+
+	if( header.is_compressed() )
+		skip_padding( stream, currOffset, header.get_data_offset() );
+
+	for( unsigned int i = 0; i < sectionOffsets.size(); ++i ) {
+		if( header.is_compressed() ) {
+			load_compressed_section( stream, *newBuffer, i, block );
+			continue;
+		}
+
+		const std::size_t sectionSize = static_cast<std::size_t>( header.get_section_size( i ) );
+		const std::size_t destOffset = newBuffer->m_bufferPointers[i];
+
+		skip_padding( stream, currOffset, sectionOffsets[i] );
+
+		if( sectionSize > 0 && !stream.read( &newBuffer->m_data[destOffset], static_cast<std::streamsize>( sectionSize ) ) ) {
+			throw std::runtime_error( "attribute_buffer_serializer.load: Failed to load buffer because the stream ended before section("
+				+ boost::lexical_cast<std::string>( i ) + ") was read." );
+		}
+
+		currOffset = sectionOffsets[i] + sectionSize;
+	}
+
+	if( header.has_checksum() && compute_checksum( *newBuffer ) != header.get_checksum() ) {
+		throw std::runtime_error( "attribute_buffer_serializer.load: Failed to load buffer because the checksum of the values does not match the"
+			+ std::string( " checksum in the header." ) );
+	}
+
+	return newBuffer;
+}
+
+std::auto_ptr<attribute_buffer> attribute_buffer_serializer::load( const std::string& filePath, storage::storage_allocator& allocator ) {
+	std::ifstream fileStream( filePath.c_str(), std::ios::in | std::ios::binary );
+
+	if( !fileStream.is_open() ) {
+		throw std::runtime_error( "attribute_buffer_serializer.load: Failed to load buffer from file(" + filePath + ") because there was an error"
+			+ std::string( " opening the file." ) );
+	}
+
+	return load( fileStream, allocator );
+}
+
+const boost::uint32_t attribute_buffer_serializer::compute_checksum( const attribute_buffer& buffer ) {
+	const attributes::attribute_map& map = buffer.get_attribute_map();
+	const unsigned int numSections = map.get_num_sections();
+	boost::crc_32_type checksum;
+
+	if( buffer.get_num_values() == 0 )
+		return checksum.checksum();
+
+	for( unsigned int i = 0; i < numSections; ++i ) {
+		const std::size_t valueSize = map.get_section_strides()[i];
+
+		checksum.process_bytes( get_section_data( buffer, i ), buffer.get_num_values() * valueSize );
+	}
+
+	return checksum.checksum();
+}
+
+// private functions
+
+attribute_buffer_serializer::attribute_buffer_serializer()
+{
+}
+
+attribute_buffer_serializer::~attribute_buffer_serializer()
+{
+}
+
+const char* attribute_buffer_serializer::get_section_data( const attribute_buffer& buffer, const unsigned int section ) {
+	// Section i starts with attribute i, so its data starts where the values of that attribute do
+	return buffer.get_data() + buffer.get_attribute_data_offsets()[section];
+}
+
+void attribute_buffer_serializer::check_section_sizes( std::istream& stream, const attribute_buffer_header& header ) {
+	const std::vector<boost::uint64_t>& sectionOffsets = header.get_section_offsets();
+	boost::uint64_t totalSize = 0;
+
+	// The offsets of the attributes are unsigned ints, so every section has to fit within their range before the buffer is sized to hold them
+	for( unsigned int i = 0; i < sectionOffsets.size(); ++i ) {
+		totalSize += header.get_section_size( i );
+
+		if( totalSize > std::numeric_limits<unsigned int>::max() ) {
+			throw std::runtime_error( "attribute_buffer_serializer.load: Failed to load buffer because section(" + boost::lexical_cast<std::string>( i )
+				+ ") ends past the largest offset a buffer can hold." );
+		}
+	}
+
+	// A stream that can not seek has no known length, so only its reads can find that it ends early
+	const std::streampos dataStart = stream.tellg();
+
+	if( dataStart == std::streampos( -1 ) )
+		return;
+
+	stream.seekg( 0, std::ios::end );
+
+	const std::streampos streamEnd = stream.tellg();
+
+	stream.clear();
+	stream.seekg( dataStart );
+
+	if( streamEnd == std::streampos( -1 ) )
+		return;
+
+	// The stream is positioned just past the header, so the length of the saved buffer is measured from the start of the header
+	const boost::uint64_t bufferSize = static_cast<boost::uint64_t>( streamEnd - dataStart ) + header.get_header_size();
+
+	if( header.is_compressed() ) {
+		const std::vector<unsigned int>& strides = header.get_attribute_map().get_section_strides();
+		const unsigned int numFullBlocks = header.get_num_values() / COMPRESSED_BLOCK_VALUES;
+		const unsigned int lastBlockValues = header.get_num_values() % COMPRESSED_BLOCK_VALUES;
+		boost::uint64_t minSize = 0;
+
+		// Compressed sections have no fixed size, but every block is preceded by its size and holds at least the widths of its groups, so the
+		// stream has to be at least that long
+		for( unsigned int i = 0; i < strides.size(); ++i ) {
+			minSize += numFullBlocks * ( 4 + stream_codec::get_min_encoded_size( static_cast<boost::uint64_t>( COMPRESSED_BLOCK_VALUES ) * strides[i] ) );
+
+			if( lastBlockValues > 0 )
+				minSize += 4 + stream_codec::get_min_encoded_size( static_cast<boost::uint64_t>( lastBlockValues ) * strides[i] );
+		}
+
+		if( header.get_data_offset() > bufferSize || minSize > bufferSize - header.get_data_offset() ) {
+			throw std::runtime_error( "attribute_buffer_serializer.load: Failed to load buffer because the stream is too short to hold the compressed"
+				+ std::string( " blocks its header describes." ) );
+		}
+
+		return;
+	}
+
+	for( unsigned int i = 0; i < sectionOffsets.size(); ++i ) {
+		if( sectionOffsets[i] > bufferSize || header.get_section_size( i ) > bufferSize - sectionOffsets[i] ) {
+			throw std::runtime_error( "attribute_buffer_serializer.load: Failed to load buffer because section(" + boost::lexical_cast<std::string>( i )
+				+ ") ends past the end of the stream." );
+		}
+	}
+}
+
+void attribute_buffer_serializer::skip_padding( std::istream& stream, const boost::uint64_t currOffset, const boost::uint64_t nextOffset ) {
+	const std::streamsize paddingSize = static_cast<std::streamsize>( nextOffset > currOffset ? nextOffset - currOffset : 0 );
+
+	if( paddingSize > 0 && stream.ignore( paddingSize ).gcount() != paddingSize ) {
+		throw std::runtime_error( "attribute_buffer_serializer.load: Failed to load buffer because the stream ended before the end of the padding." );
+	}
+}
+
+void attribute_buffer_serializer::save_compressed_section( std::ostream& stream, const attribute_buffer& buffer, const unsigned int section ) {
+	const std::size_t stride = buffer.get_attribute_map().get_section_strides()[section];
+	const char* data = get_section_data( buffer, section );
+	std::vector<char> block;
+
+	for( unsigned int first = 0; first < buffer.get_num_values(); first += COMPRESSED_BLOCK_VALUES ) {
+		const unsigned int numValues = std::min( COMPRESSED_BLOCK_VALUES, buffer.get_num_values() - first );
+		char blockSize[4];
+
+		block.clear();
+		stream_codec::encode_values( data + first * stride, numValues, stride, block );
+
+		// The size is stored in little endian byte order, the same as every integer in the header
+		for( unsigned int i = 0; i < 4; ++i ) {
+			blockSize[i] = static_cast<char>( block.size() >> ( 8 * i ) );
+		}
+
+		stream.write( blockSize, sizeof( blockSize ) );
+
+		if( !block.empty() )
+			stream.write( &block[0], static_cast<std::streamsize>( block.size() ) );
+	}
+}
+
+void attribute_buffer_serializer::load_compressed_section( std::istream& stream, attribute_buffer& buffer, const unsigned int section,
+	std::vector<char>& block ) {
+	const std::size_t stride = buffer.get_attribute_map().get_section_strides()[section];
+	char* data = &buffer.m_data[buffer.m_bufferPointers[section]];
+
+	for( unsigned int first = 0; first < buffer.get_num_values(); first += COMPRESSED_BLOCK_VALUES ) {
+		const unsigned int numValues = std::min( COMPRESSED_BLOCK_VALUES, buffer.get_num_values() - first );
+		unsigned char blockSize[4];
+
+		if( !stream.read( reinterpret_cast<char*>( blockSize ), sizeof( blockSize ) ) ) {
+			throw std::runtime_error( "attribute_buffer_serializer.load: Failed to load buffer because the stream ended before section("
+				+ boost::lexical_cast<std::string>( section ) + ") was read." );
+		}
+
+		const std::size_t encodedSize = static_cast<std::size_t>( blockSize[0] ) | ( static_cast<std::size_t>( blockSize[1] ) << 8 )
+			| ( static_cast<std::size_t>( blockSize[2] ) << 16 ) | ( static_cast<std::size_t>( blockSize[3] ) << 24 );
+
+		// The size is checked before anything is allocated, so a forged size can not make the block larger than its values could compress to
+		if( encodedSize > stream_codec::get_max_encoded_size( static_cast<boost::uint64_t>( numValues ) * stride ) ) {
+			throw std::runtime_error( "attribute_buffer_serializer.load: Failed to load buffer because a compressed block of section("
+				+ boost::lexical_cast<std::string>( section ) + ") is larger than its values could be compressed into." );
+		}
+
+		block.resize( encodedSize );
+
+		if( !block.empty() && !stream.read( &block[0], static_cast<std::streamsize>( block.size() ) ) ) {
+			throw std::runtime_error( "attribute_buffer_serializer.load: Failed to load buffer because the stream ended before section("
+				+ boost::lexical_cast<std::string>( section ) + ") was read." );
+		}
+
+		// A block that decodes from fewer bytes than it says it has is as corrupt as one that needs more
+		if( stream_codec::decode_values( block.empty() ? NULL : &block[0], block.size(), numValues, stride, data + first * stride ) != block.size() ) {
+			throw std::runtime_error( "attribute_buffer_serializer.load: Failed to load buffer because a compressed block of section("
+				+ boost::lexical_cast<std::string>( section ) + ") is not valid." );
+		}
+	}
+}
+
+} // end of buffers namespace
+} // end of occluded namespace
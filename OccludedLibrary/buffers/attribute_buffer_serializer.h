@@ -0,0 +1,130 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+
+#include "attribute_buffer_factory.h"
+#include "attribute_buffer_header.h"
+#include "stream_codec.h"
+
+namespace occluded { namespace buffers {
+
+/**
+ * \class attribute_buffer_serializer
+ * \brief Saves attribute buffers to and loads them from a binary format.
+ *
+ * Saves the attribute map and values of an attribute buffer in the format described by attribute_buffer_header, so that geometry that never
+ * changes can be loaded without inserting its values again. The values are written section by section exactly as the attribute map lays them
+ * out, so loading sizes the buffer once and reads each section straight into its storage with no work done per value. Files saved this way
+ * can also be used by a mapped_attr_buffer.
+ *
+ * Buffers can also be saved compressed, in which case each section is split into blocks of COMPRESSED_BLOCK_VALUES values compressed by
+ * stream_codec, each preceded by its size. Loading reads one block at a time and decodes it straight into the storage of the buffer while it
+ * is still in the cache, so the file never has to be held in memory as a whole and decoding keeps pace with the reads instead of following
+ * them.
+ */
+class attribute_buffer_serializer
+{
+public:
+	/**
+	 * The largest number of values in each compressed block of a section.
+	 */
+	static const unsigned int COMPRESSED_BLOCK_VALUES;
+
+	/**
+	 * \fn save
+	 * \brief Saves an attribute buffer to a stream.
+	 *
+	 * \param stream A reference to the stream the buffer is written to.
+	 * \param buffer A reference to the attribute buffer to be saved.
+	 * \param writeChecksum A bool representing whether a checksum of the values is stored in the header.
+	 * \param compress A bool representing whether the sections are stored in compressed blocks, in which case the file can not be mapped.
+	 *
+	 * Writes the header followed by each section of values. An exception is thrown if the buffer contains erased values, since the free list
+	 * is not saved, so compact should be called before saving such a buffer. An exception is also thrown if writing to the stream fails.
+	 */
+	static void save( std::ostream& stream, const attribute_buffer& buffer, const bool writeChecksum = true, const bool compress = false );
+
+	/**
+	 * \fn save
+	 * \brief Saves an attribute buffer to a file.
+	 *
+	 * \param filePath A reference to a string representing the file path of the file, which is replaced if it already exists.
+	 * \param buffer A reference to the attribute buffer to be saved.
+	 * \param writeChecksum A bool representing whether a checksum of the values is stored in the header.
+	 * \param compress A bool representing whether the sections are stored in compressed blocks, in which case the file can not be mapped.
+	 */
+	static void save( const std::string& filePath, const attribute_buffer& buffer, const bool writeChecksum = true, const bool compress = false );
+
+	/**
+	 * \fn load
+	 * \brief Loads an attribute buffer from a stream.
+	 *
+	 * \param stream A reference to the stream, which must be positioned at the start of a saved buffer.
+	 * \param allocator A reference to the storage allocator the values of the new buffer are stored in.
+	 * \return An interleaved, segregated or hybrid attribute buffer, depending on the layout flag in the header.
+	 *
+	 * Reads the header, sizes the new buffer to hold every value and reads each section directly into its storage, decoding it block by block
+	 * if the header says it is compressed. If the header contains a checksum it is compared with the values read. An exception is thrown if the
+	 * header is not valid, its sections are too large for a buffer, the stream ends early, a compressed block is not valid or the checksum does not
+	 * match. Streams that can seek are checked against their length before any storage is allocated.
+	 */
+	static std::auto_ptr<attribute_buffer> load( std::istream& stream, storage::storage_allocator& allocator = storage::storage_allocator::get_default_allocator() );
+
+	/**
+	 * \fn load
+	 * \brief Loads an attribute buffer from a file.
+	 *
+	 * \param filePath A reference to a string representing the file path of the file.
+	 * \param allocator A reference to the storage allocator the values of the new buffer are stored in.
+	 * \return An interleaved, segregated or hybrid attribute buffer, depending on the layout flag in the header.
+	 */
+	static std::auto_ptr<attribute_buffer> load( const std::string& filePath,
+		storage::storage_allocator& allocator = storage::storage_allocator::get_default_allocator() );
+
+	/**
+	 * \fn compute_checksum
+	 * \brief Computes the checksum of the values in an attribute buffer.
+	 *
+	 * \param buffer A reference to the attribute buffer.
+	 * \return A 32-bit unsigned integer representing the CRC-32 of the values of every section in order, without any unused capacity.
+	 */
+	static const boost::uint32_t compute_checksum( const attribute_buffer& buffer );
+
+private:
+	attribute_buffer_serializer();
+	~attribute_buffer_serializer();
+
+	/**
+	 * \fn get_section_data
+	 * \brief Gets a pointer to the first value of a section of an attribute buffer.
+	 */
+	static const char* get_section_data( const attribute_buffer& buffer, const unsigned int section );
+
+	/**
+	 * \fn check_section_sizes
+	 * \brief Throws an exception if the sections described by a header do not fit in a buffer or can not fit in what is left of the stream.
+	 */
+	static void check_section_sizes( std::istream& stream, const attribute_buffer_header& header );
+
+	/**
+	 * \fn skip_padding
+	 * \brief Moves a stream forward from one offset to another, throwing an exception if the stream ends.
+	 */
+	static void skip_padding( std::istream& stream, const boost::uint64_t currOffset, const boost::uint64_t nextOffset );
+
+	/**
+	 * \fn save_compressed_section
+	 * \brief Writes a section of an attribute buffer to a stream as compressed blocks.
+	 */
+	static void save_compressed_section( std::ostream& stream, const attribute_buffer& buffer, const unsigned int section );
+
+	/**
+	 * \fn load_compressed_section
+	 * \brief Reads the compressed blocks of a section from a stream and decodes them into the storage of an attribute buffer.
+	 */
+	static void load_compressed_section( std::istream& stream, attribute_buffer& buffer, const unsigned int section, std::vector<char>& block );
+};
+
+} // end of buffers namespace
+} // end of occluded namespace
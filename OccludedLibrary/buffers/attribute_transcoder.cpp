@@ -0,0 +1,339 @@
+#include "attribute_transcoder.h"
+
+#include <cstring>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define OCCLUDED_TRANSCODER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace occluded { namespace buffers {
+
+#ifdef OCCLUDED_TRANSCODER_SSE2
+
+// The shuffles only move bits around, so the values are transcoded exactly even if they are not floats
+
+static inline void split_3( const __m128 in0, const __m128 in1, const __m128 in2, __m128& x, __m128& y, __m128& z ) {
+	// [x0 y0 z0 x1] [y1 z1 x2 y2] [z2 x3 y3 z3] -> [x0 x1 x2 x3] [y0 y1 y2 y3] [z0 z1 z2 z3]
+	x = _mm_shuffle_ps( in0, _mm_shuffle_ps( in1, in2, _MM_SHUFFLE( 1, 1, 2, 2 ) ), _MM_SHUFFLE( 2, 0, 3, 0 ) );
+	y = _mm_shuffle_ps( _mm_shuffle_ps( in0, in1, _MM_SHUFFLE( 0, 0, 1, 1 ) ), _mm_shuffle_ps( in1, in2, _MM_SHUFFLE( 2, 2, 3, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+	z = _mm_shuffle_ps( _mm_shuffle_ps( in0, in1, _MM_SHUFFLE( 1, 1, 2, 2 ) ), _mm_shuffle_ps( in2, in2, _MM_SHUFFLE( 3, 3, 0, 0 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+}
+
+static inline void merge_3( const __m128 x, const __m128 y, const __m128 z, __m128& out0, __m128& out1, __m128& out2 ) {
+	// [x0 x1 x2 x3] [y0 y1 y2 y3] [z0 z1 z2 z3] -> [x0 y0 z0 x1] [y1 z1 x2 y2] [z2 x3 y3 z3]
+	const __m128 xyLo = _mm_unpacklo_ps( x, y );
+	const __m128 xyHi = _mm_unpackhi_ps( x, y );
+
+	out0 = _mm_shuffle_ps( xyLo, _mm_shuffle_ps( z, xyLo, _MM_SHUFFLE( 2, 2, 0, 0 ) ), _MM_SHUFFLE( 2, 0, 1, 0 ) );
+	out1 = _mm_shuffle_ps( _mm_shuffle_ps( xyLo, z, _MM_SHUFFLE( 1, 1, 3, 3 ) ), xyHi, _MM_SHUFFLE( 1, 0, 2, 0 ) );
+	out2 = _mm_shuffle_ps( _mm_shuffle_ps( z, xyHi, _MM_SHUFFLE( 2, 2, 2, 2 ) ), _mm_shuffle_ps( xyHi, z, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+}
+
+static inline void split_vertices( const float* vertices, const unsigned int numDwords, __m128* components ) {
+	__m128 in[8];
+	unsigned int i = 0;
+
+	for( i = 0; i < numDwords; ++i ) {
+		in[i] = _mm_loadu_ps( vertices + 4 * i );
+	}
+
+	switch( numDwords ) {
+	case 3:
+		split_3( in[0], in[1], in[2], components[0], components[1], components[2] );
+		break;
+	case 4:
+		_MM_TRANSPOSE4_PS( in[0], in[1], in[2], in[3] );
+		components[0] = in[0]; components[1] = in[1]; components[2] = in[2]; components[3] = in[3];
+		break;
+	case 6: {
+		// Two vertices span three registers, so the first four dwords of each vertex are gathered and transposed and the last two are split
+		__m128 v0 = in[0], v1 = _mm_shuffle_ps( in[1], in[2], _MM_SHUFFLE( 1, 0, 3, 2 ) );
+		__m128 v2 = in[3], v3 = _mm_shuffle_ps( in[4], in[5], _MM_SHUFFLE( 1, 0, 3, 2 ) );
+		const __m128 rest01 = _mm_shuffle_ps( in[1], in[2], _MM_SHUFFLE( 3, 2, 1, 0 ) );
+		const __m128 rest23 = _mm_shuffle_ps( in[4], in[5], _MM_SHUFFLE( 3, 2, 1, 0 ) );
+
+		_MM_TRANSPOSE4_PS( v0, v1, v2, v3 );
+		components[0] = v0; components[1] = v1; components[2] = v2; components[3] = v3;
+		components[4] = _mm_shuffle_ps( rest01, rest23, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+		components[5] = _mm_shuffle_ps( rest01, rest23, _MM_SHUFFLE( 3, 1, 3, 1 ) );
+		break;
+	}
+	case 8:
+		_MM_TRANSPOSE4_PS( in[0], in[2], in[4], in[6] );
+		_MM_TRANSPOSE4_PS( in[1], in[3], in[5], in[7] );
+		components[0] = in[0]; components[1] = in[2]; components[2] = in[4]; components[3] = in[6];
+		components[4] = in[1]; components[5] = in[3]; components[6] = in[5]; components[7] = in[7];
+		break;
+	}
+}
+
+static inline void merge_vertices( __m128* components, const unsigned int numDwords, float* vertices ) {
+	__m128 out[8];
+	unsigned int i = 0;
+
+	switch( numDwords ) {
+	case 3:
+		merge_3( components[0], components[1], components[2], out[0], out[1], out[2] );
+		break;
+	case 4:
+		_MM_TRANSPOSE4_PS( components[0], components[1], components[2], components[3] );
+		out[0] = components[0]; out[1] = components[1]; out[2] = components[2]; out[3] = components[3];
+		break;
+	case 6: {
+		const __m128 rest01 = _mm_unpacklo_ps( components[4], components[5] );
+		const __m128 rest23 = _mm_unpackhi_ps( components[4], components[5] );
+
+		_MM_TRANSPOSE4_PS( components[0], components[1], components[2], components[3] );
+		out[0] = components[0];
+		out[1] = _mm_shuffle_ps( rest01, components[1], _MM_SHUFFLE( 1, 0, 1, 0 ) );
+		out[2] = _mm_shuffle_ps( components[1], rest01, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+		out[3] = components[2];
+		out[4] = _mm_shuffle_ps( rest23, components[3], _MM_SHUFFLE( 1, 0, 1, 0 ) );
+		out[5] = _mm_shuffle_ps( components[3], rest23, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+		break;
+	}
+	case 8:
+		_MM_TRANSPOSE4_PS( components[0], components[1], components[2], components[3] );
+		_MM_TRANSPOSE4_PS( components[4], components[5], components[6], components[7] );
+		out[0] = components[0]; out[2] = components[1]; out[4] = components[2]; out[6] = components[3];
+		out[1] = components[4]; out[3] = components[5]; out[5] = components[6]; out[7] = components[7];
+		break;
+	}
+
+	for( i = 0; i < numDwords; ++i ) {
+		_mm_storeu_ps( vertices + 4 * i, out[i] );
+	}
+}
+
+#endif
+
+void attribute_transcoder::deinterleave( const attributes::attribute_map& map, const char* source, const unsigned int numValues, char* dest,
+	const std::vector<unsigned int>& sectionOffsets ) {
+	unsigned int numConverted = 0;
+
+	if( numValues == 0 || map.get_byte_size() == 0 )
+		return;
+
+	if( is_simd_layout( map ) )
+		numConverted = deinterleave_simd( map, source, numValues, dest, sectionOffsets );
+
+	deinterleave_scalar( map, source, numConverted, numValues, dest, sectionOffsets );
+}
+
+void attribute_transcoder::interleave( const attributes::attribute_map& map, const char* source, const std::vector<unsigned int>& sectionOffsets,
+	const unsigned int numValues, char* dest ) {
+	unsigned int numConverted = 0;
+
+	if( numValues == 0 || map.get_byte_size() == 0 )
+		return;
+
+	if( is_simd_layout( map ) )
+		numConverted = interleave_simd( map, source, sectionOffsets, numValues, dest );
+
+	interleave_scalar( map, source, sectionOffsets, numConverted, numValues, dest );
+}
+
+attributes::attribute_map attribute_transcoder::create_transcoded_map( const attributes::attribute_map& map ) {
+	const std::vector<const attributes::attribute>& attributes = map.get_attributes();
+	attributes::attribute_map transcodedMap( !map.is_interleaved() );
+
+	for( std::vector<const attributes::attribute>::const_iterator it = attributes.begin(); it != attributes.end(); ++it ) {
+		transcodedMap.add_attribute( *it );
+	}
+
+	transcodedMap.end_definition();
+
+	return transcodedMap;
+}
+
+const bool attribute_transcoder::is_simd_layout( const attributes::attribute_map& map ) {
+#ifdef OCCLUDED_TRANSCODER_SSE2
+	const std::size_t stride = map.get_byte_size();
+
+	if( map.get_layout() == attributes::layout_hybrid )
+		return false;
+
+	if( stride != 12 && stride != 16 && stride != 24 && stride != 32 )
+		return false;
+
+	// Each attribute has to be made up of whole dwords so it can be moved with the dword shuffles
+	for( std::vector<const attributes::attribute>::const_iterator it = map.get_attributes().begin(); it != map.get_attributes().end(); ++it ) {
+		if( it->get_attrib_size() % 4 != 0 || it->get_attrib_size() > 16 )
+			return false;
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+// Private Static Functions
+
+const unsigned int attribute_transcoder::deinterleave_simd( const attributes::attribute_map& map, const char* source, const unsigned int numValues,
+	char* dest, const std::vector<unsigned int>& sectionOffsets ) {
+#ifdef OCCLUDED_TRANSCODER_SSE2
+	const std::vector<const attributes::attribute>& attributes = map.get_attributes();
+	const std::vector<unsigned int>& offsets = map.get_attribute_offsets();
+	const std::size_t stride = map.get_byte_size();
+	const unsigned int numDwords = static_cast<unsigned int>( stride / 4 );
+	const unsigned int numBlocks = numValues / 4;
+	__m128 components[8];
+
+	for( unsigned int block = 0; block < numBlocks; ++block ) {
+		split_vertices( reinterpret_cast<const float*>( source + 4 * block * stride ), numDwords, components );
+
+		// Each attribute's components are merged back together and written to the end of its section
+		for( unsigned int i = 0; i < attributes.size(); ++i ) {
+			const std::size_t attribSize = attributes[i].get_attrib_size();
+			const unsigned int first = offsets[i] / 4;
+			float* section = reinterpret_cast<float*>( dest + sectionOffsets[i] + 4 * block * attribSize );
+
+			switch( attribSize / 4 ) {
+			case 1:
+				_mm_storeu_ps( section, components[first] );
+				break;
+			case 2:
+				_mm_storeu_ps( section, _mm_unpacklo_ps( components[first], components[first + 1] ) );
+				_mm_storeu_ps( section + 4, _mm_unpackhi_ps( components[first], components[first + 1] ) );
+				break;
+			case 3: {
+				__m128 out0, out1, out2;
+
+				merge_3( components[first], components[first + 1], components[first + 2], out0, out1, out2 );
+				_mm_storeu_ps( section, out0 );
+				_mm_storeu_ps( section + 4, out1 );
+				_mm_storeu_ps( section + 8, out2 );
+				break;
+			}
+			case 4: {
+				__m128 out0 = components[first], out1 = components[first + 1], out2 = components[first + 2], out3 = components[first + 3];
+
+				_MM_TRANSPOSE4_PS( out0, out1, out2, out3 );
+				_mm_storeu_ps( section, out0 );
+				_mm_storeu_ps( section + 4, out1 );
+				_mm_storeu_ps( section + 8, out2 );
+				_mm_storeu_ps( section + 12, out3 );
+				break;
+			}
+			}
+		}
+	}
+
+	return numBlocks * 4;
+#else
+	return 0;
+#endif
+}
+
+const unsigned int attribute_transcoder::interleave_simd( const attributes::attribute_map& map, const char* source,
+	const std::vector<unsigned int>& sectionOffsets, const unsigned int numValues, char* dest ) {
+#ifdef OCCLUDED_TRANSCODER_SSE2
+	const std::vector<const attributes::attribute>& attributes = map.get_attributes();
+	const std::vector<unsigned int>& offsets = map.get_attribute_offsets();
+	const std::size_t stride = map.get_byte_size();
+	const unsigned int numDwords = static_cast<unsigned int>( stride / 4 );
+	const unsigned int numBlocks = numValues / 4;
+	__m128 components[8];
+
+	for( unsigned int block = 0; block < numBlocks; ++block ) {
+		// Each attribute's values are split into their components, then every component is merged into the vertices
+		for( unsigned int i = 0; i < attributes.size(); ++i ) {
+			const std::size_t attribSize = attributes[i].get_attrib_size();
+			const unsigned int first = offsets[i] / 4;
+			const float* section = reinterpret_cast<const float*>( source + sectionOffsets[i] + 4 * block * attribSize );
+
+			switch( attribSize / 4 ) {
+			case 1:
+				components[first] = _mm_loadu_ps( section );
+				break;
+			case 2: {
+				const __m128 in0 = _mm_loadu_ps( section ), in1 = _mm_loadu_ps( section + 4 );
+
+				components[first] = _mm_shuffle_ps( in0, in1, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+				components[first + 1] = _mm_shuffle_ps( in0, in1, _MM_SHUFFLE( 3, 1, 3, 1 ) );
+				break;
+			}
+			case 3:
+				split_3( _mm_loadu_ps( section ), _mm_loadu_ps( section + 4 ), _mm_loadu_ps( section + 8 ),
+					components[first], components[first + 1], components[first + 2] );
+				break;
+			case 4: {
+				__m128 in0 = _mm_loadu_ps( section ), in1 = _mm_loadu_ps( section + 4 ), in2 = _mm_loadu_ps( section + 8 ), in3 = _mm_loadu_ps( section + 12 );
+
+				_MM_TRANSPOSE4_PS( in0, in1, in2, in3 );
+				components[first] = in0;
+				components[first + 1] = in1;
+				components[first + 2] = in2;
+				components[first + 3] = in3;
+				break;
+			}
+			}
+		}
+
+		merge_vertices( components, numDwords, reinterpret_cast<float*>( dest + 4 * block * stride ) );
+	}
+
+	return numBlocks * 4;
+#else
+	return 0;
+#endif
+}
+
+void attribute_transcoder::deinterleave_scalar( const attributes::attribute_map& map, const char* source, const unsigned int firstValue,
+	const unsigned int numValues, char* dest, const std::vector<unsigned int>& sectionOffsets ) {
+	const std::vector<const attributes::attribute>& attributes = map.get_attributes();
+	const std::vector<unsigned int>& offsets = map.get_attribute_offsets();
+	const std::vector<unsigned int> valueStrides = get_value_strides( map );
+	const std::size_t stride = map.get_byte_size();
+
+	for( unsigned int i = 0; i < attributes.size(); ++i ) {
+		const std::size_t attribSize = attributes[i].get_attrib_size();
+
+		for( unsigned int value = firstValue; value < numValues; ++value ) {
+			memcpy( dest + sectionOffsets[i] + value * valueStrides[i], source + value * stride + offsets[i], attribSize );
+		}
+	}
+}
+
+void attribute_transcoder::interleave_scalar( const attributes::attribute_map& map, const char* source, const std::vector<unsigned int>& sectionOffsets,
+	const unsigned int firstValue, const unsigned int numValues, char* dest ) {
+	const std::vector<const attributes::attribute>& attributes = map.get_attributes();
+	const std::vector<unsigned int>& offsets = map.get_attribute_offsets();
+	const std::vector<unsigned int> valueStrides = get_value_strides( map );
+	const std::size_t stride = map.get_byte_size();
+
+	for( unsigned int i = 0; i < attributes.size(); ++i ) {
+		const std::size_t attribSize = attributes[i].get_attrib_size();
+
+		for( unsigned int value = firstValue; value < numValues; ++value ) {
+			memcpy( dest + value * stride + offsets[i], source + sectionOffsets[i] + value * valueStrides[i], attribSize );
+		}
+	}
+}
+
+const std::vector<unsigned int> attribute_transcoder::get_value_strides( const attributes::attribute_map& map ) {
+	const std::vector<const attributes::attribute>& attributes = map.get_attributes();
+	std::vector<unsigned int> valueStrides( attributes.size() );
+
+	for( unsigned int i = 0; i < attributes.size(); ++i ) {
+		valueStrides[i] = map.get_layout() == attributes::layout_hybrid ? map.get_section_strides()[map.get_attribute_sections()[i]]
+			: static_cast<unsigned int>( attributes[i].get_attrib_size() );
+	}
+
+	return valueStrides;
+}
+
+// Private Member Functions
+
+attribute_transcoder::attribute_transcoder()
+{
+}
+
+attribute_transcoder::~attribute_transcoder()
+{
+}
+
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "attributes/attribute_map.h"
+
+namespace occluded { namespace buffers {
+
+/**
+ * \class attribute_transcoder
+ * \brief Converts values between the interleaved and segregated organizations.
+ *
+ * Converts blocks of values between the interleaved organization, where each value stores every attribute next to each other, and the
+ * segregated organization, where each attribute is stored in its own section. When SSE2 is available and the attribute map has a common
+ * stride (12, 16, 24 or 32 bytes) made up of attributes whose sizes are multiples of 4 bytes, four values are converted at a time by
+ * transposing them in registers. Every other layout is converted by copying each attribute of each value separately.
+ *
+ * Each attribute normally has a section of its own, whatever the layout of the map. If the map uses the hybrid layout, the sections are the
+ * ones of that layout instead, so the attributes after the first are interleaved in the second section.
+ */
+class attribute_transcoder
+{
+public:
+	/**
+	 * \fn deinterleave
+	 * \brief Converts interleaved values into segregated sections.
+	 *
+	 * \param map A reference to the attribute map describing the attributes of the values.
+	 * \param source A pointer to the interleaved values.
+	 * \param numValues An unsigned int representing the number of values to be converted.
+	 * \param dest A pointer to the memory containing the sections.
+	 * \param sectionOffsets A reference to a vector containing the offset in bytes of the first value of each attribute from dest.
+	 *
+	 * Copies each attribute of the values into the start of its section. Each section must be able to hold numValues values.
+	 */
+	static void deinterleave( const attributes::attribute_map& map, const char* source, const unsigned int numValues, char* dest,
+		const std::vector<unsigned int>& sectionOffsets );
+
+	/**
+	 * \fn interleave
+	 * \brief Converts segregated sections into interleaved values.
+	 *
+	 * \param map A reference to the attribute map describing the attributes of the values.
+	 * \param source A pointer to the memory containing the sections.
+	 * \param sectionOffsets A reference to a vector containing the offset in bytes of the first value of each attribute from source.
+	 * \param numValues An unsigned int representing the number of values to be converted.
+	 * \param dest A pointer to the memory the interleaved values are written to, which must be numValues times the byte size of map long.
+	 */
+	static void interleave( const attributes::attribute_map& map, const char* source, const std::vector<unsigned int>& sectionOffsets,
+		const unsigned int numValues, char* dest );
+
+	/**
+	 * \fn create_transcoded_map
+	 * \brief Creates a copy of an attribute map with the other organization.
+	 *
+	 * \param map A reference to the attribute map to be copied.
+	 * \return An attribute map with the same attributes that is segregated if map is interleaved and interleaved otherwise.
+	 */
+	static attributes::attribute_map create_transcoded_map( const attributes::attribute_map& map );
+
+	/**
+	 * \fn is_simd_layout
+	 * \brief Checks whether the values of an attribute map are converted four at a time.
+	 *
+	 * \param map A reference to the attribute map to be checked.
+	 * \return Returns true if SSE2 is available and the layout of the attribute map has a specialized conversion, otherwise false.
+	 *
+	 * Maps with the hybrid layout are never specialized.
+	 */
+	static const bool is_simd_layout( const attributes::attribute_map& map );
+
+private:
+	attribute_transcoder();
+	~attribute_transcoder();
+
+	/**
+	 * \fn deinterleave_simd
+	 * \brief Converts interleaved values into segregated sections four values at a time.
+	 *
+	 * Converts the largest multiple of four values and returns the number of values converted. The rest are left to deinterleave_scalar.
+	 */
+	static const unsigned int deinterleave_simd( const attributes::attribute_map& map, const char* source, const unsigned int numValues, char* dest,
+		const std::vector<unsigned int>& sectionOffsets );
+
+	/**
+	 * \fn interleave_simd
+	 * \brief Converts segregated sections into interleaved values four values at a time.
+	 *
+	 * Converts the largest multiple of four values and returns the number of values converted. The rest are left to interleave_scalar.
+	 */
+	static const unsigned int interleave_simd( const attributes::attribute_map& map, const char* source, const std::vector<unsigned int>& sectionOffsets,
+		const unsigned int numValues, char* dest );
+
+	/**
+	 * \fn deinterleave_scalar
+	 * \brief Converts the interleaved values in the range [firstValue, numValues) by copying each attribute separately.
+	 */
+	static void deinterleave_scalar( const attributes::attribute_map& map, const char* source, const unsigned int firstValue, const unsigned int numValues,
+		char* dest, const std::vector<unsigned int>& sectionOffsets );
+
+	/**
+	 * \fn interleave_scalar
+	 * \brief Converts the segregated values in the range [firstValue, numValues) by copying each attribute separately.
+	 */
+	static void interleave_scalar( const attributes::attribute_map& map, const char* source, const std::vector<unsigned int>& sectionOffsets,
+		const unsigned int firstValue, const unsigned int numValues, char* dest );
+
+	/**
+	 * \fn get_value_strides
+	 * \brief Gets the number of bytes between consecutive values of each attribute outside of the interleaved values.
+	 *
+	 * Each attribute's stride is its size, unless the map uses the hybrid layout, in which case it is the stride of the attribute's section.
+	 */
+	static const std::vector<unsigned int> get_value_strides( const attributes::attribute_map& map );
+};
+
+} // end of buffers namespace
+} // end of occluded namespace
@@ -2,14 +2,15 @@
 
 namespace occluded { namespace buffers { namespace attributes {
 
-const std::size_t attribute::ATTRIB_SIZE = 4; // May change if more attribute types are added
-
 attribute::attribute( const std::string& name, const unsigned int arity, const attribute_t type, const bool normalized ):
 	m_name( name ),
 	m_arity( arity ),
 	m_type( type ),
 	m_normalized( normalized )
 {
+	if( is_packed_type( m_type ) && m_arity != 4 ) {
+		throw std::runtime_error( "attribute: Failed to create attribute(" + m_name + ") because packed attribute types must have an arity of 4." );
+	}
 }
 
 
@@ -30,11 +31,14 @@ const attribute_t attribute::get_type() const {
 }
 
 const std::size_t attribute::get_component_size() const {
-	return ATTRIB_SIZE;
+	return get_type_size( m_type );
 }
 
 const std::size_t attribute::get_attrib_size() const {
-	return ATTRIB_SIZE * m_arity;
+	if( is_packed_type( m_type ) )
+		return get_type_size( m_type );
+
+	return get_type_size( m_type ) * m_arity;
 }
 
 const bool attribute::is_normalized() const {
@@ -49,6 +53,40 @@ const bool attribute::operator!=( const attribute& other ) const {
 	return !( *this == other );
 }
 
+// Static Functions
+
+const std::size_t attribute::get_type_size( const attribute_t type ) {
+	std::size_t size = 0;
+
+	switch( type ) {
+	case attrib_byte:
+	case attrib_ubyte:
+		size = 1;
+		break;
+	case attrib_half_float:
+	case attrib_short:
+	case attrib_ushort:
+		size = 2;
+		break;
+	case attrib_float:
+	case attrib_uint:
+	case attrib_int:
+	case attrib_int_2_10_10_10_rev:
+		size = 4;
+		break;
+	case attrib_invalid:
+	default:
+		size = 0;
+		break;
+	}
+
+	return size;
+}
+
+const bool attribute::is_packed_type( const attribute_t type ) {
+	return type == attrib_int_2_10_10_10_rev;
+}
+
 } // end of attributes namespace
 } // end of buffers namespace
 } // end of occluded namespace
\ No newline at end of file
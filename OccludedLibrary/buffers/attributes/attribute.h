@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <stdexcept>
 
 namespace occluded { namespace buffers { namespace attributes {
 
@@ -8,12 +9,20 @@ namespace occluded { namespace buffers { namespace attributes {
  * \enum attribute_t
  * \brief Stores the type of the attribute
  *
- * Stores the type of the attribute, so that attributes can be easily compared and appropriate values can be assigned to it.
+ * Stores the type of the attribute, so that attributes can be easily compared and appropriate values can be assigned to it. The compact types
+ * (half floats, bytes and shorts) are usually combined with the normalized flag of the attribute to store colors and normals in less space.
+ * attrib_int_2_10_10_10_rev packs all four components of an attribute into a single 32-bit integer, and therefore requires an arity of 4.
  */
 typedef enum ATTRIB_TYPE {
 	attrib_float,
 	attrib_uint,
 	attrib_int,
+	attrib_half_float,
+	attrib_byte,
+	attrib_ubyte,
+	attrib_short,
+	attrib_ushort,
+	attrib_int_2_10_10_10_rev,
 	attrib_invalid
 } attribute_t;
 
@@ -27,8 +36,6 @@ typedef enum ATTRIB_TYPE {
 class attribute
 {
 private:
-	static const std::size_t ATTRIB_SIZE;
-
 	std::string m_name;
 	unsigned int m_arity;
 	attribute_t m_type;
@@ -42,7 +49,8 @@ public:
 	 * \param type An attribute_t representing the type of the primitive of the attribute.
 	 * \param normalized An optional boolean representing whether or not the attribute needs to be normalized. The default value is false.
 	 *
-	 * Initializes the attribute using the information provided by the parameters. The normalized parameter has a default value of false.
+	 * Initializes the attribute using the information provided by the parameters. The normalized parameter has a default value of false. An
+	 * exception is thrown if the type is attrib_int_2_10_10_10_rev and the arity is not 4.
 	 */
 	attribute( const std::string& name, const unsigned int arity, const attribute_t type, const bool normalized = false );
 	~attribute();
@@ -76,6 +84,9 @@ public:
 	 * \brief Gets the size of the individual primitives that make up the attribute.
 	 *
 	 * \return Returns a std::size_t representing the size(in bytes) of the individual primitives of the attribute.
+	 *
+	 * Gets the size of the individual primitives of the attribute. Since all the components of an attrib_int_2_10_10_10_rev attribute are packed
+	 * into a single integer, the size of that integer is returned for it.
 	 */
 	const std::size_t get_component_size() const;
 
@@ -110,6 +121,24 @@ public:
 	 * \return Returns false if the two attribute have the same name, arity, and type, otherwise returns true.
 	 */
 	const bool operator!=( const attribute& other ) const;
+
+	/**
+	 * \fn get_type_size
+	 * \brief Gets the size of a primitive of an attribute type.
+	 *
+	 * \param type An attribute_t representing the type of the primitive.
+	 * \return A std::size_t representing the size(in bytes) of a single primitive of the type, or 0 for attrib_invalid.
+	 */
+	static const std::size_t get_type_size( const attribute_t type );
+
+	/**
+	 * \fn is_packed_type
+	 * \brief Gets whether or not an attribute type packs all of its components into a single primitive.
+	 *
+	 * \param type An attribute_t representing the type of the attribute.
+	 * \return A boolean that is true if all of the components of the attribute are stored in one primitive.
+	 */
+	static const bool is_packed_type( const attribute_t type );
 };
 
 } // end of attributes namespace
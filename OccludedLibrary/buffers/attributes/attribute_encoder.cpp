@@ -0,0 +1,290 @@
+#include "attribute_encoder.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define OCCLUDED_ENCODER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace occluded { namespace buffers { namespace attributes {
+
+#ifdef OCCLUDED_ENCODER_SSE2
+// Rounds halfway cases away from zero like quantize, instead of to even as _mm_cvtps_epi32 does under the default rounding mode
+static __m128i round_values( const __m128 values ) {
+	const __m128 half = _mm_or_ps( _mm_set1_ps( 0.5f ), _mm_and_ps( values, _mm_set1_ps( -0.f ) ) );
+
+	return _mm_cvttps_epi32( _mm_add_ps( values, half ) );
+}
+#endif
+
+void attribute_encoder::encode_values( const attribute& attrib, const float* values, const unsigned int numValues, void* dest ) {
+	const std::size_t count = static_cast<std::size_t>( numValues ) * attrib.get_arity();
+
+	switch( attrib.get_type() ) {
+	case attrib_float:
+		memcpy( dest, values, count * sizeof( float ) );
+		break;
+	case attrib_uint:
+		encode_uints( values, count, attrib.is_normalized(), static_cast<unsigned int*>( dest ) );
+		break;
+	case attrib_int:
+		encode_ints( values, count, attrib.is_normalized(), static_cast<int*>( dest ) );
+		break;
+	case attrib_half_float:
+		encode_half_floats( values, count, static_cast<unsigned short*>( dest ) );
+		break;
+	case attrib_byte:
+		encode_bytes( values, count, attrib.is_normalized(), static_cast<signed char*>( dest ) );
+		break;
+	case attrib_ubyte:
+		encode_ubytes( values, count, attrib.is_normalized(), static_cast<unsigned char*>( dest ) );
+		break;
+	case attrib_short:
+		encode_shorts( values, count, attrib.is_normalized(), static_cast<short*>( dest ) );
+		break;
+	case attrib_ushort:
+		encode_ushorts( values, count, attrib.is_normalized(), static_cast<unsigned short*>( dest ) );
+		break;
+	case attrib_int_2_10_10_10_rev:
+		encode_int_2_10_10_10_rev( values, numValues, attrib.is_normalized(), static_cast<unsigned int*>( dest ) );
+		break;
+	case attrib_invalid:
+	default:
+		throw std::runtime_error( "attribute_encoder.encode_values: Failed to encode values of attribute(" + attrib.get_name() + ") because its type is invalid." );
+	}
+}
+
+void attribute_encoder::encode_half_floats( const float* values, const std::size_t count, unsigned short* dest ) {
+#ifdef OCCLUDED_ENCODER_SSE2
+	const __m128i signMask = _mm_set1_epi32( 0x80000000 );
+	const __m128i halfMax = _mm_set1_epi32( ( 127 + 16 ) << 23 );
+	const __m128i nanBit = _mm_set1_epi32( 0x200 );
+	const __m128i halfInfinity = _mm_set1_epi32( 0x7c00 );
+	const __m128i minNormal = _mm_set1_epi32( ( 127 - 14 ) << 23 );
+	const __m128i subnormalMagic = _mm_set1_epi32( ( ( 127 - 15 ) + ( 23 - 10 ) + 1 ) << 23 );
+	const __m128i normalBias = _mm_set1_epi32( 0xfff - ( ( 127 - 15 ) << 23 ) );
+	float padded[4];
+	unsigned short converted[8];
+	std::size_t i = 0;
+
+	for( i = 0; i < count; i += 4 ) {
+		__m128 value;
+
+		// Pad the last few values so that they go through the same conversion as the rest
+		if( count - i >= 4 ) {
+			value = _mm_loadu_ps( &values[i] );
+		} else {
+			memset( padded, 0, sizeof( padded ) );
+			memcpy( padded, &values[i], ( count - i ) * sizeof( float ) );
+			value = _mm_loadu_ps( padded );
+		}
+
+		const __m128 sign = _mm_and_ps( value, _mm_castsi128_ps( signMask ) );
+		const __m128 absValue = _mm_xor_ps( value, sign );
+		const __m128i absBits = _mm_castps_si128( absValue );
+
+		// Values that are too large become infinity, and NaNs become quiet NaNs
+		const __m128i isNaN = _mm_castps_si128( _mm_cmpunord_ps( absValue, absValue ) );
+		const __m128i isRegular = _mm_cmpgt_epi32( halfMax, absBits );
+		const __m128i special = _mm_or_si128( _mm_and_si128( isNaN, nanBit ), halfInfinity );
+
+		// Values that become subnormal are rounded by adding a magic number that shifts the mantissa into place
+		const __m128i isSubnormal = _mm_cmpgt_epi32( minNormal, absBits );
+		const __m128i subnormal = _mm_sub_epi32( _mm_castps_si128( _mm_add_ps( absValue, _mm_castsi128_ps( subnormalMagic ) ) ), subnormalMagic );
+
+		// Normal values have their exponent rebiased and their mantissa rounded to nearest even
+		const __m128i mantissaOdd = _mm_srai_epi32( _mm_slli_epi32( absBits, 31 - 13 ), 31 );
+		const __m128i normal = _mm_srli_epi32( _mm_sub_epi32( _mm_add_epi32( absBits, normalBias ), mantissaOdd ), 13 );
+
+		const __m128i regular = _mm_or_si128( _mm_and_si128( isSubnormal, subnormal ), _mm_andnot_si128( isSubnormal, normal ) );
+		const __m128i joined = _mm_or_si128( _mm_and_si128( isRegular, regular ), _mm_andnot_si128( isRegular, special ) );
+		const __m128i result = _mm_or_si128( joined, _mm_srai_epi32( _mm_castps_si128( sign ), 16 ) );
+
+		// The sign extension keeps every result within the range of a signed short, so packing does not saturate
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( converted ), _mm_packs_epi32( result, result ) );
+		memcpy( &dest[i], converted, ( count - i >= 4 ? 4 : count - i ) * sizeof( unsigned short ) );
+	}
+#else
+	for( std::size_t i = 0; i < count; ++i ) {
+		dest[i] = encode_half_float( values[i] );
+	}
+#endif
+}
+
+void attribute_encoder::encode_bytes( const float* values, const std::size_t count, const bool normalized, signed char* dest ) {
+	if( normalized )
+		encode_integers( values, count, 127.f, -127.f, 127.f, dest );
+	else
+		encode_integers( values, count, 1.f, -128.f, 127.f, dest );
+}
+
+void attribute_encoder::encode_ubytes( const float* values, const std::size_t count, const bool normalized, unsigned char* dest ) {
+	encode_integers( values, count, normalized ? 255.f : 1.f, 0.f, 255.f, dest );
+}
+
+void attribute_encoder::encode_shorts( const float* values, const std::size_t count, const bool normalized, short* dest ) {
+	if( normalized )
+		encode_integers( values, count, 32767.f, -32767.f, 32767.f, dest );
+	else
+		encode_integers( values, count, 1.f, -32768.f, 32767.f, dest );
+}
+
+void attribute_encoder::encode_ushorts( const float* values, const std::size_t count, const bool normalized, unsigned short* dest ) {
+	encode_integers( values, count, normalized ? 65535.f : 1.f, 0.f, 65535.f, dest );
+}
+
+void attribute_encoder::encode_ints( const float* values, const std::size_t count, const bool normalized, int* dest ) {
+	for( std::size_t i = 0; i < count; ++i ) {
+		dest[i] = static_cast<int>( quantize_wide( values[i], normalized ? 2147483647.0 : 1.0, normalized ? -2147483647.0 : -2147483648.0,
+			2147483647.0 ) );
+	}
+}
+
+void attribute_encoder::encode_uints( const float* values, const std::size_t count, const bool normalized, unsigned int* dest ) {
+	for( std::size_t i = 0; i < count; ++i ) {
+		dest[i] = static_cast<unsigned int>( quantize_wide( values[i], normalized ? 4294967295.0 : 1.0, 0.0, 4294967295.0 ) );
+	}
+}
+
+void attribute_encoder::encode_int_2_10_10_10_rev( const float* values, const std::size_t numVectors, const bool normalized, unsigned int* dest ) {
+	const float scale[] = { normalized ? 511.f : 1.f, normalized ? 511.f : 1.f, normalized ? 511.f : 1.f, 1.f };
+	const float minVal[] = { normalized ? -511.f : -512.f, normalized ? -511.f : -512.f, normalized ? -511.f : -512.f, normalized ? -1.f : -2.f };
+	const float maxVal[] = { 511.f, 511.f, 511.f, 1.f };
+	int components[4];
+
+#ifdef OCCLUDED_ENCODER_SSE2
+	const __m128 scaleVec = _mm_loadu_ps( scale );
+	const __m128 minVec = _mm_loadu_ps( minVal );
+	const __m128 maxVec = _mm_loadu_ps( maxVal );
+#endif
+
+	for( std::size_t i = 0; i < numVectors; ++i ) {
+#ifdef OCCLUDED_ENCODER_SSE2
+		const __m128 clamped = _mm_min_ps( _mm_max_ps( _mm_mul_ps( _mm_loadu_ps( &values[4 * i] ), scaleVec ), minVec ), maxVec );
+
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( components ), round_values( clamped ) );
+#else
+		for( unsigned int j = 0; j < 4; ++j ) {
+			components[j] = quantize( values[4 * i + j], scale[j], minVal[j], maxVal[j] );
+		}
+#endif
+
+		dest[i] = ( static_cast<unsigned int>( components[0] ) & 0x3ff ) | ( ( static_cast<unsigned int>( components[1] ) & 0x3ff ) << 10 )
+			| ( ( static_cast<unsigned int>( components[2] ) & 0x3ff ) << 20 ) | ( ( static_cast<unsigned int>( components[3] ) & 0x3 ) << 30 );
+	}
+}
+
+// Private Static Functions
+
+template<typename T>
+void attribute_encoder::encode_integers( const float* values, const std::size_t count, const float scale, const float minVal, const float maxVal, T* dest ) {
+#ifdef OCCLUDED_ENCODER_SSE2
+	const __m128 scaleVec = _mm_set1_ps( scale );
+	const __m128 minVec = _mm_set1_ps( minVal );
+	const __m128 maxVec = _mm_set1_ps( maxVal );
+	float padded[4];
+	int converted[4];
+
+	for( std::size_t i = 0; i < count; i += 4 ) {
+		const std::size_t numInBlock = count - i >= 4 ? 4 : count - i;
+		__m128 value;
+
+		// Pad the last few values so that they are rounded the same way as the rest
+		if( numInBlock == 4 ) {
+			value = _mm_loadu_ps( &values[i] );
+		} else {
+			memset( padded, 0, sizeof( padded ) );
+			memcpy( padded, &values[i], numInBlock * sizeof( float ) );
+			value = _mm_loadu_ps( padded );
+		}
+
+		// The value is the first operand of the max so that NaNs are clamped to the minimum
+		value = _mm_min_ps( _mm_max_ps( _mm_mul_ps( value, scaleVec ), minVec ), maxVec );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( converted ), round_values( value ) );
+
+		for( std::size_t j = 0; j < numInBlock; ++j ) {
+			dest[i + j] = static_cast<T>( converted[j] );
+		}
+	}
+#else
+	for( std::size_t i = 0; i < count; ++i ) {
+		dest[i] = static_cast<T>( quantize( values[i], scale, minVal, maxVal ) );
+	}
+#endif
+}
+
+int attribute_encoder::quantize( const float value, const float scale, const float minVal, const float maxVal ) {
+	float scaled = value * scale;
+
+	// Written so that NaNs are clamped to the minimum
+	if( !( scaled >= minVal ) )
+		scaled = minVal;
+	else if( scaled > maxVal )
+		scaled = maxVal;
+
+	// Halfway cases are rounded away from zero, the same as the SSE2 path
+	return static_cast<int>( scaled + ( scaled < 0.f ? -0.5f : 0.5f ) );
+}
+
+double attribute_encoder::quantize_wide( const float value, const double scale, const double minVal, const double maxVal ) {
+	double scaled = value * scale;
+
+	// The same as quantize, but in double precision, since a float can not hold the limits of a 32-bit integer exactly
+	if( !( scaled >= minVal ) )
+		scaled = minVal;
+	else if( scaled > maxVal )
+		scaled = maxVal;
+
+	return scaled < 0.0 ? std::ceil( scaled - 0.5 ) : std::floor( scaled + 0.5 );
+}
+
+unsigned short attribute_encoder::encode_half_float( const float value ) {
+	const unsigned int infinity = 255 << 23;
+	const unsigned int halfMax = ( 127 + 16 ) << 23;
+	const unsigned int minNormal = ( 127 - 14 ) << 23;
+	const unsigned int subnormalMagicBits = ( ( 127 - 15 ) + ( 23 - 10 ) + 1 ) << 23;
+	unsigned int bits, sign, result;
+	float subnormalMagic;
+
+	memcpy( &bits, &value, sizeof( float ) );
+	memcpy( &subnormalMagic, &subnormalMagicBits, sizeof( float ) );
+
+	sign = bits & 0x80000000;
+	bits ^= sign;
+
+	if( bits >= halfMax ) {
+		// Too large to be represented becomes infinity, and NaNs become quiet NaNs
+		result = bits > infinity ? 0x7e00 : 0x7c00;
+	} else if( bits < minNormal ) {
+		float absValue;
+
+		memcpy( &absValue, &bits, sizeof( float ) );
+		absValue += subnormalMagic;
+		memcpy( &result, &absValue, sizeof( float ) );
+		result -= subnormalMagicBits;
+	} else {
+		const unsigned int mantissaOdd = ( bits >> 13 ) & 1;
+
+		bits += ( static_cast<unsigned int>( 15 - 127 ) << 23 ) + 0xfff;
+		bits += mantissaOdd;
+		result = bits >> 13;
+	}
+
+	return static_cast<unsigned short>( result | ( sign >> 16 ) );
+}
+
+// Private Member Functions
+
+attribute_encoder::attribute_encoder()
+{
+}
+
+attribute_encoder::~attribute_encoder()
+{
+}
+
+} // end of attributes namespace
+} // end of buffers namespace
+} // end of occluded namespace
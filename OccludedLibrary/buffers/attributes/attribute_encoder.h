@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+
+#include "attribute.h"
+
+namespace occluded { namespace buffers { namespace attributes {
+
+/**
+ * \class attribute_encoder
+ * \brief Converts floating point values into the storage format of an attribute.
+ *
+ * Converts floating point values into the compact formats that attributes can be stored in, so that the values can be inserted into an
+ * attribute buffer. Normalized conversions follow the OpenGL rules: unsigned values are mapped from [0, 1] and signed values from [-1, 1] to
+ * the full range of the integer type, and values outside of that range are clamped. Unnormalized conversions round the value and clamp it to
+ * the range of the integer type. Where SSE2 is available, four values are converted at a time.
+ */
+class attribute_encoder
+{
+public:
+	/**
+	 * \fn encode_values
+	 * \brief Converts values into the storage format of an attribute.
+	 *
+	 * \param attrib A reference to the attribute the values belong to.
+	 * \param values A pointer to the floating point components of the values, arity components for every value.
+	 * \param numValues An unsigned int representing the number of values to be converted.
+	 * \param dest A pointer to the memory the converted values are written to, which must be numValues times the size of the attribute long.
+	 *
+	 * Converts the values using the conversion that matches the type of the attribute and whether or not it is normalized. An exception is
+	 * thrown if the type of the attribute is attrib_invalid.
+	 */
+	static void encode_values( const attribute& attrib, const float* values, const unsigned int numValues, void* dest );
+
+	/**
+	 * \fn encode_half_floats
+	 * \brief Converts values to half precision floats.
+	 *
+	 * \param values A pointer to the values to be converted.
+	 * \param count A std::size_t representing the number of values to be converted.
+	 * \param dest A pointer to the memory the half precision floats are written to.
+	 *
+	 * Converts the values to IEEE 754 half precision floats, rounding to the nearest even value. Values too large to be represented become
+	 * infinity, and NaNs stay NaNs.
+	 */
+	static void encode_half_floats( const float* values, const std::size_t count, unsigned short* dest );
+
+	/**
+	 * \fn encode_bytes
+	 * \brief Converts values to signed bytes.
+	 *
+	 * \param values A pointer to the values to be converted.
+	 * \param count A std::size_t representing the number of values to be converted.
+	 * \param normalized A boolean that is true if the values are to be normalized.
+	 * \param dest A pointer to the memory the bytes are written to.
+	 */
+	static void encode_bytes( const float* values, const std::size_t count, const bool normalized, signed char* dest );
+
+	/**
+	 * \fn encode_ubytes
+	 * \brief Converts values to unsigned bytes.
+	 *
+	 * \param values A pointer to the values to be converted.
+	 * \param count A std::size_t representing the number of values to be converted.
+	 * \param normalized A boolean that is true if the values are to be normalized.
+	 * \param dest A pointer to the memory the bytes are written to.
+	 */
+	static void encode_ubytes( const float* values, const std::size_t count, const bool normalized, unsigned char* dest );
+
+	/**
+	 * \fn encode_shorts
+	 * \brief Converts values to signed shorts.
+	 *
+	 * \param values A pointer to the values to be converted.
+	 * \param count A std::size_t representing the number of values to be converted.
+	 * \param normalized A boolean that is true if the values are to be normalized.
+	 * \param dest A pointer to the memory the shorts are written to.
+	 */
+	static void encode_shorts( const float* values, const std::size_t count, const bool normalized, short* dest );
+
+	/**
+	 * \fn encode_ushorts
+	 * \brief Converts values to unsigned shorts.
+	 *
+	 * \param values A pointer to the values to be converted.
+	 * \param count A std::size_t representing the number of values to be converted.
+	 * \param normalized A boolean that is true if the values are to be normalized.
+	 * \param dest A pointer to the memory the shorts are written to.
+	 */
+	static void encode_ushorts( const float* values, const std::size_t count, const bool normalized, unsigned short* dest );
+
+	/**
+	 * \fn encode_ints
+	 * \brief Converts values to signed 32-bit integers.
+	 *
+	 * \param values A pointer to the values to be converted.
+	 * \param count A std::size_t representing the number of values to be converted.
+	 * \param normalized A boolean that is true if the values are to be normalized.
+	 * \param dest A pointer to the memory the integers are written to.
+	 */
+	static void encode_ints( const float* values, const std::size_t count, const bool normalized, int* dest );
+
+	/**
+	 * \fn encode_uints
+	 * \brief Converts values to unsigned 32-bit integers.
+	 *
+	 * \param values A pointer to the values to be converted.
+	 * \param count A std::size_t representing the number of values to be converted.
+	 * \param normalized A boolean that is true if the values are to be normalized.
+	 * \param dest A pointer to the memory the integers are written to.
+	 */
+	static void encode_uints( const float* values, const std::size_t count, const bool normalized, unsigned int* dest );
+
+	/**
+	 * \fn encode_int_2_10_10_10_rev
+	 * \brief Packs vectors of four values into 32-bit integers.
+	 *
+	 * \param values A pointer to the components of the vectors, four for every vector.
+	 * \param numVectors A std::size_t representing the number of vectors to be packed.
+	 * \param normalized A boolean that is true if the values are to be normalized.
+	 * \param dest A pointer to the memory the packed integers are written to.
+	 *
+	 * Packs each vector into a 32-bit integer in the GL_INT_2_10_10_10_REV format. The first three components are stored as 10-bit signed
+	 * integers starting at the lowest bit, and the fourth component is stored as a 2-bit signed integer in the highest bits.
+	 */
+	static void encode_int_2_10_10_10_rev( const float* values, const std::size_t numVectors, const bool normalized, unsigned int* dest );
+
+private:
+	attribute_encoder();
+	~attribute_encoder();
+
+	/**
+	 * \fn encode_integers
+	 * \brief Scales, clamps and rounds values and stores them as integers.
+	 *
+	 * \param values A pointer to the values to be converted.
+	 * \param count A std::size_t representing the number of values to be converted.
+	 * \param scale A float that every value is multiplied by before being clamped.
+	 * \param minVal A float representing the smallest value that can be stored.
+	 * \param maxVal A float representing the largest value that can be stored.
+	 * \param dest A pointer to the memory the integers are written to.
+	 */
+	template<typename T>
+	static void encode_integers( const float* values, const std::size_t count, const float scale, const float minVal, const float maxVal, T* dest );
+
+	/**
+	 * \fn quantize
+	 * \brief Scales, clamps and rounds a single value.
+	 *
+	 * \param value A float representing the value to be converted.
+	 * \param scale A float that the value is multiplied by before being clamped.
+	 * \param minVal A float representing the smallest value that can be stored.
+	 * \param maxVal A float representing the largest value that can be stored.
+	 * \return An int representing the value rounded to the nearest integer, with halfway cases rounded away from zero.
+	 */
+	static int quantize( const float value, const float scale, const float minVal, const float maxVal );
+
+	/**
+	 * \fn quantize_wide
+	 * \brief Scales, clamps and rounds a single value to a 32-bit integer.
+	 *
+	 * \param value A float representing the value to be converted.
+	 * \param scale A double that the value is multiplied by before being clamped.
+	 * \param minVal A double representing the smallest value that can be stored.
+	 * \param maxVal A double representing the largest value that can be stored.
+	 * \return A double holding the value rounded to the nearest integer, with halfway cases rounded away from zero and NaNs clamped to minVal.
+	 */
+	static double quantize_wide( const float value, const double scale, const double minVal, const double maxVal );
+
+	/**
+	 * \fn encode_half_float
+	 * \brief Converts a single value to a half precision float.
+	 *
+	 * \param value A float representing the value to be converted.
+	 * \return An unsigned short containing the bits of the half precision float.
+	 */
+	static unsigned short encode_half_float( const float value );
+};
+
+} // end of attributes namespace
+} // end of buffers namespace
+} // end of occluded namespace
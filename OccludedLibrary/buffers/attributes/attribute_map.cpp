@@ -2,10 +2,24 @@
 
 namespace occluded { namespace buffers { namespace attributes {
 
+const boost::uint64_t attribute_map::FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const boost::uint64_t attribute_map::FNV_PRIME = 1099511628211ULL;
+
 attribute_map::attribute_map( const bool interleaved ):
+	m_layout( interleaved ? layout_interleaved : layout_segregated ),
+	m_defining( true ),
 	m_attribCount( 0 ),
+	m_byteSize( 0 ),
+	m_hash( 0 )
+{
+}
+
+attribute_map::attribute_map( const attribute_layout_t layout ):
+	m_layout( layout ),
 	m_defining( true ),
-	m_interleaved( interleaved )
+	m_attribCount( 0 ),
+	m_byteSize( 0 ),
+	m_hash( 0 )
 {
 }
 
@@ -26,30 +40,97 @@ void attribute_map::add_attribute( const attribute& newAttrib ) {
 
 	m_attributes.push_back( newAttrib );
 	m_attribNames.insert( newAttrib.get_name() );
+	m_offsets.push_back( static_cast<unsigned int>( m_byteSize ) );
+	m_byteSize += newAttrib.get_attrib_size();
 
 	++m_attribCount;
 }
 
 void attribute_map::end_definition() {
 	m_defining = false;
+	m_hash = compute_hash();
+
+	compute_sections();
 }
 
 void attribute_map::reset( const bool interleaved ) {
+	reset( interleaved ? layout_interleaved : layout_segregated );
+}
+
+void attribute_map::reset( const attribute_layout_t layout ) {
 	m_defining = true;
 	m_attribCount = 0;
+	m_byteSize = 0;
+	m_hash = 0;
 	m_attributes.clear();
+	m_offsets.clear();
+	m_attribSections.clear();
+	m_sectionOffsets.clear();
+	m_sectionStrides.clear();
 	m_attribNames.clear();
-	m_interleaved = interleaved;
+	m_layout = layout;
 }
 
 const std::size_t attribute_map::get_byte_size() const {
-	std::size_t byteSize = 0;
+	return m_byteSize;
+}
 
-	for( std::vector<const attribute>::const_iterator it = m_attributes.begin(); it != m_attributes.end(); ++it ) {
-		byteSize += it->get_attrib_size();
+const std::vector<unsigned int>& attribute_map::get_attribute_offsets() const {
+	if( m_defining )
+		throw std::runtime_error( "attribute_map.get_attribute_offsets: Failed to get attribute offsets because the attribute map is still being defined." );
+
+	return m_offsets;
+}
+
+const unsigned int attribute_map::get_num_sections() const {
+	return static_cast<unsigned int>( m_sectionStrides.size() );
+}
+
+const std::vector<unsigned int>& attribute_map::get_attribute_sections() const {
+	if( m_defining )
+		throw std::runtime_error( "attribute_map.get_attribute_sections: Failed to get attribute sections because the attribute map is still being defined." );
+
+	return m_attribSections;
+}
+
+const std::vector<unsigned int>& attribute_map::get_section_offsets() const {
+	if( m_defining )
+		throw std::runtime_error( "attribute_map.get_section_offsets: Failed to get section offsets because the attribute map is still being defined." );
+
+	return m_sectionOffsets;
+}
+
+const std::vector<unsigned int>& attribute_map::get_section_strides() const {
+	if( m_defining )
+		throw std::runtime_error( "attribute_map.get_section_strides: Failed to get section strides because the attribute map is still being defined." );
+
+	return m_sectionStrides;
+}
+
+const std::vector<unsigned int> attribute_map::get_block_offsets( const unsigned int numValues ) const {
+	if( m_defining )
+		throw std::runtime_error( "attribute_map.get_block_offsets: Failed to get block offsets because the attribute map is still being defined." );
+
+	std::vector<unsigned int> sectionStarts( m_sectionStrides.size() ), blockOffsets( m_attribCount );
+	unsigned int currOffset = 0, i = 0;
+
+	for( i = 0; i < m_sectionStrides.size(); ++i ) {
+		sectionStarts[i] = currOffset;
+		currOffset += numValues * m_sectionStrides[i];
+	}
+
+	for( i = 0; i < m_attribCount; ++i ) {
+		blockOffsets[i] = sectionStarts[m_attribSections[i]] + m_sectionOffsets[i];
 	}
 
-	return byteSize;
+	return blockOffsets;
+}
+
+const boost::uint64_t attribute_map::get_hash() const {
+	if( m_defining )
+		throw std::runtime_error( "attribute_map.get_hash: Failed to get hash because the attribute map is still being defined." );
+
+	return m_hash;
 }
 
 const unsigned int attribute_map::get_attrib_count() const {
@@ -64,7 +145,11 @@ const std::vector<const attribute>& attribute_map::get_attributes() const {
 }
 
 const bool attribute_map::is_interleaved() const {
-	return m_interleaved;
+	return m_layout == layout_interleaved;
+}
+
+const attribute_layout_t attribute_map::get_layout() const {
+	return m_layout;
 }
 
 const bool attribute_map::being_defined() const {
@@ -72,34 +157,96 @@ const bool attribute_map::being_defined() const {
 }
 
 const bool attribute_map::operator==( const attribute_map& other ) const {
-	unsigned int i = 0;
-	bool equal = true;
-	std::vector<const attribute> otherAttrib;
-
 	// If either attribute_map is still being defined return false
-	if( this->m_defining == false && other.being_defined() == false ){
-		otherAttrib = other.get_attributes();
-	
-		// Check the counts of the attributes so that iterating through all the attributes can be avoided if possible
-		equal = otherAttrib.size() == m_attribCount;
-
-		for( i = 0; equal && i < otherAttrib.size(); ++i ) {
-			// Check to see if the attribute are not equal
-			equal = otherAttrib[i] == m_attributes[i]; 
-		}
-	
-		equal = this->m_interleaved == other.m_interleaved && equal;
-	} else {
-		equal = false;
-	}
+	if( this->m_defining || other.m_defining )
+		return false;
+
+	if( this == &other )
+		return true;
 
-	return equal;
+	return this->m_hash == other.m_hash && this->m_attribCount == other.m_attribCount && this->m_byteSize == other.m_byteSize;
 }
 
 const bool attribute_map::operator!=( const attribute_map& other ) const {
 	return !( *this == other );
 }
 
+// Private Member Functions
+
+const boost::uint64_t attribute_map::compute_hash() const {
+	const bool interleaved = m_layout == layout_interleaved;
+	boost::uint64_t hash = hash_bytes( FNV_OFFSET_BASIS, &interleaved, sizeof( interleaved ) );
+
+	// The hybrid layout is added on its own, so the hashes of interleaved and segregated maps are the same as before it existed
+	if( m_layout == layout_hybrid )
+		hash = hash_bytes( hash, &m_layout, sizeof( m_layout ) );
+
+	for( std::vector<const attribute>::const_iterator it = m_attributes.begin(); it != m_attributes.end(); ++it ) {
+		const unsigned int arity = it->get_arity();
+		const attribute_t type = it->get_type();
+
+		// Include the length of the name so that adjacent names can not run together into the same bytes
+		const std::size_t nameLength = it->get_name().size();
+
+		hash = hash_bytes( hash, &nameLength, sizeof( nameLength ) );
+		hash = hash_bytes( hash, it->get_name().data(), nameLength );
+		hash = hash_bytes( hash, &arity, sizeof( arity ) );
+		hash = hash_bytes( hash, &type, sizeof( type ) );
+
+		// Normalized attributes are read differently by the shaders, so the flag is added, but only when set so other hashes stay the same
+		if( it->is_normalized() ) {
+			const bool normalized = true;
+
+			hash = hash_bytes( hash, &normalized, sizeof( normalized ) );
+		}
+	}
+
+	return hash;
+}
+
+void attribute_map::compute_sections() {
+	m_attribSections.resize( m_attribCount );
+	m_sectionOffsets.resize( m_attribCount );
+	m_sectionStrides.clear();
+
+	for( unsigned int i = 0; i < m_attribCount; ++i ) {
+		const unsigned int attribSize = static_cast<unsigned int>( m_attributes[i].get_attrib_size() );
+		bool newSection = false;
+
+		switch( m_layout ) {
+		case layout_interleaved:
+			newSection = i == 0;
+			break;
+		case layout_segregated:
+			newSection = true;
+			break;
+		case layout_hybrid:
+			newSection = i < 2;
+			break;
+		}
+
+		if( newSection )
+			m_sectionStrides.push_back( 0 );
+
+		m_attribSections[i] = static_cast<unsigned int>( m_sectionStrides.size() - 1 );
+		m_sectionOffsets[i] = m_sectionStrides.back();
+		m_sectionStrides.back() += attribSize;
+	}
+}
+
+// Private Static Functions
+
+const boost::uint64_t attribute_map::hash_bytes( const boost::uint64_t hash, const void* data, const std::size_t size ) {
+	const unsigned char* bytes = static_cast<const unsigned char*>( data );
+	boost::uint64_t newHash = hash;
+
+	for( std::size_t i = 0; i < size; ++i ) {
+		newHash = ( newHash ^ bytes[i] ) * FNV_PRIME;
+	}
+
+	return newHash;
+}
+
 } // end of attributes namespace
 } // end of buffers namespace
 } // end of occluded namespace
@@ -4,26 +4,56 @@
 
 #include <boost/unordered_set.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/cstdint.hpp>
 
 #include "attribute.h"
 
 namespace occluded { namespace buffers { namespace attributes {
 
+/**
+ * \enum attribute_layout_t
+ * \brief An enumerable that determines how the values of the attributes in an attribute map are organized in a buffer.
+ *
+ * layout_interleaved stores every attribute of a value next to each other, and layout_segregated stores each attribute in its own section.
+ * layout_hybrid stores the first attribute, which is normally the position, tightly packed in its own section and interleaves every other
+ * attribute in a second section, so that passes that only read positions, such as depth and shadow passes, fetch only the first section.
+ */
+typedef enum ATTRIBUTE_LAYOUT {
+	layout_interleaved,
+	layout_segregated,
+	layout_hybrid
+} attribute_layout_t;
+
 /**
  * \class attribute_map
  * \brief Defines an organization of attributes.
  *
  * The attribute map defines an organization of attributes.This is to be used with an attribute buffer to determine in which order values are 
- * placed and if the values are interleaved or segregated in the buffer.
+ * placed and how the values are laid out in the buffer. Once the definition is ended the map is frozen, and its byte size, the offset of each
+ * attribute, the sections of its layout and a hash of its structure are computed once so that they do not need to be recomputed every time
+ * they are used.
+ *
+ * The layout splits a buffer into sections, each of which stores one or more attributes interleaved with a fixed stride. An interleaved map
+ * has a single section, a segregated map has a section for every attribute and a hybrid map has a section for the first attribute and a
+ * section for the rest. Section i always starts with attribute i.
  * \see { occluded::buffers::attribute_buffer }
  */
 class attribute_map
 {
 private:
-	bool m_interleaved;
+	static const boost::uint64_t FNV_OFFSET_BASIS;
+	static const boost::uint64_t FNV_PRIME;
+
+	attribute_layout_t m_layout;
 	bool m_defining;
 	unsigned int m_attribCount;
+	std::size_t m_byteSize;
+	boost::uint64_t m_hash;
 	std::vector<const attribute> m_attributes;
+	std::vector<unsigned int> m_offsets;
+	std::vector<unsigned int> m_attribSections;
+	std::vector<unsigned int> m_sectionOffsets;
+	std::vector<unsigned int> m_sectionStrides;
 	boost::unordered_set<const std::string> m_attribNames;
 
 public:
@@ -37,6 +67,15 @@ public:
 	 * end_definition call.
 	 */
 	attribute_map( const bool interleaved );
+
+	/**
+	 * \brief Initializes the attribute map with a layout.
+	 *
+	 * \param layout An attribute_layout_t which determines how the values are organized in a buffer.
+	 *
+	 * Initializes the attribute map in the same way as the other constructor, but allows the hybrid layout to be used.
+	 */
+	explicit attribute_map( const attribute_layout_t layout );
 	~attribute_map();
 
 	/**
@@ -54,7 +93,8 @@ public:
 	 * \fn end_definition
 	 * \brief Ends the definition of the attribute map.
 	 *
-	 * Ends the definition of the attribute map. This indicates that the attribute map is ready to be used by other classes.
+	 * Ends the definition of the attribute map. This indicates that the attribute map is ready to be used by other classes. The offsets of
+	 * the attributes, the sections of the layout and the structural hash of the map are computed at this point.
 	 */
 	void end_definition();
 
@@ -71,16 +111,100 @@ public:
 	 */
 	void reset( const bool interleaved );
 
+	/**
+	 * \fn reset
+	 * \brief Clears attributes and restarts definition of attribute map with a layout.
+	 *
+	 * \param layout An attribute_layout_t which determines how the values are organized in a buffer.
+	 *
+	 * \see { reset }
+	 */
+	void reset( const attribute_layout_t layout );
+
 	/**
 	 * \fn get_byte_size
 	 * \brief Gets the byte size of the attribute map.
 	 *
 	 * \return A std::size_t representing the number of bytes.
 	 *
-	 * Gets the byte of size that a single value of all the attributes in the attribute map would take up.
+	 * Gets the byte of size that a single value of all the attributes in the attribute map would take up. The size is kept up to date as
+	 * attributes are added, so no work is done by this call.
 	 */
 	const std::size_t get_byte_size() const;
 
+	/**
+	 * \fn get_attribute_offsets
+	 * \brief Gets the offset of each attribute within a single value.
+	 *
+	 * \return A reference to a vector of unsigned ints representing the offset, in bytes, of each attribute from the start of a value whose
+	 * attributes are interleaved.
+	 *
+	 * Gets the offsets that were computed when the definition of the attribute map was ended. An exception is thrown if the attribute map is
+	 * still being defined.
+	 */
+	const std::vector<unsigned int>& get_attribute_offsets() const;
+
+	/**
+	 * \fn get_num_sections
+	 * \brief Gets the number of sections the values are split into.
+	 *
+	 * \return An unsigned int representing the number of sections, which is 0 if the map has no attributes.
+	 */
+	const unsigned int get_num_sections() const;
+
+	/**
+	 * \fn get_attribute_sections
+	 * \brief Gets the section each attribute is stored in.
+	 *
+	 * \return A reference to a vector of unsigned ints containing the index of the section of each attribute.
+	 *
+	 * An exception is thrown if the attribute map is still being defined.
+	 */
+	const std::vector<unsigned int>& get_attribute_sections() const;
+
+	/**
+	 * \fn get_section_offsets
+	 * \brief Gets the offset of each attribute within a single value of its section.
+	 *
+	 * \return A reference to a vector of unsigned ints representing the offset, in bytes, of each attribute from the start of a value of its section.
+	 *
+	 * An exception is thrown if the attribute map is still being defined.
+	 */
+	const std::vector<unsigned int>& get_section_offsets() const;
+
+	/**
+	 * \fn get_section_strides
+	 * \brief Gets the stride of each section.
+	 *
+	 * \return A reference to a vector of unsigned ints representing the number of bytes between consecutive values in each section.
+	 *
+	 * An exception is thrown if the attribute map is still being defined.
+	 */
+	const std::vector<unsigned int>& get_section_strides() const;
+
+	/**
+	 * \fn get_block_offsets
+	 * \brief Gets the offsets of the attributes in a block of values organized according to the layout.
+	 *
+	 * \param numValues An unsigned int representing the number of values in the block.
+	 * \return A vector of unsigned ints representing the offset, in bytes, of the first value of each attribute from the start of the block.
+	 *
+	 * A block holds every section one after another, each with room for numValues values. This is how the memory passed to
+	 * attribute_buffer::insert_values is organized. An exception is thrown if the attribute map is still being defined.
+	 */
+	const std::vector<unsigned int> get_block_offsets( const unsigned int numValues ) const;
+
+	/**
+	 * \fn get_hash
+	 * \brief Gets the structural hash of the attribute map.
+	 *
+	 * \return A 64-bit unsigned integer computed from the layout and the name, arity, type and normalization of every attribute, in order.
+	 *
+	 * Gets the hash that was computed when the definition of the attribute map was ended. Two maps that compare equal have the same hash. An
+	 * exception is thrown if the attribute map is still being defined.
+	 */
+	const boost::uint64_t get_hash() const;
+
 	/**
 	 * \fn get_attrib_count
 	 * \brief Gets the number of attributes in the attribute map.
@@ -101,10 +225,18 @@ public:
 	 * \fn is_interleaved
 	 * \brief Gets whether or not the values of the attributes should be interleaved or segregated.
 	 *
-	 * \return A boolean that is true if the values should be interleaved and false if they should be segregated.
+	 * \return A boolean that is true if the values should be interleaved and false if they should be segregated or use the hybrid layout.
 	 */
 	const bool is_interleaved() const;
 
+	/**
+	 * \fn get_layout
+	 * \brief Gets how the values of the attributes are organized.
+	 *
+	 * \return The attribute_layout_t the map was created or reset with.
+	 */
+	const attribute_layout_t get_layout() const;
+
 	/**
 	 * \fn being_defined
 	 * \brief Gets whether or not the attribute map is still being defined.
@@ -118,6 +250,9 @@ public:
 	 * 
 	 * \return A boolean that is true if the attributes are the same in both attribute maps and are in the same order, and returns false 
 	 * otherwise.
+	 *
+	 * Compares the structural hashes of the maps instead of every attribute, so the comparison takes constant time. Attributes only count as
+	 * the same if they are also normalized the same way.
 	 */
 	const bool operator==( const attribute_map& other ) const;
 
@@ -128,6 +263,32 @@ public:
 	 * otherwise.
 	 */
 	const bool operator!=( const attribute_map& other ) const;
+
+private:
+	/**
+	 * \fn compute_hash
+	 * \brief Computes the structural hash of the attribute map.
+	 *
+	 * \return A 64-bit unsigned integer representing the FNV-1a hash of the layout and the attributes.
+	 */
+	const boost::uint64_t compute_hash() const;
+
+	/**
+	 * \fn compute_sections
+	 * \brief Computes the section, offset within the section and stride of every attribute according to the layout.
+	 */
+	void compute_sections();
+
+	/**
+	 * \fn hash_bytes
+	 * \brief Adds bytes to an FNV-1a hash.
+	 *
+	 * \param hash A 64-bit unsigned integer representing the hash computed so far.
+	 * \param data A pointer to the bytes to be added to the hash.
+	 * \param size A std::size_t representing the number of bytes to be added.
+	 * \return A 64-bit unsigned integer representing the hash after the bytes have been added.
+	 */
+	static const boost::uint64_t hash_bytes( const boost::uint64_t hash, const void* data, const std::size_t size );
 };
 
 } // end of attributes namespace
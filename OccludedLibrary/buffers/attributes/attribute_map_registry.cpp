@@ -0,0 +1,102 @@
+#include "attribute_map_registry.h"
+
+namespace occluded { namespace buffers { namespace attributes {
+
+attribute_map_registry* attribute_map_registry::s_registry = NULL;
+std::once_flag attribute_map_registry::s_registryFlag;
+
+attribute_map_registry& attribute_map_registry::get_registry() {
+	// Function-local statics are not initialized thread safely by every compiler, so the registry is created through call_once
+	std::call_once( s_registryFlag, &attribute_map_registry::create_registry );
+
+	return *s_registry;
+}
+
+const attribute_map_handle attribute_map_registry::intern( const attribute_map& map ) {
+	if( map.being_defined() ) {
+		throw std::runtime_error( "attribute_map_registry.intern: Failed to intern attribute map because it is still being defined." );
+	}
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+	std::vector<attribute_map_handle>& bucket = m_maps[map.get_hash()];
+
+	for( std::vector<attribute_map_handle>::const_iterator it = bucket.begin(); it != bucket.end(); ++it ) {
+		if( have_same_structure( **it, map ) )
+			return *it;
+	}
+
+	bucket.push_back( attribute_map_handle( new attribute_map( map ) ) );
+	++m_numMaps;
+
+	return bucket.back();
+}
+
+const unsigned int attribute_map_registry::release_unused() {
+	std::lock_guard<std::mutex> lock( m_mutex );
+	unsigned int numReleased = 0;
+
+	for( boost::unordered_map< boost::uint64_t, std::vector<attribute_map_handle> >::iterator it = m_maps.begin(); it != m_maps.end(); ) {
+		std::vector<attribute_map_handle>& bucket = it->second;
+
+		for( std::size_t i = bucket.size(); i > 0; --i ) {
+			if( bucket[i - 1].unique() ) {
+				bucket.erase( bucket.begin() + ( i - 1 ) );
+				++numReleased;
+			}
+		}
+
+		if( bucket.empty() )
+			it = m_maps.erase( it );
+		else
+			++it;
+	}
+
+	m_numMaps -= numReleased;
+
+	return numReleased;
+}
+
+const unsigned int attribute_map_registry::get_num_maps() const {
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	return m_numMaps;
+}
+
+// Private Member Functions
+
+attribute_map_registry::attribute_map_registry():
+	m_numMaps( 0 )
+{
+}
+
+attribute_map_registry::~attribute_map_registry()
+{
+}
+
+// Static Functions
+
+void attribute_map_registry::create_registry() {
+	// Only ever run by one thread, so the local static is safe to initialize here and is still destroyed when the program exits
+	static attribute_map_registry registry;
+
+	s_registry = &registry;
+}
+
+const bool attribute_map_registry::have_same_structure( const attribute_map& first, const attribute_map& second ) {
+	if( first.get_layout() != second.get_layout() || first.get_attrib_count() != second.get_attrib_count() )
+		return false;
+
+	const std::vector<const attribute>& firstAttributes = first.get_attributes();
+	const std::vector<const attribute>& secondAttributes = second.get_attributes();
+
+	for( std::size_t i = 0; i < firstAttributes.size(); ++i ) {
+		if( firstAttributes[i] != secondAttributes[i] || firstAttributes[i].is_normalized() != secondAttributes[i].is_normalized() )
+			return false;
+	}
+
+	return true;
+}
+
+} // end of attributes namespace
+} // end of buffers namespace
+} // end of occluded namespace
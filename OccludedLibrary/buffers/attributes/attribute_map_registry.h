@@ -0,0 +1,108 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "attribute_map.h"
+
+namespace occluded { namespace buffers { namespace attributes {
+
+/**
+ * \typedef attribute_map_handle
+ * \brief A shared handle to an attribute map that has been interned by the attribute_map_registry.
+ */
+typedef boost::shared_ptr<const attribute_map> attribute_map_handle;
+
+/**
+ * \class attribute_map_registry
+ * \brief Stores a single copy of every attribute map used by the buffers.
+ *
+ * Attribute buffers, shader attribute maps and vertex welders keep an attribute map for as long as they exist, and a scene usually has many
+ * of them but only a few vertex formats. Instead of each of them storing its own copy of the map, they intern the map and keep a handle to
+ * the copy stored by the registry, so every object with the same format shares one map. The structural hash covers the normalized flag of
+ * every attribute, so maps that compare equal are interned to the same copy, and unless their 64-bit hashes collide, two interned maps are
+ * equal exactly when they are at the same address.
+ *
+ * The maps are looked up by their structural hash, and the attributes and layout of every map with the same hash are compared, so maps whose
+ * hashes collide are still kept apart. Every function locks the registry, so buffers can be created on different threads at the same time.
+ */
+class attribute_map_registry
+{
+private:
+	boost::unordered_map< boost::uint64_t, std::vector<attribute_map_handle> > m_maps;
+	unsigned int m_numMaps;
+	mutable std::mutex m_mutex;
+
+	static attribute_map_registry* s_registry;
+	static std::once_flag s_registryFlag;
+
+public:
+	/**
+	 * \fn get_registry
+	 * \brief Gets the registry shared by every buffer.
+	 *
+	 * \return A reference to the registry.
+	 *
+	 * The registry is created the first time it is needed, and only once even if several threads get it at the same time.
+	 */
+	static attribute_map_registry& get_registry();
+
+	/**
+	 * \fn intern
+	 * \brief Gets the shared copy of an attribute map.
+	 *
+	 * \param map A reference to the attribute map.
+	 * \return A handle to the copy of the map stored by the registry.
+	 *
+	 * Copies the map into the registry the first time a map with its structure is interned, and returns a handle to that copy every time after.
+	 * An exception is thrown if the map is still being defined.
+	 */
+	const attribute_map_handle intern( const attribute_map& map );
+
+	/**
+	 * \fn release_unused
+	 * \brief Removes the maps that are no longer used from the registry.
+	 *
+	 * \return An unsigned int representing the number of maps that were removed.
+	 *
+	 * Removes every map whose only handle is the one held by the registry, so the memory of formats that are no longer used is freed.
+	 */
+	const unsigned int release_unused();
+
+	/**
+	 * \fn get_num_maps
+	 * \brief Gets the number of maps in the registry.
+	 *
+	 * \return An unsigned int representing the number of distinct maps that have been interned and not released.
+	 */
+	const unsigned int get_num_maps() const;
+
+	/**
+	 * \fn have_same_structure
+	 * \brief Checks whether two maps have the same layout and the same attributes in the same order.
+	 *
+	 * \param first A reference to the first attribute map.
+	 * \param second A reference to the second attribute map.
+	 * \return A boolean that is true if the maps have the same layout and the same name, arity, type and normalized flag for every attribute.
+	 *
+	 * Compares every attribute instead of the hashes, so maps whose hashes collide are still told apart.
+	 */
+	static const bool have_same_structure( const attribute_map& first, const attribute_map& second );
+
+private:
+	attribute_map_registry();
+	~attribute_map_registry();
+
+	/**
+	 * \fn create_registry
+	 * \brief Creates the registry returned by get_registry.
+	 */
+	static void create_registry();
+};
+
+} // end of attributes namespace
+} // end of buffers namespace
+} // end of occluded namespace
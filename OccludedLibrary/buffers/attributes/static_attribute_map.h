@@ -0,0 +1,286 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "attribute_map.h"
+#include "../attribute_buffer.h"
+
+namespace occluded { namespace buffers { namespace attributes {
+
+/**
+ * \struct component_traits
+ * \brief Maps a C++ type to the attribute type and arity used to store it.
+ *
+ * Maps the type of a member of a vertex structure to the attribute_t and arity of the attribute that stores it. Only float, the signed and
+ * unsigned 8, 16 and 32-bit integers, and arrays of them are supported, using any other type as a field is a compile error. Half floats and
+ * packed types have no C++ type of their own and can only be used with a runtime attribute_map.
+ */
+template<typename T>
+struct component_traits;
+
+template<>
+struct component_traits<float> {
+	static const attribute_t TYPE = attrib_float;
+	static const unsigned int ARITY = 1;
+};
+
+template<>
+struct component_traits<unsigned int> {
+	static const attribute_t TYPE = attrib_uint;
+	static const unsigned int ARITY = 1;
+};
+
+template<>
+struct component_traits<int> {
+	static const attribute_t TYPE = attrib_int;
+	static const unsigned int ARITY = 1;
+};
+
+template<>
+struct component_traits<signed char> {
+	static const attribute_t TYPE = attrib_byte;
+	static const unsigned int ARITY = 1;
+};
+
+template<>
+struct component_traits<unsigned char> {
+	static const attribute_t TYPE = attrib_ubyte;
+	static const unsigned int ARITY = 1;
+};
+
+template<>
+struct component_traits<short> {
+	static const attribute_t TYPE = attrib_short;
+	static const unsigned int ARITY = 1;
+};
+
+template<>
+struct component_traits<unsigned short> {
+	static const attribute_t TYPE = attrib_ushort;
+	static const unsigned int ARITY = 1;
+};
+
+template<typename T, std::size_t N>
+struct component_traits<T[N]> {
+	static const attribute_t TYPE = component_traits<T>::TYPE;
+	static const unsigned int ARITY = static_cast<unsigned int>( N ) * component_traits<T>::ARITY;
+};
+
+/**
+ * \struct field
+ * \brief Describes a member of a vertex structure that stores an attribute.
+ *
+ * Describes the member of a vertex structure that stores the values of a single attribute. The type, arity and size of the attribute are
+ * all determined at compile time from the type of the member.
+ * \see { occluded::buffers::attributes::static_attribute_map }
+ */
+template<typename Vertex, typename T, T Vertex::*Member, bool Normalized = false>
+struct field {
+	typedef Vertex vertex_type;
+	typedef T member_type;
+
+	static const attribute_t TYPE = component_traits<T>::TYPE;
+	static const unsigned int ARITY = component_traits<T>::ARITY;
+	static const std::size_t SIZE = sizeof( T );
+	static const bool NORMALIZED = Normalized;
+
+	/**
+	 * \fn get_member_offset
+	 * \brief Gets the offset of the member in the vertex structure.
+	 *
+	 * \return A std::size_t representing the offset in bytes of the member from the start of the vertex structure.
+	 */
+	static std::size_t get_member_offset() {
+		// Same approach as offsetof, which can not be used with a pointer to member
+		return reinterpret_cast<std::size_t>( &( reinterpret_cast<const Vertex*>( 0 )->*Member ) );
+	}
+
+	/**
+	 * \fn create_attribute
+	 * \brief Creates the attribute described by the field.
+	 *
+	 * \param name A reference to a string representing the name of the attribute.
+	 * \return The attribute described by the field.
+	 */
+	static attribute create_attribute( const std::string& name ) {
+		return attribute( name, ARITY, TYPE, NORMALIZED );
+	}
+};
+
+/**
+ * \struct packed_size
+ * \brief Sums the sizes of the first N fields of a field list at compile time.
+ */
+template<unsigned int N, typename... Fields>
+struct packed_size {
+	static const std::size_t VALUE = 0;
+};
+
+template<unsigned int N, typename First, typename... Rest>
+struct packed_size<N, First, Rest...> {
+	static const std::size_t VALUE = N == 0 ? 0 : First::SIZE + packed_size<( N == 0 ? 0 : N - 1 ), Rest...>::VALUE;
+};
+
+/**
+ * \struct fields_of_vertex
+ * \brief Checks at compile time that every field of a field list describes a member of the same vertex structure.
+ */
+template<typename Vertex, typename... Fields>
+struct fields_of_vertex {
+	static const bool VALUE = true;
+};
+
+template<typename Vertex, typename First, typename... Rest>
+struct fields_of_vertex<Vertex, First, Rest...> {
+	static const bool VALUE = std::is_same<Vertex, typename First::vertex_type>::value && fields_of_vertex<Vertex, Rest...>::VALUE;
+};
+
+/**
+ * \class static_attribute_map
+ * \brief Describes the organization of attributes in a vertex structure at compile time.
+ *
+ * Describes how the attributes of a vertex structure are laid out using a list of fields. The stride, the offset of each attribute, and the
+ * type and arity of each attribute are compile time constants, so nothing needs to be recomputed per vertex when the structures are inserted
+ * into an attribute buffer. The fields must be listed in the order the members are declared and must cover the whole structure without any
+ * padding, which is checked at compile time for the size and when the attribute map is created for the order. An attribute_map can be created
+ * from it for use with the rest of the library.
+ * \see { occluded::buffers::attributes::attribute_map }
+ */
+template<typename Vertex, typename... Fields>
+class static_attribute_map
+{
+public:
+	static const unsigned int ATTRIB_COUNT = static_cast<unsigned int>( sizeof...( Fields ) );
+	static const std::size_t STRIDE = sizeof( Vertex );
+
+	static_assert( fields_of_vertex<Vertex, Fields...>::VALUE, "static_attribute_map: Every field must describe a member of the vertex structure." );
+
+	static_assert( packed_size<ATTRIB_COUNT, Fields...>::VALUE == sizeof( Vertex ),
+		"static_attribute_map: The fields must cover the whole vertex structure and the structure can not contain padding." );
+
+	/**
+	 * \struct offset
+	 * \brief Gets the packed offset of an attribute at compile time.
+	 *
+	 * The offset is the sum of the sizes of the fields before the attribute, which is where the attribute is stored in an interleaved
+	 * value. It is only the offset of the member in the vertex structure if the fields are listed in the order the members are declared,
+	 * which create_attribute_map and insert_vertices check, since the offset of a member is not a compile time constant.
+	 */
+	template<unsigned int Index>
+	struct offset {
+		static_assert( Index < sizeof...( Fields ), "static_attribute_map: The attribute index is out of range." );
+
+		static const std::size_t VALUE = packed_size<Index, Fields...>::VALUE;
+	};
+
+	/**
+	 * \fn create_attribute_map
+	 * \brief Creates an attribute map with the organization described by the fields.
+	 *
+	 * \param interleaved A boolean which determines whether or not the values should be segregated or interleaved.
+	 * \param names The names of the attributes, one for each field and in the same order.
+	 * \return An attribute map that has finished being defined.
+	 *
+	 * Creates an attribute map containing an attribute for each field. An exception is thrown if the fields are not listed in the order the
+	 * members are declared in the vertex structure.
+	 */
+	template<typename... Names>
+	static attribute_map create_attribute_map( const bool interleaved, const Names&... names ) {
+		static_assert( sizeof...( Names ) == sizeof...( Fields ), "static_attribute_map.create_attribute_map: A name must be provided for every field." );
+
+		const attribute attributes[] = { Fields::create_attribute( names )... };
+		attribute_map map( interleaved );
+
+		check_member_order( attributes );
+
+		for( unsigned int i = 0; i < ATTRIB_COUNT; ++i ) {
+			map.add_attribute( attributes[i] );
+		}
+
+		map.end_definition();
+
+		return map;
+	}
+
+	/**
+	 * \fn insert_vertices
+	 * \brief Inserts an array of vertex structures into an attribute buffer.
+	 *
+	 * \param buffer A reference to the attribute buffer the vertices are inserted into.
+	 * \param vertices A pointer to the first vertex structure to be inserted.
+	 * \param numVertices An unsigned int representing the number of vertex structures to be inserted.
+	 *
+	 * Inserts the vertex structures into the attribute buffer. Since an array of vertex structures is already laid out the same way as an
+	 * interleaved buffer, the whole array is inserted into an interleaved buffer with a single copy. Segregated and hybrid buffers have each
+	 * structure split into their sections. An exception is thrown if the attributes of the buffer's attribute map do not have the type, arity
+	 * and normalization of the fields, in the same order, or if the fields are not in the order the members are declared.
+	 */
+	static void insert_vertices( attribute_buffer& buffer, const Vertex* vertices, const unsigned int numVertices ) {
+		const attribute_map& bufferMap = buffer.get_attribute_map();
+
+		if( bufferMap.get_attrib_count() != ATTRIB_COUNT ) {
+			throw std::runtime_error( "static_attribute_map.insert_vertices: Failed to insert vertices because the buffer's attribute map does not have an"
+				+ std::string( " attribute for every field." ) );
+		}
+
+		// The fields have no names of their own, so the map they describe is built with the names of the buffer's attributes and compared
+		const std::vector<const attribute>& bufferAttributes = bufferMap.get_attributes();
+		const attribute attributes[] = { Fields::create_attribute( std::string() )... };
+		attribute_map fieldMap( bufferMap.get_layout() );
+
+		for( unsigned int i = 0; i < ATTRIB_COUNT; ++i ) {
+			fieldMap.add_attribute( attribute( bufferAttributes[i].get_name(), attributes[i].get_arity(), attributes[i].get_type(),
+				attributes[i].is_normalized() ) );
+		}
+
+		fieldMap.end_definition();
+
+		if( !attribute_map_registry::have_same_structure( bufferMap, fieldMap ) ) {
+			throw std::runtime_error( "static_attribute_map.insert_vertices: Failed to insert vertices because the buffer's attribute map does not match"
+				+ std::string( " the fields of the vertex structure." ) );
+		}
+
+		check_member_order( &fieldMap.get_attributes()[0] );
+
+		if( buffer.get_attribute_map().is_interleaved() )
+			buffer.insert_values( static_cast<const void*>( vertices ), numVertices );
+		else
+			buffer.insert_values( vertices, vertices + numVertices );
+	}
+
+private:
+	/**
+	 * \fn check_member_order
+	 * \brief Throws an exception if the fields are not listed in the order the members are declared in the vertex structure.
+	 *
+	 * \param attributes A pointer to the attributes described by the fields, one for each field and in the same order.
+	 */
+	static void check_member_order( const attribute* attributes ) {
+		const std::size_t memberOffsets[] = { Fields::get_member_offset()... };
+		std::size_t packedOffset = 0;
+
+		for( unsigned int i = 0; i < ATTRIB_COUNT; ++i ) {
+			if( memberOffsets[i] != packedOffset ) {
+				throw std::runtime_error( "static_attribute_map: Failed to use the fields because the field for attribute(" + attributes[i].get_name()
+					+ ") is not in the same order as the members of the vertex structure." );
+			}
+
+			packedOffset += attributes[i].get_attrib_size();
+		}
+	}
+};
+
+template<typename Vertex, typename... Fields>
+const unsigned int static_attribute_map<Vertex, Fields...>::ATTRIB_COUNT;
+
+template<typename Vertex, typename... Fields>
+const std::size_t static_attribute_map<Vertex, Fields...>::STRIDE;
+
+template<typename Vertex, typename... Fields>
+template<unsigned int Index>
+const std::size_t static_attribute_map<Vertex, Fields...>::offset<Index>::VALUE;
+
+} // end of attributes namespace
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,144 @@
+#include "hybrid_attr_buffer.h"
+
+#include <limits>
+
+namespace occluded { namespace buffers {
+
+hybrid_attr_buffer::hybrid_attr_buffer( const attributes::attribute_map& map, storage::storage_allocator& allocator ):
+	attribute_buffer( map, allocator ),
+	m_capacity( 0 )
+{
+	if( map.get_layout() != attributes::layout_hybrid ) {
+		throw std::runtime_error( "hybrid_attr_buffer: Failed to initialize hybrid attribute buffer because attribute map passed to constructor"
+			+ std::string( " does not use the hybrid layout." ) );
+	}
+}
+
+hybrid_attr_buffer::~hybrid_attr_buffer()
+{
+}
+
+void hybrid_attr_buffer::reserve( const unsigned int numValues ) {
+	if( numValues > m_capacity && m_map->get_byte_size() > 0 )
+		grow_sections( numValues );
+}
+
+void hybrid_attr_buffer::clear_buffer() {
+	attribute_buffer::clear_buffer();
+
+	m_capacity = 0;
+}
+
+const unsigned int hybrid_attr_buffer::get_capacity() const {
+	return m_capacity;
+}
+
+// Protected Member Functions
+
+void hybrid_attr_buffer::overwrite_values( const unsigned int firstValue, const unsigned int numValues, const char* values,
+	const unsigned int firstSource, const unsigned int numSource ) {
+	const std::vector<unsigned int>& strides = m_map->get_section_strides();
+	std::size_t valuesOffset = 0;
+
+	for( unsigned int i = 0; i < strides.size(); ++i ) {
+		const std::size_t offset = get_section_start( i ) + firstValue * strides[i];
+
+		// The source holds all the values of one section before the values of the next
+		memcpy( &m_data[offset], &values[valuesOffset + firstSource * strides[i]], numValues * strides[i] );
+		mark_dirty( offset, numValues * strides[i] );
+		valuesOffset += numSource * strides[i];
+	}
+}
+
+void hybrid_attr_buffer::append_values( const unsigned int numValues ) {
+	const unsigned int maxValues = std::numeric_limits<unsigned int>::max();
+
+	if( numValues > maxValues - m_numValues ) {
+		throw std::runtime_error( "hybrid_attr_buffer.append_values: Failed to append " + boost::lexical_cast<std::string>( numValues )
+			+ " values because the buffer would hold more values than can be counted." );
+	}
+
+	// Grow geometrically so that repeatedly appending values only moves the sections a logarithmic number of times, but never past the
+	// capacity whose sections still fit in the offset range
+	if( m_numValues + numValues > m_capacity ) {
+		const unsigned int maxCapacity = m_map->get_byte_size() > 0 ? static_cast<unsigned int>( maxValues / m_map->get_byte_size() ) : maxValues;
+		const unsigned int grownCapacity = std::min( m_capacity > maxValues / 2 ? maxValues : 2 * m_capacity, maxCapacity );
+
+		grow_sections( std::max( m_numValues + numValues, grownCapacity ) );
+	}
+
+	m_numValues += numValues;
+	mark_all_dirty();
+}
+
+void hybrid_attr_buffer::move_values( const unsigned int destValue, const unsigned int sourceValue, const unsigned int numValues ) {
+	const std::vector<unsigned int>& strides = m_map->get_section_strides();
+
+	for( unsigned int i = 0; i < strides.size(); ++i ) {
+		const std::size_t sectionStart = get_section_start( i );
+
+		memmove( &m_data[sectionStart + destValue * strides[i]], &m_data[sectionStart + sourceValue * strides[i]], numValues * strides[i] );
+	}
+}
+
+void hybrid_attr_buffer::truncate_values( const unsigned int numValues ) {
+	m_numValues = numValues;
+}
+
+void hybrid_attr_buffer::permute_values( const std::vector<unsigned int>& remap ) {
+	const std::vector<unsigned int>& strides = m_map->get_section_strides();
+	std::vector<char> section;
+
+	for( unsigned int i = 0; i < strides.size(); ++i ) {
+		char* sectionStart = &m_data[get_section_start( i )];
+
+		section.assign( sectionStart, sectionStart + m_numValues * strides[i] );
+
+		for( unsigned int value = 0; value < remap.size(); ++value ) {
+			memcpy( sectionStart + remap[value] * strides[i], &section[value * strides[i]], strides[i] );
+		}
+	}
+}
+
+// Private Member Functions
+
+void hybrid_attr_buffer::grow_sections( const unsigned int newCapacity ) {
+	const std::vector<unsigned int>& strides = m_map->get_section_strides();
+	boost::uint64_t newSize = 0;
+	unsigned int i = 0;
+
+	for( i = 0; i < strides.size(); ++i ) {
+		newSize += static_cast<boost::uint64_t>( newCapacity ) * strides[i];
+
+		// The offsets of the attributes are unsigned ints, so every section has to end within their range
+		if( newSize > std::numeric_limits<unsigned int>::max() ) {
+			throw std::runtime_error( "hybrid_attr_buffer.grow_sections: Failed to grow buffer to " + boost::lexical_cast<std::string>( newCapacity )
+				+ " values because section(" + boost::lexical_cast<std::string>( i ) + ") would end past the largest offset a buffer can hold." );
+		}
+	}
+
+	// The offsets are only computed once the sections are known to fit, since the map adds them up as unsigned ints
+	const std::vector<unsigned int> newOffsets = m_map->get_block_offsets( newCapacity );
+
+	m_data.resize( static_cast<std::size_t>( newSize ) );
+
+	// Move the sections starting with the last one, since a section's new location may overlap the old location of the one after it
+	for( i = static_cast<unsigned int>( strides.size() ); i > 0; --i ) {
+		const std::size_t oldStart = get_section_start( i - 1 ), newStart = newOffsets[i - 1];
+
+		if( m_numValues > 0 && newStart != oldStart )
+			memmove( &m_data[newStart], &m_data[oldStart], m_numValues * strides[i - 1] );
+	}
+
+	m_bufferPointers = newOffsets;
+	m_capacity = newCapacity;
+	mark_all_dirty();
+}
+
+const std::size_t hybrid_attr_buffer::get_section_start( const unsigned int section ) const {
+	// Section i starts with attribute i, whose offset within the section is 0
+	return m_bufferPointers[section];
+}
+
+} // end of buffers namespace
+} // end of occluded namespace
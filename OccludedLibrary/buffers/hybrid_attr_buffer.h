@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+
+#include "attribute_buffer.h"
+
+namespace occluded { namespace buffers {
+
+/**
+ * \class hybrid_attr_buffer
+ * \brief An attribute buffer subclass that stores the first attribute separately from the others.
+ *
+ * An attribute buffer for attribute maps with the hybrid layout. The first attribute is stored tightly packed in the first section and every
+ * other attribute is interleaved in the second section, so that a depth or shadow pass that only reads positions fetches a fraction of the
+ * bytes it would fetch from an interleaved buffer, while passes that read everything still fetch the other attributes of a value together.
+ *
+ * Like a segregated buffer, each section reserves room for a number of values equal to the capacity of the buffer and grows geometrically.
+ * Memory passed to insert_values holds the values of the first section followed by the values of the second section, so a single value is
+ * laid out the same way as in an interleaved buffer.
+ */
+class hybrid_attr_buffer:
+	public attribute_buffer
+{
+private:
+	unsigned int m_capacity;
+
+public:
+	/**
+	 * \brief Initializes the attribute buffer.
+	 *
+	 * \param map A reference to an attribute map.
+	 * \param allocator A reference to the storage allocator the values are stored in, which must outlive the buffer.
+	 *
+	 * Initializes the attribute buffer. Throws an exception if the map does not use the hybrid layout.
+	 */
+	hybrid_attr_buffer( const attributes::attribute_map& map, storage::storage_allocator& allocator = storage::storage_allocator::get_default_allocator() );
+	~hybrid_attr_buffer();
+
+	/**
+	 * \fn reserve
+	 * \brief Reserves room in each section for a number of values.
+	 *
+	 * \param numValues An unsigned int representing the number of values each section should be able to hold.
+	 *
+	 * Grows the sections of the buffer so that each of them can hold numValues values. Nothing is done if the capacity is already large enough.
+	 */
+	void reserve( const unsigned int numValues );
+
+	/**
+	 * \fn clear_buffer
+	 * \brief Removes all the values from the buffer.
+	 *
+	 * Removes all the values from the buffer and resets its capacity.
+	 */
+	void clear_buffer();
+
+	/**
+	 * \fn get_capacity
+	 * \brief Gets the number of values each section can hold.
+	 *
+	 * \return An unsigned int representing the number of values the buffer can hold before its sections are moved.
+	 */
+	const unsigned int get_capacity() const;
+
+protected:
+	/**
+	 * \fn overwrite_values
+	 * \brief Overwrites values that are already in the attribute buffer.
+	 *
+	 * \param firstValue An unsigned int representing the index of the first value to be overwritten.
+	 * \param numValues An unsigned int representing the number of values to be overwritten.
+	 * \param values A pointer to the memory containing the new values.
+	 * \param firstSource An unsigned int representing the index of the first value in values to be copied.
+	 * \param numSource An unsigned int representing the total number of values that values points to.
+	 *
+	 * Copies the values of each section with a single copy, marking one dirty range per section.
+	 */
+	void overwrite_values( const unsigned int firstValue, const unsigned int numValues, const char* values, const unsigned int firstSource,
+		const unsigned int numSource );
+
+	/**
+	 * \fn append_values
+	 * \brief Adds values to the end of the attribute buffer.
+	 *
+	 * \param numValues An unsigned int representing the number of values to be added.
+	 *
+	 * Adds the values to the end of every section. The sections are only moved if the capacity of the buffer needs to grow.
+	 */
+	void append_values( const unsigned int numValues );
+
+	/**
+	 * \fn move_values
+	 * \brief Moves values towards the start of the attribute buffer.
+	 *
+	 * \param destValue An unsigned int representing the index the first value is moved to.
+	 * \param sourceValue An unsigned int representing the index of the first value to be moved.
+	 * \param numValues An unsigned int representing the number of values to be moved.
+	 */
+	void move_values( const unsigned int destValue, const unsigned int sourceValue, const unsigned int numValues );
+
+	/**
+	 * \fn truncate_values
+	 * \brief Removes values from the end of the attribute buffer.
+	 *
+	 * \param numValues An unsigned int representing the number of values the buffer should contain.
+	 */
+	void truncate_values( const unsigned int numValues );
+
+	/**
+	 * \fn permute_values
+	 * \brief Moves every value in the attribute buffer to a new index.
+	 *
+	 * \param remap A reference to a vector containing the new index of every value, indexed by its old index.
+	 *
+	 * Permutes each section separately, so only a copy of the largest section is needed.
+	 */
+	void permute_values( const std::vector<unsigned int>& remap );
+
+private:
+	/**
+	 * \fn grow_sections
+	 * \brief Moves the sections of the buffer so each can hold a new number of values.
+	 *
+	 * \param newCapacity An unsigned int representing the number of values each section should be able to hold.
+	 *
+	 * Resizes the storage of the buffer and moves the second section to its new offset, then updates the offset of every attribute.
+	 */
+	void grow_sections( const unsigned int newCapacity );
+
+	/**
+	 * \fn get_section_start
+	 * \brief Gets the offset, in bytes, of the first value of a section in the storage of the buffer.
+	 */
+	const std::size_t get_section_start( const unsigned int section ) const;
+};
+
+} // end of buffers namespace
+} // end of occluded namespace
@@ -1,9 +1,11 @@
 #include "interleaved_attr_buffer.h"
+#include "segregated_attr_buffer.h"
+#include "attribute_transcoder.h"
 
 namespace occluded { namespace buffers {
 
-interleaved_attr_buffer::interleaved_attr_buffer( const attributes::attribute_map& map ):
-	attribute_buffer( map )
+interleaved_attr_buffer::interleaved_attr_buffer( const attributes::attribute_map& map, storage::storage_allocator& allocator ):
+	attribute_buffer( map, allocator )
 {
 	if( !map.is_interleaved() ) {
 		throw std::runtime_error( "interleaved_attr_buffer: Failed to initialize interleaved attribute buffer because attribute map passed to constructor"
@@ -11,44 +13,65 @@ interleaved_attr_buffer::interleaved_attr_buffer( const attributes::attribute_ma
 	}
 }
 
+interleaved_attr_buffer::interleaved_attr_buffer( const segregated_attr_buffer& source ):
+	attribute_buffer( attribute_transcoder::create_transcoded_map( source.get_attribute_map() ), source.get_storage_allocator() )
+{
+	if( source.get_num_values() > 0 ) {
+		m_data.resize( source.get_num_values() * m_map->get_byte_size() );
+		attribute_transcoder::interleave( *m_map, source.get_data(), source.get_attribute_data_offsets(), source.get_num_values(), &m_data[0] );
+
+		m_bufferPointers = m_map->get_attribute_offsets();
+		m_pointersSet = true;
+		m_numValues = source.get_num_values();
+		m_freeRanges = source.get_free_ranges();
+		m_numFreeValues = source.get_num_free_values();
+	}
+}
 
 interleaved_attr_buffer::~interleaved_attr_buffer()
 {
 }
 
-void interleaved_attr_buffer::insert_values( const std::vector<char>& values ) {
-	unsigned int currIndex = 0, currOffset = 0;
-	std::vector<char> newData;
-	std::size_t startIndex = m_data.size();
-	
-	if( m_map.get_byte_size() == 0 ) {
-		throw std::runtime_error( "interleaved_attr_buffer.insert_values: Failed to insert values because the attribute map contained no attributes.");
-	}
+// Protected Member Functions
 
-	if( values.size() == 0 ) {
-		throw std::runtime_error( "interleaved_attr_buffer.insert_values: Failed to insert values because an empty vector was passed to function.");
-	}
+void interleaved_attr_buffer::overwrite_values( const unsigned int firstValue, const unsigned int numValues, const char* values,
+	const unsigned int firstSource, const unsigned int numSource ) {
+	const std::size_t offset = firstValue * m_map->get_byte_size(), size = numValues * m_map->get_byte_size();
+
+	memcpy( &m_data[offset], &values[firstSource * m_map->get_byte_size()], size );
+	mark_dirty( offset, size );
+}
 
-	if( values.size() % m_map.get_byte_size() != 0 ) {
-		throw std::runtime_error( "attribute_buffer.insert_values: Failed to insert values because the size of values vector(" + 
-			boost::lexical_cast<std::string>( values.size() ) + ") is not a valid size." ); 
+void interleaved_attr_buffer::append_values( const unsigned int numValues ) {
+	m_data.resize( ( m_numValues + numValues ) * m_map->get_byte_size() );
+
+	if( !m_pointersSet ) {
+		m_bufferPointers = m_map->get_attribute_offsets();
+		m_pointersSet = true;
 	}
 
-	m_data.resize( m_data.size() + values.size() );
+	m_numValues += numValues;
+	mark_all_dirty();
+}
 
-	memcpy( &m_data[startIndex], &values[0], values.size() * sizeof( char ) );
+void interleaved_attr_buffer::move_values( const unsigned int destValue, const unsigned int sourceValue, const unsigned int numValues ) {
+	memmove( &m_data[destValue * m_map->get_byte_size()], &m_data[sourceValue * m_map->get_byte_size()], numValues * m_map->get_byte_size() );
+}
 
-	if( !m_pointersSet ) {
-		for( std::vector<attributes::attribute>::const_iterator it = m_map.get_attributes().begin(); it != m_map.get_attributes().end(); ++it ) {
-			m_bufferPointers[currIndex] = currOffset;
-			currOffset += static_cast<unsigned int>( it->get_attrib_size() );
-			++currIndex;
-		}
+void interleaved_attr_buffer::truncate_values( const unsigned int numValues ) {
+	m_data.resize( numValues * m_map->get_byte_size() );
+	m_numValues = numValues;
+}
 
-		m_pointersSet = true;
+void interleaved_attr_buffer::permute_values( const std::vector<unsigned int>& remap ) {
+	const std::size_t stride = m_map->get_byte_size();
+	data_vector permuted( m_data.size(), 0, m_data.get_allocator() );
+
+	for( unsigned int i = 0; i < remap.size(); ++i ) {
+		memcpy( &permuted[remap[i] * stride], &m_data[i * stride], stride );
 	}
 
-	m_numValues += static_cast<unsigned int>( values.size() / m_map.get_byte_size() );
+	m_data.swap( permuted );
 }
 
 } // end of buffers namespace
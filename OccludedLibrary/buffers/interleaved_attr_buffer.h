@@ -4,6 +4,8 @@
 
 namespace occluded { namespace buffers {
 
+class segregated_attr_buffer;
+
 /**
  * \class interleaved_attr_buffer
  * \brief An attribute buffer subclass with interleaved data.
@@ -19,22 +21,77 @@ public:
 	 * \brief Initializes the attribute buffer.
 	 *
 	 * \param map A reference to an attribute map
+	 * \param allocator A reference to the storage allocator the values are stored in, which must outlive the buffer.
 	 *
 	 * Initializes the attribute buffer. Throws an exception if map is not an interleaved attribute map.
 	 */
-	interleaved_attr_buffer( const attributes::attribute_map& map );
+	interleaved_attr_buffer( const attributes::attribute_map& map, storage::storage_allocator& allocator = storage::storage_allocator::get_default_allocator() );
+
+	/**
+	 * \brief Initializes the attribute buffer with the values of a segregated buffer.
+	 *
+	 * \param source A reference to the segregated attribute buffer whose values are copied.
+	 *
+	 * Initializes the attribute buffer with an interleaved copy of the source's attribute map and interleaves the source's values into it.
+	 * The values are stored in memory from the source's storage allocator.
+	 */
+	explicit interleaved_attr_buffer( const segregated_attr_buffer& source );
 	~interleaved_attr_buffer();
 
+protected:
+	/**
+	 * \fn overwrite_values
+	 * \brief Overwrites values that are already in the attribute buffer.
+	 *
+	 * \param firstValue An unsigned int representing the index of the first value to be overwritten.
+	 * \param numValues An unsigned int representing the number of values to be overwritten.
+	 * \param values A pointer to the memory containing the new values.
+	 * \param firstSource An unsigned int representing the index of the first value in values to be copied.
+	 * \param numSource An unsigned int representing the total number of values that values points to.
+	 *
+	 * Since the attribute values are interleaved and the memory passed as a parameter has interleaved values, the values are overwritten
+	 * with a single copy and marked as a single dirty range.
+	 */
+	void overwrite_values( const unsigned int firstValue, const unsigned int numValues, const char* values, const unsigned int firstSource,
+		const unsigned int numSource );
+
+	/**
+	 * \fn append_values
+	 * \brief Adds values to the end of the attribute buffer.
+	 *
+	 * \param numValues An unsigned int representing the number of values to be added.
+	 *
+	 * Resizes the storage, which lets the vector grow geometrically.
+	 */
+	void append_values( const unsigned int numValues );
+
+	/**
+	 * \fn move_values
+	 * \brief Moves values towards the start of the attribute buffer.
+	 *
+	 * \param destValue An unsigned int representing the index the first value is moved to.
+	 * \param sourceValue An unsigned int representing the index of the first value to be moved.
+	 * \param numValues An unsigned int representing the number of values to be moved.
+	 */
+	void move_values( const unsigned int destValue, const unsigned int sourceValue, const unsigned int numValues );
+
+	/**
+	 * \fn truncate_values
+	 * \brief Removes values from the end of the attribute buffer.
+	 *
+	 * \param numValues An unsigned int representing the number of values the buffer should contain.
+	 */
+	void truncate_values( const unsigned int numValues );
+
 	/**
-	 * \fn insert_values
-	 * \brief Inserts values into the attribute buffer.
+	 * \fn permute_values
+	 * \brief Moves every value in the attribute buffer to a new index.
 	 *
-	 * \param values A reference to a vector of characters representing the values to be inserted.
+	 * \param remap A reference to a vector containing the new index of every value, indexed by its old index.
 	 *
-	 * Inserts a value into the attribute buffer. Since the attribute values are interleaved and the vector passed as a parameter
-	 * has interleaved values, the values can be placed as the end of the buffer.
+	 * Copies each value into its new place in a new copy of the storage, which then replaces the old storage.
 	 */
-	void insert_values( const std::vector<char>& values );
+	void permute_values( const std::vector<unsigned int>& remap );
 };
 
 } // end of buffers namespace
@@ -0,0 +1,155 @@
+#include "mapped_attr_buffer.h"
+
+#include <fstream>
+#include <limits>
+
+namespace occluded { namespace buffers {
+
+const std::size_t mapped_attr_buffer::DIRECT_ALIGNMENT = 4;
+
+mapped_attr_buffer::mapped_attr_buffer( const attributes::attribute_map& map, const std::string& filePath, storage::storage_allocator& allocator ):
+	attribute_buffer( map, allocator ),
+	m_mappedData( NULL ),
+	m_mappedSize( 0 )
+{
+	std::ifstream fileStream( filePath.c_str(), std::ios::in | std::ios::binary );
+
+	if( !fileStream.is_open() ) {
+		throw std::runtime_error( "mapped_attr_buffer: Failed to map file(" + filePath + ") because there was an error opening the file." );
+	}
+
+	const attribute_buffer_header header = attribute_buffer_header::read( fileStream );
+	fileStream.close();
+
+	if( header.is_compressed() ) {
+		throw std::runtime_error( "mapped_attr_buffer: Failed to map file(" + filePath + ") because its sections are compressed, so it has to be loaded"
+			+ std::string( " with attribute_buffer_serializer." ) );
+	}
+
+	if( header.get_attribute_map() != *m_map ) {
+		throw std::runtime_error( "mapped_attr_buffer: Failed to map file(" + filePath + ") because the attribute map in its header does not match the"
+			+ std::string( " attribute map passed to constructor." ) );
+	}
+
+	const std::vector<boost::uint64_t>& sectionOffsets = header.get_section_offsets();
+
+	// The offsets of the attributes are unsigned ints, so every section has to end within their range from the start of the data
+	for( unsigned int i = 0; i < sectionOffsets.size(); ++i ) {
+		if( sectionOffsets[i] + header.get_section_size( i ) - header.get_data_offset() > std::numeric_limits<unsigned int>::max() ) {
+			throw std::runtime_error( "mapped_attr_buffer: Failed to map file(" + filePath + ") because section(" + boost::lexical_cast<std::string>( i )
+				+ ") ends past the largest offset a buffer can hold." );
+		}
+	}
+
+	m_file.reset( new utilities::files::mapped_file( filePath ) );
+
+	if( m_file->get_size() < header.get_file_size() ) {
+		throw std::runtime_error( "mapped_attr_buffer: Failed to map file(" + filePath + ") because the file is shorter than its header says." );
+	}
+
+	bool aligned = true;
+
+	// The mapping starts on a page boundary, so a section is aligned in memory if its offset in the file is aligned
+	for( std::vector<boost::uint64_t>::const_iterator it = sectionOffsets.begin(); it != sectionOffsets.end(); ++it ) {
+		aligned = aligned && *it % DIRECT_ALIGNMENT == 0;
+	}
+
+	m_numValues = header.get_num_values();
+
+	if( aligned ) {
+		m_mappedData = m_file->get_data() + header.get_data_offset();
+		m_mappedSize = static_cast<std::size_t>( header.get_file_size() - header.get_data_offset() );
+
+		for( unsigned int i = 0; i < m_map->get_attrib_count(); ++i ) {
+			m_bufferPointers[i] = static_cast<unsigned int>( sectionOffsets[m_map->get_attribute_sections()[i]] - header.get_data_offset() )
+				+ m_map->get_section_offsets()[i];
+		}
+	} else {
+		copy_sections( header );
+		m_file.reset();
+	}
+
+	m_pointersSet = m_numValues > 0;
+}
+
+mapped_attr_buffer::~mapped_attr_buffer()
+{
+}
+
+void mapped_attr_buffer::reserve( const unsigned int numValues ) {
+}
+
+void mapped_attr_buffer::clear_buffer() {
+	throw std::runtime_error( "mapped_attr_buffer.clear_buffer: Failed to clear buffer because the buffer is read-only." );
+}
+
+void mapped_attr_buffer::erase_values( const unsigned int firstValue, const unsigned int numValues ) {
+	throw std::runtime_error( "mapped_attr_buffer.erase_values: Failed to erase values because the buffer is read-only." );
+}
+
+const std::size_t mapped_attr_buffer::get_byte_size() const {
+	return m_mappedData != NULL ? m_mappedSize : attribute_buffer::get_byte_size();
+}
+
+const unsigned int mapped_attr_buffer::get_capacity() const {
+	return m_numValues;
+}
+
+const char* mapped_attr_buffer::get_data() const {
+	return m_mappedData != NULL ? m_mappedData : attribute_buffer::get_data();
+}
+
+const bool mapped_attr_buffer::is_mapped() const {
+	return m_mappedData != NULL;
+}
+
+// Protected Member Functions
+
+void mapped_attr_buffer::overwrite_values( const unsigned int firstValue, const unsigned int numValues, const char* values, const unsigned int firstSource,
+	const unsigned int numSource )
+{
+	throw std::runtime_error( "mapped_attr_buffer.overwrite_values: Failed to write values because the buffer is read-only." );
+}
+
+void mapped_attr_buffer::append_values( const unsigned int numValues ) {
+	throw std::runtime_error( "mapped_attr_buffer.append_values: Failed to add values because the buffer is read-only." );
+}
+
+void mapped_attr_buffer::move_values( const unsigned int destValue, const unsigned int sourceValue, const unsigned int numValues ) {
+	throw std::runtime_error( "mapped_attr_buffer.move_values: Failed to move values because the buffer is read-only." );
+}
+
+void mapped_attr_buffer::truncate_values( const unsigned int numValues ) {
+	throw std::runtime_error( "mapped_attr_buffer.truncate_values: Failed to remove values because the buffer is read-only." );
+}
+
+void mapped_attr_buffer::permute_values( const std::vector<unsigned int>& remap ) {
+	throw std::runtime_error( "mapped_attr_buffer.permute_values: Failed to reorder values because the buffer is read-only." );
+}
+
+// Private Member Functions
+
+void mapped_attr_buffer::copy_sections( const attribute_buffer_header& header ) {
+	const std::vector<boost::uint64_t>& sectionOffsets = header.get_section_offsets();
+	std::vector<std::size_t> destOffsets( sectionOffsets.size() );
+	std::size_t currOffset = 0;
+
+	for( unsigned int i = 0; i < sectionOffsets.size(); ++i ) {
+		destOffsets[i] = ( currOffset + DIRECT_ALIGNMENT - 1 ) & ~( DIRECT_ALIGNMENT - 1 );
+		currOffset = destOffsets[i] + static_cast<std::size_t>( header.get_section_size( i ) );
+	}
+
+	m_data.resize( currOffset );
+
+	for( unsigned int i = 0; i < sectionOffsets.size(); ++i ) {
+		if( header.get_section_size( i ) > 0 )
+			memcpy( &m_data[destOffsets[i]], m_file->get_data() + sectionOffsets[i], static_cast<std::size_t>( header.get_section_size( i ) ) );
+	}
+
+	for( unsigned int i = 0; i < m_map->get_attrib_count(); ++i ) {
+		m_bufferPointers[i] = static_cast<unsigned int>( destOffsets[m_map->get_attribute_sections()[i]] ) + m_map->get_section_offsets()[i];
+	}
+}
+
+} // end of buffers namespace
+} // end of occluded namespace
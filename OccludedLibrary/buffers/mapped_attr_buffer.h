@@ -0,0 +1,142 @@
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+
+#include "attribute_buffer.h"
+#include "attribute_buffer_header.h"
+#include "../utilities/files/mapped_file.h"
+
+namespace occluded { namespace buffers {
+
+/**
+ * \class mapped_attr_buffer
+ * \brief A read-only attribute buffer whose values are mapped from a file.
+ *
+ * An attribute buffer whose values are stored in a file described by an attribute_buffer_header. The file is mapped into memory and its data
+ * sections are used in place, so the values are read from the operating system's page cache when they are used instead of being read into
+ * the heap up front. This works for interleaved, segregated and hybrid maps, since the file stores the values exactly as the map lays them out.
+ *
+ * If a section in the file does not start on a multiple of DIRECT_ALIGNMENT, the values can not be read in place and are copied into memory
+ * from the storage allocator instead, with each section moved to an aligned offset. The buffer is read-only, so an exception is thrown if
+ * values are inserted, updated, erased or moved. Since the values are not stored in a vector when the file is used in place, get_data must be
+ * used to read them instead of get_all_data.
+ */
+class mapped_attr_buffer:
+	public attribute_buffer
+{
+private:
+	boost::shared_ptr<utilities::files::mapped_file> m_file;
+	const char* m_mappedData;
+	std::size_t m_mappedSize;
+
+public:
+	/**
+	 * The alignment in bytes every section must have to be used in place.
+	 */
+	static const std::size_t DIRECT_ALIGNMENT;
+
+	/**
+	 * \brief Initializes the attribute buffer with the values in a file.
+	 *
+	 * \param map A reference to the attribute map the values in the file are expected to have.
+	 * \param filePath A reference to a string representing the file path of the file.
+	 * \param allocator A reference to the storage allocator the values are copied into if they can not be used in place.
+	 *
+	 * Reads the header of the file and maps the file into memory. An exception is thrown if the file can not be opened, if its header is not
+	 * valid or says the file is compressed, if the attribute map in its header does not match map, or if the file is shorter than its header
+	 * says.
+	 */
+	mapped_attr_buffer( const attributes::attribute_map& map, const std::string& filePath,
+		storage::storage_allocator& allocator = storage::storage_allocator::get_default_allocator() );
+	~mapped_attr_buffer();
+
+	/**
+	 * \fn reserve
+	 * \brief Does nothing, since values can not be added to the buffer.
+	 */
+	void reserve( const unsigned int numValues );
+
+	/**
+	 * \fn clear_buffer
+	 * \brief Throws an exception, since values can not be removed from the buffer.
+	 */
+	void clear_buffer();
+
+	/**
+	 * \fn erase_values
+	 * \brief Throws an exception, since values can not be removed from the buffer.
+	 */
+	void erase_values( const unsigned int firstValue, const unsigned int numValues );
+
+	/**
+	 * \fn get_byte_size
+	 * \brief Gets the size in bytes of the values.
+	 *
+	 * \return A std::size_t representing the number of bytes from the start of the first section to the end of the last section.
+	 */
+	const std::size_t get_byte_size() const;
+
+	/**
+	 * \fn get_capacity
+	 * \brief Gets the number of values in the buffer, since the buffer can not hold any more values.
+	 */
+	const unsigned int get_capacity() const;
+
+	/**
+	 * \fn get_data
+	 * \brief Gets a pointer to the values.
+	 *
+	 * \return A pointer into the mapped file if the values are used in place, otherwise a pointer to the copy of the values.
+	 */
+	const char* get_data() const;
+
+	/**
+	 * \fn is_mapped
+	 * \brief Gets whether the values are used in place.
+	 *
+	 * \return Returns true if the values are read from the mapped file, or false if they were copied into memory.
+	 */
+	const bool is_mapped() const;
+
+protected:
+	/**
+	 * \fn overwrite_values
+	 * \brief Throws an exception, since the values in the buffer can not be changed.
+	 */
+	void overwrite_values( const unsigned int firstValue, const unsigned int numValues, const char* values, const unsigned int firstSource,
+		const unsigned int numSource );
+
+	/**
+	 * \fn append_values
+	 * \brief Throws an exception, since values can not be added to the buffer.
+	 */
+	void append_values( const unsigned int numValues );
+
+	/**
+	 * \fn move_values
+	 * \brief Throws an exception, since the values in the buffer can not be changed.
+	 */
+	void move_values( const unsigned int destValue, const unsigned int sourceValue, const unsigned int numValues );
+
+	/**
+	 * \fn truncate_values
+	 * \brief Throws an exception, since values can not be removed from the buffer.
+	 */
+	void truncate_values( const unsigned int numValues );
+
+	/**
+	 * \fn permute_values
+	 * \brief Throws an exception, since the values in the buffer can not be changed.
+	 */
+	void permute_values( const std::vector<unsigned int>& remap );
+
+private:
+	/**
+	 * \fn copy_sections
+	 * \brief Copies the sections of the file into memory, moving each section to an aligned offset.
+	 */
+	void copy_sections( const attribute_buffer_header& header );
+};
+
+} // end of buffers namespace
+} // end of occluded namespace
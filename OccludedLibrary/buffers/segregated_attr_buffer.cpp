@@ -1,62 +1,154 @@
 #include "segregated_attr_buffer.h"
+#include "interleaved_attr_buffer.h"
+#include "attribute_transcoder.h"
+
+#include <limits>
 
 namespace occluded { namespace buffers {
 
-segregated_attr_buffer::segregated_attr_buffer( const attributes::attribute_map& map ):
-	attribute_buffer( map )
+segregated_attr_buffer::segregated_attr_buffer( const attributes::attribute_map& map, storage::storage_allocator& allocator ):
+	attribute_buffer( map, allocator ),
+	m_capacity( 0 )
 {
-	if( map.is_interleaved() ) {
-		throw std::runtime_error( "segregated_attr_buffer: Failed to initialize interleaved attribute buffer because attribute map passed to constructor"
-			+ std::string( " was interleaved." ) );
+	if( map.get_layout() != attributes::layout_segregated ) {
+		throw std::runtime_error( "segregated_attr_buffer: Failed to initialize segregated attribute buffer because attribute map passed to constructor"
+			+ std::string( " was not segregated." ) );
 	}
 }
 
+segregated_attr_buffer::segregated_attr_buffer( const interleaved_attr_buffer& source ):
+	attribute_buffer( attribute_transcoder::create_transcoded_map( source.get_attribute_map() ), source.get_storage_allocator() ),
+	m_capacity( 0 )
+{
+	if( source.get_num_values() > 0 ) {
+		grow_sections( source.get_num_values() );
+		attribute_transcoder::deinterleave( *m_map, source.get_data(), source.get_num_values(), &m_data[0], m_bufferPointers );
+
+		m_numValues = source.get_num_values();
+		m_freeRanges = source.get_free_ranges();
+		m_numFreeValues = source.get_num_free_values();
+	}
+}
 
 segregated_attr_buffer::~segregated_attr_buffer()
 {
 }
 
-void segregated_attr_buffer::insert_values( const std::vector<char>& values ) {
-	unsigned int numVals;
-	std::vector<char> newData;
-	unsigned int newOffset = 0, dataOffset = 0, valuesOffset = 0, currBuffOffsetIndex = 0;
+void segregated_attr_buffer::reserve( const unsigned int numValues ) {
+	if( numValues > m_capacity && m_map->get_byte_size() > 0 )
+		grow_sections( numValues );
+}
+
+void segregated_attr_buffer::clear_buffer() {
+	attribute_buffer::clear_buffer();
 
-	if( m_map.get_byte_size() == 0 ) {
-		throw std::runtime_error( "attribute_buffer.insert_values: Failed to insert values because the attribute map contained no attributes.");
+	m_capacity = 0;
+}
+
+const unsigned int segregated_attr_buffer::get_capacity() const {
+	return m_capacity;
+}
+
+// Protected Member Functions
+
+void segregated_attr_buffer::overwrite_values( const unsigned int firstValue, const unsigned int numValues, const char* values,
+	const unsigned int firstSource, const unsigned int numSource ) {
+	const std::vector<const attributes::attribute>& attributes = m_map->get_attributes();
+	std::size_t valuesOffset = 0;
+
+	for( unsigned int i = 0; i < attributes.size(); ++i ) {
+		const std::size_t attribSize = attributes[i].get_attrib_size();
+		const std::size_t offset = m_bufferPointers[i] + firstValue * attribSize;
+
+		// The source holds all the values of one attribute before the values of the next
+		memcpy( &m_data[offset], &values[valuesOffset + firstSource * attribSize], numValues * attribSize );
+		mark_dirty( offset, numValues * attribSize );
+		valuesOffset += numSource * attribSize;
 	}
+}
 
-	if( values.size() == 0 ) {
-		throw std::runtime_error( "interleaved_attr_buffer.insert_values: Failed to insert values because an empty vector was passed to function.");
+void segregated_attr_buffer::append_values( const unsigned int numValues ) {
+	const unsigned int maxValues = std::numeric_limits<unsigned int>::max();
+
+	if( numValues > maxValues - m_numValues ) {
+		throw std::runtime_error( "segregated_attr_buffer.append_values: Failed to append " + boost::lexical_cast<std::string>( numValues )
+			+ " values because the buffer would hold more values than can be counted." );
 	}
 
-	if( values.size() % m_map.get_byte_size() != 0 ) {
-		throw std::runtime_error( "attribute_buffer.insert_values: Failed to insert values because the size of values vector(" + 
-			boost::lexical_cast<std::string>( values.size() ) + ") is not a valid size." ); 
+	// Grow geometrically so that repeatedly appending values only moves the sections a logarithmic number of times, but never past the
+	// capacity whose sections still fit in the offset range, so that growing only fails when the values themselves do not fit
+	if( m_numValues + numValues > m_capacity ) {
+		const unsigned int maxCapacity = m_map->get_byte_size() > 0 ? static_cast<unsigned int>( maxValues / m_map->get_byte_size() ) : maxValues;
+		const unsigned int grownCapacity = std::min( m_capacity > maxValues / 2 ? maxValues : 2 * m_capacity, maxCapacity );
+
+		grow_sections( std::max( m_numValues + numValues, grownCapacity ) );
 	}
 
-	numVals = static_cast<unsigned int>( values.size() / m_map.get_byte_size() );
+	m_numValues += numValues;
+	mark_all_dirty();
+}
 
-	newData.resize( m_data.size() + values.size() );
+void segregated_attr_buffer::move_values( const unsigned int destValue, const unsigned int sourceValue, const unsigned int numValues ) {
+	const std::vector<const attributes::attribute>& attributes = m_map->get_attributes();
 
-	for( std::vector<const attributes::attribute>::const_iterator it = m_map.get_attributes().begin(); it != m_map.get_attributes().end(); ++it ) {
-		m_bufferPointers[currBuffOffsetIndex] = newOffset;
+	for( unsigned int i = 0; i < attributes.size(); ++i ) {
+		const std::size_t attribSize = attributes[i].get_attrib_size();
 
-		//copy the data currently in the buffer
-		if( m_numValues > 0 ) {
-			memcpy( &newData[newOffset], &m_data[dataOffset], m_numValues * it->get_attrib_size() );
-			newOffset += m_numValues * static_cast<unsigned int>( it->get_attrib_size() );
-			dataOffset += m_numValues * static_cast<unsigned int>( it->get_attrib_size() );
+		memmove( &m_data[m_bufferPointers[i] + destValue * attribSize], &m_data[m_bufferPointers[i] + sourceValue * attribSize], numValues * attribSize );
+	}
+}
+
+void segregated_attr_buffer::truncate_values( const unsigned int numValues ) {
+	m_numValues = numValues;
+}
+
+void segregated_attr_buffer::permute_values( const std::vector<unsigned int>& remap ) {
+	const std::vector<const attributes::attribute>& attributes = m_map->get_attributes();
+	std::vector<char> section;
+
+	for( unsigned int i = 0; i < attributes.size(); ++i ) {
+		const std::size_t attribSize = attributes[i].get_attrib_size();
+		char* sectionStart = &m_data[m_bufferPointers[i]];
+
+		section.assign( sectionStart, sectionStart + m_numValues * attribSize );
+
+		for( unsigned int value = 0; value < remap.size(); ++value ) {
+			memcpy( sectionStart + remap[value] * attribSize, &section[value * attribSize], attribSize );
+		}
+	}
+}
+
+// Private Member Functions
+
+void segregated_attr_buffer::grow_sections( const unsigned int newCapacity ) {
+	const std::vector<const attributes::attribute>& attributes = m_map->get_attributes();
+	std::vector<unsigned int> newOffsets( attributes.size() );
+	boost::uint64_t currOffset = 0;
+	unsigned int i = 0;
+
+	for( i = 0; i < attributes.size(); ++i ) {
+		newOffsets[i] = static_cast<unsigned int>( currOffset );
+		currOffset += static_cast<boost::uint64_t>( newCapacity ) * attributes[i].get_attrib_size();
+
+		// The offsets of the sections are unsigned ints, so every section has to end within their range
+		if( currOffset > std::numeric_limits<unsigned int>::max() ) {
+			throw std::runtime_error( "segregated_attr_buffer.grow_sections: Failed to grow buffer to " + boost::lexical_cast<std::string>( newCapacity )
+				+ " values because section(" + boost::lexical_cast<std::string>( i ) + ") would end past the largest offset a buffer can hold." );
 		}
-		
-		//copy the new data into the buffer
-		memcpy( &newData[newOffset], &values[valuesOffset], numVals * it->get_attrib_size() );
-		newOffset += numVals * static_cast<unsigned int>( it->get_attrib_size() );
-		valuesOffset += numVals * static_cast<unsigned int>( it->get_attrib_size() );
-		++currBuffOffsetIndex;
 	}
 
-	m_numValues += numVals;
-	m_data = newData;
+	m_data.resize( static_cast<std::size_t>( currOffset ) );
+
+	// Move the sections starting with the last one, since a section's new location may overlap the old location of the one after it
+	for( i = static_cast<unsigned int>( attributes.size() ); i > 0; --i ) {
+		if( m_numValues > 0 && newOffsets[i - 1] != m_bufferPointers[i - 1] )
+			memmove( &m_data[newOffsets[i - 1]], &m_data[m_bufferPointers[i - 1]], m_numValues * attributes[i - 1].get_attrib_size() );
+
+		m_bufferPointers[i - 1] = newOffsets[i - 1];
+	}
+
+	m_capacity = newCapacity;
+	mark_all_dirty();
 }
 
 } // end of buffers namespace
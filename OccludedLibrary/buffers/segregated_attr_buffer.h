@@ -1,40 +1,147 @@
 #pragma once
 
+#include <algorithm>
+
 #include "attribute_buffer.h"
 
 namespace occluded { namespace buffers {
 
+class interleaved_attr_buffer;
+
 /**
  * \class segregated_attr_buffer
  * \brief An attribute buffer subclass with segregated data.
  *
  * An attribute buffer that stores values in segregated sections. The first value of the first attribute will be stored, then the second
- * value of the first attribute is stored and so on.
+ * value of the first attribute is stored and so on. Each attribute's section reserves room for a number of values equal to the capacity
+ * of the buffer, so values can be appended to every section without moving the other sections. When the capacity is exceeded it grows
+ * geometrically, which keeps inserting values amortized constant time.
  */
 class segregated_attr_buffer:
 	public attribute_buffer
 {
+private:
+	unsigned int m_capacity;
+
 public:
 	/**
 	 * \brief Initializes the attribute buffer.
 	 *
 	 * \param map A reference to an attribute map.
+	 * \param allocator A reference to the storage allocator the values are stored in, which must outlive the buffer.
 	 *
 	 * Initializes the attribute buffer. Throws an exception if the map is not a segregated map.
 	 */
-	segregated_attr_buffer( const attributes::attribute_map& map );
+	segregated_attr_buffer( const attributes::attribute_map& map, storage::storage_allocator& allocator = storage::storage_allocator::get_default_allocator() );
+
+	/**
+	 * \brief Initializes the attribute buffer with the values of an interleaved buffer.
+	 *
+	 * \param source A reference to the interleaved attribute buffer whose values are copied.
+	 *
+	 * Initializes the attribute buffer with a segregated copy of the source's attribute map and splits the source's values into its sections.
+	 * The capacity of the buffer is the number of values in the source.
+	 */
+	explicit segregated_attr_buffer( const interleaved_attr_buffer& source );
 	~segregated_attr_buffer();
 
 	/**
-	 * \fn insert_values
-	 * \brief Inserts values into the attribute buffer.
+	 * \fn reserve
+	 * \brief Reserves room in each section for a number of values.
+	 *
+	 * \param numValues An unsigned int representing the number of values each section should be able to hold.
+	 *
+	 * Grows the sections of the buffer so that each of them can hold numValues values. The offsets returned by get_attribute_data_offsets
+	 * will not change until more than numValues values are stored in the buffer. Nothing is done if the capacity is already large enough.
+	 */
+	void reserve( const unsigned int numValues );
+
+	/**
+	 * \fn clear_buffer
+	 * \brief Removes all the values from the buffer.
+	 *
+	 * Removes all the values from the buffer and resets its capacity.
+	 */
+	void clear_buffer();
+
+	/**
+	 * \fn get_capacity
+	 * \brief Gets the number of values each section can hold.
+	 *
+	 * \return An unsigned int representing the number of values the buffer can hold before its sections are moved.
+	 */
+	const unsigned int get_capacity() const;
+
+protected:
+	/**
+	 * \fn overwrite_values
+	 * \brief Overwrites values that are already in the attribute buffer.
+	 *
+	 * \param firstValue An unsigned int representing the index of the first value to be overwritten.
+	 * \param numValues An unsigned int representing the number of values to be overwritten.
+	 * \param values A pointer to the memory containing the new values.
+	 * \param firstSource An unsigned int representing the index of the first value in values to be copied.
+	 * \param numSource An unsigned int representing the total number of values that values points to.
+	 *
+	 * The values pointed to by the values parameter are split up and each value is copied into the correct section of the buffer, marking
+	 * one dirty range per section.
+	 */
+	void overwrite_values( const unsigned int firstValue, const unsigned int numValues, const char* values, const unsigned int firstSource,
+		const unsigned int numSource );
+
+	/**
+	 * \fn append_values
+	 * \brief Adds values to the end of the attribute buffer.
+	 *
+	 * \param numValues An unsigned int representing the number of values to be added.
+	 *
+	 * Adds the values to the end of every section. The sections are only moved if the capacity of the buffer needs to grow.
+	 */
+	void append_values( const unsigned int numValues );
+
+	/**
+	 * \fn move_values
+	 * \brief Moves values towards the start of the attribute buffer.
+	 *
+	 * \param destValue An unsigned int representing the index the first value is moved to.
+	 * \param sourceValue An unsigned int representing the index of the first value to be moved.
+	 * \param numValues An unsigned int representing the number of values to be moved.
+	 *
+	 * Moves the values within each section.
+	 */
+	void move_values( const unsigned int destValue, const unsigned int sourceValue, const unsigned int numValues );
+
+	/**
+	 * \fn truncate_values
+	 * \brief Removes values from the end of the attribute buffer.
+	 *
+	 * \param numValues An unsigned int representing the number of values the buffer should contain.
+	 *
+	 * The capacity of the buffer is left unchanged, so the sections are not moved.
+	 */
+	void truncate_values( const unsigned int numValues );
+
+	/**
+	 * \fn permute_values
+	 * \brief Moves every value in the attribute buffer to a new index.
+	 *
+	 * \param remap A reference to a vector containing the new index of every value, indexed by its old index.
+	 *
+	 * Permutes each section separately, so only a copy of the largest section is needed.
+	 */
+	void permute_values( const std::vector<unsigned int>& remap );
+
+private:
+	/**
+	 * \fn grow_sections
+	 * \brief Moves the sections of the buffer so each can hold a new number of values.
 	 *
-	 * \param values A reference to a vector of characters representing the values to be inserted.
+	 * \param newCapacity An unsigned int representing the number of values each section should be able to hold.
 	 *
-	 * Inserts a value into the attribute buffer. The values in the vector parameter will be split up and each value will be placed in the
-	 * correct section of the buffer.
+	 * Resizes the storage of the buffer and moves each section, starting with the last, to its new offset. Since sections only move towards
+	 * the end of the storage, they can be moved in place without a second copy of the data.
 	 */
-	void insert_values( const std::vector<char>& values );
+	void grow_sections( const unsigned int newCapacity );
 };
 
 } // end of buffers namespace
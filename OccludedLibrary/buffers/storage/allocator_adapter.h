@@ -0,0 +1,155 @@
+#pragma once
+
+#include <limits>
+
+#include "storage_allocator.h"
+
+namespace occluded { namespace buffers { namespace storage {
+
+/**
+ * \class allocator_adapter
+ * \brief A standard library allocator that allocates its memory from a storage allocator.
+ *
+ * Lets standard library containers store their elements in memory from a storage allocator. Copies of the adapter share the storage
+ * allocator, and two adapters compare equal when they use the same storage allocator.
+ */
+template<typename T>
+class allocator_adapter
+{
+private:
+	storage_allocator* m_allocator;
+
+	template<typename U>
+	friend class allocator_adapter;
+
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	template<typename U>
+	struct rebind {
+		typedef allocator_adapter<U> other;
+	};
+
+	/**
+	 * \brief Initializes the adapter with the default storage allocator.
+	 */
+	allocator_adapter();
+
+	/**
+	 * \brief Initializes the adapter.
+	 *
+	 * \param allocator A reference to the storage allocator the memory is allocated from, which must outlive the adapter and its copies.
+	 */
+	allocator_adapter( storage_allocator& allocator );
+
+	template<typename U>
+	allocator_adapter( const allocator_adapter<U>& other );
+
+	pointer address( reference value ) const;
+	const_pointer address( const_reference value ) const;
+
+	pointer allocate( const size_type count, const void* hint = 0 );
+	void deallocate( pointer memory, const size_type count );
+	size_type max_size() const;
+
+	void construct( pointer memory, const_reference value );
+	void destroy( pointer memory );
+
+	/**
+	 * \fn get_storage_allocator
+	 * \brief Gets the storage allocator the memory is allocated from.
+	 *
+	 * \return A reference to the storage allocator.
+	 */
+	storage_allocator& get_storage_allocator() const;
+
+	template<typename U>
+	bool operator==( const allocator_adapter<U>& other ) const;
+
+	template<typename U>
+	bool operator!=( const allocator_adapter<U>& other ) const;
+};
+
+template<typename T>
+allocator_adapter<T>::allocator_adapter():
+	m_allocator( &storage_allocator::get_default_allocator() )
+{
+}
+
+template<typename T>
+allocator_adapter<T>::allocator_adapter( storage_allocator& allocator ):
+	m_allocator( &allocator )
+{
+}
+
+template<typename T>
+template<typename U>
+allocator_adapter<T>::allocator_adapter( const allocator_adapter<U>& other ):
+	m_allocator( other.m_allocator )
+{
+}
+
+template<typename T>
+typename allocator_adapter<T>::pointer allocator_adapter<T>::address( reference value ) const {
+	return &value;
+}
+
+template<typename T>
+typename allocator_adapter<T>::const_pointer allocator_adapter<T>::address( const_reference value ) const {
+	return &value;
+}
+
+template<typename T>
+typename allocator_adapter<T>::pointer allocator_adapter<T>::allocate( const size_type count, const void* hint ) {
+	if( count > max_size() )
+		throw std::bad_alloc();
+
+	return static_cast<pointer>( m_allocator->allocate( count * sizeof( T ) ) );
+}
+
+template<typename T>
+void allocator_adapter<T>::deallocate( pointer memory, const size_type count ) {
+	m_allocator->deallocate( memory, count * sizeof( T ) );
+}
+
+template<typename T>
+typename allocator_adapter<T>::size_type allocator_adapter<T>::max_size() const {
+	return std::numeric_limits<size_type>::max() / sizeof( T );
+}
+
+template<typename T>
+void allocator_adapter<T>::construct( pointer memory, const_reference value ) {
+	new( static_cast<void*>( memory ) ) T( value );
+}
+
+template<typename T>
+void allocator_adapter<T>::destroy( pointer memory ) {
+	memory->~T();
+}
+
+template<typename T>
+storage_allocator& allocator_adapter<T>::get_storage_allocator() const {
+	return *m_allocator;
+}
+
+template<typename T>
+template<typename U>
+bool allocator_adapter<T>::operator==( const allocator_adapter<U>& other ) const {
+	return m_allocator == other.m_allocator;
+}
+
+template<typename T>
+template<typename U>
+bool allocator_adapter<T>::operator!=( const allocator_adapter<U>& other ) const {
+	return m_allocator != other.m_allocator;
+}
+
+} // end of storage namespace
+} // end of buffers namespace
+} // end of occluded namespace
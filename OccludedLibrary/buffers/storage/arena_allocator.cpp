@@ -0,0 +1,87 @@
+#include "arena_allocator.h"
+
+#include <stdexcept>
+
+namespace occluded { namespace buffers { namespace storage {
+
+const std::size_t arena_allocator::ALIGNMENT = 16;
+const std::size_t arena_allocator::DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+arena_allocator::arena_allocator( const std::size_t blockSize ):
+	m_currBlock( NULL ),
+	m_blockSize( align_size( blockSize ) ),
+	m_currOffset( 0 ),
+	m_bytesAllocated( 0 )
+{
+	if( blockSize == 0 )
+		throw std::runtime_error( "arena_allocator: Failed to create arena because the block size was 0." );
+}
+
+arena_allocator::~arena_allocator()
+{
+	reset();
+}
+
+void* arena_allocator::allocate( const std::size_t numBytes ) {
+	const std::size_t size = align_size( numBytes > 0 ? numBytes : 1 );
+
+	// Allocations that would fill most of a block get their own block, so the rest of the current block is not wasted
+	if( size > m_blockSize / 2 ) {
+		char* block = static_cast<char*>( ::operator new( size ) );
+
+		m_blocks.push_back( block );
+		m_bytesAllocated += size;
+
+		return block;
+	}
+
+	if( m_currBlock == NULL || m_blockSize - m_currOffset < size ) {
+		m_currBlock = static_cast<char*>( ::operator new( m_blockSize ) );
+		m_currOffset = 0;
+
+		m_blocks.push_back( m_currBlock );
+		m_bytesAllocated += m_blockSize;
+	}
+
+	void* memory = m_currBlock + m_currOffset;
+	m_currOffset += size;
+
+	return memory;
+}
+
+void arena_allocator::deallocate( void* memory, const std::size_t numBytes ) {
+	const std::size_t size = align_size( numBytes > 0 ? numBytes : 1 );
+
+	// Only the most recent allocation can be given back, since it is the only one that does not have memory allocated after it
+	if( m_currBlock != NULL && size <= m_currOffset && memory == m_currBlock + m_currOffset - size )
+		m_currOffset -= size;
+}
+
+void arena_allocator::reset() {
+	for( std::vector<char*>::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it ) {
+		::operator delete( *it );
+	}
+
+	m_blocks.clear();
+	m_currBlock = NULL;
+	m_currOffset = 0;
+	m_bytesAllocated = 0;
+}
+
+const std::size_t arena_allocator::get_bytes_allocated() const {
+	return m_bytesAllocated;
+}
+
+const std::size_t arena_allocator::get_num_blocks() const {
+	return m_blocks.size();
+}
+
+// Static Functions
+
+const std::size_t arena_allocator::align_size( const std::size_t numBytes ) {
+	return ( numBytes + ALIGNMENT - 1 ) & ~( ALIGNMENT - 1 );
+}
+
+} // end of storage namespace
+} // end of buffers namespace
+} // end of occluded namespace
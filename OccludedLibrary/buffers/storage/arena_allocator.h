@@ -0,0 +1,106 @@
+#pragma once
+
+#include <vector>
+
+#include "storage_allocator.h"
+
+namespace occluded { namespace buffers { namespace storage {
+
+/**
+ * \class arena_allocator
+ * \brief A storage allocator that hands out memory from large blocks by bumping an offset.
+ *
+ * Allocates memory by bumping an offset through large blocks, so many small buffers share a few heap allocations and end up next to each
+ * other in memory. Memory given back to the arena is only reused if it was the most recent allocation; everything else is freed at once when
+ * the arena is reset or destroyed. This suits buffers that share a lifetime, such as the meshes of a level, since they can all be freed by
+ * dropping the arena instead of freeing each buffer's memory separately.
+ *
+ * Buffers using the arena may still be destroyed after it is reset, since giving memory back does not touch the memory, but they must not
+ * be used again.
+ */
+class arena_allocator:
+	public storage_allocator
+{
+private:
+	std::vector<char*> m_blocks;
+	char* m_currBlock;
+	std::size_t m_blockSize;
+	std::size_t m_currOffset;
+	std::size_t m_bytesAllocated;
+
+	static const std::size_t ALIGNMENT;
+
+public:
+	/**
+	 * The block size used when none is passed to the constructor.
+	 */
+	static const std::size_t DEFAULT_BLOCK_SIZE;
+
+	/**
+	 * \brief Initializes the arena.
+	 *
+	 * \param blockSize A std::size_t representing the number of bytes in each block.
+	 *
+	 * Initializes an empty arena. No memory is allocated until the first call to allocate. Allocations larger than the block size get a block
+	 * of their own. An exception is thrown if blockSize is 0.
+	 */
+	arena_allocator( const std::size_t blockSize = DEFAULT_BLOCK_SIZE );
+	~arena_allocator();
+
+	/**
+	 * \fn allocate
+	 * \brief Allocates memory from the current block.
+	 *
+	 * \param numBytes A std::size_t representing the number of bytes to be allocated.
+	 * \return A pointer to the memory.
+	 *
+	 * Allocates the memory from the end of the current block, starting a new block if the current block does not have enough room left.
+	 */
+	void* allocate( const std::size_t numBytes );
+
+	/**
+	 * \fn deallocate
+	 * \brief Gives memory back to the arena.
+	 *
+	 * \param memory A pointer to memory returned by allocate.
+	 * \param numBytes A std::size_t representing the number of bytes that were passed to allocate.
+	 *
+	 * The memory is reused only if it is the most recent allocation from the current block. Otherwise it is kept until the arena is reset.
+	 */
+	void deallocate( void* memory, const std::size_t numBytes );
+
+	/**
+	 * \fn reset
+	 * \brief Frees all of the memory allocated by the arena.
+	 *
+	 * Frees every block at once. Any memory that was allocated from the arena must not be used afterwards.
+	 */
+	void reset();
+
+	/**
+	 * \fn get_bytes_allocated
+	 * \brief Gets the number of bytes in the blocks of the arena.
+	 *
+	 * \return A std::size_t representing the total size of the blocks allocated since the arena was created or last reset.
+	 */
+	const std::size_t get_bytes_allocated() const;
+
+	/**
+	 * \fn get_num_blocks
+	 * \brief Gets the number of blocks allocated by the arena.
+	 *
+	 * \return A std::size_t representing the number of blocks allocated since the arena was created or last reset.
+	 */
+	const std::size_t get_num_blocks() const;
+
+private:
+	/**
+	 * \fn align_size
+	 * \brief Rounds a number of bytes up to a multiple of the alignment of the arena's allocations.
+	 */
+	static const std::size_t align_size( const std::size_t numBytes );
+};
+
+} // end of storage namespace
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,23 @@
+#include "heap_allocator.h"
+
+namespace occluded { namespace buffers { namespace storage {
+
+heap_allocator::heap_allocator()
+{
+}
+
+heap_allocator::~heap_allocator()
+{
+}
+
+void* heap_allocator::allocate( const std::size_t numBytes ) {
+	return ::operator new( numBytes );
+}
+
+void heap_allocator::deallocate( void* memory, const std::size_t numBytes ) {
+	::operator delete( memory );
+}
+
+} // end of storage namespace
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "storage_allocator.h"
+
+namespace occluded { namespace buffers { namespace storage {
+
+/**
+ * \class heap_allocator
+ * \brief A storage allocator that allocates each block of memory separately from the heap.
+ *
+ * Allocates memory using the global operator new, which is how attribute buffers allocated their values before allocators could be chosen.
+ */
+class heap_allocator:
+	public storage_allocator
+{
+public:
+	heap_allocator();
+	~heap_allocator();
+
+	/**
+	 * \fn allocate
+	 * \brief Allocates memory from the heap.
+	 *
+	 * \param numBytes A std::size_t representing the number of bytes to be allocated.
+	 * \return A pointer to the memory.
+	 */
+	void* allocate( const std::size_t numBytes );
+
+	/**
+	 * \fn deallocate
+	 * \brief Frees memory allocated from the heap.
+	 *
+	 * \param memory A pointer to memory returned by allocate.
+	 * \param numBytes A std::size_t representing the number of bytes that were passed to allocate.
+	 */
+	void deallocate( void* memory, const std::size_t numBytes );
+};
+
+} // end of storage namespace
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,81 @@
+#include "huge_page_allocator.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace occluded { namespace buffers { namespace storage {
+
+const std::size_t huge_page_allocator::HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+huge_page_allocator::huge_page_allocator( const std::size_t threshold ):
+	m_threshold( threshold )
+{
+}
+
+huge_page_allocator::~huge_page_allocator()
+{
+}
+
+void* huge_page_allocator::allocate( const std::size_t numBytes ) {
+	if( !uses_huge_pages( numBytes ) )
+		return ::operator new( numBytes );
+
+	const std::size_t mappedSize = get_mapped_size( numBytes );
+
+#ifdef _WIN32
+	void* memory = NULL;
+	const SIZE_T largePageSize = GetLargePageMinimum();
+
+	// Large pages fail without the lock pages in memory privilege, in which case normal pages are used
+	if( largePageSize > 0 && mappedSize % largePageSize == 0 )
+		memory = VirtualAlloc( NULL, mappedSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE );
+
+	if( memory == NULL )
+		memory = VirtualAlloc( NULL, mappedSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+
+	if( memory == NULL )
+		throw std::bad_alloc();
+#else
+	void* memory = mmap( NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+
+	if( memory == MAP_FAILED )
+		throw std::bad_alloc();
+
+#ifdef MADV_HUGEPAGE
+	// Only a hint, the memory is still usable if the kernel does not have transparent huge pages enabled
+	madvise( memory, mappedSize, MADV_HUGEPAGE );
+#endif
+#endif
+
+	return memory;
+}
+
+void huge_page_allocator::deallocate( void* memory, const std::size_t numBytes ) {
+	if( !uses_huge_pages( numBytes ) ) {
+		::operator delete( memory );
+		return;
+	}
+
+#ifdef _WIN32
+	VirtualFree( memory, 0, MEM_RELEASE );
+#else
+	munmap( memory, get_mapped_size( numBytes ) );
+#endif
+}
+
+const bool huge_page_allocator::uses_huge_pages( const std::size_t numBytes ) const {
+	return numBytes > 0 && numBytes >= m_threshold;
+}
+
+// Static Functions
+
+const std::size_t huge_page_allocator::get_mapped_size( const std::size_t numBytes ) {
+	return ( numBytes + HUGE_PAGE_SIZE - 1 ) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+} // end of storage namespace
+} // end of buffers namespace
+} // end of occluded namespace
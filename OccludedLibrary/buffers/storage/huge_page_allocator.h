@@ -0,0 +1,74 @@
+#pragma once
+
+#include "storage_allocator.h"
+
+namespace occluded { namespace buffers { namespace storage {
+
+/**
+ * \class huge_page_allocator
+ * \brief A storage allocator that backs large buffers with huge pages.
+ *
+ * Allocates memory for large buffers directly from the operating system, rounded up to a multiple of the huge page size, and asks for it to
+ * be backed by huge pages. Processing a large buffer then touches far fewer pages, which reduces TLB misses. On Linux the memory is mapped
+ * with mmap and marked with madvise( MADV_HUGEPAGE ), so transparent huge pages are used when the kernel has them enabled. On Windows large
+ * pages are used when the process holds the lock pages in memory privilege, otherwise normal pages are used. Allocations smaller than the
+ * threshold are allocated from the heap, since rounding them up to a huge page would waste most of the page.
+ */
+class huge_page_allocator:
+	public storage_allocator
+{
+private:
+	std::size_t m_threshold;
+
+public:
+	/**
+	 * The size of a huge page on x86 processors, which is also the default threshold.
+	 */
+	static const std::size_t HUGE_PAGE_SIZE;
+
+	/**
+	 * \brief Initializes the allocator.
+	 *
+	 * \param threshold A std::size_t representing the size in bytes from which allocations are backed by huge pages.
+	 */
+	huge_page_allocator( const std::size_t threshold = HUGE_PAGE_SIZE );
+	~huge_page_allocator();
+
+	/**
+	 * \fn allocate
+	 * \brief Allocates memory, using huge pages if the allocation is large enough.
+	 *
+	 * \param numBytes A std::size_t representing the number of bytes to be allocated.
+	 * \return A pointer to the memory.
+	 */
+	void* allocate( const std::size_t numBytes );
+
+	/**
+	 * \fn deallocate
+	 * \brief Gives memory back to the operating system or the heap, depending on how it was allocated.
+	 *
+	 * \param memory A pointer to memory returned by allocate.
+	 * \param numBytes A std::size_t representing the number of bytes that were passed to allocate.
+	 */
+	void deallocate( void* memory, const std::size_t numBytes );
+
+	/**
+	 * \fn uses_huge_pages
+	 * \brief Checks whether an allocation is backed by huge pages.
+	 *
+	 * \param numBytes A std::size_t representing the number of bytes requested.
+	 * \return Returns true if an allocation of numBytes is mapped from the operating system, otherwise false.
+	 */
+	const bool uses_huge_pages( const std::size_t numBytes ) const;
+
+private:
+	/**
+	 * \fn get_mapped_size
+	 * \brief Rounds a number of bytes up to a multiple of the huge page size.
+	 */
+	static const std::size_t get_mapped_size( const std::size_t numBytes );
+};
+
+} // end of storage namespace
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,97 @@
+#include "pool_allocator.h"
+
+namespace occluded { namespace buffers { namespace storage {
+
+const std::size_t pool_allocator::MIN_CLASS_SIZE = 16;
+const std::size_t pool_allocator::SLAB_SIZE = 256 * 1024;
+const std::size_t pool_allocator::DEFAULT_MAX_CLASS_SIZE = 64 * 1024;
+
+pool_allocator::pool_allocator( const std::size_t maxClassSize ):
+	m_maxClassSize( MIN_CLASS_SIZE )
+{
+	while( m_maxClassSize < maxClassSize ) {
+		m_maxClassSize *= 2;
+	}
+
+	m_freeLists.resize( get_size_class( m_maxClassSize ) + 1, NULL );
+}
+
+pool_allocator::~pool_allocator()
+{
+	for( std::vector<char*>::iterator it = m_slabs.begin(); it != m_slabs.end(); ++it ) {
+		::operator delete( *it );
+	}
+}
+
+void* pool_allocator::allocate( const std::size_t numBytes ) {
+	if( numBytes > m_maxClassSize )
+		return ::operator new( numBytes );
+
+	const unsigned int sizeClass = get_size_class( numBytes );
+
+	if( m_freeLists[sizeClass] == NULL )
+		refill_free_list( sizeClass );
+
+	// The first bytes of each free block store the pointer to the next free block
+	void* memory = m_freeLists[sizeClass];
+	m_freeLists[sizeClass] = *static_cast<void**>( memory );
+
+	return memory;
+}
+
+void pool_allocator::deallocate( void* memory, const std::size_t numBytes ) {
+	if( numBytes > m_maxClassSize ) {
+		::operator delete( memory );
+		return;
+	}
+
+	const unsigned int sizeClass = get_size_class( numBytes );
+
+	*static_cast<void**>( memory ) = m_freeLists[sizeClass];
+	m_freeLists[sizeClass] = memory;
+}
+
+const std::size_t pool_allocator::get_class_size( const std::size_t numBytes ) const {
+	if( numBytes > m_maxClassSize )
+		return numBytes;
+
+	return MIN_CLASS_SIZE << get_size_class( numBytes );
+}
+
+const std::size_t pool_allocator::get_num_slabs() const {
+	return m_slabs.size();
+}
+
+// Private Member Functions
+
+void pool_allocator::refill_free_list( const unsigned int sizeClass ) {
+	const std::size_t classSize = MIN_CLASS_SIZE << sizeClass;
+	const std::size_t slabSize = classSize > SLAB_SIZE ? classSize : SLAB_SIZE;
+	char* slab = static_cast<char*>( ::operator new( slabSize ) );
+
+	m_slabs.push_back( slab );
+
+	// Link the blocks so that they are handed out in address order
+	for( std::size_t offset = slabSize; offset >= classSize; offset -= classSize ) {
+		void* block = slab + offset - classSize;
+
+		*static_cast<void**>( block ) = m_freeLists[sizeClass];
+		m_freeLists[sizeClass] = block;
+	}
+}
+
+// Static Functions
+
+const unsigned int pool_allocator::get_size_class( const std::size_t numBytes ) {
+	unsigned int sizeClass = 0;
+
+	for( std::size_t classSize = MIN_CLASS_SIZE; classSize < numBytes; classSize *= 2 ) {
+		++sizeClass;
+	}
+
+	return sizeClass;
+}
+
+} // end of storage namespace
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+
+#include "storage_allocator.h"
+
+namespace occluded { namespace buffers { namespace storage {
+
+/**
+ * \class pool_allocator
+ * \brief A storage allocator that keeps memory given back to it in pools of fixed size classes.
+ *
+ * Rounds each allocation up to a power of two size class and hands out memory from large slabs, keeping a free list for every size class.
+ * Memory given back to the pool is reused by the next allocation of the same size class instead of being returned to the heap, so buffers
+ * that are created and destroyed often do not fragment the heap. Since buffers grow geometrically, most of their allocations already have
+ * power of two sizes. Allocations larger than the largest size class are allocated separately from the heap. The slabs are only freed when
+ * the pool is destroyed.
+ */
+class pool_allocator:
+	public storage_allocator
+{
+private:
+	std::vector<void*> m_freeLists;
+	std::vector<char*> m_slabs;
+	std::size_t m_maxClassSize;
+
+	static const std::size_t MIN_CLASS_SIZE;
+	static const std::size_t SLAB_SIZE;
+
+public:
+	/**
+	 * The largest size class used when none is passed to the constructor.
+	 */
+	static const std::size_t DEFAULT_MAX_CLASS_SIZE;
+
+	/**
+	 * \brief Initializes the pool.
+	 *
+	 * \param maxClassSize A std::size_t representing the number of bytes in the largest size class, which is rounded up to a power of two.
+	 *
+	 * Initializes an empty pool. No memory is allocated until the first call to allocate.
+	 */
+	pool_allocator( const std::size_t maxClassSize = DEFAULT_MAX_CLASS_SIZE );
+	~pool_allocator();
+
+	/**
+	 * \fn allocate
+	 * \brief Allocates memory from the pool of the allocation's size class.
+	 *
+	 * \param numBytes A std::size_t representing the number of bytes to be allocated.
+	 * \return A pointer to the memory.
+	 *
+	 * Takes the memory from the free list of the size class, carving a new slab into blocks of that size if the free list is empty.
+	 */
+	void* allocate( const std::size_t numBytes );
+
+	/**
+	 * \fn deallocate
+	 * \brief Gives memory back to the pool of the allocation's size class.
+	 *
+	 * \param memory A pointer to memory returned by allocate.
+	 * \param numBytes A std::size_t representing the number of bytes that were passed to allocate.
+	 */
+	void deallocate( void* memory, const std::size_t numBytes );
+
+	/**
+	 * \fn get_class_size
+	 * \brief Gets the number of bytes actually reserved for an allocation.
+	 *
+	 * \param numBytes A std::size_t representing the number of bytes requested.
+	 * \return A std::size_t representing the size of the size class numBytes belongs to, or numBytes if it is larger than every size class.
+	 */
+	const std::size_t get_class_size( const std::size_t numBytes ) const;
+
+	/**
+	 * \fn get_num_slabs
+	 * \brief Gets the number of slabs allocated by the pool.
+	 *
+	 * \return A std::size_t representing the number of slabs that have been allocated from the heap.
+	 */
+	const std::size_t get_num_slabs() const;
+
+private:
+	pool_allocator( const pool_allocator& other );
+	pool_allocator& operator=( const pool_allocator& other );
+
+	/**
+	 * \fn get_size_class
+	 * \brief Gets the index of the size class an allocation belongs to.
+	 */
+	static const unsigned int get_size_class( const std::size_t numBytes );
+
+	/**
+	 * \fn refill_free_list
+	 * \brief Allocates a new slab and adds its blocks to the free list of a size class.
+	 */
+	void refill_free_list( const unsigned int sizeClass );
+};
+
+} // end of storage namespace
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,24 @@
+#include "storage_allocator.h"
+#include "heap_allocator.h"
+
+namespace occluded { namespace buffers { namespace storage {
+
+storage_allocator::~storage_allocator()
+{
+}
+
+storage_allocator& storage_allocator::get_default_allocator() {
+	static heap_allocator defaultAllocator;
+
+	return defaultAllocator;
+}
+
+// Protected Member Functions
+
+storage_allocator::storage_allocator()
+{
+}
+
+} // end of storage namespace
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace occluded { namespace buffers { namespace storage {
+
+/**
+ * \class storage_allocator
+ * \brief An interface for the memory that attribute buffers store their values in.
+ *
+ * An interface for allocating the memory that attribute buffers store their values in, so that the strategy used to get that memory can be
+ * chosen for each buffer. An allocator must outlive every buffer that uses it. Allocators are not thread safe, so buffers that are used on
+ * different threads should use different allocators.
+ */
+class storage_allocator
+{
+public:
+	virtual ~storage_allocator();
+
+	/**
+	 * \fn allocate
+	 * \brief Allocates memory.
+	 *
+	 * \param numBytes A std::size_t representing the number of bytes to be allocated.
+	 * \return A pointer to the memory, which is aligned for any fundamental type.
+	 *
+	 * Allocates memory that is at least numBytes long. A std::bad_alloc is thrown if the memory can not be allocated.
+	 */
+	virtual void* allocate( const std::size_t numBytes ) = 0;
+
+	/**
+	 * \fn deallocate
+	 * \brief Gives memory back to the allocator.
+	 *
+	 * \param memory A pointer to memory returned by allocate.
+	 * \param numBytes A std::size_t representing the number of bytes that were passed to allocate.
+	 */
+	virtual void deallocate( void* memory, const std::size_t numBytes ) = 0;
+
+	/**
+	 * \fn get_default_allocator
+	 * \brief Gets the allocator used by attribute buffers when no allocator is provided.
+	 *
+	 * \return A reference to a heap_allocator shared by the whole process.
+	 */
+	static storage_allocator& get_default_allocator();
+
+protected:
+	storage_allocator();
+
+private:
+	storage_allocator( const storage_allocator& other );
+	storage_allocator& operator=( const storage_allocator& other );
+};
+
+} // end of storage namespace
+} // end of buffers namespace
+} // end of occluded namespace
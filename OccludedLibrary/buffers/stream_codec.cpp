@@ -0,0 +1,282 @@
+#include "stream_codec.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define OCCLUDED_CODEC_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace occluded { namespace buffers {
+
+// The number of bytes each group is packed into for each of the 2-bit widths
+static const std::size_t GROUP_SIZES[4] = { 0, 4, 8, 16 };
+
+#ifdef OCCLUDED_CODEC_SSE2
+// Turns 16 zigzag encoded differences back into bytes with a prefix sum done in four shifted additions, starting from the byte before them
+static inline __m128i sum_differences( const __m128i zigzag, unsigned char& prev ) {
+	__m128i sum = _mm_xor_si128( _mm_and_si128( _mm_srli_epi16( zigzag, 1 ), _mm_set1_epi8( 0x7f ) ), _mm_sub_epi8( _mm_setzero_si128(),
+		_mm_and_si128( zigzag, _mm_set1_epi8( 1 ) ) ) );
+
+	sum = _mm_add_epi8( sum, _mm_slli_si128( sum, 1 ) );
+	sum = _mm_add_epi8( sum, _mm_slli_si128( sum, 2 ) );
+	sum = _mm_add_epi8( sum, _mm_slli_si128( sum, 4 ) );
+	sum = _mm_add_epi8( sum, _mm_slli_si128( sum, 8 ) );
+	sum = _mm_add_epi8( sum, _mm_set1_epi8( static_cast<char>( prev ) ) );
+	prev = static_cast<unsigned char>( _mm_extract_epi16( sum, 7 ) >> 8 );
+
+	return sum;
+}
+#endif
+
+void stream_codec::encode_values( const char* values, const unsigned int numValues, const std::size_t stride, std::vector<char>& encoded ) {
+	if( numValues == 0 || stride == 0 )
+		return;
+
+	const unsigned char* source = reinterpret_cast<const unsigned char*>( values );
+	std::vector<unsigned char> planes( numValues * stride );
+
+	for( std::size_t k = 0; k < stride; ++k ) {
+		unsigned char* plane = &planes[k * numValues];
+		unsigned char prev = 0;
+
+		for( unsigned int i = 0; i < numValues; ++i ) {
+			const unsigned char curr = source[i * stride + k];
+			const unsigned char delta = static_cast<unsigned char>( curr - prev );
+
+			// Zigzag encoding moves the sign into the lowest bit, so differences of either sign become small numbers
+			plane[i] = static_cast<unsigned char>( ( delta << 1 ) ^ ( ( delta & 0x80 ) != 0 ? 0xff : 0 ) );
+			prev = curr;
+		}
+	}
+
+	pack_groups( &planes[0], planes.size(), encoded );
+}
+
+const std::size_t stream_codec::decode_values( const char* encoded, const std::size_t encodedSize, const unsigned int numValues, const std::size_t stride,
+	char* values ) {
+	if( numValues == 0 || stride == 0 )
+		return 0;
+
+	const std::size_t numBytes = numValues * stride;
+	std::vector<unsigned char> planes( ( numBytes + 15 ) & ~static_cast<std::size_t>( 15 ) );
+	const std::size_t bytesRead = unpack_groups( encoded, encodedSize, numBytes, &planes[0] );
+	unsigned char* dest = reinterpret_cast<unsigned char*>( values );
+	std::vector<unsigned char> prev( stride, 0 );
+	unsigned int first = 0;
+
+#ifdef OCCLUDED_CODEC_SSE2
+	// Values made of 4 byte components are reassembled 16 at a time, interleaving 4 planes into the 4 bytes of a component of each value
+	if( stride % 4 == 0 ) {
+		for( ; first + 16 <= numValues; first += 16 ) {
+			unsigned char* value = dest + first * stride;
+
+			for( std::size_t k = 0; k < stride; k += 4 ) {
+				const unsigned char* plane = &planes[k * numValues + first];
+				const __m128i b0 = sum_differences( _mm_loadu_si128( reinterpret_cast<const __m128i*>( plane ) ), prev[k] );
+				const __m128i b1 = sum_differences( _mm_loadu_si128( reinterpret_cast<const __m128i*>( plane + numValues ) ), prev[k + 1] );
+				const __m128i b2 = sum_differences( _mm_loadu_si128( reinterpret_cast<const __m128i*>( plane + 2 * numValues ) ), prev[k + 2] );
+				const __m128i b3 = sum_differences( _mm_loadu_si128( reinterpret_cast<const __m128i*>( plane + 3 * numValues ) ), prev[k + 3] );
+				const __m128i low01 = _mm_unpacklo_epi8( b0, b1 ), high01 = _mm_unpackhi_epi8( b0, b1 );
+				const __m128i low23 = _mm_unpacklo_epi8( b2, b3 ), high23 = _mm_unpackhi_epi8( b2, b3 );
+				boost::uint32_t components[16];
+
+				_mm_storeu_si128( reinterpret_cast<__m128i*>( components ), _mm_unpacklo_epi16( low01, low23 ) );
+				_mm_storeu_si128( reinterpret_cast<__m128i*>( components + 4 ), _mm_unpackhi_epi16( low01, low23 ) );
+				_mm_storeu_si128( reinterpret_cast<__m128i*>( components + 8 ), _mm_unpacklo_epi16( high01, high23 ) );
+				_mm_storeu_si128( reinterpret_cast<__m128i*>( components + 12 ), _mm_unpackhi_epi16( high01, high23 ) );
+
+				for( unsigned int j = 0; j < 16; ++j ) {
+					memcpy( value + j * stride + k, &components[j], sizeof( boost::uint32_t ) );
+				}
+			}
+		}
+	}
+#endif
+
+	// The values are written in order, adding the next difference from each plane to the same byte of the previous value
+	for( unsigned int i = first; i < numValues; ++i ) {
+		for( std::size_t k = 0; k < stride; ++k ) {
+			const unsigned char zigzag = planes[k * numValues + i];
+
+			prev[k] = static_cast<unsigned char>( prev[k] + ( ( zigzag >> 1 ) ^ ( ( zigzag & 1 ) != 0 ? 0xff : 0 ) ) );
+			dest[i * stride + k] = prev[k];
+		}
+	}
+
+	return bytesRead;
+}
+
+void stream_codec::encode_indices( const std::vector<unsigned int>& indices, std::vector<char>& encoded ) {
+	if( indices.empty() )
+		return;
+
+	const std::size_t numIndices = indices.size();
+	std::vector<unsigned char> planes( 4 * numIndices );
+	boost::uint32_t prev = 0;
+
+	for( std::size_t i = 0; i < numIndices; ++i ) {
+		const boost::uint32_t delta = static_cast<boost::uint32_t>( indices[i] ) - prev;
+		const boost::uint32_t zigzag = ( delta << 1 ) ^ ( 0u - ( delta >> 31 ) );
+
+		for( unsigned int b = 0; b < 4; ++b ) {
+			planes[b * numIndices + i] = static_cast<unsigned char>( zigzag >> ( 8 * b ) );
+		}
+
+		prev = indices[i];
+	}
+
+	pack_groups( &planes[0], planes.size(), encoded );
+}
+
+const std::size_t stream_codec::decode_indices( const char* encoded, const std::size_t encodedSize, const std::size_t numIndices,
+	std::vector<unsigned int>& indices ) {
+	indices.resize( numIndices );
+
+	if( numIndices == 0 )
+		return 0;
+
+	std::vector<unsigned char> planes( ( 4 * numIndices + 15 ) & ~static_cast<std::size_t>( 15 ) );
+	const std::size_t bytesRead = unpack_groups( encoded, encodedSize, 4 * numIndices, &planes[0] );
+	boost::uint32_t prev = 0;
+
+	for( std::size_t i = 0; i < numIndices; ++i ) {
+		const boost::uint32_t zigzag = static_cast<boost::uint32_t>( planes[i] ) | ( static_cast<boost::uint32_t>( planes[numIndices + i] ) << 8 )
+			| ( static_cast<boost::uint32_t>( planes[2 * numIndices + i] ) << 16 ) | ( static_cast<boost::uint32_t>( planes[3 * numIndices + i] ) << 24 );
+
+		prev += ( zigzag >> 1 ) ^ ( 0u - ( zigzag & 1 ) );
+		indices[i] = prev;
+	}
+
+	return bytesRead;
+}
+
+const boost::uint64_t stream_codec::get_min_encoded_size( const boost::uint64_t numBytes ) {
+	// Every group packed with a width of 0 takes no bytes, so only the widths are left
+	return ( ( numBytes + 15 ) / 16 + 3 ) / 4;
+}
+
+const boost::uint64_t stream_codec::get_max_encoded_size( const boost::uint64_t numBytes ) {
+	// Every group packed with a width of 3 stores all 16 of its bytes
+	return get_min_encoded_size( numBytes ) + ( numBytes + 15 ) / 16 * 16;
+}
+
+// private functions
+
+stream_codec::stream_codec()
+{
+}
+
+stream_codec::~stream_codec()
+{
+}
+
+void stream_codec::pack_groups( const unsigned char* bytes, const std::size_t numBytes, std::vector<char>& encoded ) {
+	const std::size_t numGroups = ( numBytes + 15 ) / 16;
+	const std::size_t widthsOffset = encoded.size();
+
+	// The widths are written first, so the packed groups are appended after room is made for them
+	encoded.resize( widthsOffset + ( numGroups + 3 ) / 4, 0 );
+
+	for( std::size_t g = 0; g < numGroups; ++g ) {
+		unsigned char group[16] = { 0 };
+		unsigned char largest = 0;
+		unsigned int width = 0;
+
+		memcpy( group, bytes + g * 16, std::min<std::size_t>( 16, numBytes - g * 16 ) );
+
+		for( unsigned int j = 0; j < 16; ++j ) {
+			largest = std::max( largest, group[j] );
+		}
+
+		width = largest == 0 ? 0 : largest < 4 ? 1 : largest < 16 ? 2 : 3;
+		encoded[widthsOffset + g / 4] = static_cast<char>( encoded[widthsOffset + g / 4] | ( width << ( 2 * ( g % 4 ) ) ) );
+
+		// Byte j of a packed group holds the bytes j, j + 4, j + 8 and j + 12 at 2 bits, or j and j + 8 at 4 bits, so each can be unpacked
+		// with a shift and a mask
+		if( width == 1 ) {
+			for( unsigned int j = 0; j < 4; ++j ) {
+				encoded.push_back( static_cast<char>( group[j] | ( group[j + 4] << 2 ) | ( group[j + 8] << 4 ) | ( group[j + 12] << 6 ) ) );
+			}
+		} else if( width == 2 ) {
+			for( unsigned int j = 0; j < 8; ++j ) {
+				encoded.push_back( static_cast<char>( group[j] | ( group[j + 8] << 4 ) ) );
+			}
+		} else if( width == 3 ) {
+			encoded.insert( encoded.end(), reinterpret_cast<const char*>( group ), reinterpret_cast<const char*>( group ) + 16 );
+		}
+	}
+}
+
+const std::size_t stream_codec::unpack_groups( const char* encoded, const std::size_t encodedSize, const std::size_t numBytes, unsigned char* bytes ) {
+	const std::size_t numGroups = ( numBytes + 15 ) / 16;
+	const unsigned char* widths = reinterpret_cast<const unsigned char*>( encoded );
+	std::size_t pos = ( numGroups + 3 ) / 4;
+
+	if( encodedSize < pos ) {
+		throw std::runtime_error( "stream_codec.unpack_groups: Failed to decode stream because it ended before the widths of its groups." );
+	}
+
+	for( std::size_t g = 0; g < numGroups; ++g ) {
+		const unsigned int width = ( widths[g / 4] >> ( 2 * ( g % 4 ) ) ) & 3;
+		const unsigned char* packed = reinterpret_cast<const unsigned char*>( encoded + pos );
+		unsigned char* group = bytes + g * 16;
+
+		if( encodedSize - pos < GROUP_SIZES[width] ) {
+			throw std::runtime_error( "stream_codec.unpack_groups: Failed to decode stream because it ended before group("
+				+ boost::lexical_cast<std::string>( g ) + ")." );
+		}
+
+#ifdef OCCLUDED_CODEC_SSE2
+		__m128i result = _mm_setzero_si128();
+
+		if( width == 1 ) {
+			int word = 0;
+
+			memcpy( &word, packed, sizeof( word ) );
+
+			// Shifting 16-bit lanes moves bits in from the next byte, which the mask removes
+			const __m128i mask = _mm_set1_epi8( 3 );
+			const __m128i v = _mm_cvtsi32_si128( word );
+			const __m128i low = _mm_unpacklo_epi32( _mm_and_si128( v, mask ), _mm_and_si128( _mm_srli_epi16( v, 2 ), mask ) );
+			const __m128i high = _mm_unpacklo_epi32( _mm_and_si128( _mm_srli_epi16( v, 4 ), mask ), _mm_and_si128( _mm_srli_epi16( v, 6 ), mask ) );
+
+			result = _mm_unpacklo_epi64( low, high );
+		} else if( width == 2 ) {
+			const __m128i mask = _mm_set1_epi8( 0x0f );
+			const __m128i v = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( packed ) );
+
+			result = _mm_unpacklo_epi64( _mm_and_si128( v, mask ), _mm_and_si128( _mm_srli_epi16( v, 4 ), mask ) );
+		} else if( width == 3 ) {
+			result = _mm_loadu_si128( reinterpret_cast<const __m128i*>( packed ) );
+		}
+
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( group ), result );
+#else
+		if( width == 1 ) {
+			for( unsigned int j = 0; j < 16; ++j ) {
+				group[j] = static_cast<unsigned char>( ( packed[j % 4] >> ( 2 * ( j / 4 ) ) ) & 3 );
+			}
+		} else if( width == 2 ) {
+			for( unsigned int j = 0; j < 16; ++j ) {
+				group[j] = static_cast<unsigned char>( ( packed[j % 8] >> ( 4 * ( j / 8 ) ) ) & 0x0f );
+			}
+		} else if( width == 3 ) {
+			memcpy( group, packed, 16 );
+		} else {
+			memset( group, 0, 16 );
+		}
+#endif
+
+		pos += GROUP_SIZES[width];
+	}
+
+	return pos;
+}
+
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <stdexcept>
+
+#include <boost/cstdint.hpp>
+
+namespace occluded { namespace buffers {
+
+/**
+ * \class stream_codec
+ * \brief Compresses streams of vertex values and indices without losing any information.
+ *
+ * Vertex values are compressed by splitting them into byte planes, so that the first byte of every value is stored together, then the second
+ * and so on. Each byte is replaced by its difference from the same byte of the previous value, zigzag encoded so that small negative
+ * differences become small numbers. Neighbouring vertices have similar values, so most planes end up almost entirely made of small numbers,
+ * and the high bytes of floats and the unused bytes of integers mostly become 0.
+ *
+ * Indices are compressed by replacing each index with its zigzag encoded difference from the previous index, which is small for meshes
+ * whose faces were ordered for the vertex cache, and splitting the differences into 4 byte planes in the same way.
+ *
+ * The planes are then packed in groups of 16 bytes, each stored with 0, 2, 4 or 8 bits per byte depending on its largest byte. The width of
+ * each group is stored in 2 bits ahead of the packed groups. When SSE2 is available each group is unpacked with a few instructions, and
+ * values whose size is a multiple of 4 bytes are reassembled 16 at a time, summing the differences of 16 bytes of a plane at once.
+ */
+class stream_codec
+{
+public:
+	/**
+	 * \fn encode_values
+	 * \brief Compresses a sequence of values.
+	 *
+	 * \param values A pointer to the first value.
+	 * \param numValues An unsigned int representing the number of values.
+	 * \param stride A std::size_t representing the size of each value in bytes.
+	 * \param encoded A reference to a vector of bytes the compressed values are appended to.
+	 */
+	static void encode_values( const char* values, const unsigned int numValues, const std::size_t stride, std::vector<char>& encoded );
+
+	/**
+	 * \fn decode_values
+	 * \brief Decompresses a sequence of values compressed by encode_values.
+	 *
+	 * \param encoded A pointer to the compressed values.
+	 * \param encodedSize A std::size_t representing the number of bytes that can be read from encoded.
+	 * \param numValues An unsigned int representing the number of values that were compressed.
+	 * \param stride A std::size_t representing the size of each value in bytes.
+	 * \param values A pointer to the memory the values are written to, which must be numValues times stride bytes long.
+	 * \return A std::size_t representing the number of bytes of encoded that were read.
+	 *
+	 * An exception is thrown if the compressed values end before every value is decoded.
+	 */
+	static const std::size_t decode_values( const char* encoded, const std::size_t encodedSize, const unsigned int numValues, const std::size_t stride,
+		char* values );
+
+	/**
+	 * \fn encode_indices
+	 * \brief Compresses a sequence of indices.
+	 *
+	 * \param indices A reference to a vector containing the indices.
+	 * \param encoded A reference to a vector of bytes the compressed indices are appended to.
+	 */
+	static void encode_indices( const std::vector<unsigned int>& indices, std::vector<char>& encoded );
+
+	/**
+	 * \fn decode_indices
+	 * \brief Decompresses a sequence of indices compressed by encode_indices.
+	 *
+	 * \param encoded A pointer to the compressed indices.
+	 * \param encodedSize A std::size_t representing the number of bytes that can be read from encoded.
+	 * \param numIndices A std::size_t representing the number of indices that were compressed.
+	 * \param indices A reference to a vector the indices are written to, which is resized to numIndices.
+	 * \return A std::size_t representing the number of bytes of encoded that were read.
+	 *
+	 * An exception is thrown if the compressed indices end before every index is decoded.
+	 */
+	static const std::size_t decode_indices( const char* encoded, const std::size_t encodedSize, const std::size_t numIndices,
+		std::vector<unsigned int>& indices );
+
+	/**
+	 * \fn get_min_encoded_size
+	 * \brief Gets the fewest bytes that a sequence of bytes can be compressed into.
+	 *
+	 * \param numBytes A 64-bit unsigned integer representing the number of bytes before they are compressed, which for values is the number of
+	 * values times their stride and for indices is 4 times the number of indices.
+	 * \return A 64-bit unsigned integer representing the size of the widths of the groups, which is all that is stored if every byte is 0.
+	 */
+	static const boost::uint64_t get_min_encoded_size( const boost::uint64_t numBytes );
+
+	/**
+	 * \fn get_max_encoded_size
+	 * \brief Gets the most bytes that a sequence of bytes can be compressed into.
+	 *
+	 * \param numBytes A 64-bit unsigned integer representing the number of bytes before they are compressed.
+	 * \return A 64-bit unsigned integer representing the size of the widths of the groups plus every group stored with 8 bits per byte.
+	 */
+	static const boost::uint64_t get_max_encoded_size( const boost::uint64_t numBytes );
+
+private:
+	stream_codec();
+	~stream_codec();
+
+	/**
+	 * \fn pack_groups
+	 * \brief Packs bytes in groups of 16 with the fewest bits that hold the largest byte of each group.
+	 *
+	 * Appends the width of every group followed by the packed groups to encoded. The last group is padded with zeros.
+	 */
+	static void pack_groups( const unsigned char* bytes, const std::size_t numBytes, std::vector<char>& encoded );
+
+	/**
+	 * \fn unpack_groups
+	 * \brief Unpacks bytes packed by pack_groups.
+	 *
+	 * Writes every group, including the padding of the last one, so bytes must be numBytes rounded up to a multiple of 16 long. Returns the
+	 * number of bytes of encoded that were read.
+	 */
+	static const std::size_t unpack_groups( const char* encoded, const std::size_t encodedSize, const std::size_t numBytes, unsigned char* bytes );
+};
+
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,218 @@
+#include "vertex_welder.h"
+#include "attribute_buffer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace occluded { namespace buffers {
+
+const unsigned int vertex_welder::EMPTY_SLOT = 0xffffffff;
+const unsigned int vertex_welder::MIN_SLOTS = 16;
+const unsigned int vertex_welder::MAX_CELL_COMPONENTS = 4;
+
+vertex_welder::vertex_welder( const attributes::attribute_map& map, const float epsilon ):
+	m_epsilon( epsilon ),
+	m_slots( MIN_SLOTS, EMPTY_SLOT ),
+	m_cellAttrib( 0 ),
+	m_numCellComponents( 0 )
+{
+	if( map.being_defined() ) {
+		throw std::runtime_error( "vertex_welder: Failed to create welder because the attribute map is still being defined." );
+	}
+
+	m_map = attributes::attribute_map_registry::get_registry().intern( map );
+
+	if( m_map->get_byte_size() == 0 ) {
+		throw std::runtime_error( "vertex_welder: Failed to create welder because the attribute map contained no attributes." );
+	}
+
+	if( !( m_epsilon >= 0.f ) ) {
+		throw std::runtime_error( "vertex_welder: Failed to create welder because the epsilon(" + boost::lexical_cast<std::string>( m_epsilon )
+			+ ") is negative." );
+	}
+
+	const std::vector<const attributes::attribute>& attributes = m_map->get_attributes();
+
+	// Only the first float attribute is hashed by its cells, so the number of lookups for each vertex stays small
+	while( m_cellAttrib < attributes.size() && attributes[m_cellAttrib].get_type() != attributes::attrib_float ) {
+		++m_cellAttrib;
+	}
+
+	if( m_epsilon > 0.f && m_cellAttrib < attributes.size() )
+		m_numCellComponents = std::min( attributes[m_cellAttrib].get_arity(), MAX_CELL_COMPONENTS );
+}
+
+vertex_welder::~vertex_welder()
+{
+}
+
+const unsigned int vertex_welder::weld( const char* vertex, const unsigned int newIndex ) {
+	const std::size_t vertexSize = m_map->get_byte_size();
+	const boost::uint32_t hash = hash_vertex( vertex, 0 );
+
+	// An equal vertex can be in the neighbouring cell of any of the hashed components, so every combination of cells is looked up
+	for( unsigned int neighbours = 0; neighbours < ( 1u << m_numCellComponents ); ++neighbours ) {
+		const unsigned int other = find_vertex( vertex, neighbours == 0 ? hash : hash_vertex( vertex, neighbours ) );
+
+		if( other != EMPTY_SLOT )
+			return m_indices[other];
+	}
+
+	m_vertices.insert( m_vertices.end(), vertex, vertex + vertexSize );
+	m_indices.push_back( newIndex );
+	m_hashes.push_back( hash );
+
+	if( 2 * m_indices.size() > m_slots.size() )
+		rebuild_slots( 2 * m_slots.size() );
+	else
+		insert_slot( static_cast<unsigned int>( m_indices.size() - 1 ) );
+
+	return newIndex;
+}
+
+void vertex_welder::remap_indices( const std::vector<unsigned int>& remap ) {
+	const std::size_t vertexSize = m_map->get_byte_size();
+	unsigned int numKept = 0;
+
+	for( unsigned int i = 0; i < m_indices.size(); ++i ) {
+		if( m_indices[i] >= remap.size() || remap[m_indices[i]] == attribute_buffer::ERASED_VALUE )
+			continue;
+
+		// Kept vertices only move towards the start, so they can be moved in place
+		if( numKept != i ) {
+			memmove( &m_vertices[numKept * vertexSize], &m_vertices[i * vertexSize], vertexSize );
+			m_hashes[numKept] = m_hashes[i];
+		}
+
+		m_indices[numKept] = remap[m_indices[i]];
+		++numKept;
+	}
+
+	m_vertices.resize( numKept * vertexSize );
+	m_indices.resize( numKept );
+	m_hashes.resize( numKept );
+
+	rebuild_slots( m_slots.size() );
+}
+
+void vertex_welder::clear() {
+	m_vertices.clear();
+	m_indices.clear();
+	m_hashes.clear();
+	m_slots.assign( MIN_SLOTS, EMPTY_SLOT );
+}
+
+const unsigned int vertex_welder::get_num_vertices() const {
+	return static_cast<unsigned int>( m_indices.size() );
+}
+
+const float vertex_welder::get_epsilon() const {
+	return m_epsilon;
+}
+
+// Private Member Functions
+
+const boost::uint32_t vertex_welder::hash_vertex( const char* vertex, const unsigned int neighbours ) const {
+	const std::vector<const attributes::attribute>& attributes = m_map->get_attributes();
+	const std::vector<unsigned int>& offsets = m_map->get_attribute_offsets();
+	boost::uint32_t hash = 2166136261u;
+
+	for( unsigned int i = 0; i < attributes.size(); ++i ) {
+		const char* attrib = vertex + offsets[i];
+
+		if( m_epsilon > 0.f && attributes[i].get_type() == attributes::attrib_float ) {
+			if( i != m_cellAttrib )
+				continue;
+
+			for( unsigned int j = 0; j < m_numCellComponents; ++j ) {
+				float component;
+				memcpy( &component, attrib + j * sizeof( float ), sizeof( float ) );
+
+				const double scaled = component / ( 2.0 * m_epsilon );
+				double cell = std::floor( scaled );
+
+				// A component within the epsilon is at most half a cell away, so it can only be in the neighbour on the nearer side
+				if( ( neighbours & ( 1u << j ) ) != 0 )
+					cell += scaled - cell < 0.5 ? -1.0 : 1.0;
+
+				// Values too large to round, infinities and NaNs are hashed as 0, since vertices_equal still compares them
+				const boost::int64_t rounded = std::fabs( cell ) < 9.0e18 ? static_cast<boost::int64_t>( cell ) : 0;
+				const unsigned char* bytes = reinterpret_cast<const unsigned char*>( &rounded );
+
+				for( unsigned int k = 0; k < sizeof( rounded ); ++k ) {
+					hash = ( hash ^ bytes[k] ) * 16777619u;
+				}
+			}
+		} else {
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>( attrib );
+
+			for( std::size_t k = 0; k < attributes[i].get_attrib_size(); ++k ) {
+				hash = ( hash ^ bytes[k] ) * 16777619u;
+			}
+		}
+	}
+
+	return hash;
+}
+
+const unsigned int vertex_welder::find_vertex( const char* vertex, const boost::uint32_t hash ) const {
+	const std::size_t vertexSize = m_map->get_byte_size();
+	const std::size_t mask = m_slots.size() - 1;
+
+	// The table is never more than half full, so there is always an empty slot that ends the probe sequence
+	for( std::size_t slot = hash & mask; m_slots[slot] != EMPTY_SLOT; slot = ( slot + 1 ) & mask ) {
+		const unsigned int other = m_slots[slot];
+
+		if( m_hashes[other] == hash && vertices_equal( vertex, &m_vertices[other * vertexSize] ) )
+			return other;
+	}
+
+	return EMPTY_SLOT;
+}
+
+const bool vertex_welder::vertices_equal( const char* first, const char* second ) const {
+	if( m_epsilon == 0.f )
+		return memcmp( first, second, m_map->get_byte_size() ) == 0;
+
+	const std::vector<const attributes::attribute>& attributes = m_map->get_attributes();
+	const std::vector<unsigned int>& offsets = m_map->get_attribute_offsets();
+
+	for( unsigned int i = 0; i < attributes.size(); ++i ) {
+		if( attributes[i].get_type() == attributes::attrib_float ) {
+			for( unsigned int j = 0; j < attributes[i].get_arity(); ++j ) {
+				float firstComponent, secondComponent;
+				memcpy( &firstComponent, first + offsets[i] + j * sizeof( float ), sizeof( float ) );
+				memcpy( &secondComponent, second + offsets[i] + j * sizeof( float ), sizeof( float ) );
+
+				if( !( std::fabs( firstComponent - secondComponent ) <= m_epsilon ) )
+					return false;
+			}
+		} else if( memcmp( first + offsets[i], second + offsets[i], attributes[i].get_attrib_size() ) != 0 ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void vertex_welder::insert_slot( const unsigned int vertex ) {
+	const std::size_t mask = m_slots.size() - 1;
+	std::size_t slot = m_hashes[vertex] & mask;
+
+	while( m_slots[slot] != EMPTY_SLOT ) {
+		slot = ( slot + 1 ) & mask;
+	}
+
+	m_slots[slot] = vertex;
+}
+
+void vertex_welder::rebuild_slots( const std::size_t numSlots ) {
+	m_slots.assign( numSlots, EMPTY_SLOT );
+
+	for( unsigned int i = 0; i < m_indices.size(); ++i ) {
+		insert_slot( i );
+	}
+}
+
+} // end of buffers namespace
+} // end of occluded namespace
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "attributes/attribute_map_registry.h"
+
+namespace occluded { namespace buffers {
+
+/**
+ * \class vertex_welder
+ * \brief Finds vertices that are equal to vertices that have already been seen.
+ *
+ * Keeps a hash table of vertices, so that duplicate vertices can be replaced by the index of the first vertex that was equal to them. Each
+ * vertex is hashed and compared according to the layout of the attribute map, a single vertex at a time with its attributes in the order they
+ * were added. The table uses open addressing with linear probing and keeps its own copy of every vertex, so it does not depend on where the
+ * vertices are stored.
+ *
+ * If the epsilon is 0, vertices are welded only if they are bit-identical. Otherwise attrib_float components are equal if they differ by at
+ * most the epsilon, and every other type of component must still be bit-identical. The first float attribute is hashed by the cell, twice
+ * the epsilon wide, that each of its first four components falls in, and the other float attributes are left out of the hash. Two components
+ * within the epsilon of each other are in the same cell or in the neighbouring cell on the side the component is closest to, so a vertex is
+ * looked up in every combination of its cells and their neighbours, and is welded to an equal vertex wherever they sit on the grid.
+ */
+class vertex_welder
+{
+private:
+	attributes::attribute_map_handle m_map;
+	float m_epsilon;
+	std::vector<char> m_vertices;
+	std::vector<unsigned int> m_indices;
+	std::vector<boost::uint32_t> m_hashes;
+	std::vector<unsigned int> m_slots;
+	unsigned int m_cellAttrib;
+	unsigned int m_numCellComponents;
+
+	static const unsigned int EMPTY_SLOT;
+	static const unsigned int MIN_SLOTS;
+	static const unsigned int MAX_CELL_COMPONENTS;
+
+public:
+	/**
+	 * \brief Initializes an empty welder.
+	 *
+	 * \param map A reference to the attribute map describing the vertices.
+	 * \param epsilon A float representing the largest difference between float components that are considered equal.
+	 *
+	 * An exception is thrown if the map is still being defined, has no attributes, or if epsilon is negative.
+	 */
+	vertex_welder( const attributes::attribute_map& map, const float epsilon = 0.f );
+	~vertex_welder();
+
+	/**
+	 * \fn weld
+	 * \brief Finds the index of a vertex, adding the vertex if it has not been seen.
+	 *
+	 * \param vertex A pointer to the vertex, which must be the byte size of the attribute map long.
+	 * \param newIndex An unsigned int representing the index the vertex is stored at if it has not been seen.
+	 * \return The index of the first vertex that is equal to vertex, or newIndex if there is none.
+	 */
+	const unsigned int weld( const char* vertex, const unsigned int newIndex );
+
+	/**
+	 * \fn remap_indices
+	 * \brief Changes the indices of the vertices in the welder.
+	 *
+	 * \param remap A reference to a vector containing the new index of every vertex, indexed by its old index.
+	 *
+	 * Replaces the index of every vertex with its new index. Vertices whose new index is attribute_buffer::ERASED_VALUE are removed, so the
+	 * welder can follow the vertices of a buffer that are erased or compacted.
+	 */
+	void remap_indices( const std::vector<unsigned int>& remap );
+
+	/**
+	 * \fn clear
+	 * \brief Removes every vertex from the welder.
+	 */
+	void clear();
+
+	/**
+	 * \fn get_num_vertices
+	 * \brief Gets the number of unique vertices in the welder.
+	 *
+	 * \return An unsigned int representing the number of vertices that have been added.
+	 */
+	const unsigned int get_num_vertices() const;
+
+	/**
+	 * \fn get_epsilon
+	 * \brief Gets the largest difference between float components that are considered equal.
+	 *
+	 * \return A float representing the epsilon passed to the constructor.
+	 */
+	const float get_epsilon() const;
+
+private:
+	/**
+	 * \fn hash_vertex
+	 * \brief Hashes the bytes of a vertex with FNV-1a, replacing float components with their cells if the epsilon is not 0.
+	 *
+	 * \param vertex A pointer to the vertex.
+	 * \param neighbours An unsigned int whose bit j is set if component j of the first float attribute is hashed with its neighbouring cell.
+	 */
+	const boost::uint32_t hash_vertex( const char* vertex, const unsigned int neighbours ) const;
+
+	/**
+	 * \fn find_vertex
+	 * \brief Looks up a vertex in the table along the probe sequence of a hash.
+	 *
+	 * \return The position of an equal vertex in the welder, or EMPTY_SLOT if there is none with that hash.
+	 */
+	const unsigned int find_vertex( const char* vertex, const boost::uint32_t hash ) const;
+
+	/**
+	 * \fn vertices_equal
+	 * \brief Checks whether two vertices are equal, comparing float components with the epsilon if it is not 0.
+	 */
+	const bool vertices_equal( const char* first, const char* second ) const;
+
+	/**
+	 * \fn insert_slot
+	 * \brief Puts a vertex in the first empty slot of its probe sequence.
+	 */
+	void insert_slot( const unsigned int vertex );
+
+	/**
+	 * \fn rebuild_slots
+	 * \brief Resizes the table to a number of slots and puts every vertex back into it.
+	 */
+	void rebuild_slots( const std::size_t numSlots );
+};
+
+} // end of buffers namespace
+} // end of occluded namespace
@@ -2,6 +2,8 @@
 
 #include <vector>
 
+#include "mesh_bounds.h"
+
 namespace occluded { namespace meshes {
 
 /**
@@ -64,6 +66,17 @@ public:
 	 * be called before adding a face to the mesh so that the chance of an exception being thrown by the call is minimized.
 	 */
 	virtual const unsigned int num_verts_for_next_face( const unsigned int numFaces ) const = 0;
+
+	/**
+	 * \fn get_bounds
+	 * \brief Gets the bounds of the vertices of the mesh.
+	 *
+	 * \return A reference to the box and sphere containing the positions of the vertices of the mesh, in object coordinates.
+	 *
+	 * The bounds are kept up to date as vertices are added, so they can be used to cull the mesh without reading its vertices. They are empty
+	 * if the mesh does not know which of its attributes is the position.
+	 */
+	virtual const mesh_bounds& get_bounds() const = 0;
 };
 
 } // end of meshes namespace
@@ -0,0 +1,151 @@
+#include "mesh_bounds.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define OCCLUDED_BOUNDS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace occluded { namespace meshes {
+
+mesh_bounds::mesh_bounds()
+{
+	clear();
+}
+
+mesh_bounds::~mesh_bounds()
+{
+}
+
+void mesh_bounds::add_positions( const char* positions, const unsigned int numPositions, const std::size_t stride ) {
+	if( positions == NULL || numPositions == 0 )
+		return;
+
+	const bool wasEmpty = m_empty;
+
+	grow_box( positions, numPositions, stride );
+
+	if( wasEmpty ) {
+		float radiusSquared = 0.f;
+
+		// The first positions are all inside the box, so the sphere around its centre only needs its radius found
+		for( unsigned int axis = 0; axis < 3; ++axis ) {
+			m_center[axis] = ( m_min[axis] + m_max[axis] ) * 0.5f;
+		}
+
+		for( unsigned int i = 0; i < numPositions; ++i ) {
+			float p[3];
+
+			memcpy( p, positions + i * stride, sizeof( p ) );
+
+			const float offset[3] = { p[0] - m_center[0], p[1] - m_center[1], p[2] - m_center[2] };
+
+			radiusSquared = std::max( radiusSquared, offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2] );
+		}
+
+		m_radius = std::sqrt( radiusSquared );
+		m_empty = false;
+	} else {
+		grow_sphere( positions, numPositions, stride );
+	}
+}
+
+void mesh_bounds::clear() {
+	for( unsigned int axis = 0; axis < 3; ++axis ) {
+		m_min[axis] = m_max[axis] = m_center[axis] = 0.f;
+	}
+
+	m_radius = 0.f;
+	m_empty = true;
+}
+
+const bool mesh_bounds::is_empty() const {
+	return m_empty;
+}
+
+const float* mesh_bounds::get_min() const {
+	return m_min;
+}
+
+const float* mesh_bounds::get_max() const {
+	return m_max;
+}
+
+const float* mesh_bounds::get_center() const {
+	return m_center;
+}
+
+const float mesh_bounds::get_radius() const {
+	return m_radius;
+}
+
+// Private Member Functions
+
+void mesh_bounds::grow_box( const char* positions, const unsigned int numPositions, const std::size_t stride ) {
+	// The fourth lanes are only there so a whole register can be loaded, and are zeroed so nothing uninitialized is read
+	float boxMin[4] = { 0.f, 0.f, 0.f, 0.f }, boxMax[4] = { 0.f, 0.f, 0.f, 0.f };
+	unsigned int i = 0, axis = 0;
+
+	memcpy( boxMin, positions, 3 * sizeof( float ) );
+	memcpy( boxMax, positions, 3 * sizeof( float ) );
+
+#ifdef OCCLUDED_BOUNDS_SSE2
+	__m128 lo = _mm_loadu_ps( boxMin ), hi = lo;
+
+	// A whole register is loaded for each position, so the last one is left to the scalar loop in case nothing follows its z coordinate
+	for( i = 1; i + 1 < numPositions; ++i ) {
+		const __m128 p = _mm_loadu_ps( reinterpret_cast<const float*>( positions + i * stride ) );
+
+		lo = _mm_min_ps( lo, p );
+		hi = _mm_max_ps( hi, p );
+	}
+
+	_mm_storeu_ps( boxMin, lo );
+	_mm_storeu_ps( boxMax, hi );
+#endif
+
+	for( ; i < numPositions; ++i ) {
+		float p[3];
+
+		memcpy( p, positions + i * stride, sizeof( p ) );
+
+		for( axis = 0; axis < 3; ++axis ) {
+			boxMin[axis] = std::min( boxMin[axis], p[axis] );
+			boxMax[axis] = std::max( boxMax[axis], p[axis] );
+		}
+	}
+
+	for( axis = 0; axis < 3; ++axis ) {
+		m_min[axis] = m_empty ? boxMin[axis] : std::min( m_min[axis], boxMin[axis] );
+		m_max[axis] = m_empty ? boxMax[axis] : std::max( m_max[axis], boxMax[axis] );
+	}
+}
+
+void mesh_bounds::grow_sphere( const char* positions, const unsigned int numPositions, const std::size_t stride ) {
+	for( unsigned int i = 0; i < numPositions; ++i ) {
+		float p[3];
+
+		memcpy( p, positions + i * stride, sizeof( p ) );
+
+		const float offset[3] = { p[0] - m_center[0], p[1] - m_center[1], p[2] - m_center[2] };
+		const float distanceSquared = offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2];
+
+		// Most positions are inside the sphere, so the square root is only taken for the ones that grow it
+		if( distanceSquared > m_radius * m_radius ) {
+			const float distance = std::sqrt( distanceSquared );
+			const float grow = ( distance - m_radius ) * 0.5f;
+
+			for( unsigned int axis = 0; axis < 3; ++axis ) {
+				m_center[axis] += offset[axis] / distance * grow;
+			}
+
+			m_radius += grow;
+		}
+	}
+}
+
+} // end of meshes namespace
+} // end of occluded namespace
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+
+namespace occluded { namespace meshes {
+
+/**
+ * \class mesh_bounds
+ * \brief An axis aligned box and a sphere containing every position added to them.
+ *
+ * The bounds are grown as positions are added, so a mesh only has to pass the vertices it has just added rather than every vertex it
+ * contains. The box is found with SSE2 minimum and maximum instructions when they are available. The sphere starts at the centre of the box of
+ * the first positions added and is then grown the way the second pass of Ritter's algorithm grows it, so it is not the smallest sphere
+ * containing the positions but the positions never need to be read again.
+ *
+ * The bounds never shrink, so they still contain vertices that have since been erased or moved.
+ */
+class mesh_bounds
+{
+private:
+	float m_min[3];
+	float m_max[3];
+	float m_center[3];
+	float m_radius;
+	bool m_empty;
+
+public:
+	/**
+	 * \brief Initializes empty bounds.
+	 */
+	mesh_bounds();
+	~mesh_bounds();
+
+	/**
+	 * \fn add_positions
+	 * \brief Grows the bounds to contain positions.
+	 *
+	 * \param positions A pointer to the x, y and z coordinates of the first position.
+	 * \param numPositions An unsigned int representing the number of positions.
+	 * \param stride A std::size_t representing the number of bytes from the start of one position to the start of the next, which must be at
+	 * least 12.
+	 */
+	void add_positions( const char* positions, const unsigned int numPositions, const std::size_t stride );
+
+	/**
+	 * \fn clear
+	 * \brief Makes the bounds empty again.
+	 */
+	void clear();
+
+	/**
+	 * \fn is_empty
+	 * \brief Checks whether any positions have been added to the bounds.
+	 *
+	 * \return Returns true if no positions have been added since the bounds were initialized or cleared, otherwise false.
+	 */
+	const bool is_empty() const;
+
+	/**
+	 * \fn get_min
+	 * \brief Gets the corner of the box with the smallest coordinates.
+	 *
+	 * \return A pointer to the x, y and z coordinates of the corner, which are all 0 if the bounds are empty.
+	 */
+	const float* get_min() const;
+
+	/**
+	 * \fn get_max
+	 * \brief Gets the corner of the box with the largest coordinates.
+	 *
+	 * \return A pointer to the x, y and z coordinates of the corner, which are all 0 if the bounds are empty.
+	 */
+	const float* get_max() const;
+
+	/**
+	 * \fn get_center
+	 * \brief Gets the centre of the sphere.
+	 *
+	 * \return A pointer to the x, y and z coordinates of the centre, which are all 0 if the bounds are empty.
+	 */
+	const float* get_center() const;
+
+	/**
+	 * \fn get_radius
+	 * \brief Gets the radius of the sphere.
+	 *
+	 * \return A float representing the radius, which is 0 if the bounds are empty.
+	 */
+	const float get_radius() const;
+
+private:
+	/**
+	 * \fn grow_box
+	 * \brief Grows the box to contain positions.
+	 */
+	void grow_box( const char* positions, const unsigned int numPositions, const std::size_t stride );
+
+	/**
+	 * \fn grow_sphere
+	 * \brief Grows the sphere to contain positions, moving its centre towards each position outside of it.
+	 */
+	void grow_sphere( const char* positions, const unsigned int numPositions, const std::size_t stride );
+};
+
+} // end of meshes namespace
+} // end of occluded namespace
@@ -0,0 +1,467 @@
+#include "mesh_simplifier.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace occluded { namespace meshes {
+
+const float mesh_simplifier::BORDER_WEIGHT = 10.f;
+const unsigned char mesh_simplifier::VERTEX_INTERIOR = 0;
+const unsigned char mesh_simplifier::VERTEX_BORDER = 1;
+const unsigned char mesh_simplifier::VERTEX_LOCKED = 2;
+
+const mesh_lod mesh_simplifier::simplify( const std::vector<unsigned int>& indices, const std::vector<float>& positions, const unsigned int targetIndexCount,
+	const std::vector<float>& attributes, const std::vector<float>& attributeWeights ) {
+	return simplify_levels( indices, positions, std::vector<unsigned int>( 1, targetIndexCount ), attributes, attributeWeights )[0];
+}
+
+const std::vector<mesh_lod> mesh_simplifier::generate_lod_chain( const std::vector<unsigned int>& indices, const std::vector<float>& positions,
+	const std::vector<float>& ratios, const std::vector<float>& attributes, const std::vector<float>& attributeWeights ) {
+	const unsigned int numTriangles = static_cast<unsigned int>( indices.size() / 3 );
+	std::vector<unsigned int> targetIndexCounts;
+
+	for( unsigned int i = 0; i < ratios.size(); ++i ) {
+		if( !( ratios[i] > 0.f && ratios[i] <= 1.f ) ) {
+			throw std::runtime_error( "mesh_simplifier.generate_lod_chain: Failed to generate levels of detail because ratio(" +
+				boost::lexical_cast<std::string>( ratios[i] ) + ") is not in (0, 1]." );
+		}
+
+		if( i > 0 && ratios[i] > ratios[i - 1] ) {
+			throw std::runtime_error( "mesh_simplifier.generate_lod_chain: Failed to generate levels of detail because the ratios are not in"
+				+ std::string( " decreasing order." ) );
+		}
+
+		targetIndexCounts.push_back( 3 * static_cast<unsigned int>( ratios[i] * static_cast<float>( numTriangles ) ) );
+	}
+
+	return simplify_levels( indices, positions, targetIndexCounts, attributes, attributeWeights );
+}
+
+// private functions
+
+mesh_simplifier::mesh_simplifier()
+{
+}
+
+mesh_simplifier::~mesh_simplifier()
+{
+}
+
+const bool mesh_simplifier::collapse::operator<( const collapse& other ) const {
+	if( error != other.error )
+		return error < other.error;
+
+	// Ties are broken by the vertices, so the collapses chosen do not depend on the sort
+	return vertex != other.vertex ? vertex < other.vertex : target < other.target;
+}
+
+const std::vector<mesh_lod> mesh_simplifier::simplify_levels( const std::vector<unsigned int>& indices, const std::vector<float>& positions,
+	const std::vector<unsigned int>& targetIndexCounts, const std::vector<float>& attributes, const std::vector<float>& attributeWeights ) {
+	if( indices.size() % 3 != 0 ) {
+		throw std::runtime_error( "mesh_simplifier: Failed to simplify indices because the number of indices(" +
+			boost::lexical_cast<std::string>( indices.size() ) + ") is not a multiple of three." );
+	}
+
+	if( positions.size() % 3 != 0 ) {
+		throw std::runtime_error( "mesh_simplifier: Failed to simplify indices because the number of positions(" +
+			boost::lexical_cast<std::string>( positions.size() ) + ") is not a multiple of three." );
+	}
+
+	const unsigned int numVertices = static_cast<unsigned int>( positions.size() / 3 );
+
+	for( std::vector<unsigned int>::const_iterator it = indices.begin(); it != indices.end(); ++it ) {
+		if( *it >= numVertices ) {
+			throw std::runtime_error( "mesh_simplifier: Failed to simplify indices because index(" + boost::lexical_cast<std::string>( *it )
+				+ ") does not correspond to a position." );
+		}
+	}
+
+	if( attributes.size() != numVertices * attributeWeights.size() ) {
+		throw std::runtime_error( "mesh_simplifier: Failed to simplify indices because the number of attribute values(" +
+			boost::lexical_cast<std::string>( attributes.size() ) + ") is not the number of weights for each vertex." );
+	}
+
+	for( std::vector<float>::const_iterator it = attributeWeights.begin(); it != attributeWeights.end(); ++it ) {
+		if( !( *it >= 0.f ) ) {
+			throw std::runtime_error( "mesh_simplifier: Failed to simplify indices because attribute weight(" + boost::lexical_cast<std::string>( *it )
+				+ ") is negative." );
+		}
+	}
+
+	const quadric empty = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+	const attribute_quadric emptyAttribute = { empty, 0.0, 0.0, 0.0, 0.0 };
+	std::vector<quadric> quadrics( numVertices, empty );
+	std::vector<attribute_quadric> attributeQuadrics( numVertices * attributeWeights.size(), emptyAttribute );
+	std::vector<unsigned int> simplified( indices );
+	std::vector<mesh_lod> levels;
+	float maxError = 0.f;
+
+	compute_quadrics( indices, positions, attributes, attributeWeights, quadrics, attributeQuadrics );
+	add_border_quadrics( indices, positions, find_edges( indices ), quadrics );
+
+	for( std::vector<unsigned int>::const_iterator it = targetIndexCounts.begin(); it != targetIndexCounts.end(); ++it ) {
+		mesh_lod level;
+
+		while( simplified.size() > *it && collapse_pass( simplified, positions, attributes, quadrics, attributeQuadrics, *it, maxError ) ) {
+		}
+
+		level.indices = simplified;
+		level.error = std::sqrt( maxError );
+		levels.push_back( level );
+	}
+
+	return levels;
+}
+
+void mesh_simplifier::compute_quadrics( const std::vector<unsigned int>& indices, const std::vector<float>& positions, const std::vector<float>& attributes,
+	const std::vector<float>& attributeWeights, std::vector<quadric>& quadrics, std::vector<attribute_quadric>& attributeQuadrics ) {
+	const std::size_t numAttributes = attributeWeights.size();
+
+	for( unsigned int i = 0; i < indices.size(); i += 3 ) {
+		const float* p0 = &positions[3 * indices[i]];
+		const float* p1 = &positions[3 * indices[i + 1]];
+		const float* p2 = &positions[3 * indices[i + 2]];
+		const double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+		const double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+		double normal[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+		const double length = std::sqrt( normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] );
+
+		// Degenerate triangles have no plane, and their attributes have no gradient
+		if( length == 0.0 )
+			continue;
+
+		const double area = 0.5 * length;
+		normal[0] /= length;
+		normal[1] /= length;
+		normal[2] /= length;
+
+		const double d = -( normal[0] * p0[0] + normal[1] * p0[1] + normal[2] * p0[2] );
+
+		for( unsigned int corner = 0; corner < 3; ++corner ) {
+			quadric& q = quadrics[indices[i + corner]];
+
+			add_plane( q, normal, d, area );
+			q.area += area;
+		}
+
+		// Find the gradient in the plane of the triangle that interpolates each attribute between its vertices
+		const double e11 = e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2];
+		const double e12 = e1[0] * e2[0] + e1[1] * e2[1] + e1[2] * e2[2];
+		const double e22 = e2[0] * e2[0] + e2[1] * e2[1] + e2[2] * e2[2];
+		const double det = e11 * e22 - e12 * e12;
+
+		for( std::size_t k = 0; k < numAttributes; ++k ) {
+			const double a0 = attributes[indices[i] * numAttributes + k];
+			const double da1 = attributes[indices[i + 1] * numAttributes + k] - a0;
+			const double da2 = attributes[indices[i + 2] * numAttributes + k] - a0;
+			const double s = ( e22 * da1 - e12 * da2 ) / det;
+			const double t = ( e11 * da2 - e12 * da1 ) / det;
+			const double gradient[3] = { s * e1[0] + t * e2[0], s * e1[1] + t * e2[1], s * e1[2] + t * e2[2] };
+			const double offset = a0 - ( gradient[0] * p0[0] + gradient[1] * p0[1] + gradient[2] * p0[2] );
+			const double weight = area * attributeWeights[k] * attributeWeights[k];
+
+			for( unsigned int corner = 0; corner < 3; ++corner ) {
+				attribute_quadric& q = attributeQuadrics[indices[i + corner] * numAttributes + k];
+
+				add_plane( q.gradients, gradient, offset, weight );
+				q.gradients.area += weight;
+				q.g0 += weight * gradient[0];
+				q.g1 += weight * gradient[1];
+				q.g2 += weight * gradient[2];
+				q.d += weight * offset;
+			}
+		}
+	}
+}
+
+void mesh_simplifier::add_border_quadrics( const std::vector<unsigned int>& indices, const std::vector<float>& positions,
+	const std::vector<boost::uint64_t>& edges, std::vector<quadric>& quadrics ) {
+	for( unsigned int i = 0; i < indices.size(); i += 3 ) {
+		const float* p0 = &positions[3 * indices[i]];
+		const float* p1 = &positions[3 * indices[i + 1]];
+		const float* p2 = &positions[3 * indices[i + 2]];
+		const double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+		const double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+		const double normal[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+
+		for( unsigned int corner = 0; corner < 3; ++corner ) {
+			const unsigned int first = indices[i + corner], second = indices[i + ( corner + 1 ) % 3];
+
+			if( count_edge( edges, first, second ) != 1 )
+				continue;
+
+			const float* a = &positions[3 * first];
+			const float* b = &positions[3 * second];
+			const double edge[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+			double plane[3] = { edge[1] * normal[2] - edge[2] * normal[1], edge[2] * normal[0] - edge[0] * normal[2], edge[0] * normal[1] - edge[1] * normal[0] };
+			const double length = std::sqrt( plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2] );
+
+			if( length == 0.0 )
+				continue;
+
+			plane[0] /= length;
+			plane[1] /= length;
+			plane[2] /= length;
+
+			// Weighting by the squared length of the edge keeps the border planes in the same units as the area weighted triangle planes
+			const double d = -( plane[0] * a[0] + plane[1] * a[1] + plane[2] * a[2] );
+			const double weight = BORDER_WEIGHT * ( edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2] );
+
+			add_plane( quadrics[first], plane, d, weight );
+			add_plane( quadrics[second], plane, d, weight );
+		}
+	}
+}
+
+const std::vector<boost::uint64_t> mesh_simplifier::find_edges( const std::vector<unsigned int>& indices ) {
+	std::vector<boost::uint64_t> edges;
+
+	edges.reserve( indices.size() );
+
+	for( unsigned int i = 0; i < indices.size(); ++i ) {
+		const boost::uint64_t first = indices[i], second = indices[i - i % 3 + ( i + 1 ) % 3];
+
+		edges.push_back( first < second ? ( first << 32 ) | second : ( second << 32 ) | first );
+	}
+
+	std::sort( edges.begin(), edges.end() );
+
+	return edges;
+}
+
+const unsigned int mesh_simplifier::count_edge( const std::vector<boost::uint64_t>& edges, const unsigned int first, const unsigned int second ) {
+	const boost::uint64_t key = first < second ? ( static_cast<boost::uint64_t>( first ) << 32 ) | second
+		: ( static_cast<boost::uint64_t>( second ) << 32 ) | first;
+
+	return static_cast<unsigned int>( std::upper_bound( edges.begin(), edges.end(), key ) - std::lower_bound( edges.begin(), edges.end(), key ) );
+}
+
+const bool mesh_simplifier::collapse_pass( std::vector<unsigned int>& indices, const std::vector<float>& positions, const std::vector<float>& attributes,
+	std::vector<quadric>& quadrics, std::vector<attribute_quadric>& attributeQuadrics, const unsigned int targetIndexCount, float& maxError ) {
+	const unsigned int numVertices = static_cast<unsigned int>( positions.size() / 3 );
+	const std::vector<boost::uint64_t> edges = find_edges( indices );
+	std::vector<unsigned char> kinds( numVertices, VERTEX_INTERIOR );
+	std::vector<unsigned int> adjacencyOffsets( numVertices + 1, 0 ), adjacency( indices.size() ), remap( numVertices );
+	std::vector<collapse> collapses;
+	std::vector<bool> touched( numVertices, false );
+	unsigned int i = 0, numIndices = static_cast<unsigned int>( indices.size() ), numCollapsed = 0;
+
+	// Edges used by one triangle are borders, and edges used by more than two are not manifold, so their vertices are locked
+	for( i = 0; i < edges.size(); ) {
+		unsigned int count = 1;
+
+		while( i + count < edges.size() && edges[i + count] == edges[i] ) {
+			++count;
+		}
+
+		const unsigned char kind = count == 1 ? VERTEX_BORDER : count > 2 ? VERTEX_LOCKED : VERTEX_INTERIOR;
+		const unsigned int first = static_cast<unsigned int>( edges[i] >> 32 ), second = static_cast<unsigned int>( edges[i] & 0xffffffff );
+
+		kinds[first] = std::max( kinds[first], kind );
+		kinds[second] = std::max( kinds[second], kind );
+		i += count;
+	}
+
+	for( i = 0; i < indices.size(); ++i ) {
+		++adjacencyOffsets[indices[i] + 1];
+	}
+
+	for( i = 0; i < numVertices; ++i ) {
+		adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+	}
+
+	std::vector<unsigned int> nextAdjacent( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+
+	for( i = 0; i < indices.size(); ++i ) {
+		adjacency[nextAdjacent[indices[i]]++] = i / 3;
+	}
+
+	for( i = 0; i < indices.size(); ++i ) {
+		const unsigned int ends[] = { indices[i], indices[i - i % 3 + ( i + 1 ) % 3] };
+
+		for( unsigned int direction = 0; direction < 2; ++direction ) {
+			const unsigned int vertex = ends[direction], target = ends[1 - direction];
+
+			if( kinds[vertex] == VERTEX_LOCKED || ( kinds[vertex] == VERTEX_BORDER && count_edge( edges, vertex, target ) != 1 ) )
+				continue;
+
+			const collapse candidate = { vertex, target, compute_error( positions, attributes, quadrics, attributeQuadrics, vertex, target ) };
+			collapses.push_back( candidate );
+		}
+	}
+
+	if( collapses.empty() )
+		return false;
+
+	std::sort( collapses.begin(), collapses.end() );
+
+	// Only the cheapest collapses are done in a pass, since cheaper ones may become possible once the vertices they touch are free again
+	const float errorLimit = collapses[collapses.size() / 6].error;
+
+	for( i = 0; i < numVertices; ++i ) {
+		remap[i] = i;
+	}
+
+	for( std::vector<collapse>::const_iterator it = collapses.begin(); it != collapses.end() && numIndices > targetIndexCount; ++it ) {
+		if( numCollapsed > 0 && it->error > errorLimit )
+			break;
+
+		if( touched[it->vertex] || touched[it->target] || flips_triangle( indices, positions, adjacencyOffsets, adjacency, it->vertex, it->target ) )
+			continue;
+
+		// The triangles around the vertex cannot change until the next pass, so later collapses in this pass are checked against them as they are
+		for( unsigned int j = adjacencyOffsets[it->vertex]; j < adjacencyOffsets[it->vertex + 1]; ++j ) {
+			const unsigned int triangle = adjacency[j];
+
+			if( indices[3 * triangle] == it->target || indices[3 * triangle + 1] == it->target || indices[3 * triangle + 2] == it->target )
+				numIndices -= 3;
+
+			touched[indices[3 * triangle]] = true;
+			touched[indices[3 * triangle + 1]] = true;
+			touched[indices[3 * triangle + 2]] = true;
+		}
+
+		add_quadric( quadrics[it->target], quadrics[it->vertex] );
+
+		for( std::size_t k = 0; k < attributeQuadrics.size() / numVertices; ++k ) {
+			attribute_quadric& target = attributeQuadrics[it->target * ( attributeQuadrics.size() / numVertices ) + k];
+			const attribute_quadric& vertex = attributeQuadrics[it->vertex * ( attributeQuadrics.size() / numVertices ) + k];
+
+			add_quadric( target.gradients, vertex.gradients );
+			target.g0 += vertex.g0;
+			target.g1 += vertex.g1;
+			target.g2 += vertex.g2;
+			target.d += vertex.d;
+		}
+
+		remap[it->vertex] = it->target;
+		maxError = std::max( maxError, it->error );
+		++numCollapsed;
+	}
+
+	if( numCollapsed == 0 )
+		return false;
+
+	std::vector<unsigned int> simplified;
+	simplified.reserve( numIndices );
+
+	// A vertex that was collapsed was never the target of another collapse in the same pass, so a single lookup finds its new index
+	for( i = 0; i < indices.size(); i += 3 ) {
+		const unsigned int a = remap[indices[i]], b = remap[indices[i + 1]], c = remap[indices[i + 2]];
+
+		if( a != b && b != c && a != c ) {
+			simplified.push_back( a );
+			simplified.push_back( b );
+			simplified.push_back( c );
+		}
+	}
+
+	indices.swap( simplified );
+
+	return true;
+}
+
+const bool mesh_simplifier::flips_triangle( const std::vector<unsigned int>& indices, const std::vector<float>& positions,
+	const std::vector<unsigned int>& adjacencyOffsets, const std::vector<unsigned int>& adjacency, const unsigned int vertex, const unsigned int target ) {
+	for( unsigned int i = adjacencyOffsets[vertex]; i < adjacencyOffsets[vertex + 1]; ++i ) {
+		const unsigned int* triangle = &indices[3 * adjacency[i]];
+
+		// Triangles that use the edge are removed by the collapse
+		if( triangle[0] == target || triangle[1] == target || triangle[2] == target )
+			continue;
+
+		const float* before[3], * after[3];
+
+		for( unsigned int corner = 0; corner < 3; ++corner ) {
+			before[corner] = &positions[3 * triangle[corner]];
+			after[corner] = triangle[corner] == vertex ? &positions[3 * target] : before[corner];
+		}
+
+		double normals[2][3];
+
+		for( unsigned int j = 0; j < 2; ++j ) {
+			const float** p = j == 0 ? before : after;
+			const double e1[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+			const double e2[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+
+			normals[j][0] = e1[1] * e2[2] - e1[2] * e2[1];
+			normals[j][1] = e1[2] * e2[0] - e1[0] * e2[2];
+			normals[j][2] = e1[0] * e2[1] - e1[1] * e2[0];
+		}
+
+		// A triangle that becomes degenerate also has a dot product of 0
+		if( normals[0][0] * normals[1][0] + normals[0][1] * normals[1][1] + normals[0][2] * normals[1][2] <= 0.0 )
+			return true;
+	}
+
+	return false;
+}
+
+void mesh_simplifier::add_plane( quadric& q, const double* normal, const double d, const double weight ) {
+	q.a00 += weight * normal[0] * normal[0];
+	q.a01 += weight * normal[0] * normal[1];
+	q.a02 += weight * normal[0] * normal[2];
+	q.a11 += weight * normal[1] * normal[1];
+	q.a12 += weight * normal[1] * normal[2];
+	q.a22 += weight * normal[2] * normal[2];
+	q.b0 += weight * d * normal[0];
+	q.b1 += weight * d * normal[1];
+	q.b2 += weight * d * normal[2];
+	q.c += weight * d * d;
+}
+
+void mesh_simplifier::add_quadric( quadric& q, const quadric& other ) {
+	q.a00 += other.a00;
+	q.a01 += other.a01;
+	q.a02 += other.a02;
+	q.a11 += other.a11;
+	q.a12 += other.a12;
+	q.a22 += other.a22;
+	q.b0 += other.b0;
+	q.b1 += other.b1;
+	q.b2 += other.b2;
+	q.c += other.c;
+	q.area += other.area;
+}
+
+const double mesh_simplifier::evaluate( const quadric& q, const float* position ) {
+	const double x = position[0], y = position[1], z = position[2];
+
+	return q.a00 * x * x + 2.0 * q.a01 * x * y + 2.0 * q.a02 * x * z + q.a11 * y * y + 2.0 * q.a12 * y * z + q.a22 * z * z
+		+ 2.0 * ( q.b0 * x + q.b1 * y + q.b2 * z ) + q.c;
+}
+
+const float mesh_simplifier::compute_error( const std::vector<float>& positions, const std::vector<float>& attributes, const std::vector<quadric>& quadrics,
+	const std::vector<attribute_quadric>& attributeQuadrics, const unsigned int vertex, const unsigned int target ) {
+	const std::size_t numAttributes = attributeQuadrics.size() / quadrics.size();
+	const float* position = &positions[3 * target];
+	quadric q = quadrics[vertex];
+
+	add_quadric( q, quadrics[target] );
+
+	double error = evaluate( q, position );
+
+	for( std::size_t k = 0; k < numAttributes; ++k ) {
+		const attribute_quadric& first = attributeQuadrics[vertex * numAttributes + k];
+		const attribute_quadric& second = attributeQuadrics[target * numAttributes + k];
+		const double value = attributes[target * numAttributes + k];
+		quadric gradients = first.gradients;
+
+		add_quadric( gradients, second.gradients );
+
+		// Expands the sum of weight * ( g.p + d - value )^2 over the triangles of both vertices
+		const double interpolated = ( first.g0 + second.g0 ) * position[0] + ( first.g1 + second.g1 ) * position[1]
+			+ ( first.g2 + second.g2 ) * position[2] + first.d + second.d;
+
+		error += evaluate( gradients, position ) - 2.0 * value * interpolated + value * value * gradients.area;
+	}
+
+	// The quadrics are area weighted, so dividing by the area gives the average squared distance
+	if( q.area > 0.0 )
+		error /= q.area;
+
+	return static_cast<float>( std::max( error, 0.0 ) );
+}
+
+} // end of meshes namespace
+} // end of occluded namespace
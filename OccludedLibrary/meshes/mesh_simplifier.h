@@ -0,0 +1,213 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/cstdint.hpp>
+
+namespace occluded { namespace meshes {
+
+/**
+ * \struct mesh_lod
+ * \brief A level of detail of a triangle list.
+ */
+struct mesh_lod {
+	/**
+	 * Three indices for each triangle of the level, which refer to the same vertices as the triangle list it was generated from.
+	 */
+	std::vector<unsigned int> indices;
+
+	/**
+	 * An estimate of the largest distance between the level and the original surface, in the units of the positions. If attributes were
+	 * weighted, their weighted difference is included.
+	 */
+	float error;
+};
+
+/**
+ * \class mesh_simplifier
+ * \brief Reduces the number of triangles of a triangle list using quadric error metrics.
+ *
+ * Simplifies by collapsing edges onto one of their vertices (Garland and Heckbert, "Surface Simplification Using Quadric Error Metrics"), so
+ * no vertices are created and every level of detail can be drawn from the original vertex buffer. Each vertex accumulates the area weighted
+ * planes of the triangles around it, and optionally the area weighted gradients of float attributes across those triangles (Hoppe, "New
+ * Quadric Metric for Simplifying Meshes with Appearance Attributes"), so collapses that change the shading are avoided as well.
+ *
+ * Edges used by a single triangle are borders. A vertex on a border only collapses along a border edge, and heavily weighted planes
+ * perpendicular to the border are added to the quadrics of its vertices, so the outline of open meshes and holes only changes shape once
+ * nothing cheaper is left to reach the target. Vertices on edges used by
+ * more than two triangles are never moved. Vertices that share a position but not their attributes are separate in the triangle list, so
+ * the seams between them are kept as borders.
+ *
+ * Collapses are done in passes. Each pass chooses the cheapest collapses that do not touch the triangles around one another, rejecting any
+ * that would flip a triangle, until the target is reached or no collapse is possible.
+ */
+class mesh_simplifier
+{
+public:
+	/**
+	 * \fn simplify
+	 * \brief Simplifies a triangle list to a number of indices.
+	 *
+	 * \param indices A reference to a vector of unsigned ints containing three indices for each triangle.
+	 * \param positions A reference to a vector of floats containing the x, y and z coordinates of every vertex.
+	 * \param targetIndexCount An unsigned int representing the number of indices to stop at, which is not reached if the error would
+	 * require moving a border or flipping a triangle.
+	 * \param attributes A reference to a vector of floats containing attributeWeights.size() values for each vertex.
+	 * \param attributeWeights A reference to a vector of floats containing how much a difference in each attribute value counts compared to
+	 * a difference in position.
+	 * \return The simplified triangle list and its error.
+	 *
+	 * An exception is thrown if the number of indices or positions is not a multiple of three, an index does not correspond to a position,
+	 * the number of attributes is not the number of weights for each vertex, or a weight is negative.
+	 */
+	static const mesh_lod simplify( const std::vector<unsigned int>& indices, const std::vector<float>& positions, const unsigned int targetIndexCount,
+		const std::vector<float>& attributes = std::vector<float>(), const std::vector<float>& attributeWeights = std::vector<float>() );
+
+	/**
+	 * \fn generate_lod_chain
+	 * \brief Simplifies a triangle list to a chain of levels of detail.
+	 *
+	 * \param indices A reference to a vector of unsigned ints containing three indices for each triangle.
+	 * \param positions A reference to a vector of floats containing the x, y and z coordinates of every vertex.
+	 * \param ratios A reference to a vector of floats containing the fraction of the triangles to keep at each level, in decreasing order.
+	 * \param attributes A reference to a vector of floats containing attributeWeights.size() values for each vertex.
+	 * \param attributeWeights A reference to a vector of floats containing how much a difference in each attribute value counts compared to
+	 * a difference in position.
+	 * \return A vector containing a level for each ratio.
+	 *
+	 * Each level is simplified from the one before it, so the chain costs about as much as simplifying to the last level and the error of the
+	 * levels never decreases. An exception is thrown for the same reasons as simplify, or if a ratio is not in (0, 1] or the ratios are not
+	 * in decreasing order.
+	 */
+	static const std::vector<mesh_lod> generate_lod_chain( const std::vector<unsigned int>& indices, const std::vector<float>& positions,
+		const std::vector<float>& ratios, const std::vector<float>& attributes = std::vector<float>(),
+		const std::vector<float>& attributeWeights = std::vector<float>() );
+
+private:
+	/**
+	 * \struct quadric
+	 * \brief The sum of squared distances to a set of weighted planes, stored as the symmetric matrix A, the vector b and the constant c of
+	 * p^T A p + 2 b^T p + c.
+	 */
+	struct quadric {
+		double a00, a01, a02, a11, a12, a22;
+		double b0, b1, b2;
+		double c;
+
+		/**
+		 * The area of the triangles that were added, which the error is divided by.
+		 */
+		double area;
+	};
+
+	/**
+	 * \struct attribute_quadric
+	 * \brief The sum of squared differences between an attribute value and the linear functions g.p + d that interpolate it across triangles.
+	 *
+	 * The squared terms of ( g.p + d - a )^2 are stored in gradients, and the terms multiplied by the attribute value are stored in g0 to d.
+	 */
+	struct attribute_quadric {
+		quadric gradients;
+		double g0, g1, g2, d;
+	};
+
+	/**
+	 * \struct collapse
+	 * \brief A collapse of the edge from vertex to target onto target.
+	 */
+	struct collapse {
+		unsigned int vertex;
+		unsigned int target;
+		float error;
+
+		const bool operator<( const collapse& other ) const;
+	};
+
+	static const float BORDER_WEIGHT;
+	static const unsigned char VERTEX_INTERIOR;
+	static const unsigned char VERTEX_BORDER;
+	static const unsigned char VERTEX_LOCKED;
+
+	mesh_simplifier();
+	~mesh_simplifier();
+
+	/**
+	 * \fn simplify_levels
+	 * \brief Simplifies a triangle list to each target index count in turn, after checking the parameters.
+	 */
+	static const std::vector<mesh_lod> simplify_levels( const std::vector<unsigned int>& indices, const std::vector<float>& positions,
+		const std::vector<unsigned int>& targetIndexCounts, const std::vector<float>& attributes, const std::vector<float>& attributeWeights );
+
+	/**
+	 * \fn compute_quadrics
+	 * \brief Adds the plane and attribute gradients of every triangle to the quadrics of its vertices.
+	 */
+	static void compute_quadrics( const std::vector<unsigned int>& indices, const std::vector<float>& positions, const std::vector<float>& attributes,
+		const std::vector<float>& attributeWeights, std::vector<quadric>& quadrics, std::vector<attribute_quadric>& attributeQuadrics );
+
+	/**
+	 * \fn add_border_quadrics
+	 * \brief Adds a plane perpendicular to each border edge to the quadrics of the vertices of the edge.
+	 */
+	static void add_border_quadrics( const std::vector<unsigned int>& indices, const std::vector<float>& positions,
+		const std::vector<boost::uint64_t>& edges, std::vector<quadric>& quadrics );
+
+	/**
+	 * \fn find_edges
+	 * \brief Finds every edge of the triangles as a sorted vector, with an edge appearing once for each triangle that uses it.
+	 */
+	static const std::vector<boost::uint64_t> find_edges( const std::vector<unsigned int>& indices );
+
+	/**
+	 * \fn count_edge
+	 * \brief Counts the number of triangles that use an edge.
+	 */
+	static const unsigned int count_edge( const std::vector<boost::uint64_t>& edges, const unsigned int first, const unsigned int second );
+
+	/**
+	 * \fn collapse_pass
+	 * \brief Performs the cheapest collapses that do not conflict with one another.
+	 *
+	 * Returns false if no collapse could be performed.
+	 */
+	static const bool collapse_pass( std::vector<unsigned int>& indices, const std::vector<float>& positions, const std::vector<float>& attributes,
+		std::vector<quadric>& quadrics, std::vector<attribute_quadric>& attributeQuadrics, const unsigned int targetIndexCount, float& maxError );
+
+	/**
+	 * \fn flips_triangle
+	 * \brief Checks whether moving a vertex to the position of target flips any triangle around it that does not use target.
+	 */
+	static const bool flips_triangle( const std::vector<unsigned int>& indices, const std::vector<float>& positions,
+		const std::vector<unsigned int>& adjacencyOffsets, const std::vector<unsigned int>& adjacency, const unsigned int vertex, const unsigned int target );
+
+	/**
+	 * \fn add_plane
+	 * \brief Adds the plane n.p + d = 0 to a quadric with a weight.
+	 */
+	static void add_plane( quadric& q, const double* normal, const double d, const double weight );
+
+	/**
+	 * \fn add_quadric
+	 * \brief Adds the terms of one quadric to another.
+	 */
+	static void add_quadric( quadric& q, const quadric& other );
+
+	/**
+	 * \fn evaluate
+	 * \brief Evaluates a quadric at a position.
+	 */
+	static const double evaluate( const quadric& q, const float* position );
+
+	/**
+	 * \fn compute_error
+	 * \brief Computes the error of collapsing a vertex onto target.
+	 */
+	static const float compute_error( const std::vector<float>& positions, const std::vector<float>& attributes, const std::vector<quadric>& quadrics,
+		const std::vector<attribute_quadric>& attributeQuadrics, const unsigned int vertex, const unsigned int target );
+};
+
+} // end of meshes namespace
+} // end of occluded namespace
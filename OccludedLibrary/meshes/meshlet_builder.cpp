@@ -0,0 +1,290 @@
+#include "meshlet_builder.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace occluded { namespace meshes {
+
+const unsigned int meshlet_builder::DEFAULT_MAX_VERTICES = 64;
+const unsigned int meshlet_builder::DEFAULT_MAX_TRIANGLES = 124;
+const unsigned int meshlet_builder::NO_VERTEX = 0xffffffff;
+
+const meshlet_table meshlet_builder::build( const std::vector<unsigned int>& indices, const std::vector<float>& positions, const unsigned int maxVertices,
+	const unsigned int maxTriangles ) {
+	if( indices.size() % 3 != 0 ) {
+		throw std::runtime_error( "meshlet_builder.build: Failed to build meshlets because the number of indices(" +
+			boost::lexical_cast<std::string>( indices.size() ) + ") is not a multiple of three." );
+	}
+
+	if( positions.size() % 3 != 0 ) {
+		throw std::runtime_error( "meshlet_builder.build: Failed to build meshlets because the number of positions(" +
+			boost::lexical_cast<std::string>( positions.size() ) + ") is not a multiple of three." );
+	}
+
+	if( maxVertices < 3 || maxVertices > 256 || maxTriangles < 1 ) {
+		throw std::runtime_error( "meshlet_builder.build: Failed to build meshlets because the limits of " + boost::lexical_cast<std::string>( maxVertices )
+			+ " vertices and " + boost::lexical_cast<std::string>( maxTriangles ) + " triangles are not valid." );
+	}
+
+	const unsigned int numVertices = static_cast<unsigned int>( positions.size() / 3 );
+	const unsigned int numTriangles = static_cast<unsigned int>( indices.size() / 3 );
+	unsigned int i = 0, cursor = 0;
+
+	for( i = 0; i < indices.size(); ++i ) {
+		if( indices[i] >= numVertices ) {
+			throw std::runtime_error( "meshlet_builder.build: Failed to build meshlets because index(" + boost::lexical_cast<std::string>( indices[i] )
+				+ ") does not correspond to a position." );
+		}
+	}
+
+	std::vector<unsigned int> adjacencyOffsets( numVertices + 1, 0 ), adjacency( indices.size() ), localIndices( numVertices, NO_VERTEX );
+	std::vector<bool> emitted( numTriangles, false );
+	meshlet_table table;
+
+	// Store the triangles that use each vertex in a single array, with the triangles of each vertex starting at its adjacency offset
+	for( i = 0; i < indices.size(); ++i ) {
+		++adjacencyOffsets[indices[i] + 1];
+	}
+
+	for( i = 0; i < numVertices; ++i ) {
+		adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+	}
+
+	std::vector<unsigned int> nextAdjacent( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+
+	for( i = 0; i < indices.size(); ++i ) {
+		adjacency[nextAdjacent[indices[i]]++] = i / 3;
+	}
+
+	while( true ) {
+		while( cursor < numTriangles && emitted[cursor] ) {
+			++cursor;
+		}
+
+		if( cursor == numTriangles )
+			break;
+
+		meshlet current = meshlet();
+		unsigned int triangle = cursor;
+
+		current.vertexOffset = static_cast<unsigned int>( table.vertices.size() );
+		current.triangleOffset = static_cast<unsigned int>( table.indices.size() / 3 );
+
+		while( triangle != NO_VERTEX ) {
+			for( unsigned int corner = 0; corner < 3; ++corner ) {
+				const unsigned int vertex = indices[3 * triangle + corner];
+
+				if( localIndices[vertex] == NO_VERTEX ) {
+					localIndices[vertex] = current.vertexCount++;
+					table.vertices.push_back( vertex );
+				}
+
+				table.triangles.push_back( static_cast<unsigned char>( localIndices[vertex] ) );
+				table.indices.push_back( vertex );
+			}
+
+			emitted[triangle] = true;
+			triangle = NO_VERTEX;
+
+			if( ++current.triangleCount == maxTriangles )
+				break;
+
+			unsigned int bestNew = 4;
+
+			// Find the neighbouring triangle that needs the fewest new vertices, preferring the earliest one in the list
+			for( i = current.vertexOffset; i < table.vertices.size(); ++i ) {
+				const unsigned int vertex = table.vertices[i];
+
+				for( unsigned int j = adjacencyOffsets[vertex]; j < adjacencyOffsets[vertex + 1]; ++j ) {
+					const unsigned int candidate = adjacency[j];
+
+					if( emitted[candidate] )
+						continue;
+
+					const unsigned int numNew = ( localIndices[indices[3 * candidate]] == NO_VERTEX ? 1 : 0 )
+						+ ( localIndices[indices[3 * candidate + 1]] == NO_VERTEX ? 1 : 0 ) + ( localIndices[indices[3 * candidate + 2]] == NO_VERTEX ? 1 : 0 );
+
+					if( current.vertexCount + numNew <= maxVertices && ( numNew < bestNew || ( numNew == bestNew && candidate < triangle ) ) ) {
+						triangle = candidate;
+						bestNew = numNew;
+					}
+				}
+			}
+
+			// Fill the rest of the meshlet from the list once there are no neighbours that fit
+			if( triangle == NO_VERTEX && current.vertexCount + 3 <= maxVertices ) {
+				while( cursor < numTriangles && emitted[cursor] ) {
+					++cursor;
+				}
+
+				if( cursor < numTriangles )
+					triangle = cursor;
+			}
+		}
+
+		for( i = current.vertexOffset; i < table.vertices.size(); ++i ) {
+			localIndices[table.vertices[i]] = NO_VERTEX;
+		}
+
+		table.meshlets.push_back( current );
+		compute_bounds( table, positions );
+	}
+
+	return table;
+}
+
+const bool meshlet_builder::is_backfacing( const meshlet& cluster, const float* cameraPosition ) {
+	const float direction[3] = { cluster.coneApex[0] - cameraPosition[0], cluster.coneApex[1] - cameraPosition[1], cluster.coneApex[2] - cameraPosition[2] };
+	const float length = std::sqrt( direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2] );
+
+	// Every triangle faces away if the direction from the camera to the apex is within the complement of the cone's angle of its axis
+	return length > 0.f && direction[0] * cluster.coneAxis[0] + direction[1] * cluster.coneAxis[1] + direction[2] * cluster.coneAxis[2]
+		>= cluster.coneCutoff * length;
+}
+
+// private functions
+
+meshlet_builder::meshlet_builder()
+{
+}
+
+meshlet_builder::~meshlet_builder()
+{
+}
+
+void meshlet_builder::compute_bounds( meshlet_table& table, const std::vector<float>& positions ) {
+	meshlet& current = table.meshlets.back();
+	const unsigned int* vertices = &table.vertices[current.vertexOffset];
+	const unsigned int* indices = &table.indices[3 * current.triangleOffset];
+	unsigned int i = 0, axis = 0, farthest = 0;
+	float distance = 0.f;
+
+	for( axis = 0; axis < 3; ++axis ) {
+		current.boundsMin[axis] = current.boundsMax[axis] = positions[3 * vertices[0] + axis];
+	}
+
+	for( i = 1; i < current.vertexCount; ++i ) {
+		for( axis = 0; axis < 3; ++axis ) {
+			current.boundsMin[axis] = std::min( current.boundsMin[axis], positions[3 * vertices[i] + axis] );
+			current.boundsMax[axis] = std::max( current.boundsMax[axis], positions[3 * vertices[i] + axis] );
+		}
+	}
+
+	// Ritter's bounding sphere: start with the two vertices found by walking to the farthest vertex twice, then grow to fit the rest
+	for( unsigned int pass = 0; pass < 2; ++pass ) {
+		const float* from = &positions[3 * vertices[farthest]];
+
+		distance = -1.f;
+
+		for( i = 0; i < current.vertexCount; ++i ) {
+			const float* p = &positions[3 * vertices[i]];
+			const float d = ( p[0] - from[0] ) * ( p[0] - from[0] ) + ( p[1] - from[1] ) * ( p[1] - from[1] ) + ( p[2] - from[2] ) * ( p[2] - from[2] );
+
+			if( d > distance ) {
+				distance = d;
+
+				if( pass == 0 )
+					farthest = i;
+				else {
+					for( axis = 0; axis < 3; ++axis ) {
+						current.center[axis] = ( p[axis] + from[axis] ) * 0.5f;
+					}
+				}
+			}
+		}
+	}
+
+	current.radius = std::sqrt( distance ) * 0.5f;
+
+	for( i = 0; i < current.vertexCount; ++i ) {
+		const float* p = &positions[3 * vertices[i]];
+		const float offset[3] = { p[0] - current.center[0], p[1] - current.center[1], p[2] - current.center[2] };
+		const float d = std::sqrt( offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2] );
+
+		if( d > current.radius ) {
+			const float grow = ( d - current.radius ) * 0.5f;
+
+			for( axis = 0; axis < 3; ++axis ) {
+				current.center[axis] += offset[axis] / d * grow;
+			}
+
+			current.radius += grow;
+		}
+	}
+
+	std::vector<float> normals( 3 * current.triangleCount, 0.f );
+	float coneAxis[3] = { 0.f, 0.f, 0.f };
+
+	for( i = 0; i < current.triangleCount; ++i ) {
+		const float* p0 = &positions[3 * indices[3 * i]];
+		const float* p1 = &positions[3 * indices[3 * i + 1]];
+		const float* p2 = &positions[3 * indices[3 * i + 2]];
+		const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+		const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+		float* normal = &normals[3 * i];
+
+		normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+		normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+		normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+
+		const float length = std::sqrt( normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] );
+
+		// Degenerate triangles are never drawn, so they do not widen the cone
+		if( length == 0.f )
+			continue;
+
+		for( axis = 0; axis < 3; ++axis ) {
+			normal[axis] /= length;
+			coneAxis[axis] += normal[axis];
+		}
+	}
+
+	const float axisLength = std::sqrt( coneAxis[0] * coneAxis[0] + coneAxis[1] * coneAxis[1] + coneAxis[2] * coneAxis[2] );
+	float minDot = 1.f, maxOffset = 0.f;
+
+	for( axis = 0; axis < 3; ++axis ) {
+		current.coneApex[axis] = current.center[axis];
+		current.coneAxis[axis] = 0.f;
+		coneAxis[axis] = axisLength > 0.f ? coneAxis[axis] / axisLength : 0.f;
+	}
+
+	current.coneCutoff = 1.f;
+
+	if( axisLength == 0.f )
+		return;
+
+	for( i = 0; i < current.triangleCount; ++i ) {
+		const float* normal = &normals[3 * i];
+
+		if( normal[0] != 0.f || normal[1] != 0.f || normal[2] != 0.f )
+			minDot = std::min( minDot, normal[0] * coneAxis[0] + normal[1] * coneAxis[1] + normal[2] * coneAxis[2] );
+	}
+
+	// A cone wider than a hemisphere always contains a direction facing the camera
+	if( minDot <= 0.f )
+		return;
+
+	// Move the apex back along the axis until every triangle's plane is in front of it, so the test holds for perspective cameras
+	for( i = 0; i < current.triangleCount; ++i ) {
+		const float* normal = &normals[3 * i];
+		const float* corner = &positions[3 * indices[3 * i]];
+		const float dn = normal[0] * coneAxis[0] + normal[1] * coneAxis[1] + normal[2] * coneAxis[2];
+
+		if( dn <= 0.f )
+			continue;
+
+		const float dc = ( current.center[0] - corner[0] ) * normal[0] + ( current.center[1] - corner[1] ) * normal[1] + ( current.center[2] - corner[2] ) * normal[2];
+
+		maxOffset = std::max( maxOffset, dc / dn );
+	}
+
+	for( axis = 0; axis < 3; ++axis ) {
+		current.coneApex[axis] = current.center[axis] - coneAxis[axis] * maxOffset;
+		current.coneAxis[axis] = coneAxis[axis];
+	}
+
+	current.coneCutoff = std::sqrt( 1.f - minDot * minDot );
+}
+
+} // end of meshes namespace
+} // end of occluded namespace
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+#include <boost/lexical_cast.hpp>
+
+namespace occluded { namespace meshes {
+
+/**
+ * \struct meshlet
+ * \brief A small cluster of the triangles of a mesh, with the bounds used to cull it.
+ */
+struct meshlet {
+	/**
+	 * The position of the first vertex of the meshlet in meshlet_table::vertices.
+	 */
+	unsigned int vertexOffset;
+
+	/**
+	 * The number of vertices used by the meshlet.
+	 */
+	unsigned int vertexCount;
+
+	/**
+	 * The position of the first triangle of the meshlet in meshlet_table::triangles and meshlet_table::indices, counted in triangles.
+	 */
+	unsigned int triangleOffset;
+
+	/**
+	 * The number of triangles in the meshlet.
+	 */
+	unsigned int triangleCount;
+
+	/**
+	 * The centre and radius of a sphere containing the vertices of the meshlet.
+	 */
+	float center[3];
+	float radius;
+
+	/**
+	 * The corners of the axis aligned box containing the vertices of the meshlet.
+	 */
+	float boundsMin[3];
+	float boundsMax[3];
+
+	/**
+	 * The apex, axis and cutoff of the cone containing the normals of the triangles, which are used by meshlet_builder::is_backfacing. The axis
+	 * is 0 and the cutoff is 1 if the triangles face too many directions for the meshlet to ever be backfacing.
+	 */
+	float coneApex[3];
+	float coneAxis[3];
+	float coneCutoff;
+};
+
+/**
+ * \struct meshlet_table
+ * \brief The meshlets of a mesh.
+ */
+struct meshlet_table {
+	/**
+	 * The meshlets.
+	 */
+	std::vector<meshlet> meshlets;
+
+	/**
+	 * The indices of the vertices of each meshlet in the mesh.
+	 */
+	std::vector<unsigned int> vertices;
+
+	/**
+	 * Three indices for each triangle of each meshlet, which refer to the vertices of the meshlet rather than the mesh.
+	 */
+	std::vector<unsigned char> triangles;
+
+	/**
+	 * Three indices for each triangle of each meshlet, which refer to the vertices of the mesh, so the triangles of a meshlet can be drawn
+	 * as a range of an index buffer.
+	 */
+	std::vector<unsigned int> indices;
+};
+
+/**
+ * \class meshlet_builder
+ * \brief Splits triangle lists into meshlets that can be culled separately.
+ *
+ * Builds each meshlet greedily, starting from the first triangle that is not yet in a meshlet and repeatedly adding the triangle next to
+ * the meshlet that needs the fewest new vertices. When no neighbouring triangle fits, the next triangle in the list is added instead, so
+ * small disconnected pieces share meshlets rather than each getting their own. Triangle lists ordered by vertex_cache_optimizer give the most
+ * compact meshlets.
+ */
+class meshlet_builder
+{
+public:
+	/**
+	 * The largest number of vertices in a meshlet used when none is passed to build.
+	 */
+	static const unsigned int DEFAULT_MAX_VERTICES;
+
+	/**
+	 * The largest number of triangles in a meshlet used when none is passed to build.
+	 */
+	static const unsigned int DEFAULT_MAX_TRIANGLES;
+
+	/**
+	 * \fn build
+	 * \brief Splits a triangle list into meshlets and computes their bounds.
+	 *
+	 * \param indices A reference to a vector of unsigned ints containing three indices for each triangle.
+	 * \param positions A reference to a vector of floats containing the x, y and z coordinates of every vertex.
+	 * \param maxVertices An unsigned int representing the largest number of vertices in a meshlet, which must be between 3 and 256.
+	 * \param maxTriangles An unsigned int representing the largest number of triangles in a meshlet, which must be at least 1.
+	 * \return The meshlets, which contain every triangle once with its winding kept.
+	 *
+	 * An exception is thrown if the number of indices or positions is not a multiple of three, an index does not correspond to a position or
+	 * a limit is not valid.
+	 */
+	static const meshlet_table build( const std::vector<unsigned int>& indices, const std::vector<float>& positions,
+		const unsigned int maxVertices = DEFAULT_MAX_VERTICES, const unsigned int maxTriangles = DEFAULT_MAX_TRIANGLES );
+
+	/**
+	 * \fn is_backfacing
+	 * \brief Checks whether every triangle of a meshlet faces away from a camera.
+	 *
+	 * \param cluster A reference to the meshlet.
+	 * \param cameraPosition A pointer to the x, y and z coordinates of the camera, in the same space as the positions of the meshlet.
+	 * \return Returns true if none of the triangles of the meshlet can be seen from the camera with back face culling enabled.
+	 */
+	static const bool is_backfacing( const meshlet& cluster, const float* cameraPosition );
+
+private:
+	static const unsigned int NO_VERTEX;
+
+	meshlet_builder();
+	~meshlet_builder();
+
+	/**
+	 * \fn compute_bounds
+	 * \brief Computes the bounding sphere, box and normal cone of the last meshlet in the table.
+	 */
+	static void compute_bounds( meshlet_table& table, const std::vector<float>& positions );
+};
+
+} // end of meshes namespace
+} // end of occluded namespace
@@ -0,0 +1,179 @@
+#include "overdraw_optimizer.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace occluded { namespace meshes {
+
+const float overdraw_optimizer::DEFAULT_THRESHOLD = 1.05f;
+
+void overdraw_optimizer::optimize_overdraw( std::vector<unsigned int>& indices, const std::vector<float>& positions, const unsigned int cacheSize,
+	const float threshold ) {
+	if( indices.size() % 3 != 0 ) {
+		throw std::runtime_error( "overdraw_optimizer.optimize_overdraw: Failed to optimize indices because the number of indices(" +
+			boost::lexical_cast<std::string>( indices.size() ) + ") is not a multiple of three." );
+	}
+
+	if( positions.size() % 3 != 0 ) {
+		throw std::runtime_error( "overdraw_optimizer.optimize_overdraw: Failed to optimize indices because the number of positions(" +
+			boost::lexical_cast<std::string>( positions.size() ) + ") is not a multiple of three." );
+	}
+
+	if( cacheSize < 3 ) {
+		throw std::runtime_error( "overdraw_optimizer.optimize_overdraw: Failed to optimize indices because the cache size(" +
+			boost::lexical_cast<std::string>( cacheSize ) + ") is less than three." );
+	}
+
+	if( !( threshold >= 1.f ) ) {
+		throw std::runtime_error( "overdraw_optimizer.optimize_overdraw: Failed to optimize indices because the threshold(" +
+			boost::lexical_cast<std::string>( threshold ) + ") is less than 1." );
+	}
+
+	const unsigned int numVertices = static_cast<unsigned int>( positions.size() / 3 );
+
+	for( std::vector<unsigned int>::const_iterator it = indices.begin(); it != indices.end(); ++it ) {
+		if( *it >= numVertices ) {
+			throw std::runtime_error( "overdraw_optimizer.optimize_overdraw: Failed to optimize indices because index(" +
+				boost::lexical_cast<std::string>( *it ) + ") does not correspond to a position." );
+		}
+	}
+
+	if( indices.empty() )
+		return;
+
+	const std::vector<unsigned int> clusters = find_clusters( indices, numVertices, cacheSize, threshold );
+	const std::vector<float> keys = compute_sort_keys( indices, positions, clusters );
+	const unsigned int numClusters = static_cast<unsigned int>( clusters.size() - 1 );
+	std::vector< std::pair<float, unsigned int> > order( numClusters );
+	std::vector<unsigned int> sorted;
+	unsigned int i = 0;
+
+	// The keys are negated so that the largest key comes first, and ties are broken by the original position of the cluster
+	for( i = 0; i < numClusters; ++i ) {
+		order[i] = std::make_pair( -keys[i], i );
+	}
+
+	std::sort( order.begin(), order.end() );
+
+	sorted.reserve( indices.size() );
+
+	for( i = 0; i < numClusters; ++i ) {
+		const unsigned int cluster = order[i].second;
+
+		sorted.insert( sorted.end(), indices.begin() + 3 * clusters[cluster], indices.begin() + 3 * clusters[cluster + 1] );
+	}
+
+	indices.swap( sorted );
+}
+
+// private functions
+
+overdraw_optimizer::overdraw_optimizer()
+{
+}
+
+overdraw_optimizer::~overdraw_optimizer()
+{
+}
+
+const std::vector<unsigned int> overdraw_optimizer::find_clusters( const std::vector<unsigned int>& indices, const unsigned int numVertices,
+	const unsigned int cacheSize, const float threshold ) {
+	const unsigned int numTriangles = static_cast<unsigned int>( indices.size() / 3 );
+	const float targetAcmr = threshold * vertex_cache_optimizer::compute_statistics( indices, numVertices, cacheSize ).acmr;
+	std::vector<unsigned int> cacheTime( numVertices, 0 ), clusters;
+	unsigned int time = cacheSize + 1, clusterStart = 0, clusterMisses = 0;
+
+	clusters.push_back( 0 );
+
+	for( unsigned int triangle = 0; triangle < numTriangles; ++triangle ) {
+		unsigned int misses = 0;
+
+		for( unsigned int corner = 0; corner < 3; ++corner ) {
+			const unsigned int vertex = indices[3 * triangle + corner];
+
+			if( time - cacheTime[vertex] > cacheSize ) {
+				cacheTime[vertex] = time++;
+				++misses;
+			}
+		}
+
+		// A triangle that misses every vertex starts a new fan with a flushed cache, so it is always the start of a cluster
+		if( misses == 3 && triangle > clusterStart ) {
+			clusters.push_back( triangle );
+			clusterStart = triangle;
+			clusterMisses = 0;
+		}
+
+		clusterMisses += misses;
+
+		// Moving time forward by more than the cache size empties the cache, so the next cluster is measured as if it was drawn first
+		if( static_cast<float>( clusterMisses ) <= targetAcmr * static_cast<float>( triangle + 1 - clusterStart ) && triangle + 1 < numTriangles ) {
+			clusters.push_back( triangle + 1 );
+			clusterStart = triangle + 1;
+			clusterMisses = 0;
+			time += cacheSize + 1;
+		}
+	}
+
+	clusters.push_back( numTriangles );
+
+	return clusters;
+}
+
+const std::vector<float> overdraw_optimizer::compute_sort_keys( const std::vector<unsigned int>& indices, const std::vector<float>& positions,
+	const std::vector<unsigned int>& clusters ) {
+	const unsigned int numClusters = static_cast<unsigned int>( clusters.size() - 1 );
+	std::vector<float> keys( numClusters, 0.f ), centroids( 3 * numClusters, 0.f ), normals( 3 * numClusters, 0.f ), areas( numClusters, 0.f );
+	float meshCentroid[3] = { 0.f, 0.f, 0.f }, meshArea = 0.f;
+	unsigned int cluster = 0, axis = 0;
+
+	for( cluster = 0; cluster < numClusters; ++cluster ) {
+		for( unsigned int triangle = clusters[cluster]; triangle < clusters[cluster + 1]; ++triangle ) {
+			const float* p0 = &positions[3 * indices[3 * triangle]];
+			const float* p1 = &positions[3 * indices[3 * triangle + 1]];
+			const float* p2 = &positions[3 * indices[3 * triangle + 2]];
+			const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+
+			// The cross product points along the normal and its length is twice the area, so summing it weights the normal by area
+			const float normal[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			const float area = std::sqrt( normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] );
+
+			for( axis = 0; axis < 3; ++axis ) {
+				const float centroid = ( p0[axis] + p1[axis] + p2[axis] ) / 3.f;
+
+				centroids[3 * cluster + axis] += centroid * area;
+				normals[3 * cluster + axis] += normal[axis];
+				meshCentroid[axis] += centroid * area;
+			}
+
+			areas[cluster] += area;
+			meshArea += area;
+		}
+	}
+
+	// Meshes made only of degenerate triangles keep their order
+	if( meshArea == 0.f )
+		return keys;
+
+	for( axis = 0; axis < 3; ++axis ) {
+		meshCentroid[axis] /= meshArea;
+	}
+
+	for( cluster = 0; cluster < numClusters; ++cluster ) {
+		const float* normal = &normals[3 * cluster];
+		const float length = std::sqrt( normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] );
+
+		if( areas[cluster] == 0.f || length == 0.f )
+			continue;
+
+		for( axis = 0; axis < 3; ++axis ) {
+			keys[cluster] += ( centroids[3 * cluster + axis] / areas[cluster] - meshCentroid[axis] ) * normal[axis] / length;
+		}
+	}
+
+	return keys;
+}
+
+} // end of meshes namespace
+} // end of occluded namespace
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+#include <boost/lexical_cast.hpp>
+
+#include "vertex_cache_optimizer.h"
+
+namespace occluded { namespace meshes {
+
+/**
+ * \class overdraw_optimizer
+ * \brief Reorders the triangles of an opaque triangle list so that early depth testing rejects more fragments.
+ *
+ * Implements the overdraw pass of Tipsify (Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw").
+ * The triangles, which should already be ordered by vertex_cache_optimizer, are split into clusters wherever the simulated cache is flushed.
+ * Those clusters are split again as soon as their average cache miss ratio, starting from an empty cache, is within threshold times the
+ * average cache miss ratio of the whole list. The clusters are then sorted by how much they face away from the centre of the mesh, which is a
+ * view-independent estimate of how likely they are to occlude the rest of the mesh.
+ *
+ * Each cluster starts with an empty cache wherever it ends up, so a threshold of 1.05 keeps the triangle list within about five percent of the
+ * vertex cache performance it had. Larger thresholds give smaller clusters, which can be sorted more finely but use the cache less.
+ */
+class overdraw_optimizer
+{
+public:
+	/**
+	 * The threshold used when none is passed to optimize_overdraw.
+	 */
+	static const float DEFAULT_THRESHOLD;
+
+	/**
+	 * \fn optimize_overdraw
+	 * \brief Reorders clusters of triangles from the most to the least occluding.
+	 *
+	 * \param indices A reference to a vector of unsigned ints containing three indices for each triangle, which is reordered in place.
+	 * \param positions A reference to a vector of floats containing the x, y and z coordinates of every vertex.
+	 * \param cacheSize An unsigned int representing the number of vertices in the cache that the indices were optimized for.
+	 * \param threshold A float representing how much worse than the whole list a cluster may use the vertex cache.
+	 *
+	 * Only the order of the clusters changes, so the triangles within each cluster and the order of their vertices are kept. An exception is
+	 * thrown if the number of indices or positions is not a multiple of three, an index does not correspond to a position, cacheSize is less
+	 * than three or threshold is less than 1.
+	 */
+	static void optimize_overdraw( std::vector<unsigned int>& indices, const std::vector<float>& positions,
+		const unsigned int cacheSize = vertex_cache_optimizer::DEFAULT_CACHE_SIZE, const float threshold = DEFAULT_THRESHOLD );
+
+private:
+	overdraw_optimizer();
+	~overdraw_optimizer();
+
+	/**
+	 * \fn find_clusters
+	 * \brief Finds the index of the first triangle of each cluster, followed by the number of triangles.
+	 */
+	static const std::vector<unsigned int> find_clusters( const std::vector<unsigned int>& indices, const unsigned int numVertices,
+		const unsigned int cacheSize, const float threshold );
+
+	/**
+	 * \fn compute_sort_keys
+	 * \brief Computes how much each cluster faces away from the centre of the mesh.
+	 *
+	 * The key of a cluster is the distance from the centroid of the mesh to the area weighted centroid of the cluster, along the area weighted
+	 * normal of the cluster. Clusters with larger keys are drawn first.
+	 */
+	static const std::vector<float> compute_sort_keys( const std::vector<unsigned int>& indices, const std::vector<float>& positions,
+		const std::vector<unsigned int>& clusters );
+};
+
+} // end of meshes namespace
+} // end of occluded namespace
@@ -0,0 +1,190 @@
+#include "vertex_cache_optimizer.h"
+
+namespace occluded { namespace meshes {
+
+const unsigned int vertex_cache_optimizer::DEFAULT_CACHE_SIZE = 16;
+const unsigned int vertex_cache_optimizer::NO_VERTEX = 0xffffffff;
+
+void vertex_cache_optimizer::optimize_vertex_cache( std::vector<unsigned int>& indices, const unsigned int numVertices, const unsigned int cacheSize ) {
+	if( indices.size() % 3 != 0 ) {
+		throw std::runtime_error( "vertex_cache_optimizer.optimize_vertex_cache: Failed to optimize indices because the number of indices(" +
+			boost::lexical_cast<std::string>( indices.size() ) + ") is not a multiple of three." );
+	}
+
+	if( cacheSize < 3 ) {
+		throw std::runtime_error( "vertex_cache_optimizer.optimize_vertex_cache: Failed to optimize indices because the cache size(" +
+			boost::lexical_cast<std::string>( cacheSize ) + ") is less than three." );
+	}
+
+	check_indices( indices, numVertices, "optimize_vertex_cache" );
+
+	if( indices.empty() )
+		return;
+
+	const unsigned int numTriangles = static_cast<unsigned int>( indices.size() / 3 );
+	std::vector<unsigned int> liveTriangles( numVertices, 0 ), adjacencyOffsets( numVertices + 1, 0 ), adjacency( indices.size() );
+	std::vector<unsigned int> cacheTime( numVertices, 0 ), deadEnd, candidates, optimized;
+	std::vector<bool> emitted( numTriangles, false );
+	unsigned int i = 0, time = cacheSize + 1, cursor = 0, fanVertex = indices[0];
+
+	// Store the triangles that use each vertex in a single array, with the triangles of each vertex starting at its adjacency offset
+	for( i = 0; i < indices.size(); ++i ) {
+		++liveTriangles[indices[i]];
+	}
+
+	for( i = 0; i < numVertices; ++i ) {
+		adjacencyOffsets[i + 1] = adjacencyOffsets[i] + liveTriangles[i];
+	}
+
+	std::vector<unsigned int> nextAdjacent( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+
+	for( i = 0; i < indices.size(); ++i ) {
+		adjacency[nextAdjacent[indices[i]]++] = i / 3;
+	}
+
+	optimized.reserve( indices.size() );
+
+	while( fanVertex != NO_VERTEX ) {
+		unsigned int bestPriority = 0;
+		bool found = false;
+
+		candidates.clear();
+
+		// Emit every triangle around the fanning vertex that has not been emitted yet
+		for( i = adjacencyOffsets[fanVertex]; i < adjacencyOffsets[fanVertex + 1]; ++i ) {
+			const unsigned int triangle = adjacency[i];
+
+			if( emitted[triangle] )
+				continue;
+
+			for( unsigned int corner = 0; corner < 3; ++corner ) {
+				const unsigned int vertex = indices[3 * triangle + corner];
+
+				optimized.push_back( vertex );
+				deadEnd.push_back( vertex );
+				candidates.push_back( vertex );
+				--liveTriangles[vertex];
+
+				if( time - cacheTime[vertex] > cacheSize )
+					cacheTime[vertex] = time++;
+			}
+
+			emitted[triangle] = true;
+		}
+
+		fanVertex = NO_VERTEX;
+
+		// Prefer the candidate that has been in the cache longest, as long as fanning around it will not push it out of the cache
+		for( std::vector<unsigned int>::const_iterator it = candidates.begin(); it != candidates.end(); ++it ) {
+			if( liveTriangles[*it] == 0 )
+				continue;
+
+			const unsigned int age = time - cacheTime[*it];
+			const unsigned int priority = age + 2 * liveTriangles[*it] <= cacheSize ? age : 0;
+
+			if( !found || priority > bestPriority ) {
+				fanVertex = *it;
+				bestPriority = priority;
+				found = true;
+			}
+		}
+
+		if( !found )
+			fanVertex = skip_dead_end( deadEnd, liveTriangles, cursor );
+	}
+
+	indices.swap( optimized );
+}
+
+const std::vector<unsigned int> vertex_cache_optimizer::optimize_vertex_fetch( std::vector<unsigned int>& indices, const unsigned int numVertices ) {
+	std::vector<unsigned int> remap( numVertices, NO_VERTEX );
+	unsigned int nextIndex = 0;
+
+	check_indices( indices, numVertices, "optimize_vertex_fetch" );
+
+	for( std::vector<unsigned int>::iterator it = indices.begin(); it != indices.end(); ++it ) {
+		if( remap[*it] == NO_VERTEX )
+			remap[*it] = nextIndex++;
+
+		*it = remap[*it];
+	}
+
+	// Vertices that are not used keep their order after the used vertices
+	for( std::vector<unsigned int>::iterator it = remap.begin(); it != remap.end(); ++it ) {
+		if( *it == NO_VERTEX )
+			*it = nextIndex++;
+	}
+
+	return remap;
+}
+
+const vertex_cache_statistics vertex_cache_optimizer::compute_statistics( const std::vector<unsigned int>& indices, const unsigned int numVertices,
+	const unsigned int cacheSize ) {
+	vertex_cache_statistics statistics = { 0.f, 0.f, 0 };
+	std::vector<unsigned int> cacheTime( numVertices, 0 );
+	std::vector<bool> used( numVertices, false );
+	unsigned int time = cacheSize + 1, numUsed = 0;
+
+	check_indices( indices, numVertices, "compute_statistics" );
+
+	if( indices.size() < 3 )
+		return statistics;
+
+	for( std::vector<unsigned int>::const_iterator it = indices.begin(); it != indices.end(); ++it ) {
+		// A vertex is still in the FIFO if fewer than cacheSize vertices have been added since it was
+		if( time - cacheTime[*it] > cacheSize ) {
+			cacheTime[*it] = time++;
+			++statistics.numTransformed;
+		}
+
+		if( !used[*it] ) {
+			used[*it] = true;
+			++numUsed;
+		}
+	}
+
+	statistics.acmr = static_cast<float>( statistics.numTransformed ) / static_cast<float>( indices.size() / 3 );
+	statistics.atvr = static_cast<float>( statistics.numTransformed ) / static_cast<float>( numUsed );
+
+	return statistics;
+}
+
+// private functions
+
+vertex_cache_optimizer::vertex_cache_optimizer()
+{
+}
+
+vertex_cache_optimizer::~vertex_cache_optimizer()
+{
+}
+
+void vertex_cache_optimizer::check_indices( const std::vector<unsigned int>& indices, const unsigned int numVertices, const std::string& function ) {
+	for( std::vector<unsigned int>::const_iterator it = indices.begin(); it != indices.end(); ++it ) {
+		if( *it >= numVertices ) {
+			throw std::runtime_error( "vertex_cache_optimizer." + function + ": Failed because index(" + boost::lexical_cast<std::string>( *it )
+				+ ") does not correspond to a vertex." );
+		}
+	}
+}
+
+const unsigned int vertex_cache_optimizer::skip_dead_end( std::vector<unsigned int>& deadEnd, const std::vector<unsigned int>& liveTriangles,
+	unsigned int& cursor ) {
+	while( !deadEnd.empty() ) {
+		const unsigned int vertex = deadEnd.back();
+		deadEnd.pop_back();
+
+		if( liveTriangles[vertex] > 0 )
+			return vertex;
+	}
+
+	for( ; cursor < liveTriangles.size(); ++cursor ) {
+		if( liveTriangles[cursor] > 0 )
+			return cursor;
+	}
+
+	return NO_VERTEX;
+}
+
+} // end of meshes namespace
+} // end of occluded namespace
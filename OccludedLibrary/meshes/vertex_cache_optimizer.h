@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+#include <boost/lexical_cast.hpp>
+
+namespace occluded { namespace meshes {
+
+/**
+ * \struct vertex_cache_statistics
+ * \brief Describes how well an index buffer uses a post-transform vertex cache.
+ */
+struct vertex_cache_statistics {
+	/**
+	 * The average number of vertices transformed per triangle, which is between 0.5 for an ideal mesh and 3 for a mesh that never hits the cache.
+	 */
+	float acmr;
+
+	/**
+	 * The average number of times each vertex used by the triangles is transformed, which is 1 for an ideal mesh.
+	 */
+	float atvr;
+
+	/**
+	 * The total number of cache misses.
+	 */
+	unsigned int numTransformed;
+};
+
+/**
+ * \class vertex_cache_optimizer
+ * \brief Reorders triangle lists so that they make better use of the post-transform vertex cache and vertex fetch.
+ *
+ * Orders triangles with the Tipsify algorithm (Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"),
+ * which fans around a vertex at a time and chooses the next vertex to fan around from the vertices of the triangles just emitted. It runs in
+ * time linear in the number of indices, so it can be used on meshes with tens of millions of triangles. The vertices can then be renumbered in
+ * the order the triangles first use them, so that vertex fetch reads the vertex buffer in order.
+ *
+ * The cache is modelled as a FIFO of cacheSize vertices, which matches most hardware closely enough for ordering purposes.
+ */
+class vertex_cache_optimizer
+{
+public:
+	/**
+	 * The cache size used when none is passed to a function.
+	 */
+	static const unsigned int DEFAULT_CACHE_SIZE;
+
+	/**
+	 * \fn optimize_vertex_cache
+	 * \brief Reorders the triangles of a triangle list for the vertex cache.
+	 *
+	 * \param indices A reference to a vector of unsigned ints containing three indices for each triangle, which is reordered in place.
+	 * \param numVertices An unsigned int representing the number of vertices the indices refer to.
+	 * \param cacheSize An unsigned int representing the number of vertices in the cache that is optimized for.
+	 *
+	 * Reorders the triangles without changing the order of the vertices within each triangle, so their winding is kept. An exception is thrown
+	 * if the number of indices is not a multiple of three, an index is not less than numVertices or cacheSize is less than 3.
+	 */
+	static void optimize_vertex_cache( std::vector<unsigned int>& indices, const unsigned int numVertices,
+		const unsigned int cacheSize = DEFAULT_CACHE_SIZE );
+
+	/**
+	 * \fn optimize_vertex_fetch
+	 * \brief Renumbers vertices in the order they are first used.
+	 *
+	 * \param indices A reference to a vector of unsigned ints containing the indices, which are replaced by the new indices.
+	 * \param numVertices An unsigned int representing the number of vertices the indices refer to.
+	 * \return A vector of unsigned ints containing the new index of every vertex, indexed by its old index.
+	 *
+	 * The vertices used by the indices are numbered in the order they are first used. Vertices that are not used are numbered after them in their
+	 * original order, so the vector returned is always a permutation that can be passed to attribute_buffer::reorder_values. An exception is thrown
+	 * if an index is not less than numVertices.
+	 */
+	static const std::vector<unsigned int> optimize_vertex_fetch( std::vector<unsigned int>& indices, const unsigned int numVertices );
+
+	/**
+	 * \fn compute_statistics
+	 * \brief Simulates a vertex cache to measure how well a triangle list uses it.
+	 *
+	 * \param indices A reference to a vector of unsigned ints containing three indices for each triangle.
+	 * \param numVertices An unsigned int representing the number of vertices the indices refer to.
+	 * \param cacheSize An unsigned int representing the number of vertices in the cache.
+	 * \return The statistics of the triangle list. Every field is 0 if there are no triangles.
+	 */
+	static const vertex_cache_statistics compute_statistics( const std::vector<unsigned int>& indices, const unsigned int numVertices,
+		const unsigned int cacheSize = DEFAULT_CACHE_SIZE );
+
+private:
+	static const unsigned int NO_VERTEX;
+
+	vertex_cache_optimizer();
+	~vertex_cache_optimizer();
+
+	/**
+	 * \fn check_indices
+	 * \brief Throws an exception if an index is not less than numVertices.
+	 */
+	static void check_indices( const std::vector<unsigned int>& indices, const unsigned int numVertices, const std::string& function );
+
+	/**
+	 * \fn skip_dead_end
+	 * \brief Finds the next vertex to fan around once the candidates from the last fan have no triangles left.
+	 *
+	 * Pops vertices off the dead end stack until one that still has triangles is found, and otherwise scans forward from cursor. Returns
+	 * NO_VERTEX once every triangle has been emitted.
+	 */
+	static const unsigned int skip_dead_end( std::vector<unsigned int>& deadEnd, const std::vector<unsigned int>& liveTriangles, unsigned int& cursor );
+};
+
+} // end of meshes namespace
+} // end of occluded namespace
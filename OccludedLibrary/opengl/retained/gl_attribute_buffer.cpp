@@ -17,15 +17,29 @@ gl_attribute_buffer::gl_attribute_buffer( gl_attribute_buffer& other ):
 }
 
 gl_attribute_buffer::gl_attribute_buffer( const GLuint vaoId, const buffers::attributes::attribute_map& map, const shaders::shader_program& shaderProg, 
-	const buffer_usage_t usage = static_draw_usage ):
+	const buffer_usage_t usage = static_draw_usage, buffers::storage::storage_allocator& allocator ):
 	m_vaoId( vaoId ),
-	m_buffer( buffers::attribute_buffer_factory::create_attribute_buffer( map ) ),
+	m_buffer( buffers::attribute_buffer_factory::create_attribute_buffer( map, allocator ) ),
 	m_usage( usage ),
 	m_shaderMap( new shaders::shader_attribute_map( map, shaderProg ) )
 {
 	init_buffer();
 }
 
+gl_attribute_buffer::gl_attribute_buffer( const GLuint vaoId, std::auto_ptr<buffers::attribute_buffer> buffer, const shaders::shader_program& shaderProg,
+	const buffer_usage_t usage ):
+	m_vaoId( vaoId ),
+	m_usage( usage )
+{
+	if( buffer.get() == NULL ) {
+		throw std::runtime_error( "gl_attribute_buffer: Failed to create buffer because the attribute buffer passed to constructor was NULL." );
+	}
+
+	m_buffer.reset( buffer.release() );
+	m_shaderMap.reset( new shaders::shader_attribute_map( m_buffer->get_attribute_map(), shaderProg ) );
+
+	init_buffer();
+}
 
 gl_attribute_buffer::~gl_attribute_buffer() {
 	gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
@@ -35,6 +49,7 @@ gl_attribute_buffer::~gl_attribute_buffer() {
 }
 
 void gl_attribute_buffer::insert_values( const std::vector<char>& values ) {
+	detach();
 	m_buffer->insert_values( values );
 
 	bind_buffer();
@@ -44,17 +59,86 @@ void gl_attribute_buffer::insert_values( const std::vector<char>& values ) {
 	}
 }
 
+void gl_attribute_buffer::insert_values( const void* values, const unsigned int numValues ) {
+	detach();
+	m_buffer->insert_values( values, numValues );
+
+	bind_buffer();
+
+	if( GL_NO_ERROR != glGetError() ) {
+		throw std::runtime_error( "gl_attribute_buffer.bind_buffer: Failed to set buffer's data." );
+	}
+}
+
+void gl_attribute_buffer::update_values( const unsigned int firstValue, const unsigned int numValues, const void* values ) {
+	detach();
+	m_buffer->update_values( firstValue, numValues, values );
+}
+
+void gl_attribute_buffer::erase_values( const unsigned int firstValue, const unsigned int numValues ) {
+	detach();
+	m_buffer->erase_values( firstValue, numValues );
+}
+
+const std::vector<unsigned int> gl_attribute_buffer::compact() {
+	detach();
+	return m_buffer->compact();
+}
+
+void gl_attribute_buffer::reorder_values( const std::vector<unsigned int>& remap ) {
+	detach();
+	m_buffer->reorder_values( remap );
+}
+
+const std::vector<unsigned int> gl_attribute_buffer::get_next_indices( const unsigned int numValues ) const {
+	return m_buffer->get_next_indices( numValues );
+}
+
+const bool gl_attribute_buffer::is_value_erased( const unsigned int index ) const {
+	return m_buffer->is_value_erased( index );
+}
+
+const bool gl_attribute_buffer::is_shared() const {
+	return !m_buffer.unique();
+}
+
 void gl_attribute_buffer::bind_buffer() const {
 	glBindVertexArray( m_vaoId );
 	glBindBuffer( GL_ARRAY_BUFFER, m_id );
 
-	// Check to make sure the buffer has a size greater than 0, so that the glBufferData call does not cause OpenGL to enter an error state.
-	if( m_buffer->get_byte_size() > 0 )
-		glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( m_buffer->get_byte_size() ), &m_buffer->get_all_data()[0], m_usage );
+	if( m_buffer->is_all_dirty() ) {
+		const std::size_t byteSize = m_buffer->get_byte_size();
+
+		// Check to make sure the buffer has a size greater than 0, so that the glBufferData call does not cause OpenGL to enter an error state.
+		if( byteSize > 0 ) {
+			const std::vector<buffers::attribute_buffer::dirty_range> usedRanges = m_buffer->get_used_ranges();
+
+			if( usedRanges.size() == 1 && usedRanges[0].first == 0 && usedRanges[0].second == byteSize ) {
+				glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( byteSize ), m_buffer->get_data(), m_usage );
+			} else {
+				// The sections are spaced by the capacity of the buffer, so the data store is sized for all of it but only the values are sent
+				glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( byteSize ), NULL, m_usage );
+
+				for( std::vector<buffers::attribute_buffer::dirty_range>::const_iterator it = usedRanges.begin(); it != usedRanges.end(); ++it ) {
+					glBufferSubData( GL_ARRAY_BUFFER, static_cast<GLintptr>( it->first ), static_cast<GLsizeiptr>( it->second ),
+						m_buffer->get_data() + it->first );
+				}
+			}
+		}
+	} else {
+		const std::vector<buffers::attribute_buffer::dirty_range>& dirtyRanges = m_buffer->get_dirty_ranges();
+
+		for( std::vector<buffers::attribute_buffer::dirty_range>::const_iterator it = dirtyRanges.begin(); it != dirtyRanges.end(); ++it ) {
+			glBufferSubData( GL_ARRAY_BUFFER, static_cast<GLintptr>( it->first ), static_cast<GLsizeiptr>( it->second ),
+				m_buffer->get_data() + it->first );
+		}
+	}
 	
 	if( GL_NO_ERROR != glGetError() ) {
 		throw std::runtime_error( "gl_attribute_buffer.bind_buffer: Failed to bind buffer." );
 	}
+
+	m_buffer->clear_dirty_ranges();
 }
 
 const GLuint gl_attribute_buffer::get_id() const {
@@ -65,6 +149,10 @@ const buffers::attributes::attribute_map& gl_attribute_buffer::get_buffer_map()
 	return m_buffer->get_attribute_map();
 }
 
+const buffers::attribute_buffer& gl_attribute_buffer::get_attribute_buffer() const {
+	return *m_buffer;
+}
+
 const buffer_usage_t gl_attribute_buffer::get_usage() const {
 	return m_usage;
 }
@@ -73,6 +161,10 @@ const unsigned int gl_attribute_buffer::get_num_values() const {
 	return m_buffer->get_num_values();
 }
 
+const unsigned int gl_attribute_buffer::get_num_free_values() const {
+	return m_buffer->get_num_free_values();
+}
+
 void gl_attribute_buffer::prepare_for_render() const {
 	bind_buffer();
 
@@ -90,6 +182,21 @@ void gl_attribute_buffer::init_buffer() {
 	bind_buffer();
 }
 
+void gl_attribute_buffer::detach() {
+	if( m_buffer.unique() )
+		return;
+
+	gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+
+	// The copy is created before the reference to the shared buffer object is released, so a failed copy leaves the buffer as it was
+	boost::shared_ptr<buffers::attribute_buffer> newBuffer( buffers::attribute_buffer_factory::create_copy( *m_buffer,
+		m_buffer->get_storage_allocator() ).release() );
+
+	manager.remove_ref_to_vbo( m_vaoId, m_id );
+	m_id = manager.get_new_vbo( m_vaoId );
+	m_buffer = newBuffer;
+}
+
 } // end of retained namespace
 } // end of opengl namespace
 } // end of occluded namespace
@@ -32,6 +32,10 @@ typedef enum BUFFER_USAGE {
  * A wrapper class for an OpenGL buffer object. It stores information about the buffer to allow for quickly accessing that information without querying
  * the OpenGL buffer object. It also contains an attribute_buffer object that will allow for storage of data outside of OpenGL which makes inserting data
  * into the buffer significantly more easy as well as allowing for checking to make sure data being inserted is valid.
+ *
+ * Copies of a gl_attribute_buffer share its attribute buffer and OpenGL buffer object, so many meshes and levels of detail can use the same
+ * vertex data without storing it more than once. The values are copy-on-write: the first time a copy that is still shared is changed, it
+ * gets its own attribute buffer and OpenGL buffer object first, so changing one copy never changes the others.
  */
 class gl_attribute_buffer
 {
@@ -40,7 +44,7 @@ private:
 	GLuint m_id;
 	buffer_usage_t m_usage;
 
-	// Need to be shared across multiple copies of an attribute buffer
+	// Shared across copies until one of them is changed
 	boost::shared_ptr<buffers::attribute_buffer> m_buffer;
 	boost::shared_ptr<shaders::shader_attribute_map> m_shaderMap;
 
@@ -51,7 +55,7 @@ public:
 	 * \param other A reference to the gl_attribute_buffer that is being copied.
 	 *
 	 * Makes a copy of an gl_attribute_buffer so that it can be used by a class that needs to retain a copy of it as well as act as its own independent
-	 * entity.
+	 * entity. The copy shares the values of other until either of them is changed, so making a copy does not copy the values.
 	 */
 	gl_attribute_buffer( gl_attribute_buffer& other );
 
@@ -62,13 +66,29 @@ public:
 	 * \param map A reference to an attribute map.
 	 * \param shaderProg A reference to a shader program.
 	 * \param usage A enumerable that will be used to tell OpenGL how the buffer will be used.
+	 * \param allocator A reference to the storage allocator the attribute buffer stores its values in, which must outlive the buffer.
 	 *
 	 * Generate the an OpenGL buffer object, creates an attribute buffer to store data inserted into the buffer, and binds that buffer
 	 * as an array buffer. An exception is thrown if the shaderProg is not linked or the map is still being defined. The default value for
 	 * the usage parameter is static_draw_usage.
 	 */
 	gl_attribute_buffer( const GLuint vaoId, const buffers::attributes::attribute_map& map, const shaders::shader_program& shaderProg, 
-		const buffer_usage_t usage );
+		const buffer_usage_t usage, buffers::storage::storage_allocator& allocator = buffers::storage::storage_allocator::get_default_allocator() );
+
+	/**
+	 * \brief Creates the buffer from an existing attribute buffer.
+	 *
+	 * \param vaoId A constant GLuint representing an OpenGL vertex array object id.
+	 * \param buffer An auto_ptr to the attribute buffer that stores the data of the buffer, which the gl_attribute_buffer takes ownership of.
+	 * \param shaderProg A reference to a shader program.
+	 * \param usage A enumerable that will be used to tell OpenGL how the buffer will be used.
+	 *
+	 * Generates an OpenGL buffer object and sets its data store to the values already in the attribute buffer. This allows buffers such as a
+	 * mapped_attr_buffer to be uploaded straight from where their values are stored. An exception is thrown if buffer is NULL or if the
+	 * shaderProg is not linked.
+	 */
+	gl_attribute_buffer( const GLuint vaoId, std::auto_ptr<buffers::attribute_buffer> buffer, const shaders::shader_program& shaderProg,
+		const buffer_usage_t usage = static_draw_usage );
 	~gl_attribute_buffer();
 	
 	/**
@@ -82,12 +102,110 @@ public:
 	 */
 	void insert_values( const std::vector<char>& values );
 
+	/**
+	 * \fn insert_values
+	 * \brief Inserts data into the buffer without an intermediate copy.
+	 *
+	 * \param values A pointer to the memory containing the data to be inserted.
+	 * \param numValues An unsigned int representing the number of values to be inserted.
+	 *
+	 * Inserts numValues values directly from the memory pointed to by values into the attribute buffer, then binds the buffer and sets the OpenGL
+	 * data store to the data in the attribute buffer.
+	 */
+	void insert_values( const void* values, const unsigned int numValues );
+
+	/**
+	 * \fn insert_values
+	 * \brief Inserts a range of vertex structures into the buffer.
+	 *
+	 * \param first A forward iterator to the first vertex structure to be inserted.
+	 * \param last A forward iterator to the position after the last vertex structure to be inserted.
+	 *
+	 * Inserts the vertex structures in the range [first, last) into the attribute buffer, then binds the buffer and sets the OpenGL data store
+	 * a single time for the whole range. \see { occluded::buffers::attribute_buffer::insert_values }
+	 */
+	template<typename ForwardIterator>
+	void insert_values( ForwardIterator first, ForwardIterator last );
+
+	/**
+	 * \fn update_values
+	 * \brief Overwrites values that are already in the buffer.
+	 *
+	 * \param firstValue An unsigned int representing the index of the first value to be overwritten.
+	 * \param numValues An unsigned int representing the number of values to be overwritten.
+	 * \param values A pointer to the memory containing the new values.
+	 *
+	 * Overwrites the values in the attribute buffer. The changed bytes are uploaded the next time the buffer is bound, using glBufferSubData
+	 * for each dirty range instead of setting the whole data store. \see { occluded::buffers::attribute_buffer::update_values }
+	 */
+	void update_values( const unsigned int firstValue, const unsigned int numValues, const void* values );
+
+	/**
+	 * \fn erase_values
+	 * \brief Erases values from the buffer.
+	 *
+	 * \param firstValue An unsigned int representing the index of the first value to be erased.
+	 * \param numValues An unsigned int representing the number of values to be erased.
+	 *
+	 * Adds the values to the free list of the attribute buffer so that they are reused by the next values inserted. Nothing needs to be uploaded,
+	 * since the erased values are left in place. \see { occluded::buffers::attribute_buffer::erase_values }
+	 */
+	void erase_values( const unsigned int firstValue, const unsigned int numValues );
+
+	/**
+	 * \fn compact
+	 * \brief Removes the erased values from the buffer.
+	 *
+	 * \return A vector of unsigned ints containing the new index of every value, indexed by its old index.
+	 *
+	 * Removes the erased values from the attribute buffer. The whole data store is set the next time the buffer is bound.
+	 * \see { occluded::buffers::attribute_buffer::compact }
+	 */
+	const std::vector<unsigned int> compact();
+
+	/**
+	 * \fn reorder_values
+	 * \brief Moves every value in the buffer to a new index.
+	 *
+	 * \param remap A reference to a vector containing the new index of every value, indexed by its old index.
+	 *
+	 * The whole data store is set the next time the buffer is bound. \see { occluded::buffers::attribute_buffer::reorder_values }
+	 */
+	void reorder_values( const std::vector<unsigned int>& remap );
+
+	/**
+	 * \fn get_next_indices
+	 * \brief Gets the indices that the next values inserted will be stored at.
+	 *
+	 * \param numValues An unsigned int representing the number of values that will be inserted.
+	 * \return A vector of unsigned ints containing the index each of the values will be stored at, in the order they are inserted.
+	 */
+	const std::vector<unsigned int> get_next_indices( const unsigned int numValues ) const;
+
+	/**
+	 * \fn is_value_erased
+	 * \brief Checks whether a value has been erased.
+	 *
+	 * \param index An unsigned int representing the index of the value.
+	 * \return Returns true if the value has been erased and not yet reused, otherwise false.
+	 */
+	const bool is_value_erased( const unsigned int index ) const;
+
+	/**
+	 * \fn is_shared
+	 * \brief Checks whether the values of the buffer are shared with a copy of it.
+	 *
+	 * \return Returns true if another gl_attribute_buffer shares the attribute buffer and OpenGL buffer object, otherwise false.
+	 */
+	const bool is_shared() const;
+
 	/**
 	 * \fn bind_buffer
 	 * \brief Binds the buffer as an array buffer object.
 	 *
-	 * Binds the buffer as an array buffer object and sets the OpenGL buffer's data store to the contents of the attribute buffer. Should
-	 * be called prior to using the buffer in an OpenGL draw call or after the data in the attribute buffer has changed.
+	 * Binds the buffer as an array buffer object and uploads whatever has changed in the attribute buffer since it was last bound. The whole
+	 * data store is set if values were inserted or the buffer was cleared, otherwise only the dirty ranges are uploaded. Should be called prior
+	 * to using the buffer in an OpenGL draw call or after the data in the attribute buffer has changed.
 	 */
 	void bind_buffer() const;
 
@@ -113,6 +231,14 @@ public:
 	 */
 	const buffers::attributes::attribute_map& get_buffer_map() const;
 
+	/**
+	 * \fn get_attribute_buffer
+	 * \brief Gets the attribute_buffer that stores the data of the buffer.
+	 *
+	 * \return A reference to the attribute_buffer contained by the gl_attribute_buffer, which can be used to read the values in the buffer.
+	 */
+	const buffers::attribute_buffer& get_attribute_buffer() const;
+
 	/**
 	 * \fn get_usage
 	 * \brief Gets the usage of the buffer.
@@ -129,6 +255,14 @@ public:
 	 */
 	const unsigned int get_num_values() const;
 
+	/**
+	 * \fn get_num_free_values
+	 * \brief Gets the number of erased values in the buffer.
+	 *
+	 * \return An unsigned int representing the number of values that have been erased and not yet reused or compacted.
+	 */
+	const unsigned int get_num_free_values() const;
+
 	/**
 	 * \fn prepare_for_render
 	 * \brief Sets up the buffer for rendering.
@@ -146,8 +280,29 @@ private:
 	 * Initializes the buffer by generating the OpenGL buffer object and checking to make sure no errors occured in the generation of that object.
 	 */
 	void init_buffer();
+
+	/**
+	 * \fn detach
+	 * \brief Gives the buffer its own copy of the values if they are shared.
+	 *
+	 * Copies the attribute buffer and generates a new OpenGL buffer object for the copy, which is uploaded the next time the buffer is bound.
+	 * Nothing is done if no other gl_attribute_buffer shares the values. Called before anything that changes the values.
+	 */
+	void detach();
 };
 
+template<typename ForwardIterator>
+void gl_attribute_buffer::insert_values( ForwardIterator first, ForwardIterator last ) {
+	detach();
+	m_buffer->insert_values( first, last );
+
+	bind_buffer();
+
+	if( GL_NO_ERROR != glGetError() ) {
+		throw std::runtime_error( "gl_attribute_buffer.bind_buffer: Failed to set buffer's data." );
+	}
+}
+
 } // end of retained namespace
 } // end of opengl namespace
 } // end of occluded namespace
@@ -0,0 +1,343 @@
+#include "gl_chunked_mesh.h"
+
+#include <boost/cstdint.hpp>
+
+namespace occluded { namespace opengl { namespace retained {
+
+const unsigned int gl_chunked_mesh::MAX_CHUNK_VERTICES = 0x10000;
+
+gl_chunked_mesh::gl_chunked_mesh( const GLuint vaoId, const occluded::buffers::attributes::attribute_map& map, const shaders::shader_program& shaderProg,
+	const buffer_usage_t usage, const primitive_type_t primitiveType, const unsigned int maxChunkVertices,
+	occluded::buffers::storage::storage_allocator& allocator ):
+	m_vaoId( vaoId ),
+	m_shaderProg( shaderProg ),
+	m_usage( usage ),
+	m_primitiveType( primitiveType ),
+	m_maxChunkVertices( maxChunkVertices ),
+	m_allocator( allocator ),
+	m_numFaces( 0 ),
+	m_positionAttrib( 0 )
+{
+	if( map.being_defined() || map.get_attributes().empty() ) {
+		throw std::runtime_error( "gl_chunked_mesh: Failed to initialize mesh because the attribute map is still being defined or has no attributes." );
+	}
+
+	if( num_verts_for_next_face( 0 ) == 0 ) {
+		throw std::runtime_error( "gl_chunked_mesh: Failed to initialize mesh because its primitive is not primitive_point, primitive_lines or"
+			+ std::string( " primitive_triangles." ) );
+	}
+
+	if( maxChunkVertices < 3 || maxChunkVertices > MAX_CHUNK_VERTICES ) {
+		throw std::runtime_error( "gl_chunked_mesh: Failed to initialize mesh because the largest number of vertices in a chunk(" +
+			boost::lexical_cast<std::string>( maxChunkVertices ) + ") is not between 3 and " + boost::lexical_cast<std::string>( MAX_CHUNK_VERTICES )
+			+ "." );
+	}
+
+	m_map = occluded::buffers::attributes::attribute_map_registry::get_registry().intern( map );
+}
+
+gl_chunked_mesh::~gl_chunked_mesh()
+{
+}
+
+void gl_chunked_mesh::draw() const {
+	for( std::vector< boost::shared_ptr<gl_retained_mesh> >::const_iterator it = m_chunks.begin(); it != m_chunks.end(); ++it ) {
+		if( ( *it )->get_num_faces() > 0 )
+			( *it )->draw();
+	}
+}
+
+const std::vector<unsigned int> gl_chunked_mesh::add_vertices( const std::vector<char>& vertices ) {
+	const std::size_t vertexSize = m_map->get_byte_size();
+
+	if( vertices.size() % vertexSize != 0 ) {
+		throw std::runtime_error( "gl_chunked_mesh.add_vertices: Failed to add vertices because the size of the vector(" +
+			boost::lexical_cast<std::string>( vertices.size() ) + ") is not a multiple of the byte size of the attribute map." );
+	}
+
+	return add_vertices( vertices.empty() ? NULL : static_cast<const void*>( &vertices[0] ), static_cast<unsigned int>( vertices.size() / vertexSize ) );
+}
+
+const std::vector<unsigned int> gl_chunked_mesh::add_vertices( const void* vertices, const unsigned int numVertices ) {
+	if( vertices == NULL || numVertices == 0 ) {
+		throw std::runtime_error( "gl_chunked_mesh.add_vertices: Failed to add vertices because no vertices were passed." );
+	}
+
+	if( static_cast<boost::uint64_t>( m_locations.size() ) + numVertices > 0xffffffffu ) {
+		throw std::runtime_error( "gl_chunked_mesh.add_vertices: Failed to add vertices because the mesh would have more vertices than can be indexed." );
+	}
+
+	const char* source = static_cast<const char*>( vertices );
+	const std::vector<unsigned int>& strides = m_map->get_section_strides();
+	const std::vector<unsigned int> sourceStarts = get_section_starts( numVertices );
+	std::vector<unsigned int> indices;
+	std::vector<char> part;
+	unsigned int added = 0;
+
+	indices.reserve( numVertices );
+	update_bounds( source, numVertices );
+
+	while( added < numVertices ) {
+		if( m_chunks.empty() || m_chunkSizes.back() == m_maxChunkVertices )
+			add_chunk();
+
+		const unsigned int count = std::min( numVertices - added, m_maxChunkVertices - m_chunkSizes.back() );
+		const char* values = source;
+
+		// The values of each section are stored together, so the part of each section that fits in the chunk is gathered into a block of its own
+		if( count != numVertices ) {
+			const std::vector<unsigned int> partStarts = get_section_starts( count );
+
+			part.resize( count * m_map->get_byte_size() );
+
+			for( unsigned int i = 0; i < strides.size(); ++i ) {
+				memcpy( &part[partStarts[i]], source + sourceStarts[i] + added * strides[i], count * strides[i] );
+			}
+
+			values = &part[0];
+		}
+
+		const std::vector<unsigned int> local = m_chunks.back()->add_vertices( static_cast<const void*>( values ), count );
+
+		for( unsigned int i = 0; i < count; ++i ) {
+			const vertex_location location = { static_cast<unsigned int>( m_chunks.size() - 1 ), local[i] };
+
+			indices.push_back( static_cast<unsigned int>( m_locations.size() ) );
+			m_locations.push_back( location );
+		}
+
+		m_chunkSizes.back() += count;
+		added += count;
+	}
+
+	return indices;
+}
+
+const std::vector<unsigned int> gl_chunked_mesh::add_faces( const std::vector<unsigned int>& faceIndices ) {
+	const unsigned int faceSize = num_verts_for_next_face( m_numFaces );
+	std::vector< std::vector<unsigned int> > chunkIndices;
+	std::vector<unsigned int> addedFaces;
+	std::size_t i = 0;
+
+	if( faceIndices.size() % faceSize != 0 ) {
+		throw std::runtime_error( "gl_chunked_mesh.add_faces: Failed to add faces because the number of indices(" +
+			boost::lexical_cast<std::string>( faceIndices.size() ) + ") is not a multiple of " + boost::lexical_cast<std::string>( faceSize ) + "." );
+	}
+
+	// Check every face first, so that a face that is not valid leaves the chunks as they were
+	for( i = 0; i < faceIndices.size(); ++i ) {
+		if( faceIndices[i] >= m_locations.size() ) {
+			throw std::runtime_error( "gl_chunked_mesh.add_faces: Failed to add faces because an index(" + boost::lexical_cast<std::string>( faceIndices[i] )
+				+ ") that does not correspond to a vertex was found." );
+		}
+
+		for( std::size_t j = i - i % faceSize; j < i; ++j ) {
+			if( faceIndices[j] == faceIndices[i] ) {
+				throw std::runtime_error( "gl_chunked_mesh.add_faces: Failed to add faces because an index(" +
+					boost::lexical_cast<std::string>( faceIndices[i] ) + ") appears more than once in the same face." );
+			}
+		}
+	}
+
+	addedFaces.reserve( faceIndices.size() / faceSize );
+
+	// The faces of each chunk are collected so that each chunk only checks and stores its faces once
+	for( i = 0; i < faceIndices.size(); i += faceSize ) {
+		const unsigned int* face = &faceIndices[i];
+		const unsigned int chunk = find_chunk( face, faceSize );
+
+		chunkIndices.resize( m_chunks.size() );
+
+		for( unsigned int j = 0; j < faceSize; ++j ) {
+			chunkIndices[chunk].push_back( get_local_index( chunk, face[j] ) );
+		}
+
+		addedFaces.push_back( m_numFaces++ );
+	}
+
+	for( i = 0; i < chunkIndices.size(); ++i ) {
+		if( !chunkIndices[i].empty() )
+			m_chunks[i]->add_faces( chunkIndices[i] );
+	}
+
+	return addedFaces;
+}
+
+const unsigned int gl_chunked_mesh::add_face( const std::vector<unsigned int>& faceIndices ) {
+	if( faceIndices.size() != num_verts_for_next_face( m_numFaces ) ) {
+		throw std::runtime_error( "gl_chunked_mesh.add_face: Failed to add face because an incorrect number of indices(" +
+			boost::lexical_cast<std::string>( faceIndices.size() ) + ") were passed to the function." );
+	}
+
+	return add_faces( faceIndices )[0];
+}
+
+const unsigned int gl_chunked_mesh::num_verts_for_next_face( const unsigned int numFaces ) const {
+	switch( m_primitiveType ) {
+	case primitive_point:
+		return 1;
+	case primitive_lines:
+		return 2;
+	case primitive_triangles:
+		return 3;
+	default:
+		return 0;
+	}
+}
+
+void gl_chunked_mesh::set_position_attribute( const std::string& positionName ) {
+	const std::vector<const occluded::buffers::attributes::attribute>& attributes = m_map->get_attributes();
+	unsigned int attrib = 0;
+
+	while( attrib < attributes.size() && attributes[attrib].get_name() != positionName ) {
+		++attrib;
+	}
+
+	if( attrib == attributes.size() || attributes[attrib].get_type() != occluded::buffers::attributes::attrib_float
+		|| attributes[attrib].get_arity() < 3 ) {
+		throw std::runtime_error( "gl_chunked_mesh.set_position_attribute: Failed to set position attribute(" + positionName + ") because it is not"
+			+ " an attribute with 3 float components." );
+	}
+
+	m_positionName = positionName;
+	m_positionAttrib = attrib;
+	m_bounds.clear();
+
+	for( std::vector< boost::shared_ptr<gl_retained_mesh> >::iterator it = m_chunks.begin(); it != m_chunks.end(); ++it ) {
+		const occluded::buffers::attribute_buffer& buffer = ( *it )->get_vertex_buffer().get_attribute_buffer();
+
+		( *it )->set_position_attribute( positionName );
+
+		// Vertices copied into a chunk are already in the bounds, so adding them again does not change them
+		m_bounds.add_positions( buffer.get_data() + buffer.get_attribute_data_offsets()[attrib], buffer.get_num_values(),
+			m_map->get_section_strides()[m_map->get_attribute_sections()[attrib]] );
+	}
+}
+
+const occluded::meshes::mesh_bounds& gl_chunked_mesh::get_bounds() const {
+	return m_bounds;
+}
+
+const unsigned int gl_chunked_mesh::get_num_vertices() const {
+	return static_cast<unsigned int>( m_locations.size() );
+}
+
+const unsigned int gl_chunked_mesh::get_num_faces() const {
+	return m_numFaces;
+}
+
+const unsigned int gl_chunked_mesh::get_num_chunks() const {
+	return static_cast<unsigned int>( m_chunks.size() );
+}
+
+const gl_retained_mesh& gl_chunked_mesh::get_chunk( const unsigned int chunk ) const {
+	if( chunk >= m_chunks.size() ) {
+		throw std::runtime_error( "gl_chunked_mesh.get_chunk: Failed to get chunk(" + boost::lexical_cast<std::string>( chunk )
+			+ ") because the mesh only has " + boost::lexical_cast<std::string>( m_chunks.size() ) + " chunks." );
+	}
+
+	return *m_chunks[chunk];
+}
+
+// Private Member Functions
+
+void gl_chunked_mesh::add_chunk() {
+	m_chunks.push_back( boost::shared_ptr<gl_retained_mesh>( new gl_retained_mesh( m_vaoId, *m_map, m_shaderProg, m_usage, m_primitiveType,
+		m_allocator ) ) );
+	m_chunkSizes.push_back( 0 );
+	m_copies.push_back( boost::unordered_map<unsigned int, unsigned int>() );
+
+	if( !m_positionName.empty() )
+		m_chunks.back()->set_position_attribute( m_positionName );
+}
+
+const unsigned int gl_chunked_mesh::find_chunk( const unsigned int* face, const unsigned int numIndices ) {
+	// A chunk that already stores a vertex of the face only needs the others copied into it
+	for( unsigned int i = 0; i < numIndices; ++i ) {
+		const unsigned int chunk = m_locations[face[i]].chunk;
+
+		if( m_chunkSizes[chunk] + count_missing_vertices( chunk, face, numIndices ) <= m_maxChunkVertices )
+			return chunk;
+	}
+
+	const unsigned int last = static_cast<unsigned int>( m_chunks.size() - 1 );
+
+	if( m_chunkSizes[last] + count_missing_vertices( last, face, numIndices ) <= m_maxChunkVertices )
+		return last;
+
+	add_chunk();
+
+	return last + 1;
+}
+
+const unsigned int gl_chunked_mesh::count_missing_vertices( const unsigned int chunk, const unsigned int* face, const unsigned int numIndices ) const {
+	unsigned int numMissing = 0;
+
+	for( unsigned int i = 0; i < numIndices; ++i ) {
+		if( m_locations[face[i]].chunk != chunk && m_copies[chunk].find( face[i] ) == m_copies[chunk].end() )
+			++numMissing;
+	}
+
+	return numMissing;
+}
+
+const unsigned int gl_chunked_mesh::get_local_index( const unsigned int chunk, const unsigned int vertex ) {
+	const vertex_location& location = m_locations[vertex];
+
+	if( location.chunk == chunk )
+		return location.index;
+
+	boost::unordered_map<unsigned int, unsigned int>::const_iterator copy = m_copies[chunk].find( vertex );
+
+	if( copy != m_copies[chunk].end() )
+		return copy->second;
+
+	const occluded::buffers::attribute_buffer& source = m_chunks[location.chunk]->get_vertex_buffer().get_attribute_buffer();
+	const std::vector<const occluded::buffers::attributes::attribute>& attributes = m_map->get_attributes();
+	const std::vector<unsigned int>& offsets = m_map->get_attribute_offsets();
+	const std::vector<unsigned int>& sections = m_map->get_attribute_sections();
+	const std::vector<unsigned int>& strides = m_map->get_section_strides();
+	std::vector<char> values( m_map->get_byte_size() );
+
+	// A single vertex is laid out the same way whatever the layout of the map, so each attribute is copied to its interleaved offset
+	for( unsigned int i = 0; i < attributes.size(); ++i ) {
+		memcpy( &values[offsets[i]], source.get_data() + source.get_attribute_data_offsets()[i] + location.index * strides[sections[i]],
+			attributes[i].get_attrib_size() );
+	}
+
+	const unsigned int index = m_chunks[chunk]->add_vertices( static_cast<const void*>( &values[0] ), 1 )[0];
+
+	m_copies[chunk][vertex] = index;
+	++m_chunkSizes[chunk];
+
+	return index;
+}
+
+void gl_chunked_mesh::update_bounds( const char* vertices, const unsigned int numVertices ) {
+	if( m_positionName.empty() )
+		return;
+
+	// The positions of the vertices are organized the same way as they are inserted into the buffers
+	const unsigned int offset = m_map->get_block_offsets( numVertices )[m_positionAttrib];
+	const std::size_t stride = m_map->get_section_strides()[m_map->get_attribute_sections()[m_positionAttrib]];
+
+	m_bounds.add_positions( vertices + offset, numVertices, stride );
+}
+
+const std::vector<unsigned int> gl_chunked_mesh::get_section_starts( const unsigned int numVertices ) const {
+	const std::vector<unsigned int> blockOffsets = m_map->get_block_offsets( numVertices );
+	const std::vector<unsigned int>& sections = m_map->get_attribute_sections();
+	const std::vector<unsigned int>& sectionOffsets = m_map->get_section_offsets();
+	std::vector<unsigned int> starts( m_map->get_section_strides().size(), 0 );
+
+	// a section can hold several attributes, so the start is recovered from each attribute's offset in its section
+	for( unsigned int i = 0; i < blockOffsets.size(); ++i ) {
+		starts[sections[i]] = blockOffsets[i] - sectionOffsets[i];
+	}
+
+	return starts;
+}
+
+} // end of retained namespace
+} // end of opengl namespace
+} // end of occluded namespace
@@ -0,0 +1,271 @@
+#pragma once
+
+#ifndef UNIT_TESTING
+#include "GL/glew.h"
+#else
+#include "opengl_mock.h"
+#endif
+
+#include <vector>
+#include <stdexcept>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "gl_retained_mesh.h"
+
+namespace occluded { namespace opengl { namespace retained {
+
+/**
+ * \class gl_chunked_mesh
+ * \brief A mesh for OpenGL retained mode that is split into chunks small enough to be drawn with 16-bit indices.
+ *
+ * Stores its vertices in a sequence of gl_retained_meshes, the chunks, which each have their own gl_attribute_buffer and index buffer and are
+ * drawn with a draw call each. A chunk holds at most 65536 vertices, so its indices are always uploaded as GL_UNSIGNED_SHORT or narrower, and
+ * no buffer ever needs an offset larger than a chunk, so the mesh as a whole can hold more data than fits in 32-bit byte offsets.
+ *
+ * Vertices are added to the last chunk until it is full, after which a new chunk is started. The indices returned by add_vertices number the
+ * vertices of the whole mesh. Each face is added to a chunk that already stores one of its vertices and has room for the rest, or otherwise
+ * to the last chunk, starting a new one if it is full. A vertex of the face that is stored in another chunk is copied into the face's chunk
+ * the first time the chunk needs it, so the vertices on the border between two chunks are stored in both. When the faces use vertices that
+ * were added close together, as the vertices of scanned meshes are, only the faces on the borders of chunks cause copies. Faces are
+ * independent of each other only for lists, so the primitive must be primitive_point, primitive_lines or primitive_triangles.
+ */
+class gl_chunked_mesh:
+	public occluded::meshes::mesh
+{
+public:
+	/**
+	 * The largest number of vertices in a chunk, which is the number of vertices that can be indexed with 16 bits.
+	 */
+	static const unsigned int MAX_CHUNK_VERTICES;
+
+private:
+	/**
+	 * \struct vertex_location
+	 * \brief The chunk a vertex was added to and its index within the chunk.
+	 */
+	struct vertex_location {
+		unsigned int chunk;
+		unsigned int index;
+	};
+
+	const GLuint m_vaoId;
+	occluded::buffers::attributes::attribute_map_handle m_map;
+	const shaders::shader_program& m_shaderProg;
+	const buffer_usage_t m_usage;
+	const primitive_type_t m_primitiveType;
+	const unsigned int m_maxChunkVertices;
+	occluded::buffers::storage::storage_allocator& m_allocator;
+
+	std::vector< boost::shared_ptr<gl_retained_mesh> > m_chunks;
+	std::vector<unsigned int> m_chunkSizes;
+	std::vector< boost::unordered_map<unsigned int, unsigned int> > m_copies;
+	std::vector<vertex_location> m_locations;
+	unsigned int m_numFaces;
+
+	std::string m_positionName;
+	unsigned int m_positionAttrib;
+	occluded::meshes::mesh_bounds m_bounds;
+
+	// The chunks own OpenGL objects, so the mesh is not copyable
+	gl_chunked_mesh( const gl_chunked_mesh& other );
+	gl_chunked_mesh& operator=( const gl_chunked_mesh& other );
+
+public:
+	/**
+	 * \brief Initializes an empty mesh.
+	 *
+	 * \param vaoId A constant GLuint that represents the id of an OpenGL vertex attribute object.
+	 * \param map A reference to the attribute map that will be used to store vertex data.
+	 * \param shaderProg A reference to a shader program that will be used to render the mesh, which must outlive the mesh.
+	 * \param usage A buffer usage type that specifies how the vertex and index data of every chunk will be used.
+	 * \param primitiveType A primitive type that specifies which OpenGL primitive will be used to construct the faces of the mesh.
+	 * \param maxChunkVertices An unsigned int representing the largest number of vertices in a chunk, which must be at least 3 and at most
+	 * MAX_CHUNK_VERTICES.
+	 * \param allocator A reference to the storage allocator the vertex data of every chunk is stored in, which must outlive the mesh.
+	 *
+	 * No chunks are created until vertices are added. An exception is thrown if the attribute map is still being defined or has no attributes,
+	 * if the primitive is not a list or if maxChunkVertices is not valid.
+	 */
+	gl_chunked_mesh( const GLuint vaoId, const occluded::buffers::attributes::attribute_map& map, const shaders::shader_program& shaderProg,
+		const buffer_usage_t usage = static_draw_usage, const primitive_type_t primitiveType = primitive_triangles,
+		const unsigned int maxChunkVertices = MAX_CHUNK_VERTICES,
+		occluded::buffers::storage::storage_allocator& allocator = occluded::buffers::storage::storage_allocator::get_default_allocator() );
+	~gl_chunked_mesh();
+
+	/**
+	 * \fn draw
+	 * \brief Draws the mesh.
+	 *
+	 * Draws each chunk that has faces with a draw call of its own.
+	 */
+	void draw() const;
+
+	/**
+	 * \fn add_vertices
+	 * \brief Adds vertices to the mesh.
+	 *
+	 * \param vertices A reference to a vector of bytes.
+	 * \return A vector of unsigned ints representing the indices of the vertices added.
+	 *
+	 * Adds the vertices contained in the vector to the mesh, formatted the same way as for gl_retained_mesh::add_vertices. An exception is thrown
+	 * if the size of the vector is not a multiple of the byte size of the attribute map.
+	 */
+	const std::vector<unsigned int> add_vertices( const std::vector<char>& vertices );
+
+	/**
+	 * \fn add_vertices
+	 * \brief Adds vertices to the mesh without an intermediate copy.
+	 *
+	 * \param vertices A pointer to the memory containing the vertices, formatted the same way as for gl_retained_mesh::add_vertices.
+	 * \param numVertices An unsigned int representing the number of vertices to be added.
+	 * \return A vector of unsigned ints representing the indices of the vertices added.
+	 *
+	 * The vertices are split between the last chunk and as many new chunks as they need. An exception is thrown if vertices is null, numVertices
+	 * is 0 or the mesh would have more vertices than can be indexed with an unsigned int.
+	 */
+	const std::vector<unsigned int> add_vertices( const void* vertices, const unsigned int numVertices );
+
+	/**
+	 * \fn add_faces
+	 * \brief Adds faces to the mesh.
+	 *
+	 * \param faceIndices A reference to a vector of unsigned ints containing the indices of the vertices that make up the faces to be added.
+	 * \return A vector of unsigned ints representing the indices of the faces that were added.
+	 *
+	 * Every face is checked before any is added, so an exception leaves the mesh unchanged. An exception is thrown if the number of indices is
+	 * not a multiple of the number of vertices of a face, if an index does not correspond to a vertex, or if a face uses a vertex more than once.
+	 */
+	const std::vector<unsigned int> add_faces( const std::vector<unsigned int>& faceIndices );
+
+	/**
+	 * \fn add_face
+	 * \brief Adds a single face to the mesh.
+	 *
+	 * \param faceIndices A reference to a vector of unsigned ints containing the indices of the vertices that make up the face to be added.
+	 * \return A unsigned int representing the index of the face that was added.
+	 *
+	 * An exception is thrown for the same reasons as add_faces, or if faceIndices does not contain exactly one face.
+	 */
+	const unsigned int add_face( const std::vector<unsigned int>& faceIndices );
+
+	/**
+	 * \fn num_verts_for_next_face
+	 * \brief Gets the number of vertices needed for the next face.
+	 *
+	 * \param numFaces An unsigned int that specifies a face in the mesh.
+	 * \return Returns an unsigned int representing the number of vertices of a face, which is the same for every face of a list.
+	 */
+	const unsigned int num_verts_for_next_face( const unsigned int numFaces ) const;
+
+	/**
+	 * \fn set_position_attribute
+	 * \brief Sets the attribute the bounds of the mesh and of each chunk are computed from.
+	 *
+	 * \param positionName A reference to a string containing the name of the attribute that holds the position of each vertex.
+	 *
+	 * An exception is thrown if the attribute does not exist or does not have at least 3 attrib_float components.
+	 * \see { occluded::opengl::retained::gl_retained_mesh::set_position_attribute }
+	 */
+	void set_position_attribute( const std::string& positionName );
+
+	/**
+	 * \fn get_bounds
+	 * \brief Gets the bounds of the vertices of the whole mesh.
+	 *
+	 * \return A reference to the box and sphere containing every vertex, which are empty until set_position_attribute is called. The bounds of
+	 * each chunk can be got from the chunk, so chunks can be culled separately.
+	 */
+	const occluded::meshes::mesh_bounds& get_bounds() const;
+
+	/**
+	 * \fn get_num_vertices
+	 * \brief Gets the number of vertices added to the mesh.
+	 *
+	 * \return An unsigned int representing the number of vertices, not counting the copies made on the borders of chunks.
+	 */
+	const unsigned int get_num_vertices() const;
+
+	/**
+	 * \fn get_num_faces
+	 * \brief Gets the number of faces in the mesh.
+	 *
+	 * \return An unsigned int representing the number of faces in every chunk.
+	 */
+	const unsigned int get_num_faces() const;
+
+	/**
+	 * \fn get_num_chunks
+	 * \brief Gets the number of chunks the mesh is split into.
+	 *
+	 * \return An unsigned int representing the number of chunks.
+	 */
+	const unsigned int get_num_chunks() const;
+
+	/**
+	 * \fn get_chunk
+	 * \brief Gets one of the chunks of the mesh.
+	 *
+	 * \param chunk An unsigned int representing the index of the chunk.
+	 * \return A reference to the chunk, whose vertices and indices are local to it.
+	 *
+	 * An exception is thrown if the chunk does not exist.
+	 */
+	const gl_retained_mesh& get_chunk( const unsigned int chunk ) const;
+
+private:
+	/**
+	 * \fn add_chunk
+	 * \brief Starts a new, empty chunk.
+	 */
+	void add_chunk();
+
+	/**
+	 * \fn find_chunk
+	 * \brief Chooses the chunk a face is added to, starting a new chunk if none has room.
+	 *
+	 * \param face A pointer to the indices of the vertices of the face in the mesh.
+	 * \param numIndices An unsigned int representing the number of vertices of the face.
+	 * \return An unsigned int representing the index of the chunk.
+	 */
+	const unsigned int find_chunk( const unsigned int* face, const unsigned int numIndices );
+
+	/**
+	 * \fn count_missing_vertices
+	 * \brief Counts the vertices of a face that are not yet stored in a chunk.
+	 */
+	const unsigned int count_missing_vertices( const unsigned int chunk, const unsigned int* face, const unsigned int numIndices ) const;
+
+	/**
+	 * \fn get_local_index
+	 * \brief Gets the index of a vertex in a chunk, copying the vertex into the chunk if it is stored in another one.
+	 *
+	 * \param chunk An unsigned int representing the index of the chunk.
+	 * \param vertex An unsigned int representing the index of the vertex in the mesh.
+	 * \return An unsigned int representing the index of the vertex in the chunk.
+	 */
+	const unsigned int get_local_index( const unsigned int chunk, const unsigned int vertex );
+
+	/**
+	 * \fn update_bounds
+	 * \brief Grows the bounds of the mesh to contain vertices that were just added.
+	 *
+	 * \param vertices A pointer to the memory containing the vertices, formatted the same way as for add_vertices.
+	 * \param numVertices An unsigned int representing the number of vertices.
+	 */
+	void update_bounds( const char* vertices, const unsigned int numVertices );
+
+	/**
+	 * \fn get_section_starts
+	 * \brief Gets where each section of the map starts in a block of vertices formatted the same way as for add_vertices.
+	 *
+	 * \param numVertices An unsigned int representing the number of vertices in the block.
+	 * \return A vector of unsigned ints representing the byte offset of each section in the block.
+	 */
+	const std::vector<unsigned int> get_section_starts( const unsigned int numVertices ) const;
+};
+
+} // end of retained namespace
+} // end of opengl namespace
+} // end of occluded namespace
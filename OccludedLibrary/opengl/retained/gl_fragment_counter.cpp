@@ -0,0 +1,49 @@
+#include "gl_fragment_counter.h"
+
+namespace occluded { namespace opengl { namespace retained {
+
+gl_fragment_counter::gl_fragment_counter():
+	m_queryId( 0 )
+{
+	glGenQueries( 1, &m_queryId );
+
+	if( m_queryId == 0 || GL_NO_ERROR != glGetError() )
+		throw std::runtime_error( "gl_fragment_counter: Failed to create a query object because of an error in OpenGL." );
+}
+
+gl_fragment_counter::~gl_fragment_counter()
+{
+	glDeleteQueries( 1, &m_queryId );
+}
+
+const GLuint gl_fragment_counter::count_fragments( const gl_retained_mesh& mesh ) const {
+	GLuint numSamples = 0;
+
+	glClear( GL_DEPTH_BUFFER_BIT );
+	glEnable( GL_DEPTH_TEST );
+	glDepthFunc( GL_LESS );
+
+	glBeginQuery( GL_SAMPLES_PASSED, m_queryId );
+
+	// The query has to be ended even if the draw fails, otherwise it stays active and the next query started in the context fails
+	try {
+		mesh.draw();
+	} catch( ... ) {
+		glEndQuery( GL_SAMPLES_PASSED );
+		throw;
+	}
+
+	glEndQuery( GL_SAMPLES_PASSED );
+
+	// Reading the result waits until the draw has finished
+	glGetQueryObjectuiv( m_queryId, GL_QUERY_RESULT, &numSamples );
+
+	if( GL_NO_ERROR != glGetError() )
+		throw std::runtime_error( "gl_fragment_counter.count_fragments: Failed to count the fragments of the mesh because of an error in OpenGL." );
+
+	return numSamples;
+}
+
+} // end of retained namespace
+} // end of opengl namespace
+} // end of occluded namespace
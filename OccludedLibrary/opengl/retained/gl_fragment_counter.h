@@ -0,0 +1,59 @@
+#pragma once
+
+#ifndef UNIT_TESTING
+#include "GL/glew.h"
+#else
+#include "opengl_mock.h"
+#endif
+
+#include <stdexcept>
+
+#include "gl_retained_mesh.h"
+
+namespace occluded { namespace opengl { namespace retained {
+
+/**
+ * \class gl_fragment_counter
+ * \brief Counts the fragments that are shaded when a mesh is drawn, to measure overdraw.
+ *
+ * Counts fragments with a GL_SAMPLES_PASSED occlusion query around a draw with depth testing enabled. With an opaque shader, which neither
+ * discards fragments nor writes depth, the samples that pass the depth test are the fragments that are shaded, so drawing a mesh before and
+ * after gl_retained_mesh::optimize shows how much overdraw was removed. It does not create a context, so it works with whichever context is
+ * current, such as an offscreen context on a software rasterizer like Mesa's llvmpipe, which makes the counts repeatable between machines.
+ * The view and the uniforms of the mesh's shader program must be set before counting.
+ */
+class gl_fragment_counter
+{
+private:
+	GLuint m_queryId;
+
+	// The query object cannot be shared, so the counter is not copyable
+	gl_fragment_counter( const gl_fragment_counter& other );
+	gl_fragment_counter& operator=( const gl_fragment_counter& other );
+
+public:
+	/**
+	 * \brief Creates the query object used to count fragments.
+	 *
+	 * A context must be current. An exception is thrown if OpenGL enters an error state when creating the query object.
+	 */
+	gl_fragment_counter();
+	~gl_fragment_counter();
+
+	/**
+	 * \fn count_fragments
+	 * \brief Draws a mesh into an empty depth buffer and counts the fragments that pass the depth test.
+	 *
+	 * \param mesh A reference to the mesh to be drawn.
+	 * \return A GLuint representing the number of samples that passed the depth test.
+	 *
+	 * Clears the depth buffer, enables depth testing with GL_LESS and draws the mesh, which are left as they are afterwards. Waits for the
+	 * draw to finish before returning. An exception is thrown if OpenGL enters an error state or the mesh fails to draw, in which case the
+	 * query is still ended.
+	 */
+	const GLuint count_fragments( const gl_retained_mesh& mesh ) const;
+};
+
+} // end of retained namespace
+} // end of opengl namespace
+} // end of occluded namespace
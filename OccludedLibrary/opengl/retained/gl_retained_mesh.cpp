@@ -1,15 +1,35 @@
 #include "gl_retained_mesh.h"
+#include "../../buffers/attribute_transcoder.h"
+
+#include <boost/cstdint.hpp>
 
 namespace occluded { namespace opengl { namespace retained {
 
+// Converts indices to a narrower type, returning a pointer to the converted indices
+template<typename IndexType>
+static const GLvoid* pack_indices( const std::vector<unsigned int>& indices, std::vector<char>& packed ) {
+	packed.resize( indices.size() * sizeof( IndexType ) );
+
+	IndexType* dest = reinterpret_cast<IndexType*>( &packed[0] );
+
+	for( std::size_t i = 0; i < indices.size(); ++i ) {
+		dest[i] = static_cast<IndexType>( indices[i] );
+	}
+
+	return reinterpret_cast<const GLvoid*>( &packed[0] );
+}
+
 gl_retained_mesh::gl_retained_mesh( const GLuint vaoId, const occluded::buffers::attributes::attribute_map& map, const shaders::shader_program& shaderProg, 
-	const buffer_usage_t usage, const primitive_type_t primitiveType ):
+	const buffer_usage_t usage, const primitive_type_t primitiveType, occluded::buffers::storage::storage_allocator& allocator ):
 	m_vaoId( vaoId ),
 	m_shaderProg( shaderProg ),
-	m_buffer( gl_attribute_buffer( vaoId, map, shaderProg, usage ) ),
+	m_buffer( gl_attribute_buffer( vaoId, map, shaderProg, usage, allocator ) ),
 	m_primitiveType( primitiveType ),
 	m_numFaces( 0 ),
-	m_indices( 0 )
+	m_indices( 0 ),
+	m_indicesDirty( true ),
+	m_uploadedIndexType( 0 ),
+	m_positionAttrib( 0 )
 {
 	init_buffer();
 }
@@ -21,8 +41,15 @@ gl_retained_mesh::gl_retained_mesh( const GLuint vaoId, const shaders::shader_pr
 	m_buffer( buffer ),
 	m_primitiveType( primitiveType ),
 	m_numFaces( 0 ),
-	m_indices( 0 )
+	m_indices( 0 ),
+	m_indicesDirty( true ),
+	m_uploadedIndexType( 0 ),
+	m_positionAttrib( 0 )
 {
+	// The faces are added before the index buffer is generated, so the reference to it is not leaked if they are invalid
+	if( !faces.empty() )
+		add_faces( faces );
+
 	init_buffer();
 }
 
@@ -36,32 +63,218 @@ gl_retained_mesh::~gl_retained_mesh()
 }
 
 void gl_retained_mesh::draw() const {
-	m_buffer.prepare_for_render();
-	bind_buffer();
+	draw_indices( m_indices );
+}
 
-	assert( GL_NO_ERROR == glGetError() );
+void gl_retained_mesh::draw( const occluded::meshes::mesh_lod& lod ) const {
+	draw_indices( lod.indices );
+}
 
-	if( m_indices.size() > 0 )
-		glDrawElements( m_primitiveType, static_cast<GLsizei>( m_indices.size() ), GL_UNSIGNED_INT, reinterpret_cast<const GLvoid*>( &m_indices[0] ) );
+void gl_retained_mesh::draw_meshlets( const std::vector<unsigned int>& meshlets ) const {
+	std::vector<unsigned int> indices;
 
-	if( GL_NO_ERROR != glGetError() ) {
-		throw std::runtime_error( "gl_retained_mesh.draw: Failed to draw mesh because OpenGL entered an error state after glDrawElements call." );
+	for( std::vector<unsigned int>::const_iterator it = meshlets.begin(); it != meshlets.end(); ++it ) {
+		if( *it >= m_meshlets.meshlets.size() ) {
+			throw std::runtime_error( "gl_retained_mesh.draw_meshlets: Failed to draw meshlets because meshlet(" + boost::lexical_cast<std::string>( *it )
+				+ ") does not exist." );
+		}
+
+		const occluded::meshes::meshlet& cluster = m_meshlets.meshlets[*it];
+		const std::vector<unsigned int>::const_iterator first = m_meshlets.indices.begin() + 3 * cluster.triangleOffset;
+
+		indices.insert( indices.end(), first, first + 3 * cluster.triangleCount );
 	}
+
+	draw_indices( indices );
 }
 
 const std::vector<unsigned int> gl_retained_mesh::add_vertices( const std::vector<char>& vertices ) {
-	std::vector<unsigned int> indices;
-	unsigned int initNumVals = m_buffer.get_num_values();
+	const std::size_t vertexSize = m_buffer.get_buffer_map().get_byte_size();
+	// Vectors that can not be inserted are passed on to the buffer, which throws an exception
+	if( m_welder && !vertices.empty() && vertexSize > 0 && vertices.size() % vertexSize == 0 )
+		return weld_vertices( &vertices[0], static_cast<unsigned int>( vertices.size() / vertexSize ) );
+
+	const std::vector<unsigned int> indices = m_buffer.get_next_indices( vertexSize > 0 ? static_cast<unsigned int>( vertices.size() / vertexSize ) : 0 );
 
 	m_buffer.insert_values( vertices );
 
-	for( unsigned int i = initNumVals; i < m_buffer.get_num_values(); ++i ) {
-		indices.push_back( i );
-	}
+	if( !vertices.empty() && vertexSize > 0 )
+		update_bounds( &vertices[0], static_cast<unsigned int>( vertices.size() / vertexSize ) );
 
 	return indices;
 }
 
+const std::vector<unsigned int> gl_retained_mesh::add_vertices( const void* vertices, const unsigned int numVertices ) {
+	if( m_welder && vertices != NULL && numVertices > 0 )
+		return weld_vertices( static_cast<const char*>( vertices ), numVertices );
+
+	const std::vector<unsigned int> indices = m_buffer.get_next_indices( numVertices );
+
+	m_buffer.insert_values( vertices, numVertices );
+	update_bounds( static_cast<const char*>( vertices ), numVertices );
+
+	return indices;
+}
+
+void gl_retained_mesh::enable_vertex_welding( const float epsilon ) {
+	const occluded::buffers::attribute_buffer& buffer = m_buffer.get_attribute_buffer();
+	const occluded::buffers::attributes::attribute_map& map = buffer.get_attribute_map();
+	const unsigned int numVertices = buffer.get_num_values();
+	std::vector<char> interleaved;
+	const char* vertices = buffer.get_data();
+
+	m_welder.reset( new occluded::buffers::vertex_welder( map, epsilon ) );
+
+	if( numVertices == 0 )
+		return;
+
+	if( !map.is_interleaved() ) {
+		interleaved.resize( numVertices * map.get_byte_size() );
+		occluded::buffers::attribute_transcoder::interleave( map, buffer.get_data(), buffer.get_attribute_data_offsets(), numVertices, &interleaved[0] );
+		vertices = &interleaved[0];
+	}
+
+	for( unsigned int i = 0; i < numVertices; ++i ) {
+		if( !buffer.is_value_erased( i ) )
+			m_welder->weld( vertices + i * map.get_byte_size(), i );
+	}
+}
+
+void gl_retained_mesh::disable_vertex_welding() {
+	m_welder.reset();
+}
+
+const bool gl_retained_mesh::is_vertex_welding_enabled() const {
+	return m_welder.get() != NULL;
+}
+
+void gl_retained_mesh::erase_vertices( const unsigned int firstVertex, const unsigned int numVertices ) {
+	for( std::vector<unsigned int>::const_iterator it = m_indices.begin(); it != m_indices.end(); ++it ) {
+		if( *it >= firstVertex && *it - firstVertex < numVertices ) {
+			throw std::runtime_error( "gl_retained_mesh.erase_vertices: Failed to erase vertices because vertex(" + boost::lexical_cast<std::string>( *it )
+				+ ") is used by a face of the mesh." );
+		}
+	}
+
+	m_buffer.erase_values( firstVertex, numVertices );
+
+	// Erased indices are reused by the next vertices added, so the welder must not return them
+	if( m_welder ) {
+		std::vector<unsigned int> remap( m_buffer.get_num_values() );
+
+		for( unsigned int i = 0; i < remap.size(); ++i ) {
+			remap[i] = i - firstVertex < numVertices ? occluded::buffers::attribute_buffer::ERASED_VALUE : i;
+		}
+
+		m_welder->remap_indices( remap );
+	}
+}
+
+const std::vector<unsigned int> gl_retained_mesh::compact() {
+	const std::vector<unsigned int> remap = m_buffer.compact();
+
+	m_meshlets = occluded::meshes::meshlet_table();
+
+	// None of the faces use an erased vertex, so every index has a new index
+	for( std::vector<unsigned int>::iterator it = m_indices.begin(); it != m_indices.end(); ++it ) {
+		*it = remap[*it];
+	}
+
+	m_indicesDirty = true;
+
+	if( m_welder )
+		m_welder->remap_indices( remap );
+
+	return remap;
+}
+
+const mesh_optimization_report gl_retained_mesh::optimize( const unsigned int cacheSize ) {
+	return optimize_faces( cacheSize, NULL, 0.f );
+}
+
+const mesh_optimization_report gl_retained_mesh::optimize( const std::string& positionName, const float overdrawThreshold, const unsigned int cacheSize ) {
+	return optimize_faces( cacheSize, &positionName, overdrawThreshold );
+}
+
+const std::vector<occluded::meshes::mesh_lod> gl_retained_mesh::generate_lods( const std::string& positionName, const std::vector<float>& ratios,
+	const std::vector< std::pair<std::string, float> >& attributeWeights, const unsigned int cacheSize ) const {
+	const unsigned int numVertices = m_buffer.get_num_values();
+	std::vector< std::vector<float> > values;
+	std::vector<float> attributes, weights;
+
+	if( m_primitiveType != primitive_triangles ) {
+		throw std::runtime_error( "gl_retained_mesh.generate_lods: Failed to generate levels of detail because the primitive of the mesh is not"
+			+ std::string( " primitive_triangles." ) );
+	}
+
+	// Every component of an attribute is weighted the same
+	for( std::vector< std::pair<std::string, float> >::const_iterator it = attributeWeights.begin(); it != attributeWeights.end(); ++it ) {
+		values.push_back( get_float_values( it->first, 0 ) );
+		weights.insert( weights.end(), numVertices == 0 ? 0 : values.back().size() / numVertices, it->second );
+	}
+
+	// The simplifier expects the weighted components of each vertex to be together
+	attributes.reserve( weights.size() * numVertices );
+
+	for( unsigned int vertex = 0; vertex < numVertices; ++vertex ) {
+		for( unsigned int i = 0; i < values.size(); ++i ) {
+			const std::size_t arity = values[i].size() / numVertices;
+
+			attributes.insert( attributes.end(), values[i].begin() + vertex * arity, values[i].begin() + ( vertex + 1 ) * arity );
+		}
+	}
+
+	std::vector<occluded::meshes::mesh_lod> lods = occluded::meshes::mesh_simplifier::generate_lod_chain( m_indices, get_float_values( positionName, 3 ),
+		ratios, attributes, weights );
+
+	for( std::vector<occluded::meshes::mesh_lod>::iterator it = lods.begin(); it != lods.end(); ++it ) {
+		occluded::meshes::vertex_cache_optimizer::optimize_vertex_cache( it->indices, numVertices, cacheSize );
+	}
+
+	return lods;
+}
+
+const occluded::meshes::meshlet_table& gl_retained_mesh::build_meshlets( const std::string& positionName, const unsigned int maxVertices,
+	const unsigned int maxTriangles ) {
+	if( m_primitiveType != primitive_triangles ) {
+		throw std::runtime_error( "gl_retained_mesh.build_meshlets: Failed to build meshlets because the primitive of the mesh is not"
+			+ std::string( " primitive_triangles." ) );
+	}
+
+	m_meshlets = occluded::meshes::meshlet_builder::build( m_indices, get_float_values( positionName, 3 ), maxVertices, maxTriangles );
+
+	return m_meshlets;
+}
+
+const occluded::meshes::meshlet_table& gl_retained_mesh::get_meshlets() const {
+	return m_meshlets;
+}
+
+void gl_retained_mesh::set_position_attribute( const std::string& positionName ) {
+	const std::vector<float> positions = get_float_values( positionName, 3 );
+	const std::vector<const occluded::buffers::attributes::attribute>& attributes = m_buffer.get_buffer_map().get_attributes();
+	unsigned int attrib = 0;
+
+	while( attributes[attrib].get_name() != positionName ) {
+		++attrib;
+	}
+
+	m_positionName = positionName;
+	m_positionAttrib = attrib;
+	m_bounds.clear();
+
+	if( !positions.empty() )
+		m_bounds.add_positions( reinterpret_cast<const char*>( &positions[0] ), static_cast<unsigned int>( positions.size() / 3 ), 3 * sizeof( float ) );
+}
+
+const std::string& gl_retained_mesh::get_position_attribute() const {
+	return m_positionName;
+}
+
+const occluded::meshes::mesh_bounds& gl_retained_mesh::get_bounds() const {
+	return m_bounds;
+}
+
 const std::vector<unsigned int> gl_retained_mesh::add_faces( const std::vector<unsigned int>& faceIndices ) {
 	unsigned int currIndex = 0, currFace = m_numFaces;
 	std::vector< std::vector<unsigned int> > toAdd;
@@ -130,8 +343,176 @@ const unsigned int gl_retained_mesh::num_verts_for_next_face( const unsigned int
 	return numVerts;
 }
 
+const gl_attribute_buffer& gl_retained_mesh::get_vertex_buffer() const {
+	return m_buffer;
+}
+
+const GLenum gl_retained_mesh::get_index_type() const {
+	const unsigned int numVertices = m_buffer.get_num_values();
+
+	if( numVertices <= 0x100 )
+		return GL_UNSIGNED_BYTE;
+
+	if( numVertices <= 0x10000 )
+		return GL_UNSIGNED_SHORT;
+
+	return GL_UNSIGNED_INT;
+}
+
 // Private Member Functions
 
+const mesh_optimization_report gl_retained_mesh::optimize_faces( const unsigned int cacheSize, const std::string* positionName,
+	const float overdrawThreshold ) {
+	mesh_optimization_report report;
+
+	if( m_primitiveType != primitive_triangles ) {
+		throw std::runtime_error( "gl_retained_mesh.optimize: Failed to optimize mesh because its primitive is not primitive_triangles." );
+	}
+
+	// Look up the position attribute before the mesh is changed, so an invalid name leaves the mesh as it was
+	if( positionName != NULL )
+		get_float_values( *positionName, 3 );
+
+	report.before = occluded::meshes::vertex_cache_optimizer::compute_statistics( m_indices, m_buffer.get_num_values(), cacheSize );
+	report.remap = compact();
+
+	occluded::meshes::vertex_cache_optimizer::optimize_vertex_cache( m_indices, m_buffer.get_num_values(), cacheSize );
+
+	if( positionName != NULL )
+		occluded::meshes::overdraw_optimizer::optimize_overdraw( m_indices, get_float_values( *positionName, 3 ), cacheSize, overdrawThreshold );
+
+	const std::vector<unsigned int> fetchRemap = occluded::meshes::vertex_cache_optimizer::optimize_vertex_fetch( m_indices, m_buffer.get_num_values() );
+
+	m_buffer.reorder_values( fetchRemap );
+
+	if( m_welder )
+		m_welder->remap_indices( fetchRemap );
+
+	for( std::vector<unsigned int>::iterator it = report.remap.begin(); it != report.remap.end(); ++it ) {
+		if( *it != occluded::buffers::attribute_buffer::ERASED_VALUE )
+			*it = fetchRemap[*it];
+	}
+
+	report.after = occluded::meshes::vertex_cache_optimizer::compute_statistics( m_indices, m_buffer.get_num_values(), cacheSize );
+	m_indicesDirty = true;
+
+	return report;
+}
+
+const std::vector<float> gl_retained_mesh::get_float_values( const std::string& name, const unsigned int numComponents ) const {
+	const occluded::buffers::attribute_buffer& buffer = m_buffer.get_attribute_buffer();
+	const occluded::buffers::attributes::attribute_map& map = buffer.get_attribute_map();
+	const std::vector<const occluded::buffers::attributes::attribute>& attributes = map.get_attributes();
+	unsigned int attrib = 0;
+
+	while( attrib < attributes.size() && attributes[attrib].get_name() != name ) {
+		++attrib;
+	}
+
+	if( attrib == attributes.size() ) {
+		throw std::runtime_error( "gl_retained_mesh.get_float_values: Failed to get the values of attribute(" + name + ") because there is no"
+			+ std::string( " attribute with that name." ) );
+	}
+
+	if( attributes[attrib].get_type() != occluded::buffers::attributes::attrib_float || attributes[attrib].get_arity() < numComponents ) {
+		throw std::runtime_error( "gl_retained_mesh.get_float_values: Failed to get the values of attribute(" + name + ") because it does not"
+			+ " have " + boost::lexical_cast<std::string>( numComponents ) + " float components." );
+	}
+
+	const unsigned int arity = numComponents == 0 ? attributes[attrib].get_arity() : numComponents;
+	const std::size_t stride = map.get_section_strides()[map.get_attribute_sections()[attrib]];
+	const char* source = buffer.get_data() + buffer.get_attribute_data_offsets()[attrib];
+	std::vector<float> values( arity * buffer.get_num_values() );
+
+	for( unsigned int i = 0; i < buffer.get_num_values(); ++i ) {
+		memcpy( &values[arity * i], source + i * stride, arity * sizeof( float ) );
+	}
+
+	return values;
+}
+
+void gl_retained_mesh::draw_indices( const std::vector<unsigned int>& indices ) const {
+	const GLenum indexType = get_index_type();
+
+	m_buffer.prepare_for_render();
+	bind_buffer( indices, indexType );
+
+	assert( GL_NO_ERROR == glGetError() );
+
+	// The indices are read from the start of the bound index buffer
+	if( indices.size() > 0 )
+		glDrawElements( m_primitiveType, static_cast<GLsizei>( indices.size() ), indexType, 0 );
+
+	if( GL_NO_ERROR != glGetError() ) {
+		throw std::runtime_error( "gl_retained_mesh.draw: Failed to draw mesh because OpenGL entered an error state after glDrawElements call." );
+	}
+}
+
+const std::vector<unsigned int> gl_retained_mesh::weld_vertices( const char* vertices, const unsigned int numVertices ) {
+	const occluded::buffers::attributes::attribute_map& map = m_buffer.get_buffer_map();
+	std::vector<char> interleaved;
+
+	// The vertices are welded one at a time, so segregated and hybrid vertices are interleaved first
+	if( !map.is_interleaved() && numVertices > 1 ) {
+		interleaved.resize( numVertices * map.get_byte_size() );
+		occluded::buffers::attribute_transcoder::interleave( map, vertices, map.get_block_offsets( numVertices ), numVertices, &interleaved[0] );
+		vertices = &interleaved[0];
+	}
+
+	return weld_interleaved_vertices( vertices, numVertices );
+}
+
+const std::vector<unsigned int> gl_retained_mesh::weld_interleaved_vertices( const char* vertices, const unsigned int numVertices ) {
+	const occluded::buffers::attributes::attribute_map& map = m_buffer.get_buffer_map();
+	const std::size_t vertexSize = map.get_byte_size();
+	const std::vector<unsigned int> nextIndices = m_buffer.get_next_indices( numVertices );
+	std::vector<unsigned int> indices( numVertices ), sectionOffsets;
+	std::vector<char> interleaved, newVertices;
+	unsigned int numNew = 0;
+
+	newVertices.reserve( numVertices * vertexSize );
+
+	// A vertex that has not been seen gets the next index that will be used, and is added with the other new vertices afterwards
+	for( unsigned int i = 0; i < numVertices; ++i ) {
+		const char* vertex = vertices + i * vertexSize;
+
+		indices[i] = m_welder->weld( vertex, nextIndices[numNew] );
+
+		if( indices[i] == nextIndices[numNew] ) {
+			newVertices.insert( newVertices.end(), vertex, vertex + vertexSize );
+			++numNew;
+		}
+	}
+
+	if( numNew > 1 && !map.is_interleaved() ) {
+		sectionOffsets = map.get_block_offsets( numNew );
+
+		interleaved.swap( newVertices );
+		newVertices.resize( numNew * vertexSize );
+		occluded::buffers::attribute_transcoder::deinterleave( map, &interleaved[0], numNew, &newVertices[0], sectionOffsets );
+	}
+
+	if( numNew > 0 ) {
+		m_buffer.insert_values( static_cast<const void*>( &newVertices[0] ), numNew );
+		update_bounds( &newVertices[0], numNew );
+		m_indicesDirty = true;
+	}
+
+	return indices;
+}
+
+void gl_retained_mesh::update_bounds( const char* vertices, const unsigned int numVertices ) {
+	if( m_positionName.empty() || vertices == NULL || numVertices == 0 )
+		return;
+
+	const occluded::buffers::attributes::attribute_map& map = m_buffer.get_buffer_map();
+	// The positions of the vertices are organized the same way as they are inserted into the buffer
+	const unsigned int offset = map.get_block_offsets( numVertices )[m_positionAttrib];
+	const std::size_t stride = map.get_section_strides()[map.get_attribute_sections()[m_positionAttrib]];
+
+	m_bounds.add_positions( vertices + offset, numVertices, stride );
+}
+
 void gl_retained_mesh::init_buffer() {
 	gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
 	
@@ -143,10 +524,10 @@ void gl_retained_mesh::init_buffer() {
 			+ std::string( "to generate a buffer for mesh indices." ) );
 	}
 
-	bind_buffer();
+	bind_buffer( m_indices, get_index_type() );
 }
 
-void gl_retained_mesh::bind_buffer() const {
+void gl_retained_mesh::bind_buffer( const std::vector<unsigned int>& indices, const GLenum indexType ) const {
 	glBindVertexArray( m_vaoId );
 	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_bufferId );
 
@@ -155,11 +536,30 @@ void gl_retained_mesh::bind_buffer() const {
 			") to element array target because OpenGL entered an error state after attempting to bind buffer." );
 	}
 
-	if( m_indices.size() > 0 ) {
-		glBufferData( GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>( m_indices.size() * sizeof( unsigned int ) ), 
-			reinterpret_cast<const GLvoid*>( &m_indices[0] ), m_buffer.get_usage() );
+	const bool meshIndices = &indices == &m_indices;
+
+	// The indices of the mesh are still in the buffer if nothing else was uploaded since, so they are only uploaded when they or their type change
+	if( indices.size() > 0 && ( !meshIndices || m_indicesDirty || indexType != m_uploadedIndexType ) ) {
+		const GLvoid* data = reinterpret_cast<const GLvoid*>( &indices[0] );
+		GLsizeiptr size = static_cast<GLsizeiptr>( indices.size() * sizeof( unsigned int ) );
+
+		// The narrowed indices are only needed until they are uploaded, so they are not kept alongside the mesh indices
+		std::vector<char> packedIndices;
+
+		if( indexType == GL_UNSIGNED_BYTE ) {
+			data = pack_indices<boost::uint8_t>( indices, packedIndices );
+			size = static_cast<GLsizeiptr>( packedIndices.size() );
+		} else if( indexType == GL_UNSIGNED_SHORT ) {
+			data = pack_indices<boost::uint16_t>( indices, packedIndices );
+			size = static_cast<GLsizeiptr>( packedIndices.size() );
+		}
+
+		glBufferData( GL_ELEMENT_ARRAY_BUFFER, size, data, m_buffer.get_usage() );
 	}
 
+	m_indicesDirty = !meshIndices;
+	m_uploadedIndexType = indexType;
+
 	if( GL_NO_ERROR != glGetError() ) {
 		throw std::runtime_error( "gl_retained_mesh.bind_buffer: Failed to bind buffer(" + boost::lexical_cast<std::string>( m_bufferId ) +
 			") because OpenGL entered an error state after attempting to specify the data used for the indices." );
@@ -175,7 +575,7 @@ void gl_retained_mesh::check_face( const std::vector<unsigned int>& faceIndices
 
 	// Check to make sure there are no indices that don't correspond to a vertex and that there are no duplicate indices in the face
 	for( std::vector<unsigned int>::const_iterator it = faceIndices.begin(); it != faceIndices.end(); ++it ) {
-		if( *it >= numVertices ) {
+		if( *it >= numVertices || m_buffer.is_value_erased( *it ) ) {
 			throw std::runtime_error( "gl_retained_mesh.add_faces: Failed to add faces because an index(" + boost::lexical_cast<std::string>( *it )
 				+ ") that dose not correspond to vertex was found." );
 		}
@@ -196,6 +596,10 @@ const unsigned int gl_retained_mesh::insert_face( const std::vector<unsigned int
 		m_indices.push_back( *it );
 	}
 
+	// The meshlets no longer contain every face
+	m_meshlets = occluded::meshes::meshlet_table();
+	m_indicesDirty = true;
+
 	m_numFaces++;
 
 	return newFaceIndex;
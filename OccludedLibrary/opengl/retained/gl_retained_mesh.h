@@ -7,9 +7,18 @@
 #endif
 
 #include <algorithm>
+#include <cstring>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/iterator/indirect_iterator.hpp>
 
 #include "gl_attribute_buffer.h"
+#include "../../buffers/vertex_welder.h"
 #include "../../meshes/mesh.h"
+#include "../../meshes/vertex_cache_optimizer.h"
+#include "../../meshes/overdraw_optimizer.h"
+#include "../../meshes/mesh_simplifier.h"
+#include "../../meshes/meshlet_builder.h"
 
 
 namespace occluded { namespace opengl { namespace retained {
@@ -32,6 +41,27 @@ typedef enum PRIMITIVE_TYPE {
 	primitive_patches = GL_PATCHES
 } primitive_type_t;
 
+/**
+ * \struct mesh_optimization_report
+ * \brief Describes the changes made to a mesh by gl_retained_mesh::optimize.
+ */
+struct mesh_optimization_report {
+	/**
+	 * The vertex cache statistics of the faces before they were reordered.
+	 */
+	occluded::meshes::vertex_cache_statistics before;
+
+	/**
+	 * The vertex cache statistics of the faces after they were reordered.
+	 */
+	occluded::meshes::vertex_cache_statistics after;
+
+	/**
+	 * The new index of every vertex, indexed by its index before the mesh was optimized. Erased vertices map to attribute_buffer::ERASED_VALUE.
+	 */
+	std::vector<unsigned int> remap;
+};
+
 /**
  * \class gl_retained_mesh
  * \brief A mesh implementation for OpenGL retained mode.
@@ -39,6 +69,13 @@ typedef enum PRIMITIVE_TYPE {
  * A mesh implementation for OpenGL retained mode. This contains a gl_attribute_buffer and a vector of unsigned int representing the faces of the
  * of the mesh. This is class contains everything needed to draw a single object in object coordinates. The purpose of this class is to be contained
  * within a model class and allow the model class to render the mesh with a single call.
+ *
+ * Indices are uploaded as GL_UNSIGNED_BYTE or GL_UNSIGNED_SHORT while the mesh has few enough vertices for every index to fit, which makes
+ * the index buffer of a small mesh two to four times smaller. The width is chosen from the number of vertices each time the mesh is drawn, so
+ * the mesh switches to GL_UNSIGNED_INT as soon as vertices added push it past the limit.
+ *
+ * When vertex welding is enabled, vertices that are equal to a vertex already in the mesh are not added again. add_vertices instead returns
+ * the index of the existing vertex in their place, so the indices returned can be passed straight to add_faces.
  * /see { occluded::opengl::retained::gl_attribute_buffer }
  */
 class gl_retained_mesh:
@@ -55,6 +92,16 @@ private:
 	GLuint m_vaoId;
 	GLuint m_bufferId;
 
+	boost::shared_ptr<occluded::buffers::vertex_welder> m_welder;
+	occluded::meshes::meshlet_table m_meshlets;
+
+	mutable bool m_indicesDirty;
+	mutable GLenum m_uploadedIndexType;
+
+	std::string m_positionName;
+	unsigned int m_positionAttrib;
+	occluded::meshes::mesh_bounds m_bounds;
+
 public:
 	/**
 	 * \brief Initializes an empty mesh.
@@ -64,13 +111,15 @@ public:
 	 * \param shaderProg A refernce to a shader program that will be used to render the mesh.
 	 * \param usage A buffer usage type that specifies how the vertex and index data will be used.
 	 * \param primitiveType A primitive type that specifies which OpenGL primitive will be used to construct the faces of the mesh.
+	 * \param allocator A reference to the storage allocator the vertex data is stored in, which must outlive the mesh.
 	 *
 	 * Initializes the mesh by constructing an gl_attribute_buffer from the map, shader program and usage parameters. The default primitive used for
 	 * constructing the mesh is primitive_triangles. This constructor is to be used if the mesh is to be built up from scratch. An exception will be
 	 * thrown in the attribute map is still being defined or if the shader program has not been linked.
 	 */
 	gl_retained_mesh( const GLuint vaoId, const occluded::buffers::attributes::attribute_map& map, const shaders::shader_program& shaderProg, 
-		const buffer_usage_t usage = static_draw_usage, const primitive_type_t primitiveType = primitive_triangles );
+		const buffer_usage_t usage = static_draw_usage, const primitive_type_t primitiveType = primitive_triangles,
+		occluded::buffers::storage::storage_allocator& allocator = occluded::buffers::storage::storage_allocator::get_default_allocator() );
 
 	/**
 	 * \brief Initializes an mesh.
@@ -81,9 +130,11 @@ public:
 	 * \param faces A reference to a vector of unsigned integers representing the vertices that make up the faces of the mesh.
 	 * \param primitiveType A primitive type that specifies which OpenGL primitive will be used to construct the faces of the mesh.
 	 *
-	 * Initializes the mesh by making a copy of an gl_attribute_buffer and a vector of indices. he default primitive used for constructing the mesh is
-	 * primitive_triangles. This constructor is to be used if the mesh is to be pre-built or to be built up from another mesh. An exception will be
-	 * thrown in the attribute map is still being defined or if the shader program has not been linked.
+	 * Initializes the mesh by making a copy of an gl_attribute_buffer and adding the faces in the vector of indices. he default primitive used for
+	 * constructing the mesh is primitive_triangles. This constructor is to be used if the mesh is to be pre-built or to be built up from another mesh.
+	 * The vertex data is shared with buffer until either of them is changed, so meshes and levels of detail built from the same vertices only store
+	 * them once. An exception will be thrown in the attribute map is still being defined, if the shader program has not been linked or if the faces
+	 * can not be added. \see { occluded::opengl::retained::gl_attribute_buffer }
 	 */
 	gl_retained_mesh( const GLuint vaoId, const shaders::shader_program& shaderProg, gl_attribute_buffer& buffer, const std::vector<unsigned int>& faces,
 		const primitive_type_t primitiveType = primitive_triangles );
@@ -97,6 +148,27 @@ public:
 	 */
 	void draw() const;
 
+	/**
+	 * \fn draw
+	 * \brief Draws a level of detail of the mesh.
+	 *
+	 * \param lod A reference to a level of detail generated from the vertices of the mesh.
+	 *
+	 * Draws the faces of the level of detail instead of the faces of the mesh. \see { generate_lods }
+	 */
+	void draw( const occluded::meshes::mesh_lod& lod ) const;
+
+	/**
+	 * \fn draw_meshlets
+	 * \brief Draws some of the meshlets of the mesh.
+	 *
+	 * \param meshlets A reference to a vector of unsigned ints containing the positions of the meshlets to be drawn in the meshlet table.
+	 *
+	 * Draws the faces of the meshlets that were not culled in a single draw call. An exception is thrown if a meshlet does not exist.
+	 * \see { build_meshlets }
+	 */
+	void draw_meshlets( const std::vector<unsigned int>& meshlets ) const;
+
 	/**
 	 * \fn add_vertices
 	 * \brief Adds vertices to the mesh.
@@ -105,10 +177,197 @@ public:
 	 * \return A vector of unsigned ints representing the indices of the vertices added.
 	 * 
 	 * Adds the vertices contained in the vector to the gl_attribute_buffer in the gl_retained_mesh. An exception will be thrown if the vertices 
-	 * vector is not formatted to be properly inserted into the data structure that is to contain the data.
+	 * vector is not formatted to be properly inserted into the data structure that is to contain the data. If vertex welding is enabled, the
+	 * index of a vertex that is equal to one already in the mesh is the index of the existing vertex.
 	 */
 	const std::vector<unsigned int> add_vertices( const std::vector<char>& vertices );
 
+	/**
+	 * \fn add_vertices
+	 * \brief Adds vertices to the mesh without an intermediate copy.
+	 *
+	 * \param vertices A pointer to the memory containing the vertices.
+	 * \param numVertices An unsigned int representing the number of vertices to be added.
+	 * \return A vector of unsigned ints representing the indices of the vertices added.
+	 *
+	 * Adds numVertices vertices directly from the memory pointed to by vertices to the gl_attribute_buffer in the gl_retained_mesh. The memory must
+	 * be formatted the same way as the vector passed to the other add_vertices function. If vertex welding is enabled, the unique vertices are
+	 * added with a single insertion and the index of every duplicate is the index of the vertex it is equal to.
+	 */
+	const std::vector<unsigned int> add_vertices( const void* vertices, const unsigned int numVertices );
+
+	/**
+	 * \fn add_vertices
+	 * \brief Adds a range of vertex structures to the mesh.
+	 *
+	 * \param first A forward iterator to the first vertex structure to be added.
+	 * \param last A forward iterator to the position after the last vertex structure to be added.
+	 * \return A vector of unsigned ints representing the indices of the vertices added.
+	 *
+	 * Adds the vertex structures in the range [first, last) to the gl_attribute_buffer in the gl_retained_mesh. An exception will be thrown if
+	 * the size of the vertex structure does not match the byte size of the mesh's attribute map.
+	 */
+	template<typename ForwardIterator>
+	const std::vector<unsigned int> add_vertices( ForwardIterator first, ForwardIterator last );
+
+	/**
+	 * \fn enable_vertex_welding
+	 * \brief Makes the mesh reuse existing vertices instead of adding duplicates.
+	 *
+	 * \param epsilon A float representing the largest difference between float components that are considered equal, or 0 to only weld
+	 * vertices that are bit-identical.
+	 *
+	 * Builds a table of the vertices already in the mesh, which every vertex added afterwards is looked up in. An exception is thrown if epsilon
+	 * is negative. \see { occluded::buffers::vertex_welder }
+	 */
+	void enable_vertex_welding( const float epsilon = 0.f );
+
+	/**
+	 * \fn disable_vertex_welding
+	 * \brief Makes the mesh add every vertex, and frees the table of vertices used for welding.
+	 */
+	void disable_vertex_welding();
+
+	/**
+	 * \fn is_vertex_welding_enabled
+	 * \brief Checks whether vertices are welded when they are added.
+	 *
+	 * \return Returns true if enable_vertex_welding has been called since vertex welding was last disabled, otherwise false.
+	 */
+	const bool is_vertex_welding_enabled() const;
+
+	/**
+	 * \fn erase_vertices
+	 * \brief Erases vertices from the mesh.
+	 *
+	 * \param firstVertex An unsigned int representing the index of the first vertex to be erased.
+	 * \param numVertices An unsigned int representing the number of vertices to be erased.
+	 *
+	 * Erases the vertices in the range [firstVertex, firstVertex + numVertices), so that their indices are reused by the next vertices added.
+	 * The indices of the other vertices do not change. An exception is thrown if a face of the mesh uses one of the vertices, or if the range
+	 * is not valid. \see { occluded::buffers::attribute_buffer::erase_values }
+	 */
+	void erase_vertices( const unsigned int firstVertex, const unsigned int numVertices );
+
+	/**
+	 * \fn compact
+	 * \brief Removes the erased vertices from the mesh.
+	 *
+	 * \return A vector of unsigned ints containing the new index of every vertex, indexed by its old index.
+	 *
+	 * Removes the erased vertices from the vertex buffer and updates the indices of the faces of the mesh to the new indices of their
+	 * vertices. Indices of vertices held outside of the mesh must be updated using the vector returned.
+	 */
+	const std::vector<unsigned int> compact();
+
+	/**
+	 * \fn optimize
+	 * \brief Reorders the faces and vertices of a finished mesh for the GPU.
+	 *
+	 * \param cacheSize An unsigned int representing the number of vertices in the post-transform cache that is optimized for.
+	 * \return A report containing the vertex cache statistics before and after optimizing and the new index of every vertex.
+	 *
+	 * Compacts the mesh, reorders the faces for the post-transform vertex cache and then renumbers the vertices in the order the faces first use
+	 * them, so the vertex buffer is read in order. Indices of vertices held outside of the mesh must be updated using the remap in the report.
+	 * An exception is thrown if the primitive of the mesh is not primitive_triangles. \see { occluded::meshes::vertex_cache_optimizer }
+	 */
+	const mesh_optimization_report optimize( const unsigned int cacheSize = occluded::meshes::vertex_cache_optimizer::DEFAULT_CACHE_SIZE );
+
+	/**
+	 * \fn optimize
+	 * \brief Reorders the faces and vertices of a finished opaque mesh for the GPU and to reduce overdraw.
+	 *
+	 * \param positionName A reference to a string containing the name of the attribute that holds the position of each vertex.
+	 * \param overdrawThreshold A float representing how much worse than the vertex cache order a cluster of faces may use the cache.
+	 * \param cacheSize An unsigned int representing the number of vertices in the post-transform cache that is optimized for.
+	 * \return A report containing the vertex cache statistics before and after optimizing and the new index of every vertex.
+	 *
+	 * Optimizes the mesh the same way as the other optimize function, except that the faces ordered for the vertex cache are then clustered and
+	 * the clusters are sorted so the faces most likely to occlude the rest of the mesh are drawn first. An exception is thrown if the primitive
+	 * of the mesh is not primitive_triangles, or if the position attribute does not exist or does not have 3 or 4 attrib_float components.
+	 * \see { occluded::meshes::overdraw_optimizer }
+	 */
+	const mesh_optimization_report optimize( const std::string& positionName,
+		const float overdrawThreshold = occluded::meshes::overdraw_optimizer::DEFAULT_THRESHOLD,
+		const unsigned int cacheSize = occluded::meshes::vertex_cache_optimizer::DEFAULT_CACHE_SIZE );
+
+	/**
+	 * \fn generate_lods
+	 * \brief Generates simplified versions of the faces of the mesh for drawing it at a distance.
+	 *
+	 * \param positionName A reference to a string containing the name of the attribute that holds the position of each vertex.
+	 * \param ratios A reference to a vector of floats containing the fraction of the faces to keep at each level, in decreasing order.
+	 * \param attributeWeights A reference to a vector containing the names of float attributes whose changes should be avoided, and how much
+	 * a difference in each of their components counts compared to a difference in position.
+	 * \param cacheSize An unsigned int representing the number of vertices in the post-transform cache the faces of each level are ordered
+	 * for.
+	 * \return A vector containing a level of detail for each ratio, and the error of each, which can be compared with the size of a pixel in
+	 * object space to choose a level.
+	 *
+	 * The levels use the vertices of the mesh, so they must be generated again if its vertices are compacted or optimized. An exception is
+	 * thrown if the primitive of the mesh is not primitive_triangles, an attribute does not exist or is not attrib_float, the position
+	 * attribute has fewer than 3 components, or a ratio is not valid. \see { occluded::meshes::mesh_simplifier }
+	 */
+	const std::vector<occluded::meshes::mesh_lod> generate_lods( const std::string& positionName, const std::vector<float>& ratios,
+		const std::vector< std::pair<std::string, float> >& attributeWeights = std::vector< std::pair<std::string, float> >(),
+		const unsigned int cacheSize = occluded::meshes::vertex_cache_optimizer::DEFAULT_CACHE_SIZE ) const;
+
+	/**
+	 * \fn build_meshlets
+	 * \brief Splits the faces of the mesh into meshlets, so parts of the mesh can be culled.
+	 *
+	 * \param positionName A reference to a string containing the name of the attribute that holds the position of each vertex.
+	 * \param maxVertices An unsigned int representing the largest number of vertices in a meshlet.
+	 * \param maxTriangles An unsigned int representing the largest number of faces in a meshlet.
+	 * \return A reference to the meshlet table, which is stored with the mesh.
+	 *
+	 * The meshlet table is cleared when faces are added to the mesh or the mesh is compacted or optimized, so it should be built once the
+	 * mesh is finished. An exception is thrown if the primitive of the mesh is not primitive_triangles, if the position attribute does not
+	 * exist or does not have at least 3 attrib_float components, or if a limit is not valid. \see { occluded::meshes::meshlet_builder }
+	 */
+	const occluded::meshes::meshlet_table& build_meshlets( const std::string& positionName,
+		const unsigned int maxVertices = occluded::meshes::meshlet_builder::DEFAULT_MAX_VERTICES,
+		const unsigned int maxTriangles = occluded::meshes::meshlet_builder::DEFAULT_MAX_TRIANGLES );
+
+	/**
+	 * \fn get_meshlets
+	 * \brief Gets the meshlets of the mesh.
+	 *
+	 * \return A reference to the meshlet table, which is empty if build_meshlets has not been called since the faces last changed.
+	 */
+	const occluded::meshes::meshlet_table& get_meshlets() const;
+
+	/**
+	 * \fn set_position_attribute
+	 * \brief Sets the attribute the bounds of the mesh are computed from.
+	 *
+	 * \param positionName A reference to a string containing the name of the attribute that holds the position of each vertex.
+	 *
+	 * Computes the bounds of the vertices already in the mesh, after which the bounds are grown by every vertex added. An exception is thrown
+	 * if the attribute does not exist or does not have at least 3 attrib_float components, in which case the bounds are left as they were.
+	 * \see { get_bounds }
+	 */
+	void set_position_attribute( const std::string& positionName );
+
+	/**
+	 * \fn get_position_attribute
+	 * \brief Gets the name of the attribute the bounds of the mesh are computed from.
+	 *
+	 * \return A reference to a string containing the name passed to set_position_attribute, or an empty string if it has not been called.
+	 */
+	const std::string& get_position_attribute() const;
+
+	/**
+	 * \fn get_bounds
+	 * \brief Gets the bounds of the vertices of the mesh.
+	 *
+	 * \return A reference to the box and sphere containing the positions of the vertices of the mesh.
+	 *
+	 * Only the vertices added are read to update the bounds, so they are never shrunk by erasing vertices. The bounds are empty until
+	 * set_position_attribute is called. \see { occluded::meshes::mesh_bounds }
+	 */
+	const occluded::meshes::mesh_bounds& get_bounds() const;
+
 	/**
 	 * \fn add_faces.
 	 * \brief Adds faces to the mesh.
@@ -154,7 +413,98 @@ public:
 	 */
 	const unsigned int num_verts_for_next_face( const unsigned int numFaces ) const;
 
+	/**
+	 * \fn get_vertex_buffer
+	 * \brief Gets the buffer the vertices of the mesh are stored in.
+	 *
+	 * \return A reference to the gl_attribute_buffer of the mesh.
+	 */
+	const gl_attribute_buffer& get_vertex_buffer() const;
+
+	/**
+	 * \fn get_index_type
+	 * \brief Gets the type the indices of the mesh are uploaded as.
+	 *
+	 * \return GL_UNSIGNED_BYTE if the mesh has at most 256 vertices, GL_UNSIGNED_SHORT if it has at most 65536 vertices, and otherwise
+	 * GL_UNSIGNED_INT. Erased vertices that have not been compacted are counted.
+	 */
+	const GLenum get_index_type() const;
+
 private:
+	/**
+	 * \fn weld_vertices
+	 * \brief Adds the vertices that are not already in the mesh.
+	 *
+	 * \param vertices A pointer to the memory containing the vertices, formatted the same way as for add_vertices.
+	 * \param numVertices An unsigned int representing the number of vertices.
+	 * \return A vector of unsigned ints containing the index of each vertex, which is the index of an existing vertex if it was a duplicate.
+	 */
+	const std::vector<unsigned int> weld_vertices( const char* vertices, const unsigned int numVertices );
+
+	/**
+	 * \fn weld_interleaved_vertices
+	 * \brief Adds the vertices that are not already in the mesh, from vertices that are interleaved whatever the layout of the mesh.
+	 *
+	 * \param vertices A pointer to the memory containing the vertices, each of which holds every attribute in the order of the attribute map.
+	 * \param numVertices An unsigned int representing the number of vertices.
+	 * \return A vector of unsigned ints containing the index of each vertex, which is the index of an existing vertex if it was a duplicate.
+	 */
+	const std::vector<unsigned int> weld_interleaved_vertices( const char* vertices, const unsigned int numVertices );
+
+	/**
+	 * \fn update_bounds
+	 * \brief Grows the bounds of the mesh to contain vertices that were just added.
+	 *
+	 * \param vertices A pointer to the memory containing the vertices, formatted the same way as for add_vertices.
+	 * \param numVertices An unsigned int representing the number of vertices.
+	 */
+	void update_bounds( const char* vertices, const unsigned int numVertices );
+
+	/**
+	 * \fn update_structure_bounds
+	 * \brief Grows the bounds of the mesh to contain vertex structures that were just added.
+	 *
+	 * \param first A forward iterator to the first vertex structure.
+	 * \param numVertices An unsigned int representing the number of vertex structures.
+	 *
+	 * Gathers the position of every structure into a single block, so the bounds are grown with one pass over all of them.
+	 */
+	template<typename ForwardIterator>
+	void update_structure_bounds( ForwardIterator first, const unsigned int numVertices );
+
+	/**
+	 * \fn update_structure_bounds
+	 * \brief Grows the bounds of the mesh to contain an array of vertex structures that were just added.
+	 *
+	 * Behaves like the iterator version, but the positions are read straight from the array, one structure apart.
+	 */
+	template<typename T>
+	void update_structure_bounds( T* first, const unsigned int numVertices );
+
+	/**
+	 * \fn optimize_faces
+	 * \brief Optimizes the mesh, reducing overdraw as well if positionName is not NULL.
+	 */
+	const mesh_optimization_report optimize_faces( const unsigned int cacheSize, const std::string* positionName, const float overdrawThreshold );
+
+	/**
+	 * \fn get_float_values
+	 * \brief Copies the components of a float attribute of every vertex.
+	 *
+	 * \param name A reference to a string containing the name of the attribute.
+	 * \param numComponents An unsigned int representing the number of components to copy from each vertex, or 0 to copy all of them.
+	 * \return A vector of floats containing the components of each vertex in turn.
+	 *
+	 * An exception is thrown if there is no attribute with the name, or if it is not attrib_float or has fewer than numComponents components.
+	 */
+	const std::vector<float> get_float_values( const std::string& name, const unsigned int numComponents ) const;
+
+	/**
+	 * \fn draw_indices
+	 * \brief Draws faces made up of the vertices of the mesh.
+	 */
+	void draw_indices( const std::vector<unsigned int>& indices ) const;
+
 	/**
 	 * \fn init_mesh
 	 * \brief Initializes the mesh.
@@ -167,9 +517,13 @@ private:
 	 * \fn bind_buffer
 	 * \brief Binds the index buffer.
 	 *
-	 * Binds and sets the data for the indice buffer.
+	 * \param indices A reference to a vector of unsigned ints containing the indices to be put in the buffer.
+	 * \param indexType A GLenum representing the type the indices are converted to, which every index must fit in.
+	 *
+	 * Binds the indice buffer and sets its data. The indices of the mesh are only converted and uploaded again if they or their type changed
+	 * since they were last uploaded, while any other indices are always uploaded and replace them in the buffer.
 	 */
-	void bind_buffer() const;
+	void bind_buffer( const std::vector<unsigned int>& indices, const GLenum indexType ) const;
 
 	/**
 	 * \fn check_face
@@ -224,6 +578,80 @@ private:
 	static unsigned int get_num_verts_for_init_face( const primitive_type_t primitiveType );
 };
 
+template<typename ForwardIterator>
+const std::vector<unsigned int> gl_retained_mesh::add_vertices( ForwardIterator first, ForwardIterator last ) {
+	if( m_welder ) {
+		typedef typename std::iterator_traits<ForwardIterator>::value_type structure_type;
+
+		if( sizeof( structure_type ) != m_buffer.get_buffer_map().get_byte_size() ) {
+			throw std::runtime_error( "gl_retained_mesh.add_vertices: Failed to add vertices because the size of the vertex structure does not match"
+				+ std::string( " the byte size of the attribute map." ) );
+		}
+
+		const unsigned int numVertices = static_cast<unsigned int>( std::distance( first, last ) );
+
+		if( numVertices == 0 )
+			return std::vector<unsigned int>();
+
+		const std::vector<unsigned int> nextIndices = m_buffer.get_next_indices( numVertices );
+		std::vector<unsigned int> indices( numVertices );
+		std::vector<const structure_type*> newVertices;
+
+		// The structures are already interleaved, so they are welded where they are and only the new ones are inserted, together, afterwards
+		for( unsigned int i = 0; i < numVertices; ++i, ++first ) {
+			const structure_type* vertex = &*first;
+
+			indices[i] = m_welder->weld( reinterpret_cast<const char*>( vertex ), nextIndices[newVertices.size()] );
+
+			if( indices[i] == nextIndices[newVertices.size()] )
+				newVertices.push_back( vertex );
+		}
+
+		if( !newVertices.empty() ) {
+			m_buffer.insert_values( boost::make_indirect_iterator( newVertices.begin() ), boost::make_indirect_iterator( newVertices.end() ) );
+			m_indicesDirty = true;
+
+			update_structure_bounds( boost::make_indirect_iterator( newVertices.begin() ), static_cast<unsigned int>( newVertices.size() ) );
+		}
+
+		return indices;
+	}
+
+	const unsigned int numVertices = static_cast<unsigned int>( std::distance( first, last ) );
+	const std::vector<unsigned int> indices = m_buffer.get_next_indices( numVertices );
+
+	m_buffer.insert_values( first, last );
+	update_structure_bounds( first, numVertices );
+
+	return indices;
+}
+
+template<typename ForwardIterator>
+void gl_retained_mesh::update_structure_bounds( ForwardIterator first, const unsigned int numVertices ) {
+	if( m_positionName.empty() || numVertices == 0 )
+		return;
+
+	// Structures hold every attribute in order whatever the layout of the mesh, so the position is at its interleaved offset
+	const std::size_t offset = m_buffer.get_buffer_map().get_attribute_offsets()[m_positionAttrib];
+	std::vector<float> positions( 3 * numVertices );
+
+	for( unsigned int i = 0; i < numVertices; ++i, ++first ) {
+		memcpy( &positions[3 * i], reinterpret_cast<const char*>( &*first ) + offset, 3 * sizeof( float ) );
+	}
+
+	m_bounds.add_positions( reinterpret_cast<const char*>( &positions[0] ), numVertices, 3 * sizeof( float ) );
+}
+
+template<typename T>
+void gl_retained_mesh::update_structure_bounds( T* first, const unsigned int numVertices ) {
+	if( m_positionName.empty() || numVertices == 0 )
+		return;
+
+	const std::size_t offset = m_buffer.get_buffer_map().get_attribute_offsets()[m_positionAttrib];
+
+	m_bounds.add_positions( reinterpret_cast<const char*>( first ) + offset, numVertices, sizeof( T ) );
+}
+
 } // end of retained namespace
 } // end of opengl namespace
 } // end of occluded namespace
@@ -3,12 +3,13 @@
 namespace occluded { namespace opengl { namespace retained { namespace shaders {
 
 shader_attribute_map::shader_attribute_map( const buffers::attributes::attribute_map& map, const shader_program& shaderProg ):
-	m_attribMap( map ),
 	m_shaderProg( shaderProg )
 {
-	if( m_attribMap.being_defined() )
+	if( map.being_defined() )
 		throw std::runtime_error( "shader_attribute_map.shader_attribute_map: Failed to create shader_attribute_map because attribute_map provided is still being defined." );
 
+	m_attribMap = buffers::attributes::attribute_map_registry::get_registry().intern( map );
+
 	if( !m_shaderProg.is_linked() )
 		throw std::runtime_error( "shader_attribute_map.shader_attribute_map: Failed to create shader_attribute_map because shader_program provided has not been linked." );
 
@@ -22,10 +23,12 @@ shader_attribute_map::~shader_attribute_map()
 
 void shader_attribute_map::set_attrib_pointers( const buffers::attribute_buffer& buffer ) const {
 	unsigned int i = 0;
-	std::vector<const buffers::attributes::attribute> attributes = m_attribMap.get_attributes();
+	const std::vector<const buffers::attributes::attribute>& attributes = m_attribMap->get_attributes();
+	const std::vector<unsigned int>& sections = m_attribMap->get_attribute_sections();
+	const std::vector<unsigned int>& strides = m_attribMap->get_section_strides();
 
-	// Checks to make sure the buffer's attribute map is the same as the attribute map
-	if( buffer.get_attribute_map() != m_attribMap ) {
+	// Checks to make sure the buffer's attribute map is the same as the attribute map. Both maps are interned, so equal maps are the same map
+	if( &buffer.get_attribute_map() != m_attribMap.get() ) {
 		throw std::runtime_error( "shader_attribute_map.set_attrib_pointers: Failed to set attribute pointers because the attribute_buffer's attribute_map passed does not match"
 			+ std::string( " the attribute_map contained byy the shader_attribute_map." ) );
 	}
@@ -44,15 +47,11 @@ void shader_attribute_map::set_attrib_pointers( const buffers::attribute_buffer&
 
 		// If the location exists, setup the attribute pointer
 		if( entry->second.second >= 0 ) {
-			if( m_attribMap.is_interleaved() ) {
-				glVertexAttribPointer( static_cast<GLuint>( entry->second.second ), static_cast<GLint>( attributes[i].get_arity() ), attributes[i].get_type(), 
-					static_cast<GLboolean>( attributes[i].is_normalized() ), static_cast<GLsizei>( m_attribMap.get_byte_size() ), 
-					reinterpret_cast<const GLvoid*>( buffer.get_attribute_data_offsets()[i] ) );
-			} else {
-				glVertexAttribPointer( static_cast<GLuint>( entry->second.second ), static_cast<GLint>( attributes[i].get_arity() ), attributes[i].get_type(),
-					static_cast<GLboolean>( attributes[i].is_normalized() ), static_cast<GLsizei>( 0 ), 
-					reinterpret_cast<const GLvoid*>( buffer.get_attribute_data_offsets()[i] ) );
-			}
+			// Each attribute uses the stride of its section, which is 0 for tightly packed segregated sections
+			const GLsizei stride = m_attribMap->get_layout() == buffers::attributes::layout_segregated ? 0 : static_cast<GLsizei>( strides[sections[i]] );
+
+			glVertexAttribPointer( static_cast<GLuint>( entry->second.second ), static_cast<GLint>( attributes[i].get_arity() ), get_gl_type( attributes[i].get_type() ),
+				static_cast<GLboolean>( attributes[i].is_normalized() ), stride, reinterpret_cast<const GLvoid*>( buffer.get_attribute_data_offsets()[i] ) );
 
 			if( GL_NO_ERROR != glGetError() )
 				throw std::runtime_error( "shader_attribute_map.set_attrib_pointers: OpenGL entered an error state after a vertex attrib pointer was attempted to be setup." );
@@ -63,7 +62,7 @@ void shader_attribute_map::set_attrib_pointers( const buffers::attribute_buffer&
 // Private Member Functions
 
 void shader_attribute_map::init_map() {
-	std::vector<const buffers::attributes::attribute> attributes = m_attribMap.get_attributes();
+	const std::vector<const buffers::attributes::attribute>& attributes = m_attribMap->get_attributes();
 
 	// Get the location of each attribute in the shader program
 	for( std::vector<const buffers::attributes::attribute>::const_iterator it = attributes.begin(); it != attributes.end(); ++it ) {
@@ -107,6 +106,47 @@ const std::string shader_attribute_map::get_shader_attrib_name( const std::strin
 	return shaderAttribName;
 }
 
+// Static Functions
+
+GLenum shader_attribute_map::get_gl_type( const buffers::attributes::attribute_t type ) {
+	GLenum glType = GL_FLOAT;
+
+	switch( type ) {
+	case buffers::attributes::attrib_float:
+		glType = GL_FLOAT;
+		break;
+	case buffers::attributes::attrib_uint:
+		glType = GL_UNSIGNED_INT;
+		break;
+	case buffers::attributes::attrib_int:
+		glType = GL_INT;
+		break;
+	case buffers::attributes::attrib_half_float:
+		glType = GL_HALF_FLOAT;
+		break;
+	case buffers::attributes::attrib_byte:
+		glType = GL_BYTE;
+		break;
+	case buffers::attributes::attrib_ubyte:
+		glType = GL_UNSIGNED_BYTE;
+		break;
+	case buffers::attributes::attrib_short:
+		glType = GL_SHORT;
+		break;
+	case buffers::attributes::attrib_ushort:
+		glType = GL_UNSIGNED_SHORT;
+		break;
+	case buffers::attributes::attrib_int_2_10_10_10_rev:
+		glType = GL_INT_2_10_10_10_REV;
+		break;
+	case buffers::attributes::attrib_invalid:
+	default:
+		throw std::runtime_error( "shader_attribute_map.get_gl_type: Failed to convert attribute type because it is not a valid type." );
+	}
+
+	return glType;
+}
+
 } // end of shaders namespace
 } // end of retained namespace
 } // end of opengl namespace
@@ -26,7 +26,7 @@ class shader_attribute_map
 {
 private:
 	const shader_program& m_shaderProg;
-	const buffers::attributes::attribute_map m_attribMap;
+	buffers::attributes::attribute_map_handle m_attribMap;
 
 	std::map< const std::string, std::pair<const std::string, GLint> > m_map;
 
@@ -53,7 +53,8 @@ public:
 	 * \param buffer The attribute buffer the attrib pointers will be set for.
 	 *
 	 * Makes all the necessary calls to glVertexAttribPointer that are needed in order to make a glDraw call. Used the necessary preparation 
-	 * for an OpenGL buffer object, thats data is organized according to the attribute_map, to be used by a glDraw call.
+	 * for an OpenGL buffer object, thats data is organized according to the attribute_map, to be used by a glDraw call. Each attribute is given
+	 * the stride of the section it is stored in, so a shader that only reads the first attribute of a hybrid buffer only fetches its section.
 	 */
 	void set_attrib_pointers( const buffers::attribute_buffer& buffer ) const;
 
@@ -76,6 +77,17 @@ private:
 	 * Takes the name of an attribute an converts it to its shader equivalent by capitalizing the first letter and adding a 'v' prefix.
 	 */
 	const std::string get_shader_attrib_name( const std::string& attribName ) const;
+
+	/**
+	 * \fn get_gl_type
+	 * \brief Converts the type of an attribute to its OpenGL equivalent.
+	 *
+	 * \param type An attribute_t representing the type of an attribute.
+	 * \return A GLenum representing the type that is passed to glVertexAttribPointer for the attribute.
+	 *
+	 * Converts the type of an attribute to the OpenGL enum for that type. An exception is thrown if the type is attrib_invalid.
+	 */
+	static GLenum get_gl_type( const buffers::attributes::attribute_t type );
 };
 
 } // end of shaders namespace
@@ -0,0 +1,121 @@
+#include "mapped_file.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace occluded { namespace utilities { namespace files {
+
+#ifdef _WIN32
+
+mapped_file::mapped_file( const std::string& filePath ):
+	m_data( NULL ),
+	m_size( 0 ),
+	m_fileHandle( INVALID_HANDLE_VALUE ),
+	m_mappingHandle( NULL )
+{
+	LARGE_INTEGER fileSize;
+
+	m_fileHandle = CreateFileA( filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+
+	if( m_fileHandle == INVALID_HANDLE_VALUE ) {
+		throw std::runtime_error( "mapped_file: Failed to map file(" + filePath + ") because there was an error opening the file." );
+	}
+
+	if( !GetFileSizeEx( m_fileHandle, &fileSize ) ) {
+		CloseHandle( m_fileHandle );
+		throw std::runtime_error( "mapped_file: Failed to map file(" + filePath + ") because the size of the file could not be read." );
+	}
+
+	m_size = static_cast<std::size_t>( fileSize.QuadPart );
+
+	// Empty files can not be mapped, but there is nothing to read from them anyway
+	if( m_size > 0 ) {
+		m_mappingHandle = CreateFileMappingA( m_fileHandle, NULL, PAGE_READONLY, 0, 0, NULL );
+
+		if( m_mappingHandle != NULL )
+			m_data = static_cast<const char*>( MapViewOfFile( m_mappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+
+		if( m_data == NULL ) {
+			if( m_mappingHandle != NULL )
+				CloseHandle( m_mappingHandle );
+
+			CloseHandle( m_fileHandle );
+			throw std::runtime_error( "mapped_file: Failed to map file(" + filePath + ") because there was an error mapping the file." );
+		}
+	}
+}
+
+mapped_file::~mapped_file()
+{
+	if( m_data != NULL )
+		UnmapViewOfFile( m_data );
+
+	if( m_mappingHandle != NULL )
+		CloseHandle( m_mappingHandle );
+
+	CloseHandle( m_fileHandle );
+}
+
+#else
+
+mapped_file::mapped_file( const std::string& filePath ):
+	m_data( NULL ),
+	m_size( 0 )
+{
+	struct stat fileStats;
+	const int fileDescriptor = open( filePath.c_str(), O_RDONLY );
+
+	if( fileDescriptor < 0 ) {
+		throw std::runtime_error( "mapped_file: Failed to map file(" + filePath + ") because there was an error opening the file." );
+	}
+
+	if( fstat( fileDescriptor, &fileStats ) != 0 ) {
+		close( fileDescriptor );
+		throw std::runtime_error( "mapped_file: Failed to map file(" + filePath + ") because the size of the file could not be read." );
+	}
+
+	m_size = static_cast<std::size_t>( fileStats.st_size );
+
+	// Empty files can not be mapped, but there is nothing to read from them anyway
+	if( m_size > 0 ) {
+		void* data = mmap( NULL, m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0 );
+
+		if( data == MAP_FAILED ) {
+			close( fileDescriptor );
+			throw std::runtime_error( "mapped_file: Failed to map file(" + filePath + ") because there was an error mapping the file." );
+		}
+
+		m_data = static_cast<const char*>( data );
+	}
+
+	// The mapping keeps its own reference to the file
+	close( fileDescriptor );
+}
+
+mapped_file::~mapped_file()
+{
+	if( m_data != NULL )
+		munmap( const_cast<char*>( m_data ), m_size );
+}
+
+#endif
+
+const char* mapped_file::get_data() const {
+	return m_data;
+}
+
+const std::size_t mapped_file::get_size() const {
+	return m_size;
+}
+
+} // end of files namespace
+} // end of utilities namespace
+} // end of occluded namespace
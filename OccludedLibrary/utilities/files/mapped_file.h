@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace occluded { namespace utilities { namespace files {
+
+/**
+ * \class mapped_file
+ * \brief A read-only view of a file's contents mapped into memory.
+ *
+ * Maps the whole contents of a file into memory, so the file can be read directly from the operating system's page cache instead of being
+ * copied into memory first. Pages are only read from disk when they are first touched. The mapping is released when the object is destroyed.
+ */
+class mapped_file
+{
+private:
+	const char* m_data;
+	std::size_t m_size;
+
+#ifdef _WIN32
+	void* m_fileHandle;
+	void* m_mappingHandle;
+#endif
+
+public:
+	/**
+	 * \brief Maps a file into memory.
+	 *
+	 * \param filePath A reference to a string representing the file path of the file.
+	 *
+	 * Maps the contents of the file located at filePath into memory as read-only. An exception is thrown if the file can not be opened or mapped.
+	 */
+	mapped_file( const std::string& filePath );
+	~mapped_file();
+
+	/**
+	 * \fn get_data
+	 * \brief Gets the contents of the file.
+	 *
+	 * \return A pointer to the first byte of the file, which is aligned to a page boundary, or NULL if the file is empty.
+	 */
+	const char* get_data() const;
+
+	/**
+	 * \fn get_size
+	 * \brief Gets the size of the file.
+	 *
+	 * \return A std::size_t representing the size of the file in bytes.
+	 */
+	const std::size_t get_size() const;
+
+private:
+	mapped_file( const mapped_file& other );
+	mapped_file& operator=( const mapped_file& other );
+};
+
+} // end of files namespace 
+} // end of utilities namespace
+} // end of occluded namespace
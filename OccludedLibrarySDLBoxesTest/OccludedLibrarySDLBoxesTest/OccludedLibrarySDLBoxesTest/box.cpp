@@ -130,7 +130,6 @@ void box::set_attrib_pointers() {
 // Private Static Functions
 
 void box::populate_box_buffer( occluded::opengl::retained::gl_attribute_buffer& buffer ) {
-	std::vector<char> data( buffer.get_buffer_map().get_byte_size() );
 	float vertexX, vertexY, vertexZ;
 	float colorR, colorG, colorB;
 
@@ -186,16 +185,9 @@ void box::populate_box_buffer( occluded::opengl::retained::gl_attribute_buffer&
 }
 
 void box::place_vertex_in_buffer( occluded::opengl::retained::gl_attribute_buffer& buffer, float vertX, float vertY, float vertZ, float colR, float colG, float colB ) {
-	std::vector<char> data( buffer.get_buffer_map().get_byte_size() );
+	const float vertex[] = { vertX, vertY, vertZ, colR, colG, colB };
 
-	memcpy( &data[0], &vertX, sizeof( float ) );
-	memcpy( &data[sizeof(float)], &vertY, sizeof( float ) );
-	memcpy( &data[2*sizeof(float)], &vertZ, sizeof( float ) );
-	memcpy( &data[3*sizeof(float)], &colR, sizeof( float ) );
-	memcpy( &data[4*sizeof(float)], &colG, sizeof( float ) );
-	memcpy( &data[5*sizeof(float)], &colB, sizeof( float ) );
-
-	buffer.insert_values( data );
+	buffer.insert_values( vertex, 1 );
 }
 
 void box::populate_box_indices( std::vector<unsigned int>& indices ) {
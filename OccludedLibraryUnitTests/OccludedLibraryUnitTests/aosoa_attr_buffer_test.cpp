@@ -0,0 +1,236 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <buffers/aosoa_attr_buffer.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+using namespace occluded::buffers::attributes;
+
+namespace OccludedLibraryUnitTests
+{
+	static attribute_map* aosoaMap = NULL;
+
+	TEST_CLASS( aosoa_attr_buffer_test )
+	{
+	public:
+
+		TEST_CLASS_INITIALIZE( aosoa_attr_buffer_class_init )
+		{
+			aosoaMap = new attribute_map( layout_interleaved );
+		}
+
+		TEST_CLASS_CLEANUP( aosoa_attr_buffer_class_delete )
+		{
+			delete aosoaMap;
+			aosoaMap = NULL;
+		}
+
+		TEST_METHOD_INITIALIZE( aosoa_attr_buffer_method_init )
+		{
+			aosoaMap->reset( layout_interleaved );
+			aosoaMap->add_attribute( attribute( "position", 3, attrib_float ) );
+			aosoaMap->add_attribute( attribute( "colour", 1, attrib_float ) );
+			aosoaMap->end_definition();
+		}
+
+		TEST_METHOD( aosoa_attr_buffer_invalid_map_test )
+		{
+			try {
+				aosoa_attr_buffer testBuffer( *aosoaMap, 6 );
+
+				// Test to make sure an exception is thrown if the block width is not supported
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			aosoaMap->reset( layout_interleaved );
+			aosoaMap->add_attribute( attribute( "position", 3, attrib_short ) );
+			aosoaMap->end_definition();
+
+			try {
+				aosoa_attr_buffer testBuffer( *aosoaMap );
+
+				// Test to make sure an exception is thrown if an attribute's components are not 4 bytes
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			aosoaMap->reset( layout_interleaved );
+
+			try {
+				aosoa_attr_buffer testBuffer( *aosoaMap );
+
+				// Test to make sure an exception is thrown if the attribute map is still being defined
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( aosoa_attr_buffer_insert_values_test )
+		{
+			aosoa_attr_buffer testBuffer( *aosoaMap, 4 );
+			std::vector<float> initialVals;
+
+			for( unsigned int i = 0; i < 5; ++i ) {
+				initialVals.push_back( static_cast<float>( i ) );
+				initialVals.push_back( static_cast<float>( 10 + i ) );
+				initialVals.push_back( static_cast<float>( 20 + i ) );
+				initialVals.push_back( static_cast<float>( 30 + i ) );
+			}
+
+			// Test to make sure the index of the first value inserted is returned
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testBuffer.insert_values( &initialVals[0], 5 ) );
+			Assert::AreEqual( static_cast<unsigned int>( 5 ), testBuffer.get_num_values() );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testBuffer.get_num_blocks() );
+
+			// Test to make sure each component of each value is stored in its own lane
+			Assert::AreEqual( 0.f, testBuffer.get_lanes( 0, 0, 0 )[0] );
+			Assert::AreEqual( 3.f, testBuffer.get_lanes( 0, 0, 0 )[3] );
+			Assert::AreEqual( 12.f, testBuffer.get_lanes( 0, 0, 1 )[2] );
+			Assert::AreEqual( 31.f, testBuffer.get_lanes( 0, 1, 0 )[1] );
+			Assert::AreEqual( 24.f, testBuffer.get_lanes( 1, 0, 2 )[0] );
+			Assert::AreEqual( 34.f, testBuffer.get_lanes( 1, 1, 0 )[0] );
+
+			// Test to make sure the lanes after the last value are 0 and each row is aligned to its size
+			Assert::AreEqual( 0.f, testBuffer.get_lanes( 1, 0, 0 )[1] );
+			Assert::AreEqual( 0.f, testBuffer.get_lanes( 1, 1, 0 )[3] );
+			Assert::AreEqual( static_cast<std::size_t>( 0 ), reinterpret_cast<std::size_t>( testBuffer.get_lanes( 1, 0, 1 ) ) % ( 4 * sizeof( float ) ) );
+
+			try {
+				testBuffer.get_lanes( 0, 1, 1 );
+
+				// Test to make sure an exception is thrown if the component does not exist
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			std::vector<float> readVals( initialVals.size() );
+
+			testBuffer.read_values( 0, 5, &readVals[0] );
+
+			// Test to make sure the values are read back as the structures they were inserted as
+			Assert::IsTrue( readVals == initialVals );
+		}
+
+		TEST_METHOD( aosoa_attr_buffer_transform_points_test )
+		{
+			aosoa_attr_buffer testBuffer( *aosoaMap );
+			const float initialVals[] = { 1.f, 2.f, 3.f, 5.f, 4.f, 5.f, 6.f, 7.f, -1.f, 0.f, 1.f, 9.f };
+			// Scales x by 2 and translates by( 10, 20, 30 ), in column-major order
+			const float matrix[] = { 2.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 10.f, 20.f, 30.f, 1.f };
+			float testVals[12];
+
+			testBuffer.insert_values( initialVals, 3 );
+			testBuffer.transform_points( 0, matrix );
+			testBuffer.read_values( 0, 3, testVals );
+
+			// Test to make sure every point was transformed and the other attributes were left alone
+			Assert::AreEqual( 12.f, testVals[0] );
+			Assert::AreEqual( 22.f, testVals[1] );
+			Assert::AreEqual( 33.f, testVals[2] );
+			Assert::AreEqual( 5.f, testVals[3] );
+			Assert::AreEqual( 8.f, testVals[8] );
+			Assert::AreEqual( 20.f, testVals[9] );
+			Assert::AreEqual( 31.f, testVals[10] );
+			Assert::AreEqual( 9.f, testVals[11] );
+
+			// Test to make sure the empty lanes of the last block are still 0
+			Assert::AreEqual( 0.f, testBuffer.get_lanes( 0, 0, 0 )[3] );
+			Assert::AreEqual( 0.f, testBuffer.get_lanes( 0, 0, 2 )[7] );
+
+			try {
+				testBuffer.transform_points( 1, matrix );
+
+				// Test to make sure an exception is thrown if the attribute has fewer than three components
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( aosoa_attr_buffer_convert_test )
+		{
+			attribute_map segregatedMap( layout_segregated );
+			std::vector<float> initialVals;
+
+			segregatedMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			segregatedMap.add_attribute( attribute( "colour", 1, attrib_float ) );
+			segregatedMap.end_definition();
+
+			std::auto_ptr<attribute_buffer> sourceBuffer = attribute_buffer_factory::create_attribute_buffer( segregatedMap );
+
+			// The positions of all 20 values, followed by their colours
+			for( unsigned int i = 0; i < 20; ++i ) {
+				initialVals.push_back( static_cast<float>( i ) );
+				initialVals.push_back( static_cast<float>( 100 + i ) );
+				initialVals.push_back( static_cast<float>( 200 + i ) );
+			}
+
+			for( unsigned int i = 0; i < 20; ++i ) {
+				initialVals.push_back( static_cast<float>( 300 + i ) );
+			}
+
+			sourceBuffer->insert_values( &initialVals[0], 20 );
+
+			aosoa_attr_buffer testBuffer( *sourceBuffer, 16 );
+
+			// Test to make sure every value of a segregated buffer is gathered into the blocks
+			Assert::AreEqual( static_cast<unsigned int>( 20 ), testBuffer.get_num_values() );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testBuffer.get_num_blocks() );
+			Assert::AreEqual( 115.f, testBuffer.get_lanes( 0, 0, 1 )[15] );
+			Assert::AreEqual( 219.f, testBuffer.get_lanes( 1, 0, 2 )[3] );
+			Assert::AreEqual( 316.f, testBuffer.get_lanes( 1, 1, 0 )[0] );
+
+			std::auto_ptr<attribute_buffer> interleavedBuffer = testBuffer.create_interleaved_buffer();
+			const float* testVals = reinterpret_cast<const float*>( interleavedBuffer->get_data() );
+
+			// Test to make sure the converted buffer is interleaved and holds every value
+			Assert::IsTrue( interleavedBuffer->get_attribute_map().is_interleaved() );
+			Assert::AreEqual( static_cast<unsigned int>( 20 ), interleavedBuffer->get_num_values() );
+			Assert::AreEqual( 0.f, testVals[0] );
+			Assert::AreEqual( 300.f, testVals[3] );
+			Assert::AreEqual( 19.f, testVals[76] );
+			Assert::AreEqual( 119.f, testVals[77] );
+			Assert::AreEqual( 319.f, testVals[79] );
+		}
+
+		TEST_METHOD( aosoa_attr_buffer_convert_hybrid_test )
+		{
+			attribute_map hybridMap( layout_hybrid );
+			std::vector<float> initialVals;
+
+			hybridMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			hybridMap.add_attribute( attribute( "colour", 1, attrib_float ) );
+			hybridMap.add_attribute( attribute( "normal", 3, attrib_float ) );
+			hybridMap.end_definition();
+
+			std::auto_ptr<attribute_buffer> sourceBuffer = attribute_buffer_factory::create_attribute_buffer( hybridMap );
+
+			// The positions of all 10 values, followed by their interleaved colours and normals
+			for( unsigned int i = 0; i < 10; ++i ) {
+				initialVals.push_back( static_cast<float>( i ) );
+				initialVals.push_back( static_cast<float>( 100 + i ) );
+				initialVals.push_back( static_cast<float>( 200 + i ) );
+			}
+
+			for( unsigned int i = 0; i < 10; ++i ) {
+				initialVals.push_back( static_cast<float>( 300 + i ) );
+				initialVals.push_back( static_cast<float>( 400 + i ) );
+				initialVals.push_back( static_cast<float>( 500 + i ) );
+				initialVals.push_back( static_cast<float>( 600 + i ) );
+			}
+
+			sourceBuffer->insert_values( &initialVals[0], 10 );
+
+			aosoa_attr_buffer testBuffer( *sourceBuffer, 8 );
+
+			// Test to make sure each attribute of a section holding several attributes is gathered from its own offset
+			Assert::AreEqual( static_cast<unsigned int>( 10 ), testBuffer.get_num_values() );
+			Assert::AreEqual( 107.f, testBuffer.get_lanes( 0, 0, 1 )[7] );
+			Assert::AreEqual( 302.f, testBuffer.get_lanes( 0, 1, 0 )[2] );
+			Assert::AreEqual( 405.f, testBuffer.get_lanes( 0, 2, 0 )[5] );
+			Assert::AreEqual( 508.f, testBuffer.get_lanes( 1, 2, 1 )[0] );
+			Assert::AreEqual( 609.f, testBuffer.get_lanes( 1, 2, 2 )[1] );
+		}
+	};
+}
@@ -0,0 +1,100 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <buffers/interleaved_attr_buffer.h>
+#include <buffers/storage/arena_allocator.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+using namespace occluded::buffers::attributes;
+using namespace occluded::buffers::storage;
+
+namespace OccludedLibraryUnitTests
+{
+	TEST_CLASS( arena_allocator_test )
+	{
+	public:
+
+		TEST_METHOD( arena_allocator_invalid_param_test )
+		{
+			try {
+				arena_allocator testArena( 0 );
+
+				// Test to make sure an exception is thrown when the block size is 0
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( arena_allocator_allocate_test )
+		{
+			arena_allocator testArena( 1024 );
+
+			// Test to make sure no memory is allocated until it is needed
+			Assert::AreEqual( static_cast<std::size_t>( 0 ), testArena.get_num_blocks() );
+
+			char* first = static_cast<char*>( testArena.allocate( 100 ) );
+			char* second = static_cast<char*>( testArena.allocate( 10 ) );
+
+			// Test to make sure small allocations are placed next to each other in the same block
+			Assert::AreEqual( static_cast<std::size_t>( 1 ), testArena.get_num_blocks() );
+			Assert::IsTrue( second == first + 112 );
+
+			testArena.deallocate( second, 10 );
+
+			// Test to make sure the most recent allocation is reused once it is given back
+			Assert::IsTrue( testArena.allocate( 16 ) == second );
+
+			testArena.deallocate( first, 100 );
+
+			// Test to make sure memory that is not the most recent allocation is not reused
+			Assert::IsFalse( testArena.allocate( 100 ) == first );
+
+			testArena.allocate( 600 );
+
+			// Test to make sure a large allocation gets its own block
+			Assert::AreEqual( static_cast<std::size_t>( 2 ), testArena.get_num_blocks() );
+			Assert::AreEqual( static_cast<std::size_t>( 1024 + 608 ), testArena.get_bytes_allocated() );
+
+			testArena.allocate( 900 / 2 );
+			testArena.allocate( 900 / 2 );
+
+			// Test to make sure a new block is started when the current block is full
+			Assert::AreEqual( static_cast<std::size_t>( 3 ), testArena.get_num_blocks() );
+
+			testArena.reset();
+
+			// Test to make sure resetting the arena frees every block
+			Assert::AreEqual( static_cast<std::size_t>( 0 ), testArena.get_num_blocks() );
+			Assert::AreEqual( static_cast<std::size_t>( 0 ), testArena.get_bytes_allocated() );
+		}
+
+		TEST_METHOD( arena_allocator_attribute_buffer_test )
+		{
+			arena_allocator testArena;
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "test", 1, attrib_float ) );
+			testMap.end_definition();
+
+			const float values[] = { 1.f, 2.f, 3.f };
+
+			{
+				interleaved_attr_buffer firstBuffer( testMap, testArena );
+				interleaved_attr_buffer secondBuffer( testMap, testArena );
+
+				firstBuffer.insert_values( static_cast<const void*>( values ), 3 );
+				secondBuffer.insert_values( static_cast<const void*>( values ), 3 );
+
+				// Test to make sure the buffers store their values in the arena instead of separate heap allocations
+				Assert::IsTrue( &firstBuffer.get_storage_allocator() == &testArena );
+				Assert::AreEqual( static_cast<std::size_t>( 1 ), testArena.get_num_blocks() );
+				Assert::AreEqual( 3.f, reinterpret_cast<const float*>( &secondBuffer.get_all_data()[0] )[2] );
+			}
+
+			testArena.reset();
+
+			// Test to make sure the memory of the buffers is freed by resetting the arena
+			Assert::AreEqual( static_cast<std::size_t>( 0 ), testArena.get_bytes_allocated() );
+		}
+	};
+}
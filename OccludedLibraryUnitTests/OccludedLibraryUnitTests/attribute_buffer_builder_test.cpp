@@ -0,0 +1,137 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <buffers/attribute_buffer_builder.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+using namespace occluded::buffers::attributes;
+
+namespace OccludedLibraryUnitTests
+{
+	TEST_CLASS( attribute_buffer_builder_test )
+	{
+	public:
+
+		TEST_METHOD( attribute_buffer_builder_build_test )
+		{
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "position", 2, attrib_float ) );
+			testMap.add_attribute( attribute( "weight", 1, attrib_float ) );
+			testMap.end_definition();
+
+			attribute_buffer_builder testBuilder( testMap, 3 );
+			const float firstValues[] = { 0.f, 1.f, 10.f, 2.f, 3.f, 20.f }, secondValues[] = { 4.f, 5.f, 30.f };
+			const unsigned int firstIndices[] = { 0, 1, 1 }, secondIndices[] = { 0, 0, 0 };
+
+			// The chunks are filled out of order and the middle chunk is left empty
+			testBuilder.get_chunk( 2 ).add_values( static_cast<const void*>( secondValues ), 1 );
+			testBuilder.get_chunk( 2 ).add_indices( std::vector<unsigned int>( secondIndices, secondIndices + 3 ) );
+			testBuilder.get_chunk( 0 ).add_values( static_cast<const void*>( firstValues ), 2 );
+			testBuilder.get_chunk( 0 ).add_indices( std::vector<unsigned int>( firstIndices, firstIndices + 3 ) );
+
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), testBuilder.get_num_values() );
+
+			std::vector<unsigned int> indices;
+			std::auto_ptr<attribute_buffer> testBuffer = testBuilder.build( indices );
+			const float* positions = reinterpret_cast<const float*>( testBuffer->get_data() + testBuffer->get_attribute_data_offsets()[0] );
+			const float* weights = reinterpret_cast<const float*>( testBuffer->get_data() + testBuffer->get_attribute_data_offsets()[1] );
+
+			// Test to make sure the chunks are merged in order into a segregated buffer
+			Assert::IsNotNull( dynamic_cast<segregated_attr_buffer*>( testBuffer.get() ) );
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), testBuffer->get_num_values() );
+			Assert::AreEqual( 3.f, positions[3] );
+			Assert::AreEqual( 4.f, positions[4] );
+			Assert::AreEqual( 30.f, weights[2] );
+
+			// Test to make sure the indices of each chunk are offset by the index of its first value
+			Assert::AreEqual( static_cast<std::size_t>( 6 ), indices.size() );
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), indices[2] );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), indices[3] );
+
+			// Test to make sure the chunks are emptied once they are merged
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testBuilder.get_num_values() );
+		}
+
+		TEST_METHOD( attribute_buffer_builder_interleaved_test )
+		{
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 2, attrib_float ) );
+			testMap.add_attribute( attribute( "weight", 1, attrib_float ) );
+			testMap.end_definition();
+
+			attribute_buffer_builder testBuilder( testMap, 2 );
+			const float values[] = { 0.f, 1.f, 10.f, 2.f, 3.f, 20.f };
+
+			testBuilder.get_chunk( 0 ).add_values( static_cast<const void*>( values ), 1 );
+			testBuilder.get_chunk( 1 ).add_values( static_cast<const void*>( values + 3 ), 1 );
+
+			std::vector<unsigned int> indices( 1, 5 );
+			std::auto_ptr<attribute_buffer> testBuffer = testBuilder.build( indices );
+
+			// Test to make sure the chunks are merged into an interleaved buffer and the indices passed in are replaced
+			Assert::IsNotNull( dynamic_cast<interleaved_attr_buffer*>( testBuffer.get() ) );
+			Assert::IsTrue( memcmp( testBuffer->get_data(), values, sizeof( values ) ) == 0 );
+			Assert::IsTrue( indices.empty() );
+
+			testBuilder.get_chunk( 0 ).add_values( static_cast<const void*>( values ), 1 );
+			testBuilder.get_chunk( 1 ).add_indices( std::vector<unsigned int>( 1, 0 ) );
+
+			try {
+				testBuilder.build( indices );
+
+				// Test to make sure an exception is thrown when an index refers to a value in another chunk
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			// Test to make sure a failed build leaves the chunks unchanged
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), testBuilder.get_num_values() );
+
+			try {
+				testBuilder.get_chunk( 2 );
+
+				// Test to make sure an exception is thrown when the chunk does not exist
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			try {
+				attribute_buffer_builder invalidBuilder( testMap, 0 );
+
+				// Test to make sure an exception is thrown when the builder has no chunks
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( attribute_buffer_builder_hybrid_test )
+		{
+			attribute_map testMap( layout_hybrid );
+			testMap.add_attribute( attribute( "position", 2, attrib_float ) );
+			testMap.add_attribute( attribute( "normal", 1, attrib_float ) );
+			testMap.add_attribute( attribute( "weight", 1, attrib_float ) );
+			testMap.end_definition();
+
+			attribute_buffer_builder testBuilder( testMap, 2 );
+			const float values[] = { 0.f, 1.f, 10.f, 100.f, 2.f, 3.f, 20.f, 200.f, 4.f, 5.f, 30.f, 300.f };
+
+			testBuilder.get_chunk( 0 ).add_values( static_cast<const void*>( values ), 2 );
+			testBuilder.get_chunk( 1 ).add_values( static_cast<const void*>( values + 8 ), 1 );
+
+			std::vector<unsigned int> indices;
+			std::auto_ptr<attribute_buffer> testBuffer = testBuilder.build( indices );
+
+			const float* positions = reinterpret_cast<const float*>( testBuffer->get_data() + testBuffer->get_attribute_data_offsets()[0] );
+			const float* rest = reinterpret_cast<const float*>( testBuffer->get_data() + testBuffer->get_attribute_data_offsets()[1] );
+
+			// Test to make sure the chunks are merged into a hybrid buffer with the positions packed and the other attributes interleaved
+			Assert::IsNotNull( dynamic_cast<hybrid_attr_buffer*>( testBuffer.get() ) );
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), testBuffer->get_num_values() );
+			Assert::AreEqual( 3.f, positions[3] );
+			Assert::AreEqual( 5.f, positions[5] );
+			Assert::AreEqual( 20.f, rest[2] );
+			Assert::AreEqual( 300.f, rest[5] );
+		}
+	};
+}
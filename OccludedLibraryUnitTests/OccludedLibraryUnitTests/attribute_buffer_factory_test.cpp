@@ -38,7 +38,89 @@ namespace OccludedLibraryUnitTests
 			} catch( std::exception& ) {
 				Assert::Fail();
 			}
+
+			testMap.reset( layout_hybrid );
+			testMap.add_attribute( attribute( "test", 1, attrib_uint ) );
+			testMap.end_definition();
+
+			try {
+				std::auto_ptr<attribute_buffer> testBuffer = attribute_buffer_factory::create_attribute_buffer( testMap );
+
+				// Test to make sure a hybrid attribute map creates a hybrid attribute buffer
+				Assert::IsNotNull( dynamic_cast<hybrid_attr_buffer*>( testBuffer.get() ) );
+			} catch( std::exception& ) {
+				Assert::Fail();
+			}
+		}
+
+		TEST_METHOD( attribute_buffer_factory_create_transcoded_buffer_test )
+		{
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.add_attribute( attribute( "id", 1, attrib_uint ) );
+			testMap.end_definition();
+
+			std::auto_ptr<attribute_buffer> interleavedBuffer = attribute_buffer_factory::create_attribute_buffer( testMap );
+			std::vector<float> values;
+
+			for( unsigned int i = 0; i < 6 * 4; ++i ) {
+				values.push_back( static_cast<float>( i ) );
+			}
+
+			interleavedBuffer->insert_values( static_cast<const void*>( &values[0] ), 6 );
+
+			std::auto_ptr<attribute_buffer> segregatedBuffer = attribute_buffer_factory::create_transcoded_buffer( *interleavedBuffer );
+
+			// Test to make sure the interleaved buffer was split into sections
+			Assert::IsFalse( segregatedBuffer->get_attribute_map().is_interleaved() );
+			Assert::AreEqual( static_cast<unsigned int>( 6 ), segregatedBuffer->get_num_values() );
+
+			const float* testIds = reinterpret_cast<const float*>( &segregatedBuffer->get_all_data()[segregatedBuffer->get_attribute_data_offsets()[1]] );
+
+			for( unsigned int i = 0; i < 6; ++i ) {
+				Assert::AreEqual( values[4 * i + 3], testIds[i] );
+			}
+
+			// Test to make sure values can still be appended to the transcoded buffer
+			segregatedBuffer->insert_values( static_cast<const void*>( &values[0] ), 1 );
+			Assert::AreEqual( static_cast<unsigned int>( 7 ), segregatedBuffer->get_num_values() );
+
+			std::auto_ptr<attribute_buffer> roundTripBuffer = attribute_buffer_factory::create_transcoded_buffer( *segregatedBuffer );
+
+			// Test to make sure transcoding the buffer back restores the interleaved values
+			Assert::IsTrue( roundTripBuffer->get_attribute_map().is_interleaved() );
+			Assert::AreEqual( static_cast<unsigned int>( 7 ), roundTripBuffer->get_num_values() );
+			Assert::AreEqual( 0, memcmp( &interleavedBuffer->get_all_data()[0], &roundTripBuffer->get_all_data()[0], 6 * testMap.get_byte_size() ) );
+			Assert::AreEqual( 0, memcmp( &values[0], &roundTripBuffer->get_all_data()[6 * testMap.get_byte_size()], testMap.get_byte_size() ) );
 		}
 
+		TEST_METHOD( attribute_buffer_factory_create_copy_test )
+		{
+			attribute_map testMap( layout_hybrid );
+			testMap.add_attribute( attribute( "position", 2, attrib_float ) );
+			testMap.add_attribute( attribute( "weight", 1, attrib_float ) );
+			testMap.end_definition();
+
+			hybrid_attr_buffer testBuffer( testMap );
+			const float values[] = { 0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 10.f, 20.f, 30.f };
+
+			testBuffer.insert_values( static_cast<const void*>( values ), 3 );
+			testBuffer.erase_values( 1, 1 );
+
+			std::auto_ptr<attribute_buffer> copy = attribute_buffer_factory::create_copy( testBuffer );
+
+			// Test to make sure the copy has the same organization, values and erased values as the buffer
+			Assert::IsNotNull( dynamic_cast<hybrid_attr_buffer*>( copy.get() ) );
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), copy->get_num_values() );
+			Assert::AreEqual( 5.f, reinterpret_cast<const float*>( copy->get_data() + copy->get_attribute_data_offsets()[0] )[5] );
+			Assert::AreEqual( 30.f, reinterpret_cast<const float*>( copy->get_data() + copy->get_attribute_data_offsets()[1] )[2] );
+			Assert::IsTrue( copy->is_value_erased( 1 ) );
+			Assert::IsTrue( copy->is_all_dirty() );
+
+			copy->update_values( 0, 1, values + 3 );
+
+			// Test to make sure changing the copy does not change the buffer
+			Assert::AreEqual( 0.f, reinterpret_cast<const float*>( testBuffer.get_data() )[0] );
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <sstream>
+
+#include <buffers/attribute_buffer_header.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+using namespace occluded::buffers::attributes;
+
+namespace OccludedLibraryUnitTests
+{
+	TEST_CLASS( attribute_buffer_header_test )
+	{
+	public:
+
+		TEST_METHOD( attribute_buffer_header_layout_test )
+		{
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.add_attribute( attribute( "color", 4, attrib_ubyte, true ) );
+			testMap.end_definition();
+
+			attribute_buffer_header testHeader( testMap, 10 );
+
+			// Test to make sure a segregated map has a section for each attribute, each starting on a multiple of the section alignment
+			Assert::AreEqual( static_cast<std::size_t>( 2 ), testHeader.get_section_offsets().size() );
+			Assert::AreEqual( static_cast<boost::uint64_t>( 0 ), testHeader.get_section_offsets()[0] % attribute_buffer_header::SECTION_ALIGNMENT );
+			Assert::AreEqual( static_cast<boost::uint64_t>( 128 ), testHeader.get_section_offsets()[1] - testHeader.get_section_offsets()[0] );
+			Assert::AreEqual( static_cast<boost::uint64_t>( 40 ), testHeader.get_section_size( 1 ) );
+			Assert::AreEqual( testHeader.get_section_offsets()[1] + 40, testHeader.get_file_size() );
+
+			attribute_map interleavedMap( true );
+			interleavedMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			interleavedMap.add_attribute( attribute( "color", 4, attrib_ubyte, true ) );
+			interleavedMap.end_definition();
+
+			attribute_buffer_header interleavedHeader( interleavedMap, 10 );
+
+			// Test to make sure an interleaved map has a single section containing every value
+			Assert::AreEqual( static_cast<std::size_t>( 1 ), interleavedHeader.get_section_offsets().size() );
+			Assert::AreEqual( static_cast<boost::uint64_t>( 160 ), interleavedHeader.get_section_size( 0 ) );
+
+			try {
+				attribute_buffer_header invalidHeader( testMap, 10, 3 );
+
+				// Test to make sure an exception is thrown when the section alignment is not a power of two
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( attribute_buffer_header_read_write_test )
+		{
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.add_attribute( attribute( "normal", 4, attrib_int_2_10_10_10_rev, true ) );
+			testMap.end_definition();
+
+			attribute_buffer_header testHeader( testMap, 7 );
+			testHeader.set_checksum( 0xdeadbeef );
+			std::stringstream stream( std::ios::in | std::ios::out | std::ios::binary );
+
+			testHeader.write( stream );
+
+			// Test to make sure the header is padded up to the first section
+			Assert::AreEqual( testHeader.get_data_offset(), static_cast<boost::uint64_t>( stream.tellp() ) );
+
+			attribute_buffer_header readHeader = attribute_buffer_header::read( stream );
+
+			// Test to make sure reading the header restores the map, the number of values and the sections
+			Assert::IsTrue( readHeader.get_attribute_map() == testMap );
+			Assert::IsTrue( readHeader.get_attribute_map().get_attributes()[1].is_normalized() );
+			Assert::AreEqual( static_cast<unsigned int>( 7 ), readHeader.get_num_values() );
+			Assert::IsTrue( readHeader.get_section_offsets() == testHeader.get_section_offsets() );
+			Assert::IsTrue( readHeader.has_checksum() );
+			Assert::AreEqual( static_cast<boost::uint32_t>( 0xdeadbeef ), readHeader.get_checksum() );
+
+			std::string bytes = stream.str();
+			bytes[0] = 'X';
+			std::stringstream badMagic( bytes, std::ios::in | std::ios::binary );
+
+			try {
+				attribute_buffer_header::read( badMagic );
+
+				// Test to make sure an exception is thrown when the stream does not start with a header
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			std::stringstream truncated( stream.str().substr( 0, 30 ), std::ios::in | std::ios::binary );
+
+			try {
+				attribute_buffer_header::read( truncated );
+
+				// Test to make sure an exception is thrown when the stream ends before the end of the header
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+	};
+}
@@ -0,0 +1,279 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <sstream>
+
+#include <buffers/attribute_buffer_serializer.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+using namespace occluded::buffers::attributes;
+
+namespace OccludedLibraryUnitTests
+{
+	TEST_CLASS( attribute_buffer_serializer_test )
+	{
+	public:
+
+		TEST_METHOD( attribute_buffer_serializer_save_load_test )
+		{
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.add_attribute( attribute( "weight", 1, attrib_float ) );
+			testMap.end_definition();
+
+			segregated_attr_buffer testBuffer( testMap );
+			const float values[] = { 0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 10.f, 20.f };
+
+			// Reserve extra room so the unused capacity between the sections is not saved
+			testBuffer.reserve( 10 );
+			testBuffer.insert_values( static_cast<const void*>( values ), 2 );
+
+			std::stringstream stream( std::ios::in | std::ios::out | std::ios::binary );
+			attribute_buffer_serializer::save( stream, testBuffer );
+
+			std::auto_ptr<attribute_buffer> loadedBuffer = attribute_buffer_serializer::load( stream );
+
+			// Test to make sure loading restores the layout and the values of every section
+			Assert::IsNotNull( dynamic_cast<segregated_attr_buffer*>( loadedBuffer.get() ) );
+			Assert::IsTrue( loadedBuffer->get_attribute_map() == testMap );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), loadedBuffer->get_num_values() );
+			Assert::AreEqual( 5.f, reinterpret_cast<const float*>( loadedBuffer->get_data() + loadedBuffer->get_attribute_data_offsets()[0] )[5] );
+			Assert::AreEqual( 20.f, reinterpret_cast<const float*>( loadedBuffer->get_data() + loadedBuffer->get_attribute_data_offsets()[1] )[1] );
+			Assert::IsTrue( loadedBuffer->is_all_dirty() );
+
+			attribute_map interleavedMap( true );
+			interleavedMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			interleavedMap.add_attribute( attribute( "weight", 1, attrib_float ) );
+			interleavedMap.end_definition();
+
+			interleaved_attr_buffer interleavedBuffer( interleavedMap );
+			interleavedBuffer.insert_values( static_cast<const void*>( values ), 2 );
+
+			std::stringstream interleavedStream( std::ios::in | std::ios::out | std::ios::binary );
+			attribute_buffer_serializer::save( interleavedStream, interleavedBuffer, false );
+
+			loadedBuffer = attribute_buffer_serializer::load( interleavedStream );
+
+			// Test to make sure an interleaved buffer is loaded as a single section
+			Assert::IsNotNull( dynamic_cast<interleaved_attr_buffer*>( loadedBuffer.get() ) );
+			Assert::IsTrue( loadedBuffer->get_all_data() == interleavedBuffer.get_all_data() );
+
+			attribute_map hybridMap( layout_hybrid );
+			hybridMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			hybridMap.add_attribute( attribute( "weight", 1, attrib_float ) );
+			hybridMap.end_definition();
+
+			hybrid_attr_buffer hybridBuffer( hybridMap );
+			hybridBuffer.reserve( 10 );
+			hybridBuffer.insert_values( static_cast<const void*>( values ), 2 );
+
+			std::stringstream hybridStream( std::ios::in | std::ios::out | std::ios::binary );
+			attribute_buffer_serializer::save( hybridStream, hybridBuffer );
+
+			loadedBuffer = attribute_buffer_serializer::load( hybridStream );
+
+			// Test to make sure a hybrid buffer is loaded with its positions packed before the other attributes
+			Assert::IsNotNull( dynamic_cast<hybrid_attr_buffer*>( loadedBuffer.get() ) );
+			Assert::IsTrue( loadedBuffer->get_attribute_map() == hybridMap );
+			Assert::AreEqual( 5.f, reinterpret_cast<const float*>( loadedBuffer->get_data() + loadedBuffer->get_attribute_data_offsets()[0] )[5] );
+			Assert::AreEqual( 20.f, reinterpret_cast<const float*>( loadedBuffer->get_data() + loadedBuffer->get_attribute_data_offsets()[1] )[1] );
+		}
+
+		TEST_METHOD( attribute_buffer_serializer_checksum_test )
+		{
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "test", 1, attrib_float ) );
+			testMap.end_definition();
+
+			interleaved_attr_buffer testBuffer( testMap );
+			const float values[] = { 0.f, 1.f, 2.f };
+
+			testBuffer.insert_values( static_cast<const void*>( values ), 3 );
+
+			std::stringstream stream( std::ios::in | std::ios::out | std::ios::binary );
+			attribute_buffer_serializer::save( stream, testBuffer );
+
+			std::string bytes = stream.str();
+			bytes[bytes.size() - 1] ^= 0x1;
+			std::stringstream corrupted( bytes, std::ios::in | std::ios::binary );
+
+			try {
+				attribute_buffer_serializer::load( corrupted );
+
+				// Test to make sure an exception is thrown when the values do not match the checksum
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			std::stringstream truncated( stream.str().substr( 0, stream.str().size() - 1 ), std::ios::in | std::ios::binary );
+
+			try {
+				attribute_buffer_serializer::load( truncated );
+
+				// Test to make sure an exception is thrown when the stream ends before the last section
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			testBuffer.erase_values( 1, 1 );
+
+			try {
+				attribute_buffer_serializer::save( stream, testBuffer );
+
+				// Test to make sure an exception is thrown when saving a buffer with erased values
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( attribute_buffer_serializer_forged_header_test )
+		{
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "position", 4, attrib_float ) );
+			testMap.end_definition();
+
+			// A header written without any values after it, claiming enough values that the section ends past the largest offset a buffer can hold
+			std::stringstream largeStream( std::ios::in | std::ios::out | std::ios::binary );
+			attribute_buffer_header( testMap, 0x10000001 ).write( largeStream );
+
+			try {
+				attribute_buffer_serializer::load( largeStream );
+
+				// Test to make sure an exception is thrown instead of sizing the buffer from a section that does not fit its offsets
+				Assert::Fail();
+			} catch( const std::runtime_error& ) {
+			}
+
+			std::stringstream shortStream( std::ios::in | std::ios::out | std::ios::binary );
+			attribute_buffer_header( testMap, 0x1000000 ).write( shortStream );
+
+			try {
+				attribute_buffer_serializer::load( shortStream );
+
+				// Test to make sure an exception is thrown before any storage is allocated when the stream is too short to hold the section
+				Assert::Fail();
+			} catch( const std::runtime_error& ) {
+			}
+
+			attribute_buffer_header compressedHeader( testMap, 0x1000000 );
+			std::stringstream compressedStream( std::ios::in | std::ios::out | std::ios::binary );
+
+			compressedHeader.set_compressed();
+			compressedHeader.write( compressedStream );
+
+			try {
+				attribute_buffer_serializer::load( compressedStream );
+
+				// Test to make sure an exception is thrown when the stream is too short to hold the size of every compressed block
+				Assert::Fail();
+			} catch( const std::runtime_error& ) {
+			}
+		}
+
+		TEST_METHOD( attribute_buffer_serializer_forged_compressed_test )
+		{
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "position", 4, attrib_float ) );
+			testMap.end_definition();
+
+			segregated_attr_buffer testBuffer( testMap );
+			const float values[] = { 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f };
+
+			testBuffer.insert_values( static_cast<const void*>( values ), 2 );
+
+			std::stringstream stream( std::ios::in | std::ios::out | std::ios::binary );
+			attribute_buffer_serializer::save( stream, testBuffer, true, true );
+
+			// The size of the first block is stored at the start of the data, and is set to 0xf0000000
+			std::string bytes = stream.str();
+			const std::size_t dataOffset = static_cast<std::size_t>( attribute_buffer_header( testMap, 2 ).get_data_offset() );
+
+			bytes[dataOffset] = 0;
+			bytes[dataOffset + 1] = 0;
+			bytes[dataOffset + 2] = 0;
+			bytes[dataOffset + 3] = static_cast<char>( 0xf0 );
+
+			std::stringstream largeBlock( bytes, std::ios::in | std::ios::binary );
+
+			try {
+				attribute_buffer_serializer::load( largeBlock );
+
+				// Test to make sure an exception is thrown before allocating a block larger than its values could be compressed into
+				Assert::Fail();
+			} catch( const std::runtime_error& ) {
+			}
+
+			// A header for four full blocks followed by enough bytes for the size of every block, but not for the widths of their groups
+			attribute_buffer_header header( testMap, 4 * attribute_buffer_serializer::COMPRESSED_BLOCK_VALUES );
+			std::stringstream shortStream( std::ios::in | std::ios::out | std::ios::binary );
+
+			header.set_compressed();
+			header.write( shortStream );
+			shortStream.write( std::string( 64, '\0' ).c_str(), 64 );
+
+			try {
+				attribute_buffer_serializer::load( shortStream );
+
+				// Test to make sure an exception is thrown before the buffer is sized when the stream can not hold the smallest possible blocks
+				Assert::Fail();
+			} catch( const std::runtime_error& ) {
+			}
+		}
+
+		TEST_METHOD( attribute_buffer_serializer_compressed_test )
+		{
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.add_attribute( attribute( "id", 1, attrib_uint ) );
+			testMap.end_definition();
+
+			segregated_attr_buffer testBuffer( testMap );
+			const unsigned int numValues = attribute_buffer_serializer::COMPRESSED_BLOCK_VALUES + 100;
+			std::vector<float> positions;
+			std::vector<unsigned int> ids;
+
+			for( unsigned int i = 0; i < numValues; ++i ) {
+				positions.push_back( static_cast<float>( i % 128 ) );
+				positions.push_back( static_cast<float>( i / 128 ) );
+				positions.push_back( 0.5f );
+				ids.push_back( i );
+			}
+
+			std::vector<char> values( reinterpret_cast<const char*>( &positions[0] ), reinterpret_cast<const char*>( &positions[0] ) + positions.size()
+				* sizeof( float ) );
+			values.insert( values.end(), reinterpret_cast<const char*>( &ids[0] ), reinterpret_cast<const char*>( &ids[0] ) + ids.size()
+				* sizeof( unsigned int ) );
+
+			testBuffer.insert_values( static_cast<const void*>( &values[0] ), numValues );
+
+			std::stringstream stream( std::ios::in | std::ios::out | std::ios::binary );
+			std::stringstream uncompressedStream( std::ios::in | std::ios::out | std::ios::binary );
+			attribute_buffer_serializer::save( stream, testBuffer, true, true );
+			attribute_buffer_serializer::save( uncompressedStream, testBuffer );
+
+			// Test to make sure compressing values that change smoothly makes the file smaller
+			Assert::IsTrue( stream.str().size() < uncompressedStream.str().size() / 2 );
+
+			std::auto_ptr<attribute_buffer> loadedBuffer = attribute_buffer_serializer::load( stream );
+
+			// Test to make sure every block of every section is decoded exactly
+			Assert::IsTrue( loadedBuffer->get_attribute_map() == testMap );
+			Assert::AreEqual( numValues, loadedBuffer->get_num_values() );
+			Assert::IsTrue( memcmp( loadedBuffer->get_data() + loadedBuffer->get_attribute_data_offsets()[0], &positions[0],
+				positions.size() * sizeof( float ) ) == 0 );
+			Assert::IsTrue( memcmp( loadedBuffer->get_data() + loadedBuffer->get_attribute_data_offsets()[1], &ids[0],
+				ids.size() * sizeof( unsigned int ) ) == 0 );
+
+			std::stringstream truncated( stream.str().substr( 0, stream.str().size() - 1 ), std::ios::in | std::ios::binary );
+
+			try {
+				attribute_buffer_serializer::load( truncated );
+
+				// Test to make sure an exception is thrown when the stream ends before the last block
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+	};
+}
@@ -0,0 +1,168 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <limits>
+
+#include <buffers/attributes/attribute_encoder.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers::attributes;
+
+namespace OccludedLibraryUnitTests
+{
+	TEST_CLASS( attribute_encoder_test )
+	{
+	public:
+
+		TEST_METHOD( attribute_encoder_encode_half_floats_test )
+		{
+			const float testValues[] = { 1.f, -2.f, 0.f, 0.5f, 65520.f, 1e-8f };
+			unsigned short testHalfs[6];
+
+			attribute_encoder::encode_half_floats( testValues, 6, testHalfs );
+
+			// Test to make sure values that can be represented exactly are converted exactly
+			Assert::AreEqual( static_cast<unsigned short>( 0x3c00 ), testHalfs[0] );
+			Assert::AreEqual( static_cast<unsigned short>( 0xc000 ), testHalfs[1] );
+			Assert::AreEqual( static_cast<unsigned short>( 0x0000 ), testHalfs[2] );
+			Assert::AreEqual( static_cast<unsigned short>( 0x3800 ), testHalfs[3] );
+
+			// Test to make sure values too large to be represented become infinity and values too small become zero
+			Assert::AreEqual( static_cast<unsigned short>( 0x7c00 ), testHalfs[4] );
+			Assert::AreEqual( static_cast<unsigned short>( 0x0000 ), testHalfs[5] );
+		}
+
+		TEST_METHOD( attribute_encoder_encode_ubytes_test )
+		{
+			const float testValues[] = { 0.f, 1.f, 0.5f, -1.f, 2.f };
+			unsigned char testBytes[5];
+
+			attribute_encoder::encode_ubytes( testValues, 5, true, testBytes );
+
+			// Test to make sure normalized values are mapped from [0, 1] and clamped
+			Assert::AreEqual( static_cast<int>( 0 ), static_cast<int>( testBytes[0] ) );
+			Assert::AreEqual( static_cast<int>( 255 ), static_cast<int>( testBytes[1] ) );
+			Assert::AreEqual( static_cast<int>( 128 ), static_cast<int>( testBytes[2] ) );
+			Assert::AreEqual( static_cast<int>( 0 ), static_cast<int>( testBytes[3] ) );
+			Assert::AreEqual( static_cast<int>( 255 ), static_cast<int>( testBytes[4] ) );
+
+			const float testUnnormalized[] = { 12.f, 300.f };
+
+			attribute_encoder::encode_ubytes( testUnnormalized, 2, false, testBytes );
+
+			// Test to make sure unnormalized values are clamped to the range of the type
+			Assert::AreEqual( static_cast<int>( 12 ), static_cast<int>( testBytes[0] ) );
+			Assert::AreEqual( static_cast<int>( 255 ), static_cast<int>( testBytes[1] ) );
+		}
+
+		TEST_METHOD( attribute_encoder_encode_signed_test )
+		{
+			const float testValues[] = { -1.f, 1.f, 0.f, -2.f };
+			signed char testBytes[4];
+			short testShorts[4];
+
+			attribute_encoder::encode_bytes( testValues, 4, true, testBytes );
+			attribute_encoder::encode_shorts( testValues, 4, true, testShorts );
+
+			// Test to make sure normalized signed values are mapped from [-1, 1] symmetrically
+			Assert::AreEqual( static_cast<int>( -127 ), static_cast<int>( testBytes[0] ) );
+			Assert::AreEqual( static_cast<int>( 127 ), static_cast<int>( testBytes[1] ) );
+			Assert::AreEqual( static_cast<int>( 0 ), static_cast<int>( testBytes[2] ) );
+			Assert::AreEqual( static_cast<int>( -127 ), static_cast<int>( testBytes[3] ) );
+			Assert::AreEqual( static_cast<short>( -32767 ), testShorts[0] );
+			Assert::AreEqual( static_cast<short>( 32767 ), testShorts[1] );
+		}
+
+		TEST_METHOD( attribute_encoder_round_half_test )
+		{
+			const float testValues[] = { 0.5f, 2.5f, 100.5f, -0.5f, -2.5f, -100.5f, 1.49f, -1.49f, 3.5f };
+			short testShorts[9];
+			const short expected[] = { 1, 3, 101, -1, -3, -101, 1, -1, 4 };
+
+			attribute_encoder::encode_shorts( testValues, 9, false, testShorts );
+
+			// Test to make sure halfway values are rounded away from zero, including the values that are not in a full block of four
+			for( unsigned int i = 0; i < 9; ++i ) {
+				Assert::AreEqual( expected[i], testShorts[i] );
+			}
+
+			const float testVectors[] = { 2.5f, -2.5f, 100.5f, 0.5f };
+			unsigned int testPacked;
+
+			attribute_encoder::encode_int_2_10_10_10_rev( testVectors, 1, false, &testPacked );
+
+			// Test to make sure packed vectors are rounded the same way
+			Assert::AreEqual( 0x3u | ( 0x3fdu << 10 ) | ( 0x65u << 20 ) | ( 0x1u << 30 ), testPacked );
+		}
+
+		TEST_METHOD( attribute_encoder_encode_int_2_10_10_10_rev_test )
+		{
+			const float testValues[] = { 1.f, -1.f, 0.f, 1.f, 0.f, 0.f, 0.f, -1.f };
+			unsigned int testPacked[2];
+
+			attribute_encoder::encode_int_2_10_10_10_rev( testValues, 2, true, testPacked );
+
+			// Test to make sure the components are packed starting at the lowest bit
+			Assert::AreEqual( 0x1ffu | ( 0x201u << 10 ) | ( 0x1u << 30 ), testPacked[0] );
+			Assert::AreEqual( 0x3u << 30, testPacked[1] );
+		}
+
+		TEST_METHOD( attribute_encoder_encode_32_bit_integers_test )
+		{
+			const float testValues[] = { -1.f, 1e10f, std::numeric_limits<float>::quiet_NaN(), 2.5f, -2.5f, -1e10f };
+			unsigned int testUints[6];
+			int testInts[6];
+
+			attribute_encoder::encode_uints( testValues, 6, false, testUints );
+			attribute_encoder::encode_ints( testValues, 6, false, testInts );
+
+			// Test to make sure values out of range are clamped instead of wrapping around, and NaNs are clamped to the minimum
+			Assert::AreEqual( 0u, testUints[0] );
+			Assert::AreEqual( 4294967295u, testUints[1] );
+			Assert::AreEqual( 0u, testUints[2] );
+			Assert::AreEqual( 0u, testUints[5] );
+			Assert::AreEqual( -1, testInts[0] );
+			Assert::AreEqual( 2147483647, testInts[1] );
+			Assert::IsTrue( testInts[2] == -2147483647 - 1 );
+			Assert::IsTrue( testInts[5] == -2147483647 - 1 );
+
+			// Test to make sure halfway values are rounded away from zero like the other integer types
+			Assert::AreEqual( 3u, testUints[3] );
+			Assert::AreEqual( 3, testInts[3] );
+			Assert::AreEqual( -3, testInts[4] );
+
+			const float normalizedValues[] = { 1.f, -1.f, 0.f };
+
+			attribute_encoder::encode_uints( normalizedValues, 3, true, testUints );
+			attribute_encoder::encode_ints( normalizedValues, 3, true, testInts );
+
+			// Test to make sure normalized values are mapped to the full range of the type
+			Assert::AreEqual( 4294967295u, testUints[0] );
+			Assert::AreEqual( 0u, testUints[1] );
+			Assert::AreEqual( 2147483647, testInts[0] );
+			Assert::AreEqual( -2147483647, testInts[1] );
+			Assert::AreEqual( 0, testInts[2] );
+		}
+
+		TEST_METHOD( attribute_encoder_encode_values_test )
+		{
+			const float testValues[] = { 0.f, 1.f, 0.f, 1.f, 1.f, 1.f, 1.f, 0.f };
+			unsigned char testBytes[8];
+			attribute colorAttrib( "color", 4, attrib_ubyte, true );
+
+			attribute_encoder::encode_values( colorAttrib, testValues, 2, testBytes );
+
+			// Test to make sure the conversion matching the attribute's type is used
+			Assert::AreEqual( static_cast<int>( 255 ), static_cast<int>( testBytes[1] ) );
+			Assert::AreEqual( static_cast<int>( 0 ), static_cast<int>( testBytes[7] ) );
+
+			try {
+				attribute_encoder::encode_values( attribute( "invalid", 1, attrib_invalid ), testValues, 1, testBytes );
+
+				// Test to make sure an exception is thrown if the attribute's type is invalid
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+	};
+}
@@ -0,0 +1,101 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <buffers/interleaved_attr_buffer.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+using namespace occluded::buffers::attributes;
+
+namespace OccludedLibraryUnitTests
+{
+	TEST_CLASS( attribute_map_registry_test )
+	{
+	public:
+
+		TEST_METHOD( attribute_map_registry_intern_test )
+		{
+			attribute_map_registry& registry = attribute_map_registry::get_registry();
+			attribute_map testMap( true );
+			attribute_map testMap2( true );
+			attribute_map otherMap( false );
+
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.end_definition();
+
+			testMap2.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap2.end_definition();
+
+			otherMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			otherMap.end_definition();
+
+			registry.release_unused();
+
+			const unsigned int numMaps = registry.get_num_maps();
+			attribute_map_handle handle = registry.intern( testMap );
+			attribute_map_handle handle2 = registry.intern( testMap2 );
+			attribute_map_handle otherHandle = registry.intern( otherMap );
+
+			// Test to make sure equal maps are interned to the same copy and different maps are not
+			Assert::IsTrue( handle.get() == handle2.get() );
+			Assert::IsFalse( handle.get() == otherHandle.get() );
+			Assert::IsFalse( handle.get() == &testMap );
+			Assert::IsTrue( *handle == testMap );
+			Assert::AreEqual( numMaps + 2, registry.get_num_maps() );
+
+			otherHandle.reset();
+
+			// Test to make sure only the maps that are no longer used are released
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), registry.release_unused() );
+			Assert::AreEqual( numMaps + 1, registry.get_num_maps() );
+
+			testMap.reset( true );
+
+			try {
+				registry.intern( testMap );
+
+				// Test to make sure an exception is thrown if a map that is still being defined is interned
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( attribute_map_registry_shared_by_buffers_test )
+		{
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.add_attribute( attribute( "normal", 3, attrib_float ) );
+			testMap.end_definition();
+
+			interleaved_attr_buffer testBuffer( testMap );
+			interleaved_attr_buffer testBuffer2( testMap );
+
+			// Test to make sure buffers with equal maps share a single map instead of each storing a copy
+			Assert::IsTrue( &testBuffer.get_attribute_map() == &testBuffer2.get_attribute_map() );
+			Assert::IsTrue( testBuffer.get_attribute_map() == testMap );
+		}
+
+		TEST_METHOD( attribute_map_registry_normalized_test )
+		{
+			attribute_map_registry& registry = attribute_map_registry::get_registry();
+			attribute_map testMap( true );
+			attribute_map normalizedMap( true );
+
+			testMap.add_attribute( attribute( "color", 4, attrib_ubyte ) );
+			testMap.end_definition();
+
+			normalizedMap.add_attribute( attribute( "color", 4, attrib_ubyte, true ) );
+			normalizedMap.end_definition();
+
+			attribute_map_handle handle = registry.intern( testMap );
+			attribute_map_handle normalizedHandle = registry.intern( normalizedMap );
+
+			// Test to make sure maps that only differ in whether an attribute is normalized are interned to different copies that are not equal
+			Assert::IsFalse( handle.get() == normalizedHandle.get() );
+			Assert::IsFalse( *handle == *normalizedHandle );
+			Assert::IsFalse( handle->get_attributes()[0].is_normalized() );
+			Assert::IsTrue( normalizedHandle->get_attributes()[0].is_normalized() );
+			Assert::IsTrue( normalizedHandle.get() == registry.intern( normalizedMap ).get() );
+		}
+	};
+}
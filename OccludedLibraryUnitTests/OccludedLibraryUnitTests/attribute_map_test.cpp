@@ -288,5 +288,117 @@ namespace OccludedLibraryUnitTests
 				Assert::Fail();
 			}
 		}
+
+		TEST_METHOD( attribute_map_get_attribute_offsets_test )
+		{
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "test", 1, attrib_float ) );
+			testMap.add_attribute( attribute( "test2", 3, attrib_int ) );
+			testMap.add_attribute( attribute( "test3", 2, attrib_uint ) );
+
+			try {
+				testMap.get_attribute_offsets();
+
+				// Test to make sure an exception is thrown if the offsets are requested while the map is still being defined
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			testMap.end_definition();
+
+			// Test to make sure each offset is the sum of the sizes of the attributes before it
+			Assert::AreEqual( static_cast<std::size_t>( 3 ), testMap.get_attribute_offsets().size() );
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testMap.get_attribute_offsets()[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 4 ), testMap.get_attribute_offsets()[1] );
+			Assert::AreEqual( static_cast<unsigned int>( 16 ), testMap.get_attribute_offsets()[2] );
+			Assert::AreEqual( static_cast<std::size_t>( 24 ), testMap.get_byte_size() );
+
+			testMap.reset( true );
+
+			// Test to make sure the cached size is cleared when the map is reset
+			Assert::AreEqual( static_cast<std::size_t>( 0 ), testMap.get_byte_size() );
+		}
+
+		TEST_METHOD( attribute_map_get_hash_test )
+		{
+			attribute_map testMap( true );
+			attribute_map testMap2( true );
+			attribute_map testMap3( true );
+
+			testMap.add_attribute( attribute( "test", 1, attrib_float ) );
+			testMap.add_attribute( attribute( "test2", 2, attrib_int ) );
+			testMap.end_definition();
+
+			testMap2.add_attribute( attribute( "test", 1, attrib_float ) );
+			testMap2.add_attribute( attribute( "test2", 2, attrib_int ) );
+			testMap2.end_definition();
+
+			testMap3.add_attribute( attribute( "test2", 2, attrib_int ) );
+			testMap3.add_attribute( attribute( "test", 1, attrib_float ) );
+			testMap3.end_definition();
+
+			// Test to make sure maps with the same structure have the same hash and that the order of the attributes changes the hash
+			Assert::IsTrue( testMap.get_hash() == testMap2.get_hash() );
+			Assert::IsFalse( testMap.get_hash() == testMap3.get_hash() );
+			Assert::IsFalse( testMap == testMap3 );
+
+			testMap2.reset( false );
+			testMap2.add_attribute( attribute( "test", 1, attrib_float ) );
+			testMap2.add_attribute( attribute( "test2", 2, attrib_int ) );
+			testMap2.end_definition();
+
+			// Test to make sure the layout flag changes the hash
+			Assert::IsFalse( testMap.get_hash() == testMap2.get_hash() );
+
+			testMap2.reset( true );
+			testMap2.add_attribute( attribute( "test", 1, attrib_float ) );
+			testMap2.add_attribute( attribute( "test2", 2, attrib_int, true ) );
+			testMap2.end_definition();
+
+			// Test to make sure maps that only differ in whether an attribute is normalized have different hashes and are not equal
+			Assert::IsFalse( testMap.get_hash() == testMap2.get_hash() );
+			Assert::IsFalse( testMap == testMap2 );
+		}
+
+		TEST_METHOD( attribute_map_hybrid_sections_test )
+		{
+			attribute_map testMap( layout_hybrid );
+			attribute_map segregatedMap( false );
+
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.add_attribute( attribute( "normal", 3, attrib_float ) );
+			testMap.add_attribute( attribute( "colour", 4, attrib_ubyte ) );
+			testMap.end_definition();
+
+			segregatedMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			segregatedMap.add_attribute( attribute( "normal", 3, attrib_float ) );
+			segregatedMap.add_attribute( attribute( "colour", 4, attrib_ubyte ) );
+			segregatedMap.end_definition();
+
+			// Test to make sure a hybrid map is neither interleaved nor segregated
+			Assert::IsTrue( testMap.get_layout() == layout_hybrid );
+			Assert::IsFalse( testMap.is_interleaved() );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testMap.get_num_sections() );
+
+			// Test to make sure the first attribute is alone in the first section and the others share the second section
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testMap.get_attribute_sections()[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), testMap.get_attribute_sections()[1] );
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), testMap.get_attribute_sections()[2] );
+			Assert::AreEqual( static_cast<unsigned int>( 3 * sizeof( float ) ), testMap.get_section_strides()[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 3 * sizeof( float ) + 4 ), testMap.get_section_strides()[1] );
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testMap.get_section_offsets()[1] );
+			Assert::AreEqual( static_cast<unsigned int>( 3 * sizeof( float ) ), testMap.get_section_offsets()[2] );
+
+			const std::vector<unsigned int> blockOffsets = testMap.get_block_offsets( 10 );
+
+			// Test to make sure the second section of a block starts after the positions of every value in the block and is interleaved
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), blockOffsets[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 10 * 3 * sizeof( float ) ), blockOffsets[1] );
+			Assert::AreEqual( static_cast<unsigned int>( 10 * 3 * sizeof( float ) + 3 * sizeof( float ) ), blockOffsets[2] );
+
+			// Test to make sure the hybrid layout changes the hash
+			Assert::IsFalse( testMap.get_hash() == segregatedMap.get_hash() );
+			Assert::IsFalse( testMap == segregatedMap );
+		}
 	};
 }
\ No newline at end of file
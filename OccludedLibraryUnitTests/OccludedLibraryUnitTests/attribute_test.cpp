@@ -52,6 +52,33 @@ namespace OccludedLibraryUnitTests
 
 			attrib = attribute( "test", 2, attrib_float );
 			Assert::AreEqual( static_cast<std::size_t>( 8 ), attrib.get_attrib_size() );
+
+			attrib = attribute( "test", 4, attrib_ubyte, true );
+			// Test to make sure the compact types use the size of their primitive
+			Assert::AreEqual( static_cast<std::size_t>( 1 ), attrib.get_component_size() );
+			Assert::AreEqual( static_cast<std::size_t>( 4 ), attrib.get_attrib_size() );
+
+			attrib = attribute( "test", 3, attrib_half_float );
+			Assert::AreEqual( static_cast<std::size_t>( 2 ), attrib.get_component_size() );
+			Assert::AreEqual( static_cast<std::size_t>( 6 ), attrib.get_attrib_size() );
+
+			attrib = attribute( "test", 2, attrib_short, true );
+			Assert::AreEqual( static_cast<std::size_t>( 4 ), attrib.get_attrib_size() );
+
+			attrib = attribute( "test", 4, attrib_int_2_10_10_10_rev, true );
+			// Test to make sure all the components of a packed type are stored in a single integer
+			Assert::AreEqual( static_cast<std::size_t>( 4 ), attrib.get_attrib_size() );
+		}
+
+		TEST_METHOD( attribute_packed_arity_test )
+		{
+			try {
+				attribute attrib( "test", 3, attrib_int_2_10_10_10_rev, true );
+
+				// Test to make sure an exception is thrown if a packed type does not have an arity of 4
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
 		}
 
 		TEST_METHOD( attribute_is_normalized_test )
@@ -0,0 +1,114 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <buffers/attribute_transcoder.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+using namespace occluded::buffers::attributes;
+
+namespace OccludedLibraryUnitTests
+{
+	TEST_CLASS( attribute_transcoder_test )
+	{
+	public:
+
+		TEST_METHOD( attribute_transcoder_round_trip_test )
+		{
+			// Layouts covering every specialized stride and attribute size, and some that have to be converted one attribute at a time
+			const unsigned int layouts[][4] = {
+				{ 3, 0, 0, 0 }, { 2, 1, 0, 0 }, { 1, 3, 0, 0 }, { 4, 0, 0, 0 }, { 3, 1, 0, 0 }, { 2, 2, 0, 0 }, { 1, 1, 1, 1 },
+				{ 3, 3, 0, 0 }, { 4, 2, 0, 0 }, { 2, 3, 1, 0 }, { 4, 4, 0, 0 }, { 3, 3, 2, 0 }, { 1, 4, 3, 0 }, { 3, 2, 0, 0 }, { 4, 4, 1, 0 }
+			};
+			const unsigned int numLayouts = sizeof( layouts ) / sizeof( layouts[0] );
+
+			for( unsigned int layout = 0; layout < numLayouts; ++layout ) {
+				attribute_map testMap( true );
+
+				for( unsigned int i = 0; i < 4 && layouts[layout][i] > 0; ++i ) {
+					testMap.add_attribute( attribute( "test" + boost::lexical_cast<std::string>( i ), layouts[layout][i], attrib_uint ) );
+				}
+
+				testMap.end_definition();
+
+				// An odd number of values, so that both the four value blocks and the remaining values are converted
+				const unsigned int numValues = 11;
+				const std::size_t stride = testMap.get_byte_size();
+				std::vector<unsigned int> interleaved( numValues * stride / 4 );
+				std::vector<unsigned int> segregated( interleaved.size() ), roundTrip( interleaved.size() );
+				std::vector<unsigned int> sectionOffsets;
+				unsigned int currOffset = 0;
+
+				for( unsigned int i = 0; i < interleaved.size(); ++i ) {
+					interleaved[i] = i;
+				}
+
+				for( unsigned int i = 0; i < testMap.get_attrib_count(); ++i ) {
+					sectionOffsets.push_back( currOffset );
+					currOffset += numValues * static_cast<unsigned int>( testMap.get_attributes()[i].get_attrib_size() );
+				}
+
+				attribute_transcoder::deinterleave( testMap, reinterpret_cast<const char*>( &interleaved[0] ), numValues,
+					reinterpret_cast<char*>( &segregated[0] ), sectionOffsets );
+
+				// Test to make sure every component was copied to the right place in its section
+				for( unsigned int i = 0; i < testMap.get_attrib_count(); ++i ) {
+					const unsigned int arity = testMap.get_attributes()[i].get_arity();
+
+					for( unsigned int value = 0; value < numValues; ++value ) {
+						for( unsigned int comp = 0; comp < arity; ++comp ) {
+							const unsigned int expected = interleaved[value * stride / 4 + testMap.get_attribute_offsets()[i] / 4 + comp];
+
+							Assert::AreEqual( expected, segregated[sectionOffsets[i] / 4 + value * arity + comp] );
+						}
+					}
+				}
+
+				attribute_transcoder::interleave( testMap, reinterpret_cast<const char*>( &segregated[0] ), sectionOffsets, numValues,
+					reinterpret_cast<char*>( &roundTrip[0] ) );
+
+				// Test to make sure interleaving the sections restores the original values
+				Assert::IsTrue( interleaved == roundTrip );
+			}
+		}
+
+		TEST_METHOD( attribute_transcoder_is_simd_layout_test )
+		{
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.add_attribute( attribute( "color", 4, attrib_ubyte, true ) );
+			testMap.end_definition();
+
+			attribute_map oddMap( true );
+			oddMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			oddMap.add_attribute( attribute( "uv", 2, attrib_half_float ) );
+			oddMap.add_attribute( attribute( "id", 1, attrib_ushort ) );
+			oddMap.end_definition();
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+			// Test to make sure a 16 byte stride made of whole dwords is specialized
+			Assert::IsTrue( attribute_transcoder::is_simd_layout( testMap ) );
+#endif
+
+			// Test to make sure attributes that are not made of whole dwords are not specialized, even with a common stride
+			Assert::IsFalse( attribute_transcoder::is_simd_layout( oddMap ) );
+		}
+
+		TEST_METHOD( attribute_transcoder_create_transcoded_map_test )
+		{
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.add_attribute( attribute( "normal", 3, attrib_float, true ) );
+			testMap.end_definition();
+
+			attribute_map transcodedMap = attribute_transcoder::create_transcoded_map( testMap );
+
+			// Test to make sure the copy has the same attributes and the other organization
+			Assert::IsFalse( transcodedMap.is_interleaved() );
+			Assert::IsFalse( transcodedMap.being_defined() );
+			Assert::AreEqual( testMap.get_attrib_count(), transcodedMap.get_attrib_count() );
+			Assert::IsTrue( testMap.get_attributes()[1] == transcodedMap.get_attributes()[1] );
+			Assert::IsTrue( transcodedMap.get_attributes()[1].is_normalized() );
+		}
+	};
+}
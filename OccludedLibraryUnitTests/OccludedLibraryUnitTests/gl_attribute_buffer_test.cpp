@@ -8,6 +8,9 @@ using namespace occluded::opengl::retained;
 using namespace occluded::opengl::retained::shaders;
 using namespace occluded::buffers::attributes;
 
+unsigned int bufferDataCalls = 0;
+unsigned int bufferSubDataCalls = 0;
+
 namespace OccludedLibraryUnitTests
 {
 	static std::vector< const boost::shared_ptr<const shader> > shaders;
@@ -152,5 +155,161 @@ namespace OccludedLibraryUnitTests
 			// Test to make sure the nubmer of values is 3 after 3 values are inserted
 			Assert::AreEqual( static_cast<unsigned int>( 3 ), testBuffer.get_num_values() );
 		}
+
+		TEST_METHOD( gl_attribute_buffer_update_values_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program testProgram( shaders );
+
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "test", 1, attrib_float ) );
+			testMap.end_definition();
+
+			gl_attribute_buffer testBuffer( vaoId, testMap, testProgram, dynamic_draw_usage );
+			const float values[] = { 0.f, 1.f, 2.f, 3.f, 4.f, 5.f };
+
+			testBuffer.insert_values( static_cast<const void*>( values ), 6 );
+
+			bufferDataCalls = 0;
+			bufferSubDataCalls = 0;
+
+			testBuffer.update_values( 0, 1, values );
+			testBuffer.update_values( 4, 2, values );
+
+			// Test to make sure nothing is uploaded until the buffer is bound
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), bufferSubDataCalls );
+
+			testBuffer.bind_buffer();
+
+			// Test to make sure each dirty range is uploaded on its own instead of setting the whole data store
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), bufferDataCalls );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), bufferSubDataCalls );
+
+			testBuffer.bind_buffer();
+
+			// Test to make sure binding a buffer that has not changed uploads nothing
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), bufferDataCalls );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), bufferSubDataCalls );
+
+			testBuffer.insert_values( static_cast<const void*>( values ), 1 );
+
+			// Test to make sure inserting values sets the whole data store
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), bufferDataCalls );
+		}
+
+
+		TEST_METHOD( gl_attribute_buffer_existing_buffer_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program testProgram( shaders );
+
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "test", 1, attrib_float ) );
+			testMap.end_definition();
+
+			std::auto_ptr<occluded::buffers::attribute_buffer> buffer( new occluded::buffers::interleaved_attr_buffer( testMap ) );
+			const float values[] = { 0.f, 1.f, 2.f };
+
+			buffer->insert_values( static_cast<const void*>( values ), 3 );
+			bufferDataCalls = 0;
+
+			gl_attribute_buffer testBuffer( vaoId, buffer, testProgram );
+
+			// Test to make sure the values already in the attribute buffer are uploaded when the buffer is created
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), bufferDataCalls );
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), testBuffer.get_num_values() );
+
+			try {
+				gl_attribute_buffer nullBuffer( vaoId, std::auto_ptr<occluded::buffers::attribute_buffer>(), testProgram );
+
+				// Test to make sure an exception is thrown when no attribute buffer is passed to the constructor
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( gl_attribute_buffer_copy_on_write_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program testProgram( shaders );
+
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "test", 1, attrib_float ) );
+			testMap.end_definition();
+
+			gl_attribute_buffer testBuffer( vaoId, testMap, testProgram, dynamic_draw_usage );
+			const float values[] = { 0.f, 1.f, 2.f };
+			const float newValue = 10.f;
+
+			testBuffer.insert_values( static_cast<const void*>( values ), 3 );
+
+			gl_attribute_buffer copy( testBuffer );
+
+			// Test to make sure a copy shares the values and the OpenGL buffer object until it is changed
+			Assert::IsTrue( testBuffer.is_shared() );
+			Assert::IsTrue( copy.is_shared() );
+			Assert::IsTrue( &testBuffer.get_attribute_buffer() == &copy.get_attribute_buffer() );
+			Assert::AreEqual( testBuffer.get_id(), copy.get_id() );
+
+			copy.update_values( 1, 1, &newValue );
+
+			// Test to make sure changing the copy gives it its own values and buffer object, and leaves the original unchanged
+			Assert::IsFalse( testBuffer.is_shared() );
+			Assert::IsFalse( copy.is_shared() );
+			Assert::IsFalse( testBuffer.get_id() == copy.get_id() );
+			Assert::AreEqual( 1.f, reinterpret_cast<const float*>( testBuffer.get_attribute_buffer().get_data() )[1] );
+			Assert::AreEqual( 10.f, reinterpret_cast<const float*>( copy.get_attribute_buffer().get_data() )[1] );
+			Assert::AreEqual( 2.f, reinterpret_cast<const float*>( copy.get_attribute_buffer().get_data() )[2] );
+
+			bufferDataCalls = 0;
+			copy.bind_buffer();
+
+			// Test to make sure the whole data store of the copy's new buffer object is set the next time it is bound
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), bufferDataCalls );
+
+			testBuffer.update_values( 0, 1, &newValue );
+
+			// Test to make sure a buffer that is no longer shared is changed in place
+			Assert::AreEqual( 10.f, reinterpret_cast<const float*>( testBuffer.get_attribute_buffer().get_data() )[0] );
+			Assert::AreEqual( 0.f, reinterpret_cast<const float*>( copy.get_attribute_buffer().get_data() )[0] );
+		}
+
+		TEST_METHOD( gl_attribute_buffer_upload_sections_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program testProgram( shaders );
+
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "test", 1, attrib_float ) );
+			testMap.add_attribute( attribute( "test2", 1, attrib_float ) );
+			testMap.end_definition();
+
+			gl_attribute_buffer testBuffer( vaoId, testMap, testProgram, dynamic_draw_usage );
+			const float values[] = { 0.f, 1.f, 2.f, 3.f, 4.f, 5.f };
+
+			testBuffer.insert_values( static_cast<const void*>( values ), 3 );
+
+			bufferDataCalls = 0;
+			bufferSubDataCalls = 0;
+
+			testBuffer.insert_values( static_cast<const void*>( values ), 1 );
+
+			const std::vector<occluded::buffers::attribute_buffer::dirty_range> usedRanges = testBuffer.get_attribute_buffer().get_used_ranges();
+
+			// Test to make sure only the values of each section are uploaded, leaving out the capacity between the sections
+			Assert::AreEqual( static_cast<std::size_t>( 2 ), usedRanges.size() );
+			Assert::AreEqual( 4 * sizeof( float ), usedRanges[0].second );
+			Assert::IsTrue( testBuffer.get_attribute_buffer().get_byte_size() > 8 * sizeof( float ) );
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), bufferDataCalls );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), bufferSubDataCalls );
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,277 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "opengl/retained/gl_chunked_mesh.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::opengl::retained;
+using namespace occluded::opengl::retained::shaders;
+using namespace occluded::buffers::attributes;
+
+namespace OccludedLibraryUnitTests
+{
+	static std::vector< const boost::shared_ptr<const shader> > chunkShaders;
+
+	// Gets the x coordinate of a vertex stored in a chunk whose map has a single float colour followed by a position
+	static const float get_chunk_x( const gl_chunked_mesh& mesh, const unsigned int chunk, const unsigned int index ) {
+		const occluded::buffers::attribute_buffer& buffer = mesh.get_chunk( chunk ).get_vertex_buffer().get_attribute_buffer();
+		float x = 0.f;
+
+		memcpy( &x, buffer.get_data() + buffer.get_attribute_data_offsets()[1] + index * 3 * sizeof( float ), sizeof( float ) );
+
+		return x;
+	}
+
+	TEST_CLASS( gl_chunked_mesh_test )
+	{
+	public:
+		TEST_CLASS_INITIALIZE( gl_chunked_mesh_init )
+		{
+			errorState = false;
+
+			std::string src( "Not Empty" );
+
+			chunkShaders.push_back( boost::shared_ptr<shader>( new shader( src, vert_shader ) ) );
+			chunkShaders.push_back( boost::shared_ptr<shader>( new shader( src, frag_shader ) ) );
+		}
+
+		TEST_METHOD_CLEANUP( gl_chunked_mesh_method_cleanup )
+		{
+			errorState = false;
+
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			manager.delete_objects();
+		}
+
+		TEST_METHOD( gl_chunked_mesh_constructor_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( chunkShaders );
+
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+
+			try {
+				gl_chunked_mesh testMesh( vaoId, testMap, shaderProg );
+
+				// Test to make sure an exception is thrown if the attribute map is still being defined
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			testMap.end_definition();
+
+			try {
+				gl_chunked_mesh testMesh( vaoId, testMap, shaderProg, static_draw_usage, primitive_triangle_strip );
+
+				// Test to make sure an exception is thrown if the primitive is not a list
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			try {
+				gl_chunked_mesh testMesh( vaoId, testMap, shaderProg, static_draw_usage, primitive_triangles, gl_chunked_mesh::MAX_CHUNK_VERTICES + 1 );
+
+				// Test to make sure an exception is thrown if a chunk could hold more vertices than 16 bits can index
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			gl_chunked_mesh testMesh( vaoId, testMap, shaderProg );
+
+			// Test to make sure no chunks are created until vertices are added
+			Assert::AreEqual( 0u, testMesh.get_num_chunks() );
+			Assert::AreEqual( 0u, testMesh.get_num_vertices() );
+			Assert::AreEqual( 3u, testMesh.num_verts_for_next_face( 0 ) );
+		}
+
+		TEST_METHOD( gl_chunked_mesh_add_vertices_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( chunkShaders );
+
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "colour", 1, attrib_float ) );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.end_definition();
+
+			gl_chunked_mesh testMesh( vaoId, testMap, shaderProg, static_draw_usage, primitive_triangles, 4 );
+			std::vector<float> vertices;
+
+			// The colours of the six vertices, followed by their positions
+			for( unsigned int i = 0; i < 6; ++i ) {
+				vertices.push_back( static_cast<float>( 10 + i ) );
+			}
+
+			for( unsigned int i = 0; i < 6; ++i ) {
+				vertices.push_back( static_cast<float>( i ) );
+				vertices.push_back( 0.f );
+				vertices.push_back( 0.f );
+			}
+
+			const std::vector<unsigned int> indices = testMesh.add_vertices( static_cast<const void*>( &vertices[0] ), 6 );
+
+			// Test to make sure the vertices are numbered across the whole mesh and split between chunks that are filled in order
+			Assert::AreEqual( static_cast<std::size_t>( 6 ), indices.size() );
+			Assert::AreEqual( 5u, indices[5] );
+			Assert::AreEqual( 2u, testMesh.get_num_chunks() );
+			Assert::AreEqual( 4u, testMesh.get_chunk( 0 ).get_vertex_buffer().get_num_values() );
+			Assert::AreEqual( 2u, testMesh.get_chunk( 1 ).get_vertex_buffer().get_num_values() );
+
+			// Test to make sure each section of the vertices is split at the same vertex
+			Assert::AreEqual( 3.f, get_chunk_x( testMesh, 0, 3 ) );
+			Assert::AreEqual( 4.f, get_chunk_x( testMesh, 1, 0 ) );
+
+			try {
+				testMesh.add_vertices( std::vector<char>( 3 ) );
+
+				// Test to make sure an exception is thrown if the vector does not hold whole vertices
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			try {
+				testMesh.get_chunk( 2 );
+
+				// Test to make sure an exception is thrown if the chunk does not exist
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( gl_chunked_mesh_add_faces_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( chunkShaders );
+
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "colour", 1, attrib_float ) );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.end_definition();
+
+			gl_chunked_mesh testMesh( vaoId, testMap, shaderProg, static_draw_usage, primitive_triangles, 4 );
+			std::vector<float> vertices( 6, 1.f );
+
+			for( unsigned int i = 0; i < 6; ++i ) {
+				vertices.push_back( static_cast<float>( i ) );
+				vertices.push_back( 0.f );
+				vertices.push_back( 0.f );
+			}
+
+			testMesh.add_vertices( static_cast<const void*>( &vertices[0] ), 6 );
+
+			const unsigned int faceVals[] = { 0, 1, 2, 3, 4, 5 };
+			const std::vector<unsigned int> faces( faceVals, faceVals + 6 );
+			const std::vector<unsigned int> addedFaces = testMesh.add_faces( faces );
+
+			// Test to make sure each face is added to a chunk that holds one of its vertices
+			Assert::AreEqual( static_cast<std::size_t>( 2 ), addedFaces.size() );
+			Assert::AreEqual( 2u, testMesh.get_num_faces() );
+			Assert::AreEqual( 1u, testMesh.get_chunk( 0 ).get_num_faces() );
+			Assert::AreEqual( 1u, testMesh.get_chunk( 1 ).get_num_faces() );
+
+			// Test to make sure the vertex on the border is copied into the chunk that did not have it
+			Assert::AreEqual( 3u, testMesh.get_chunk( 1 ).get_vertex_buffer().get_num_values() );
+			Assert::AreEqual( 3.f, get_chunk_x( testMesh, 1, 2 ) );
+			Assert::AreEqual( 6u, testMesh.get_num_vertices() );
+
+			std::vector<unsigned int> face( faceVals + 3, faceVals + 6 );
+
+			face[0] = 4;
+			face[1] = 3;
+			testMesh.add_face( face );
+
+			// Test to make sure a vertex that was already copied into a chunk is not copied again
+			Assert::AreEqual( 3u, testMesh.get_chunk( 1 ).get_vertex_buffer().get_num_values() );
+			Assert::AreEqual( 2u, testMesh.get_chunk( 1 ).get_num_faces() );
+
+			face[0] = 0;
+			face[1] = 2;
+			testMesh.add_face( face );
+
+			// Test to make sure a face that does not fit in any chunk holding its vertices starts a new chunk
+			Assert::AreEqual( 3u, testMesh.get_num_chunks() );
+			Assert::AreEqual( 3u, testMesh.get_chunk( 2 ).get_vertex_buffer().get_num_values() );
+			Assert::AreEqual( 4u, testMesh.get_num_faces() );
+
+			testMesh.draw();
+
+			// Test to make sure every chunk is drawn with indices narrow enough for it
+			Assert::AreEqual( static_cast<GLenum>( GL_UNSIGNED_BYTE ), testMesh.get_chunk( 2 ).get_index_type() );
+			Assert::AreEqual( static_cast<GLenum>( GL_UNSIGNED_BYTE ), drawElementsType );
+
+			face[2] = 6;
+
+			try {
+				testMesh.add_face( face );
+
+				// Test to make sure an exception is thrown if an index does not correspond to a vertex
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			face[2] = 0;
+
+			try {
+				testMesh.add_face( face );
+
+				// Test to make sure an exception is thrown if a face uses a vertex more than once
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			// Test to make sure a face that is not valid leaves the mesh unchanged
+			Assert::AreEqual( 4u, testMesh.get_num_faces() );
+			Assert::AreEqual( 3u, testMesh.get_num_chunks() );
+		}
+
+		TEST_METHOD( gl_chunked_mesh_bounds_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( chunkShaders );
+
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "colour", 1, attrib_float ) );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.end_definition();
+
+			gl_chunked_mesh testMesh( vaoId, testMap, shaderProg, static_draw_usage, primitive_triangles, 4 );
+			// The colours of the five vertices, followed by their positions
+			const float initialVals[] = { 0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 2.f, 0.f, 0.f, 3.f, 0.f, 0.f, 4.f, -5.f, 0.f, 0.f, 0.f, 7.f };
+
+			testMesh.add_vertices( static_cast<const void*>( initialVals ), 5 );
+			testMesh.set_position_attribute( "position" );
+
+			// Test to make sure setting the position attribute computes the bounds of every chunk and of the whole mesh
+			Assert::AreEqual( -5.f, testMesh.get_bounds().get_min()[1] );
+			Assert::AreEqual( 7.f, testMesh.get_bounds().get_max()[2] );
+			Assert::AreEqual( 4.f, testMesh.get_chunk( 0 ).get_bounds().get_max()[0] );
+			Assert::AreEqual( -5.f, testMesh.get_chunk( 0 ).get_bounds().get_min()[1] );
+			Assert::AreEqual( 7.f, testMesh.get_chunk( 1 ).get_bounds().get_max()[2] );
+
+			const float singleVal[] = { 0.f, 9.f, 0.f, 0.f };
+
+			testMesh.add_vertices( static_cast<const void*>( singleVal ), 1 );
+
+			// Test to make sure vertices added afterwards grow the bounds
+			Assert::AreEqual( 9.f, testMesh.get_bounds().get_max()[0] );
+			Assert::AreEqual( 9.f, testMesh.get_chunk( 1 ).get_bounds().get_max()[0] );
+
+			try {
+				testMesh.set_position_attribute( "colour" );
+
+				// Test to make sure an exception is thrown if the attribute does not have 3 float components
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+	};
+}
@@ -0,0 +1,85 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "opengl/retained/gl_fragment_counter.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::opengl::retained;
+using namespace occluded::opengl::retained::shaders;
+using namespace occluded::buffers::attributes;
+
+unsigned int samplesPassed = 0;
+bool queryActive = false;
+
+namespace OccludedLibraryUnitTests
+{
+	static std::vector< const boost::shared_ptr<const shader> > shaders;
+
+	TEST_CLASS( gl_fragment_counter_test )
+	{
+	public:
+		TEST_CLASS_INITIALIZE( gl_fragment_counter_init )
+		{
+			errorState = false;
+
+			std::string src( "Not Empty" );
+
+			shaders.push_back( boost::shared_ptr<shader>( new shader( src, vert_shader ) ) );
+			shaders.push_back( boost::shared_ptr<shader>( new shader( src, frag_shader ) ) );
+		}
+
+		TEST_METHOD_CLEANUP( gl_fragment_counter_method_cleanup )
+		{
+			errorState = false;
+			samplesPassed = 0;
+			queryActive = false;
+
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			manager.delete_objects();
+		}
+
+		TEST_METHOD( gl_fragment_counter_count_fragments_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( shaders );
+
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.end_definition();
+
+			gl_retained_mesh testMesh( vaoId, testMap, shaderProg );
+			gl_fragment_counter testCounter;
+
+			samplesPassed = 1024;
+
+			// Test to make sure the number of samples counted by the query is returned
+			Assert::AreEqual( static_cast<GLuint>( 1024 ), testCounter.count_fragments( testMesh ) );
+
+			// Test to make sure the query is ended after counting
+			Assert::IsFalse( queryActive );
+
+			errorState = true;
+
+			try {
+				testCounter.count_fragments( testMesh );
+
+				// Test to make sure an exception is thrown when the mesh fails to draw
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			// Test to make sure the query is ended even though the draw failed
+			Assert::IsFalse( queryActive );
+
+			try {
+				gl_fragment_counter invalidCounter;
+
+				// Test to make sure an exception is thrown when the query object cannot be created
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+	};
+}
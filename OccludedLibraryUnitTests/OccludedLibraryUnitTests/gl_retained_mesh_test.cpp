@@ -1,6 +1,8 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
 
+#include <list>
+
 #include "opengl/retained/gl_retained_mesh.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -8,6 +10,9 @@ using namespace occluded::opengl::retained;
 using namespace occluded::opengl::retained::shaders;
 using namespace occluded::buffers::attributes;
 
+GLsizeiptr bufferDataSize = 0;
+GLenum drawElementsType = 0;
+
 namespace OccludedLibraryUnitTests
 {
 	std::vector< const boost::shared_ptr<const shader> > shaders;
@@ -528,5 +533,507 @@ namespace OccludedLibraryUnitTests
 			} catch( const std::exception& ) {
 			}
 		}
+
+
+		TEST_METHOD( gl_retained_mesh_erase_vertices_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( shaders );
+
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "test", 1, attrib_float ) );
+			testMap.end_definition();
+
+			gl_retained_mesh testMesh( vaoId, testMap, shaderProg );
+			std::vector<char> vertices( 6 * sizeof( float ) );
+			std::vector<unsigned int> indices( 3 );
+
+			testMesh.add_vertices( vertices );
+
+			indices[0] = 3;
+			indices[1] = 4;
+			indices[2] = 5;
+
+			testMesh.add_faces( indices );
+
+			try {
+				testMesh.erase_vertices( 2, 2 );
+
+				// Test to make sure an exception is thrown when an erased vertex is used by a face
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			testMesh.erase_vertices( 0, 3 );
+
+			indices[0] = 0;
+
+			try {
+				testMesh.add_faces( indices );
+
+				// Test to make sure an exception is thrown when a face uses an erased vertex
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			std::vector<unsigned int> added = testMesh.add_vertices( static_cast<const void*>( &vertices[0] ), 1 );
+
+			// Test to make sure the indices returned are the erased indices that were reused
+			Assert::AreEqual( static_cast<std::size_t>( 1 ), added.size() );
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), added[0] );
+
+			std::vector<unsigned int> remap = testMesh.compact();
+
+			// Test to make sure compacting moves the vertices used by the face down and keeps the face
+			Assert::AreEqual( static_cast<std::size_t>( 6 ), remap.size() );
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), remap[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), remap[3] );
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), remap[5] );
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), testMesh.get_num_faces() );
+		}
+
+		TEST_METHOD( gl_retained_mesh_vertex_welding_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( shaders );
+
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "position", 1, attrib_float ) );
+			testMap.add_attribute( attribute( "color", 1, attrib_float ) );
+			testMap.end_definition();
+
+			gl_retained_mesh testMesh( vaoId, testMap, shaderProg );
+			// The positions of the vertices, followed by their colors
+			const float first[] = { 0.f, 1.f, 2.f, 0.f, 3.f, 4.f };
+			const float second[] = { 1.f, 0.f, 4.f, 3.f, 0.f, 5.f };
+
+			testMesh.add_vertices( static_cast<const void*>( first ), 3 );
+			testMesh.enable_vertex_welding();
+
+			std::vector<unsigned int> indices = testMesh.add_vertices( static_cast<const void*>( second ), 3 );
+
+			// Test to make sure vertices equal to ones already in the mesh reuse their indices and only the new vertex is added
+			Assert::IsTrue( testMesh.is_vertex_welding_enabled() );
+			Assert::AreEqual( static_cast<std::size_t>( 3 ), indices.size() );
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), indices[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), indices[1] );
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), indices[2] );
+			Assert::AreEqual( static_cast<std::size_t>( 1 ), testMesh.add_faces( indices ).size() );
+
+			testMesh.disable_vertex_welding();
+			indices = testMesh.add_vertices( static_cast<const void*>( second ), 3 );
+
+			// Test to make sure every vertex is added once welding is disabled
+			Assert::IsFalse( testMesh.is_vertex_welding_enabled() );
+			Assert::AreEqual( static_cast<unsigned int>( 4 ), indices[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 6 ), indices[2] );
+
+			struct test_vertex {
+				float position;
+				float color;
+			};
+
+			const test_vertex structures[] = { { 4.f, 5.f }, { 7.f, 8.f } };
+			const std::list<test_vertex> structureList( structures, structures + 2 );
+
+			testMesh.enable_vertex_welding();
+			indices = testMesh.add_vertices( structureList.begin(), structureList.end() );
+
+			// Test to make sure a range of interleaved structures is welded against the segregated vertices already in the mesh
+			Assert::AreEqual( static_cast<std::size_t>( 2 ), indices.size() );
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), indices[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 7 ), indices[1] );
+			Assert::AreEqual( static_cast<unsigned int>( 8 ), testMesh.get_vertex_buffer().get_num_values() );
+		}
+
+		TEST_METHOD( gl_retained_mesh_optimize_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( shaders );
+
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 1, attrib_float ) );
+			testMap.end_definition();
+
+			gl_retained_mesh testMesh( vaoId, testMap, shaderProg );
+			const float vertices[] = { 0.f, 1.f, 2.f, 3.f, 4.f };
+			std::vector<unsigned int> indices( 6 );
+
+			testMesh.add_vertices( static_cast<const void*>( vertices ), 5 );
+
+			indices[0] = 4;
+			indices[1] = 2;
+			indices[2] = 0;
+			indices[3] = 0;
+			indices[4] = 2;
+			indices[5] = 3;
+
+			testMesh.add_faces( indices );
+
+			const mesh_optimization_report report = testMesh.optimize();
+
+			// Test to make sure the vertex the faces do not use is moved after the others and the faces are kept
+			Assert::AreEqual( static_cast<std::size_t>( 5 ), report.remap.size() );
+			Assert::AreEqual( static_cast<unsigned int>( 4 ), report.remap[1] );
+			Assert::AreEqual( report.before.numTransformed, report.after.numTransformed );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testMesh.get_num_faces() );
+
+			gl_retained_mesh fanMesh( vaoId, testMap, shaderProg, static_draw_usage, primitive_triangle_fan );
+
+			try {
+				fanMesh.optimize();
+
+				// Test to make sure an exception is thrown when the mesh is not a triangle list
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( gl_retained_mesh_optimize_overdraw_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( shaders );
+
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "color", 1, attrib_float ) );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.end_definition();
+
+			gl_retained_mesh testMesh( vaoId, testMap, shaderProg );
+			const float vertices[] = { 0.f, 1.f, 2.f, 3.f, 4.f, 5.f,
+				0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 1.f, 0.f, 1.f, 0.f, 1.f, 1.f };
+			std::vector<unsigned int> indices( 6 );
+
+			testMesh.add_vertices( static_cast<const void*>( vertices ), 6 );
+
+			for( unsigned int i = 0; i < indices.size(); ++i ) {
+				indices[i] = i;
+			}
+
+			testMesh.add_faces( indices );
+
+			try {
+				testMesh.optimize( "color" );
+
+				// Test to make sure an exception is thrown when the position attribute does not have three components
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			const mesh_optimization_report report = testMesh.optimize( "position" );
+
+			// Test to make sure the face in front is drawn first, so its vertices are moved to the start of the buffer
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), report.remap[3] );
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), report.remap[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testMesh.get_num_faces() );
+		}
+
+		TEST_METHOD( gl_retained_mesh_generate_lods_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( shaders );
+
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.add_attribute( attribute( "color", 1, attrib_float ) );
+			testMap.end_definition();
+
+			gl_retained_mesh testMesh( vaoId, testMap, shaderProg );
+			std::vector<unsigned int> indices;
+			std::vector<float> ratios( 1, 0.5f );
+			std::vector< std::pair<std::string, float> > attributeWeights( 1, std::make_pair( std::string( "color" ), 1.f ) );
+
+			// A flat strip of 8 quads, with every vertex the same color
+			for( unsigned int i = 0; i <= 8; ++i ) {
+				const float vertices[] = { static_cast<float>( i ), 0.f, 0.f, 1.f, static_cast<float>( i ), 1.f, 0.f, 1.f };
+
+				testMesh.add_vertices( static_cast<const void*>( vertices ), 2 );
+			}
+
+			for( unsigned int i = 0; i < 8; ++i ) {
+				const unsigned int quad[] = { 2 * i, 2 * i + 2, 2 * i + 1, 2 * i + 1, 2 * i + 2, 2 * i + 3 };
+
+				indices.insert( indices.end(), quad, quad + 6 );
+			}
+
+			testMesh.add_faces( indices );
+
+			const std::vector<occluded::meshes::mesh_lod> lods = testMesh.generate_lods( "position", ratios, attributeWeights );
+
+			// Test to make sure the level has half of the faces and no error, and that it can be drawn
+			Assert::AreEqual( static_cast<std::size_t>( 1 ), lods.size() );
+			Assert::AreEqual( indices.size() / 2, lods[0].indices.size() );
+			Assert::AreEqual( 0.f, lods[0].error );
+
+			testMesh.draw( lods[0] );
+
+			attributeWeights.push_back( std::make_pair( std::string( "normal" ), 1.f ) );
+
+			try {
+				testMesh.generate_lods( "position", ratios, attributeWeights );
+
+				// Test to make sure an exception is thrown when a weighted attribute does not exist
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( gl_retained_mesh_build_meshlets_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( shaders );
+
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.end_definition();
+
+			gl_retained_mesh testMesh( vaoId, testMap, shaderProg );
+			std::vector<unsigned int> indices;
+
+			// A flat strip of 8 quads
+			for( unsigned int i = 0; i <= 8; ++i ) {
+				const float vertices[] = { static_cast<float>( i ), 0.f, 0.f, static_cast<float>( i ), 1.f, 0.f };
+
+				testMesh.add_vertices( static_cast<const void*>( vertices ), 2 );
+			}
+
+			for( unsigned int i = 0; i < 8; ++i ) {
+				const unsigned int quad[] = { 2 * i, 2 * i + 2, 2 * i + 1, 2 * i + 1, 2 * i + 2, 2 * i + 3 };
+
+				indices.insert( indices.end(), quad, quad + 6 );
+			}
+
+			testMesh.add_faces( indices );
+
+			const occluded::meshes::meshlet_table& table = testMesh.build_meshlets( "position", 6, 4 );
+
+			// Test to make sure every face is in a meshlet and the table is kept by the mesh
+			Assert::AreEqual( indices.size(), table.indices.size() );
+			Assert::IsTrue( table.meshlets.size() >= 4 );
+			Assert::AreEqual( table.meshlets.size(), testMesh.get_meshlets().meshlets.size() );
+
+			testMesh.draw_meshlets( std::vector<unsigned int>( 1, 0 ) );
+
+			try {
+				testMesh.draw_meshlets( std::vector<unsigned int>( 1, static_cast<unsigned int>( table.meshlets.size() ) ) );
+
+				// Test to make sure an exception is thrown when a meshlet does not exist
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			testMesh.add_faces( std::vector<unsigned int>( indices.begin(), indices.begin() + 3 ) );
+
+			// Test to make sure the meshlets are removed when the faces change
+			Assert::IsTrue( testMesh.get_meshlets().meshlets.empty() );
+		}
+
+		TEST_METHOD( gl_retained_mesh_shared_buffer_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( shaders );
+
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 1, attrib_float ) );
+			testMap.end_definition();
+
+			gl_attribute_buffer buffer( vaoId, testMap, shaderProg, static_draw_usage );
+			const float vertices[] = { 0.f, 1.f, 2.f, 3.f };
+			std::vector<unsigned int> faces( 6 );
+
+			buffer.insert_values( static_cast<const void*>( vertices ), 4 );
+
+			faces[0] = 0;
+			faces[1] = 1;
+			faces[2] = 2;
+			faces[3] = 2;
+			faces[4] = 1;
+			faces[5] = 3;
+
+			gl_retained_mesh testMesh( vaoId, shaderProg, buffer, faces );
+			gl_retained_mesh lodMesh( vaoId, shaderProg, buffer, std::vector<unsigned int>( faces.begin(), faces.begin() + 3 ) );
+
+			// Test to make sure the faces passed to the constructor are added and the vertices are shared instead of copied
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testMesh.get_num_faces() );
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), lodMesh.get_num_faces() );
+			Assert::IsTrue( buffer.is_shared() );
+
+			const std::vector<unsigned int> indices = testMesh.add_vertices( static_cast<const void*>( vertices ), 1 );
+
+			faces.resize( 3 );
+			faces[2] = indices[0];
+
+			// Test to make sure adding vertices to one mesh does not change the vertices of the buffer it was created from
+			Assert::AreEqual( static_cast<unsigned int>( 4 ), indices[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testMesh.add_face( faces ) );
+			Assert::AreEqual( static_cast<unsigned int>( 4 ), buffer.get_num_values() );
+			Assert::IsTrue( buffer.is_shared() );
+
+			try {
+				gl_retained_mesh invalidMesh( vaoId, shaderProg, buffer, faces );
+
+				// Test to make sure an exception is thrown if a face passed to the constructor uses a vertex that is not in the buffer
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( gl_retained_mesh_bounds_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( shaders );
+
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "colour", 1, attrib_float ) );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.end_definition();
+
+			gl_retained_mesh testMesh( vaoId, testMap, shaderProg );
+			// The colours of both vertices, followed by their positions
+			const float initialVals[] = { 7.f, 8.f, 1.f, 2.f, 3.f, -1.f, 0.f, 4.f };
+
+			testMesh.add_vertices( static_cast<const void*>( initialVals ), 2 );
+
+			// Test to make sure the bounds are empty until the position attribute is set
+			Assert::IsTrue( testMesh.get_bounds().is_empty() );
+
+			testMesh.set_position_attribute( "position" );
+
+			// Test to make sure setting the position attribute computes the bounds of the vertices already in the mesh
+			Assert::AreEqual( std::string( "position" ), testMesh.get_position_attribute() );
+			Assert::AreEqual( -1.f, testMesh.get_bounds().get_min()[0] );
+			Assert::AreEqual( 4.f, testMesh.get_bounds().get_max()[2] );
+
+			const float singleVal[] = { 9.f, 5.f, -6.f, 0.f };
+			std::vector<char> vertex( reinterpret_cast<const char*>( singleVal ), reinterpret_cast<const char*>( singleVal ) + sizeof( singleVal ) );
+
+			testMesh.add_vertices( vertex );
+
+			// Test to make sure vertices added afterwards grow the bounds
+			Assert::AreEqual( 5.f, testMesh.get_bounds().get_max()[0] );
+			Assert::AreEqual( -6.f, testMesh.get_bounds().get_min()[1] );
+
+			struct test_vertex {
+				float colour;
+				float position[3];
+			};
+
+			const test_vertex structures[] = { { 0.f, { 1.f, 2.f, 3.f } }, { 0.f, { -2.f, 10.f, 0.f } }, { 0.f, { 0.f, 0.f, -8.f } } };
+
+			testMesh.add_vertices( structures, structures + 3 );
+
+			// Test to make sure every structure in an array grows the bounds, reading the position at its offset in the structure
+			Assert::AreEqual( -2.f, testMesh.get_bounds().get_min()[0] );
+			Assert::AreEqual( 10.f, testMesh.get_bounds().get_max()[1] );
+			Assert::AreEqual( -8.f, testMesh.get_bounds().get_min()[2] );
+
+			std::list<test_vertex> structureList( structures, structures + 3 );
+
+			structureList.front().position[0] = 20.f;
+			structureList.back().position[1] = -30.f;
+			testMesh.add_vertices( structureList.begin(), structureList.end() );
+
+			// Test to make sure structures that are not stored one after another grow the bounds as well
+			Assert::AreEqual( 20.f, testMesh.get_bounds().get_max()[0] );
+			Assert::AreEqual( -30.f, testMesh.get_bounds().get_min()[1] );
+
+			const occluded::meshes::mesh& baseMesh = testMesh;
+
+			// Test to make sure the bounds can be read through the mesh interface
+			Assert::AreEqual( testMesh.get_bounds().get_radius(), baseMesh.get_bounds().get_radius() );
+
+			try {
+				testMesh.set_position_attribute( "colour" );
+
+				// Test to make sure an exception is thrown if the attribute does not have 3 float components
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			// Test to make sure a failed call leaves the bounds as they were
+			Assert::AreEqual( std::string( "position" ), testMesh.get_position_attribute() );
+			Assert::AreEqual( 20.f, testMesh.get_bounds().get_max()[0] );
+		}
+
+		TEST_METHOD( gl_retained_mesh_index_type_test )
+		{
+			gl_retained_object_manager& manager = gl_retained_object_manager::get_manager();
+			GLuint vaoId = manager.get_new_vao();
+
+			shader_program shaderProg( shaders );
+
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 1, attrib_float ) );
+			testMap.end_definition();
+
+			gl_retained_mesh testMesh( vaoId, testMap, shaderProg );
+			const std::vector<float> vertices( 0x10000, 0.f );
+			std::vector<unsigned int> faces( 6 );
+
+			testMesh.add_vertices( static_cast<const void*>( &vertices[0] ), 4 );
+
+			faces[0] = 0;
+			faces[1] = 1;
+			faces[2] = 2;
+			faces[3] = 2;
+			faces[4] = 1;
+			faces[5] = 3;
+
+			testMesh.add_faces( faces );
+			testMesh.draw();
+
+			// Test to make sure the indices of a mesh with few vertices are uploaded and drawn as bytes
+			Assert::AreEqual( static_cast<GLenum>( GL_UNSIGNED_BYTE ), testMesh.get_index_type() );
+			Assert::AreEqual( static_cast<GLenum>( GL_UNSIGNED_BYTE ), drawElementsType );
+			Assert::AreEqual( static_cast<GLsizeiptr>( 6 ), bufferDataSize );
+
+			bufferDataCalls = 0;
+			testMesh.draw();
+
+			// Test to make sure drawing again without changing the indices does not upload them again
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), bufferDataCalls );
+
+			testMesh.add_faces( std::vector<unsigned int>( faces.begin(), faces.begin() + 3 ) );
+			testMesh.draw();
+
+			// Test to make sure adding faces uploads the indices on the next draw
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), bufferDataCalls );
+			Assert::AreEqual( static_cast<GLsizeiptr>( 9 ), bufferDataSize );
+
+			testMesh.add_vertices( static_cast<const void*>( &vertices[0] ), 253 );
+			testMesh.draw();
+
+			// Test to make sure the indices are widened to shorts once there are more vertices than a byte can index
+			Assert::AreEqual( static_cast<GLenum>( GL_UNSIGNED_SHORT ), drawElementsType );
+			Assert::AreEqual( static_cast<GLsizeiptr>( 9 * sizeof( unsigned short ) ), bufferDataSize );
+
+			testMesh.add_vertices( static_cast<const void*>( &vertices[0] ), 0x10000 - 257 );
+
+			// Test to make sure a mesh whose indices all fit in a short keeps using shorts
+			Assert::AreEqual( static_cast<GLenum>( GL_UNSIGNED_SHORT ), testMesh.get_index_type() );
+
+			testMesh.add_vertices( static_cast<const void*>( &vertices[0] ), 1 );
+			testMesh.draw();
+
+			// Test to make sure the indices are widened to unsigned ints once there are more vertices than a short can index
+			Assert::AreEqual( static_cast<GLenum>( GL_UNSIGNED_INT ), drawElementsType );
+			Assert::AreEqual( static_cast<GLsizeiptr>( 9 * sizeof( unsigned int ) ), bufferDataSize );
+		}
 	};
 }
\ No newline at end of file
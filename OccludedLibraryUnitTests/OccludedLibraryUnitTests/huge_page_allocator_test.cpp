@@ -0,0 +1,65 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <buffers/interleaved_attr_buffer.h>
+#include <buffers/storage/huge_page_allocator.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+using namespace occluded::buffers::attributes;
+using namespace occluded::buffers::storage;
+
+namespace OccludedLibraryUnitTests
+{
+	TEST_CLASS( huge_page_allocator_test )
+	{
+	public:
+
+		TEST_METHOD( huge_page_allocator_allocate_test )
+		{
+			huge_page_allocator testAllocator;
+
+			// Test to make sure only allocations of at least the threshold are backed by huge pages
+			Assert::IsFalse( testAllocator.uses_huge_pages( huge_page_allocator::HUGE_PAGE_SIZE - 1 ) );
+			Assert::IsTrue( testAllocator.uses_huge_pages( huge_page_allocator::HUGE_PAGE_SIZE ) );
+
+			const std::size_t size = huge_page_allocator::HUGE_PAGE_SIZE + 100;
+			char* memory = static_cast<char*>( testAllocator.allocate( size ) );
+
+			memset( memory, 0xab, size );
+
+			// Test to make sure all of the memory requested can be written to
+			Assert::AreEqual( static_cast<char>( 0xab ), memory[size - 1] );
+
+			testAllocator.deallocate( memory, size );
+
+			char* small = static_cast<char*>( testAllocator.allocate( 16 ) );
+			small[15] = 1;
+			testAllocator.deallocate( small, 16 );
+		}
+
+		TEST_METHOD( huge_page_allocator_attribute_buffer_test )
+		{
+			huge_page_allocator testAllocator( 4096 );
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "test", 4, attrib_float ) );
+			testMap.end_definition();
+
+			interleaved_attr_buffer testBuffer( testMap, testAllocator );
+			std::vector<float> values( 4 * 1000 );
+
+			for( unsigned int i = 0; i < values.size(); ++i ) {
+				values[i] = static_cast<float>( i );
+			}
+
+			testBuffer.insert_values( static_cast<const void*>( &values[0] ), 1000 );
+			testBuffer.insert_values( static_cast<const void*>( &values[0] ), 1000 );
+
+			const float* testData = reinterpret_cast<const float*>( &testBuffer.get_all_data()[0] );
+
+			// Test to make sure the values survive the buffer growing from heap memory into huge pages
+			Assert::AreEqual( 3999.f, testData[3999] );
+			Assert::AreEqual( 3999.f, testData[7999] );
+		}
+	};
+}
@@ -0,0 +1,191 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <buffers/hybrid_attr_buffer.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+using namespace occluded::buffers::attributes;
+
+namespace OccludedLibraryUnitTests
+{
+	static attribute_map* hybridMap = NULL;
+
+	TEST_CLASS( hybrid_attr_buffer_test )
+	{
+	public:
+
+		TEST_CLASS_INITIALIZE( hybrid_attr_buffer_class_init )
+		{
+			hybridMap = new attribute_map( layout_hybrid );
+		}
+
+		TEST_CLASS_CLEANUP( hybrid_attr_buffer_class_delete )
+		{
+			delete hybridMap;
+			hybridMap = NULL;
+		}
+
+		TEST_METHOD_INITIALIZE( hybrid_attr_buffer_method_init )
+		{
+			hybridMap->reset( layout_hybrid );
+			hybridMap->add_attribute( attribute( "position", 2, attrib_float ) );
+			hybridMap->add_attribute( attribute( "normal", 1, attrib_float ) );
+			hybridMap->add_attribute( attribute( "colour", 1, attrib_float ) );
+			hybridMap->end_definition();
+		}
+
+		TEST_METHOD( hybrid_attr_buffer_invalid_map_test )
+		{
+			hybridMap->reset( false );
+			hybridMap->add_attribute( attribute( "position", 2, attrib_float ) );
+			hybridMap->end_definition();
+
+			try {
+				hybrid_attr_buffer testBuffer( *hybridMap );
+
+				// Test to make sure an exception is thrown if a segregated attribute map is passed to a hybrid attribute buffer's constructor
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			hybridMap->reset( true );
+			hybridMap->add_attribute( attribute( "position", 2, attrib_float ) );
+			hybridMap->end_definition();
+
+			try {
+				hybrid_attr_buffer testBuffer( *hybridMap );
+
+				// Test to make sure an exception is thrown if an interleaved attribute map is passed to a hybrid attribute buffer's constructor
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( hybrid_attr_buffer_insert_values_test )
+		{
+			hybrid_attr_buffer testBuffer( *hybridMap );
+			// The positions of both values, followed by the normal and colour of each value
+			const float initialVals[] = { 0.f, 1.f, 2.f, 3.f, 10.f, 20.f, 11.f, 21.f };
+
+			testBuffer.insert_values( static_cast<const void*>( initialVals ), 2 );
+
+			const std::vector<unsigned int>& offsets = testBuffer.get_attribute_data_offsets();
+			const float* testPositions = reinterpret_cast<const float*>( &testBuffer.get_all_data()[offsets[0]] );
+			const float* testRest = reinterpret_cast<const float*>( &testBuffer.get_all_data()[offsets[1]] );
+
+			// Test to make sure the positions are tightly packed at the start of the buffer
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testBuffer.get_num_values() );
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), offsets[0] );
+			Assert::AreEqual( 0.f, testPositions[0] );
+			Assert::AreEqual( 1.f, testPositions[1] );
+			Assert::AreEqual( 2.f, testPositions[2] );
+			Assert::AreEqual( 3.f, testPositions[3] );
+
+			// Test to make sure the other attributes are interleaved after room for the positions of every value
+			Assert::AreEqual( static_cast<unsigned int>( 2 * 2 * sizeof( float ) ), offsets[1] );
+			Assert::AreEqual( offsets[1] + static_cast<unsigned int>( sizeof( float ) ), offsets[2] );
+			Assert::AreEqual( 10.f, testRest[0] );
+			Assert::AreEqual( 20.f, testRest[1] );
+			Assert::AreEqual( 11.f, testRest[2] );
+			Assert::AreEqual( 21.f, testRest[3] );
+
+			const float singleVal[] = { 4.f, 5.f, 12.f, 22.f };
+
+			testBuffer.insert_values( static_cast<const void*>( singleVal ), 1 );
+
+			testPositions = reinterpret_cast<const float*>( &testBuffer.get_all_data()[offsets[0]] );
+			testRest = reinterpret_cast<const float*>( &testBuffer.get_all_data()[offsets[1]] );
+
+			// Test to make sure a single value is laid out the same way as an interleaved value and survives the sections growing
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), testBuffer.get_num_values() );
+			Assert::AreEqual( 2.f, testPositions[2] );
+			Assert::AreEqual( 4.f, testPositions[4] );
+			Assert::AreEqual( 5.f, testPositions[5] );
+			Assert::AreEqual( 11.f, testRest[2] );
+			Assert::AreEqual( 12.f, testRest[4] );
+			Assert::AreEqual( 22.f, testRest[5] );
+		}
+
+		TEST_METHOD( hybrid_attr_buffer_reserve_test )
+		{
+			hybrid_attr_buffer testBuffer( *hybridMap );
+			std::vector<char> data( hybridMap->get_byte_size() );
+
+			testBuffer.reserve( 100 );
+
+			// Test to make sure reserving room places the second section after room for 100 positions
+			Assert::AreEqual( static_cast<unsigned int>( 100 ), testBuffer.get_capacity() );
+			Assert::AreEqual( static_cast<unsigned int>( 100 * 2 * sizeof( float ) ), testBuffer.get_attribute_data_offsets()[1] );
+
+			for( unsigned int i = 0; i < 100; ++i ) {
+				testBuffer.insert_values( data );
+			}
+
+			// Test to make sure the offsets do not change while the buffer is within its reserved capacity
+			Assert::AreEqual( static_cast<unsigned int>( 100 ), testBuffer.get_capacity() );
+			Assert::AreEqual( static_cast<unsigned int>( 100 * 2 * sizeof( float ) ), testBuffer.get_attribute_data_offsets()[1] );
+
+			testBuffer.clear_buffer();
+
+			// Test to make sure the capacity is reset when the buffer is cleared
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testBuffer.get_capacity() );
+		}
+
+		TEST_METHOD( hybrid_attr_buffer_grow_past_offset_range_test )
+		{
+			hybrid_attr_buffer testBuffer( *hybridMap );
+
+			try {
+				testBuffer.reserve( 0x10000000 );
+
+				// Test to make sure an exception is thrown instead of wrapping the offsets when the sections would end past their range
+				Assert::Fail();
+			} catch( const std::runtime_error& ) {
+			}
+
+			// Test to make sure the buffer was left empty
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testBuffer.get_capacity() );
+			Assert::IsTrue( testBuffer.get_all_data().empty() );
+		}
+
+		TEST_METHOD( hybrid_attr_buffer_erase_compact_test )
+		{
+			hybrid_attr_buffer testBuffer( *hybridMap );
+			const float initialVals[] = { 0.f, 0.f, 1.f, 1.f, 2.f, 2.f, 10.f, 20.f, 11.f, 21.f, 12.f, 22.f };
+			std::vector<unsigned int> remap( 3 );
+
+			testBuffer.insert_values( static_cast<const void*>( initialVals ), 3 );
+			testBuffer.erase_values( 0, 1 );
+
+			remap = testBuffer.compact();
+
+			const float* testPositions = reinterpret_cast<const float*>( &testBuffer.get_all_data()[testBuffer.get_attribute_data_offsets()[0]] );
+			const float* testRest = reinterpret_cast<const float*>( &testBuffer.get_all_data()[testBuffer.get_attribute_data_offsets()[1]] );
+
+			// Test to make sure the values after the erased value were moved down in both sections
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testBuffer.get_num_values() );
+			Assert::AreEqual( 1.f, testPositions[0] );
+			Assert::AreEqual( 2.f, testPositions[3] );
+			Assert::AreEqual( 11.f, testRest[0] );
+			Assert::AreEqual( 22.f, testRest[3] );
+			Assert::AreEqual( attribute_buffer::ERASED_VALUE, remap[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), remap[2] );
+
+			remap.resize( 2 );
+			remap[0] = 1;
+			remap[1] = 0;
+
+			testBuffer.reorder_values( remap );
+
+			testPositions = reinterpret_cast<const float*>( &testBuffer.get_all_data()[testBuffer.get_attribute_data_offsets()[0]] );
+			testRest = reinterpret_cast<const float*>( &testBuffer.get_all_data()[testBuffer.get_attribute_data_offsets()[1]] );
+
+			// Test to make sure each value was moved to its new index in both sections
+			Assert::AreEqual( 2.f, testPositions[0] );
+			Assert::AreEqual( 1.f, testPositions[2] );
+			Assert::AreEqual( 12.f, testRest[0] );
+			Assert::AreEqual( 21.f, testRest[3] );
+		}
+	};
+}
@@ -217,5 +217,297 @@ namespace OccludedLibraryUnitTests
 			// Test to make sure the number of values is 3 after inserting 3 values
 			Assert::AreEqual( static_cast<unsigned int>( 3 ), testBuffer.get_num_values() );
 		}
+
+		TEST_METHOD( interleaved_attr_buffer_insert_pointer_test )
+		{
+			testMap->add_attribute( attribute( "test2", 2, attrib_int ) );
+			testMap->end_definition();
+
+			interleaved_attr_buffer testBuffer( *testMap );
+			const float floatVals[] = { 1.5f, 0.f, 0.f, -2.25f, 0.f, 0.f };
+			std::vector<char> values( sizeof( floatVals ) );
+			int testInt;
+			float testFloat;
+
+			memcpy( &values[0], floatVals, sizeof( floatVals ) );
+			testInt = 7;
+			memcpy( &values[sizeof( float ) + sizeof( int )], &testInt, sizeof( int ) );
+
+			testBuffer.insert_values( static_cast<const void*>( &values[0] ), 2 );
+
+			// Test to make sure both values were inserted directly from the memory passed
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testBuffer.get_num_values() );
+			Assert::AreEqual( values.size(), testBuffer.get_byte_size() );
+
+			testFloat = *( reinterpret_cast<const float*>( &testBuffer.get_all_data()[3 * sizeof( float )] ) );
+			testInt = *( reinterpret_cast<const int*>( &testBuffer.get_all_data()[sizeof( float ) + sizeof( int )] ) );
+
+			Assert::IsTrue( testFloat >= -2.25f - MAX_ERR && testFloat <= -2.25f + MAX_ERR );
+			Assert::AreEqual( 7, testInt );
+
+			try {
+				testBuffer.insert_values( static_cast<const void*>( &values[0] ), 0 );
+
+				// Test to make sure an exception is thrown when no values are passed
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( interleaved_attr_buffer_insert_encoded_values_test )
+		{
+			testMap->add_attribute( attribute( "color", 4, attrib_ubyte, true ) );
+			testMap->add_attribute( attribute( "id", 1, attrib_uint ) );
+			testMap->end_definition();
+
+			interleaved_attr_buffer testBuffer( *testMap );
+
+			// Every value of each attribute, one attribute after another
+			const float values[] = { 1.5f, -2.25f, 1.f, 0.f, 0.5f, 2.f, 0.f, 1.f, 1.f, 1.f, 7.f, -1.f };
+			const std::size_t stride = sizeof( float ) + 4 + sizeof( unsigned int );
+
+			testBuffer.insert_encoded_values( values, 2 );
+
+			const attribute_buffer::data_vector& testData = testBuffer.get_all_data();
+			float testFloat;
+			unsigned int testId;
+
+			// Test to make sure each attribute is converted to its own format and interleaved with the others
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testBuffer.get_num_values() );
+			Assert::AreEqual( 2 * stride, testBuffer.get_byte_size() );
+
+			memcpy( &testFloat, &testData[stride], sizeof( float ) );
+			Assert::AreEqual( -2.25f, testFloat );
+			Assert::AreEqual( 255, static_cast<int>( static_cast<unsigned char>( testData[sizeof( float )] ) ) );
+			Assert::AreEqual( 128, static_cast<int>( static_cast<unsigned char>( testData[sizeof( float ) + 2] ) ) );
+			Assert::AreEqual( 255, static_cast<int>( static_cast<unsigned char>( testData[sizeof( float ) + 3] ) ) );
+			Assert::AreEqual( 0, static_cast<int>( static_cast<unsigned char>( testData[stride + sizeof( float )] ) ) );
+
+			memcpy( &testId, &testData[sizeof( float ) + 4], sizeof( unsigned int ) );
+			Assert::AreEqual( 7u, testId );
+
+			// Test to make sure values out of the range of the type are clamped instead of wrapping around
+			memcpy( &testId, &testData[stride + sizeof( float ) + 4], sizeof( unsigned int ) );
+			Assert::AreEqual( 0u, testId );
+
+			try {
+				testBuffer.insert_encoded_values( NULL, 1 );
+
+				// Test to make sure an exception is thrown when no values are passed
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( interleaved_attr_buffer_insert_range_test )
+		{
+			struct test_vertex {
+				float value;
+				int other[2];
+			};
+
+			testMap->add_attribute( attribute( "test2", 2, attrib_int ) );
+			testMap->end_definition();
+
+			interleaved_attr_buffer testBuffer( *testMap );
+			std::vector<test_vertex> vertices( 3 );
+			float testFloat;
+
+			for( unsigned int i = 0; i < vertices.size(); ++i ) {
+				vertices[i].value = static_cast<float>( i ) + 0.5f;
+				vertices[i].other[0] = static_cast<int>( i );
+				vertices[i].other[1] = -static_cast<int>( i );
+			}
+
+			testBuffer.insert_values( vertices.begin(), vertices.end() );
+
+			// Test to make sure each vertex structure was inserted as a value
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), testBuffer.get_num_values() );
+			Assert::AreEqual( 0, memcmp( &vertices[0], &testBuffer.get_all_data()[0], vertices.size() * sizeof( test_vertex ) ) );
+
+			testFloat = *( reinterpret_cast<const float*>( &testBuffer.get_all_data()[2 * sizeof( test_vertex )] ) );
+			Assert::IsTrue( testFloat >= 2.5f - MAX_ERR && testFloat <= 2.5f + MAX_ERR );
+
+			try {
+				std::vector<float> wrongSize( 3 );
+				testBuffer.insert_values( wrongSize.begin(), wrongSize.end() );
+
+				// Test to make sure an exception is thrown when the structure does not match the attribute map
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( interleaved_attr_buffer_update_values_test )
+		{
+			testMap->end_definition();
+
+			interleaved_attr_buffer testBuffer( *testMap );
+			const float initialVals[] = { 0.f, 1.f, 2.f, 3.f, 4.f, 5.f };
+			const float newVals[] = { -1.f, -2.f };
+
+			testBuffer.insert_values( static_cast<const void*>( initialVals ), 6 );
+
+			// Test to make sure inserting values makes the whole buffer dirty
+			Assert::IsTrue( testBuffer.is_all_dirty() );
+
+			testBuffer.clear_dirty_ranges();
+			testBuffer.update_values( 1, 2, newVals );
+
+			// Test to make sure the values were overwritten in place
+			Assert::AreEqual( static_cast<unsigned int>( 6 ), testBuffer.get_num_values() );
+			Assert::AreEqual( 0, memcmp( newVals, &testBuffer.get_all_data()[sizeof( float )], sizeof( newVals ) ) );
+
+			// Test to make sure a single dirty range covering the overwritten values was recorded
+			Assert::IsFalse( testBuffer.is_all_dirty() );
+			Assert::AreEqual( static_cast<std::size_t>( 1 ), testBuffer.get_dirty_ranges().size() );
+			Assert::AreEqual( sizeof( float ), testBuffer.get_dirty_ranges()[0].first );
+			Assert::AreEqual( 2 * sizeof( float ), testBuffer.get_dirty_ranges()[0].second );
+
+			testBuffer.update_values( 5, 1, newVals );
+			testBuffer.update_values( 3, 1, newVals );
+
+			// Test to make sure ranges that touch are merged and ranges that do not stay separate
+			Assert::AreEqual( static_cast<std::size_t>( 2 ), testBuffer.get_dirty_ranges().size() );
+			Assert::AreEqual( sizeof( float ), testBuffer.get_dirty_ranges()[0].first );
+			Assert::AreEqual( 3 * sizeof( float ), testBuffer.get_dirty_ranges()[0].second );
+			Assert::AreEqual( 5 * sizeof( float ), testBuffer.get_dirty_ranges()[1].first );
+
+			testBuffer.update_values( 0, 6, initialVals );
+
+			// Test to make sure a range covering the others merges them all
+			Assert::AreEqual( static_cast<std::size_t>( 1 ), testBuffer.get_dirty_ranges().size() );
+			Assert::AreEqual( testBuffer.get_byte_size(), testBuffer.get_dirty_ranges()[0].second );
+
+			try {
+				testBuffer.update_values( 5, 2, newVals );
+
+				// Test to make sure an exception is thrown when the range goes past the end of the buffer
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+
+		TEST_METHOD( interleaved_attr_buffer_erase_values_test )
+		{
+			testMap->end_definition();
+
+			interleaved_attr_buffer testBuffer( *testMap );
+			const float initialVals[] = { 0.f, 1.f, 2.f, 3.f, 4.f, 5.f };
+			const float newVals[] = { -1.f, -2.f, -3.f };
+
+			testBuffer.insert_values( static_cast<const void*>( initialVals ), 6 );
+			testBuffer.erase_values( 4, 1 );
+			testBuffer.erase_values( 1, 1 );
+			testBuffer.erase_values( 2, 1 );
+
+			// Test to make sure erased ranges that touch are merged and the erased values are left in place
+			Assert::AreEqual( static_cast<std::size_t>( 2 ), testBuffer.get_free_ranges().size() );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testBuffer.get_free_ranges()[0].second );
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), testBuffer.get_num_free_values() );
+			Assert::AreEqual( static_cast<unsigned int>( 6 ), testBuffer.get_num_values() );
+			Assert::IsTrue( testBuffer.is_value_erased( 4 ) );
+			Assert::IsFalse( testBuffer.is_value_erased( 3 ) );
+
+			try {
+				testBuffer.erase_values( 2, 1 );
+
+				// Test to make sure an exception is thrown when a value is erased twice
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			try {
+				testBuffer.erase_values( 5, 2 );
+
+				// Test to make sure an exception is thrown when the range goes past the end of the buffer
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			// Test to make sure the next values inserted are stored at the lowest erased indices
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), testBuffer.get_next_indices( 3 )[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 4 ), testBuffer.get_next_indices( 3 )[2] );
+
+			testBuffer.insert_values( static_cast<const void*>( newVals ), 3 );
+
+			const float* testData = reinterpret_cast<const float*>( &testBuffer.get_all_data()[0] );
+
+			// Test to make sure the erased values were reused instead of growing the buffer
+			Assert::AreEqual( static_cast<unsigned int>( 6 ), testBuffer.get_num_values() );
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testBuffer.get_num_free_values() );
+			Assert::AreEqual( -1.f, testData[1] );
+			Assert::AreEqual( 3.f, testData[3] );
+			Assert::AreEqual( -3.f, testData[4] );
+		}
+
+		TEST_METHOD( interleaved_attr_buffer_compact_test )
+		{
+			testMap->end_definition();
+
+			interleaved_attr_buffer testBuffer( *testMap );
+			const float initialVals[] = { 0.f, 1.f, 2.f, 3.f, 4.f, 5.f };
+
+			testBuffer.insert_values( static_cast<const void*>( initialVals ), 6 );
+			testBuffer.erase_values( 0, 1 );
+			testBuffer.erase_values( 3, 2 );
+			testBuffer.clear_dirty_ranges();
+
+			std::vector<unsigned int> remap = testBuffer.compact();
+			const float* testData = reinterpret_cast<const float*>( &testBuffer.get_all_data()[0] );
+
+			// Test to make sure the remaining values were moved down in order
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), testBuffer.get_num_values() );
+			Assert::AreEqual( 3 * sizeof( float ), testBuffer.get_byte_size() );
+			Assert::AreEqual( 1.f, testData[0] );
+			Assert::AreEqual( 2.f, testData[1] );
+			Assert::AreEqual( 5.f, testData[2] );
+
+			// Test to make sure the remap gives the new index of every value and marks the erased ones
+			Assert::AreEqual( static_cast<std::size_t>( 6 ), remap.size() );
+			Assert::AreEqual( attribute_buffer::ERASED_VALUE, remap[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), remap[1] );
+			Assert::AreEqual( attribute_buffer::ERASED_VALUE, remap[4] );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), remap[5] );
+
+			// Test to make sure compacting empties the free list and makes the whole buffer dirty
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testBuffer.get_num_free_values() );
+			Assert::IsTrue( testBuffer.is_all_dirty() );
+		}
+
+		TEST_METHOD( interleaved_attr_buffer_reorder_values_test )
+		{
+			testMap->end_definition();
+
+			interleaved_attr_buffer testBuffer( *testMap );
+			const float initialVals[] = { 0.f, 1.f, 2.f };
+			std::vector<unsigned int> remap( 3 );
+
+			testBuffer.insert_values( static_cast<const void*>( initialVals ), 3 );
+
+			remap[0] = 1;
+			remap[1] = 2;
+			remap[2] = 0;
+
+			testBuffer.reorder_values( remap );
+
+			const float* testVals = reinterpret_cast<const float*>( &testBuffer.get_all_data()[0] );
+
+			// Test to make sure each value was moved to its new index
+			Assert::AreEqual( 2.f, testVals[0] );
+			Assert::AreEqual( 0.f, testVals[1] );
+			Assert::AreEqual( 1.f, testVals[2] );
+
+			testBuffer.erase_values( 0, 1 );
+
+			try {
+				testBuffer.reorder_values( remap );
+
+				// Test to make sure an exception is thrown when the buffer contains erased values
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
 	};
 }
\ No newline at end of file
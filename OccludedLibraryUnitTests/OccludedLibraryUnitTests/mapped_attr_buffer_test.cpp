@@ -0,0 +1,232 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <buffers/interleaved_attr_buffer.h>
+#include <buffers/mapped_attr_buffer.h>
+#include <buffers/segregated_attr_buffer.h>
+#include <buffers/attribute_buffer_serializer.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+using namespace occluded::buffers::attributes;
+
+namespace OccludedLibraryUnitTests
+{
+	static const std::string mappedFilePath( "mapped_attr_buffer_test.bin" );
+
+	// Writes the values of a buffer to a file, with each section at the offset given by the header
+	static void write_buffer_file( const attribute_buffer& buffer, const std::size_t sectionAlignment ) {
+		const attribute_buffer_header header( buffer.get_attribute_map(), buffer.get_num_values(), sectionAlignment );
+		std::ofstream fileStream( mappedFilePath.c_str(), std::ios::out | std::ios::binary );
+
+		header.write( fileStream );
+
+		for( unsigned int i = 0; i < header.get_section_offsets().size(); ++i ) {
+			while( static_cast<boost::uint64_t>( fileStream.tellp() ) < header.get_section_offsets()[i] ) {
+				fileStream.put( '\0' );
+			}
+
+			fileStream.write( buffer.get_data() + buffer.get_attribute_data_offsets()[i], static_cast<std::streamsize>( header.get_section_size( i ) ) );
+		}
+	}
+
+	TEST_CLASS( mapped_attr_buffer_test )
+	{
+	public:
+
+		TEST_METHOD_CLEANUP( mapped_attr_buffer_method_cleanup )
+		{
+			remove( mappedFilePath.c_str() );
+		}
+
+		TEST_METHOD( mapped_attr_buffer_interleaved_test )
+		{
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.add_attribute( attribute( "id", 1, attrib_uint ) );
+			testMap.end_definition();
+
+			interleaved_attr_buffer sourceBuffer( testMap );
+			const float values[] = { 1.f, 2.f, 3.f, 0.f, 4.f, 5.f, 6.f, 0.f };
+
+			sourceBuffer.insert_values( static_cast<const void*>( values ), 2 );
+			write_buffer_file( sourceBuffer, attribute_buffer_header::SECTION_ALIGNMENT );
+
+			mapped_attr_buffer testBuffer( testMap, mappedFilePath );
+
+			// Test to make sure the values are read in place from the mapped file
+			Assert::IsTrue( testBuffer.is_mapped() );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testBuffer.get_num_values() );
+			Assert::AreEqual( sourceBuffer.get_byte_size(), testBuffer.get_byte_size() );
+			Assert::AreEqual( 0, memcmp( values, testBuffer.get_data(), sizeof( values ) ) );
+			Assert::IsTrue( testBuffer.get_attribute_data_offsets() == testMap.get_attribute_offsets() );
+
+			try {
+				testBuffer.insert_values( static_cast<const void*>( values ), 1 );
+
+				// Test to make sure an exception is thrown when values are inserted into the read-only buffer
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			try {
+				testBuffer.update_values( 0, 1, values );
+
+				// Test to make sure an exception is thrown when values in the read-only buffer are updated
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			try {
+				testBuffer.erase_values( 0, 1 );
+
+				// Test to make sure an exception is thrown when values in the read-only buffer are erased
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			// Test to make sure the values that failed to be erased are still in the buffer
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testBuffer.get_num_free_values() );
+			Assert::IsFalse( testBuffer.is_value_erased( 0 ) );
+		}
+
+		TEST_METHOD( mapped_attr_buffer_segregated_test )
+		{
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "color", 3, attrib_ubyte, true ) );
+			testMap.add_attribute( attribute( "weight", 1, attrib_float ) );
+			testMap.end_definition();
+
+			segregated_attr_buffer sourceBuffer( testMap );
+			// The colors of the values, followed by their weights
+			const unsigned char colors[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+			const float weights[] = { 0.5f, 1.5f, 2.5f };
+			std::vector<char> values( sizeof( colors ) + sizeof( weights ) );
+
+			memcpy( &values[0], colors, sizeof( colors ) );
+			memcpy( &values[sizeof( colors )], weights, sizeof( weights ) );
+
+			sourceBuffer.insert_values( static_cast<const void*>( &values[0] ), 3 );
+			write_buffer_file( sourceBuffer, attribute_buffer_header::SECTION_ALIGNMENT );
+
+			{
+				mapped_attr_buffer testBuffer( testMap, mappedFilePath );
+				const float* testWeights = reinterpret_cast<const float*>( testBuffer.get_data() + testBuffer.get_attribute_data_offsets()[1] );
+
+				// Test to make sure each section is read in place at its offset in the file
+				Assert::IsTrue( testBuffer.is_mapped() );
+				Assert::AreEqual( static_cast<char>( 9 ), testBuffer.get_data()[testBuffer.get_attribute_data_offsets()[0] + 8] );
+				Assert::AreEqual( 2.5f, testWeights[2] );
+			}
+
+			// Sections packed one after another leave the weights at an offset that is not a multiple of 4
+			write_buffer_file( sourceBuffer, 1 );
+
+			mapped_attr_buffer copiedBuffer( testMap, mappedFilePath );
+			const float* copiedWeights = reinterpret_cast<const float*>( copiedBuffer.get_data() + copiedBuffer.get_attribute_data_offsets()[1] );
+
+			// Test to make sure sections that are not aligned are copied to aligned offsets
+			Assert::IsFalse( copiedBuffer.is_mapped() );
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), copiedBuffer.get_attribute_data_offsets()[1] % 4 );
+			Assert::AreEqual( static_cast<char>( 4 ), copiedBuffer.get_data()[3] );
+			Assert::AreEqual( 0.5f, copiedWeights[0] );
+			Assert::AreEqual( 2.5f, copiedWeights[2] );
+		}
+
+		TEST_METHOD( mapped_attr_buffer_invalid_file_test )
+		{
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.end_definition();
+
+			attribute_map otherMap( true );
+			otherMap.add_attribute( attribute( "position", 4, attrib_float ) );
+			otherMap.end_definition();
+
+			interleaved_attr_buffer sourceBuffer( testMap );
+			const float values[] = { 1.f, 2.f, 3.f };
+
+			sourceBuffer.insert_values( static_cast<const void*>( values ), 1 );
+			write_buffer_file( sourceBuffer, attribute_buffer_header::SECTION_ALIGNMENT );
+
+			try {
+				mapped_attr_buffer testBuffer( otherMap, mappedFilePath );
+
+				// Test to make sure an exception is thrown when the map in the header does not match the map passed to the constructor
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			try {
+				mapped_attr_buffer testBuffer( testMap, "not_exist.bin" );
+
+				// Test to make sure an exception is thrown when the file does not exist
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			{
+				// Cut off the last byte of the values
+				attribute_buffer_header header( testMap, 1 );
+				std::ofstream fileStream( mappedFilePath.c_str(), std::ios::out | std::ios::binary );
+
+				header.write( fileStream );
+				fileStream.write( reinterpret_cast<const char*>( values ), sizeof( values ) - 1 );
+			}
+
+			try {
+				mapped_attr_buffer testBuffer( testMap, mappedFilePath );
+
+				// Test to make sure an exception is thrown when the file is shorter than its header says
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			attribute_buffer_serializer::save( mappedFilePath, sourceBuffer, true, true );
+
+			try {
+				mapped_attr_buffer testBuffer( testMap, mappedFilePath );
+
+				// Test to make sure an exception is thrown when the sections of the file are compressed
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( mapped_attr_buffer_large_offset_test )
+		{
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			testMap.add_attribute( attribute( "weight", 1, attrib_float ) );
+			testMap.end_definition();
+
+			segregated_attr_buffer sourceBuffer( testMap );
+			const float values[] = { 1.f, 2.f, 3.f, 0.5f };
+
+			sourceBuffer.insert_values( static_cast<const void*>( values ), 1 );
+			write_buffer_file( sourceBuffer, attribute_buffer_header::SECTION_ALIGNMENT );
+
+			{
+				// The offset of the last section is stored just before the checksum at the end of the header, and is set to 0x100000100 so that the
+				// section starts more than 4 GiB after the first one
+				const attribute_buffer_header header( testMap, 1 );
+				std::fstream fileStream( mappedFilePath.c_str(), std::ios::in | std::ios::out | std::ios::binary );
+				const unsigned char largeOffset[] = { 0, 1, 0, 0, 1, 0, 0, 0 };
+
+				fileStream.seekp( static_cast<std::streamoff>( header.get_header_size() - sizeof( boost::uint32_t ) - sizeof( boost::uint64_t ) ) );
+				fileStream.write( reinterpret_cast<const char*>( largeOffset ), sizeof( largeOffset ) );
+			}
+
+			try {
+				mapped_attr_buffer testBuffer( testMap, mappedFilePath );
+
+				// Test to make sure an exception is thrown when a section starts past the largest offset a buffer can hold
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+	};
+}
@@ -0,0 +1,50 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <cstdio>
+#include <fstream>
+#include "utilities/files/mapped_file.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::utilities::files;
+
+namespace OccludedLibraryUnitTests
+{
+	TEST_CLASS( mapped_file_test )
+	{
+	public:
+
+		TEST_METHOD( mapped_file_valid_file_test )
+		{
+			const std::string testPath( "mapped_file_test.bin" );
+			const std::string testContent( "Mapped file contents." );
+
+			{
+				std::ofstream fileStream( testPath.c_str(), std::ios::out | std::ios::binary );
+				fileStream.write( testContent.c_str(), testContent.size() );
+			}
+
+			{
+				mapped_file testFile( testPath );
+
+				// Test to make sure the whole file is mapped
+				Assert::AreEqual( testContent.size(), testFile.get_size() );
+				Assert::AreEqual( testContent, std::string( testFile.get_data(), testFile.get_size() ) );
+			}
+
+			// Test to make sure the file is released when the mapping is destroyed
+			Assert::AreEqual( 0, remove( testPath.c_str() ) );
+		}
+
+		TEST_METHOD( mapped_file_invalid_file_test )
+		{
+			try {
+				mapped_file testFile( "not_exist.bin" );
+
+				// Test to make sure an exception is thrown if a file that doesn't exist is mapped
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+	};
+}
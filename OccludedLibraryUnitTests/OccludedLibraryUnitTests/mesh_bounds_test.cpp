@@ -0,0 +1,86 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <cmath>
+
+#include <meshes/mesh_bounds.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::meshes;
+
+namespace OccludedLibraryUnitTests
+{
+	// Checks that a position is inside the sphere of the bounds, allowing for rounding
+	static const bool sphere_contains( const mesh_bounds& bounds, const float* p ) {
+		const float* center = bounds.get_center();
+		const float offset[3] = { p[0] - center[0], p[1] - center[1], p[2] - center[2] };
+
+		return std::sqrt( offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2] ) <= bounds.get_radius() * 1.0001f;
+	}
+
+	TEST_CLASS( mesh_bounds_test )
+	{
+	public:
+
+		TEST_METHOD( mesh_bounds_add_positions_test )
+		{
+			mesh_bounds testBounds;
+			// Each position is followed by a colour, so the positions are 16 bytes apart
+			const float initialVals[] = { 1.f, 2.f, 3.f, 100.f, -1.f, 5.f, 0.f, -100.f, 4.f, -2.f, 1.f, 100.f };
+
+			// Test to make sure the bounds start empty
+			Assert::IsTrue( testBounds.is_empty() );
+			Assert::AreEqual( 0.f, testBounds.get_radius() );
+
+			testBounds.add_positions( reinterpret_cast<const char*>( initialVals ), 3, 4 * sizeof( float ) );
+
+			// Test to make sure the box contains exactly the positions and the colours are not read as positions
+			Assert::IsFalse( testBounds.is_empty() );
+			Assert::AreEqual( -1.f, testBounds.get_min()[0] );
+			Assert::AreEqual( -2.f, testBounds.get_min()[1] );
+			Assert::AreEqual( 0.f, testBounds.get_min()[2] );
+			Assert::AreEqual( 4.f, testBounds.get_max()[0] );
+			Assert::AreEqual( 5.f, testBounds.get_max()[1] );
+			Assert::AreEqual( 3.f, testBounds.get_max()[2] );
+
+			for( unsigned int i = 0; i < 3; ++i ) {
+				// Test to make sure the sphere contains every position
+				Assert::IsTrue( sphere_contains( testBounds, &initialVals[4 * i] ) );
+			}
+
+			const float packedVals[] = { 0.f, 0.f, 0.f, 10.f, 1.f, 1.f, 2.f, -8.f, 2.f };
+
+			testBounds.add_positions( reinterpret_cast<const char*>( packedVals ), 3, 3 * sizeof( float ) );
+
+			// Test to make sure the bounds grow to contain positions added later, including the last one, which is not read with SIMD
+			Assert::AreEqual( -1.f, testBounds.get_min()[0] );
+			Assert::AreEqual( -8.f, testBounds.get_min()[1] );
+			Assert::AreEqual( 10.f, testBounds.get_max()[0] );
+
+			for( unsigned int i = 0; i < 3; ++i ) {
+				Assert::IsTrue( sphere_contains( testBounds, &initialVals[4 * i] ) );
+				Assert::IsTrue( sphere_contains( testBounds, &packedVals[3 * i] ) );
+			}
+
+			testBounds.clear();
+
+			// Test to make sure clearing the bounds makes them empty
+			Assert::IsTrue( testBounds.is_empty() );
+			Assert::AreEqual( 0.f, testBounds.get_max()[0] );
+		}
+
+		TEST_METHOD( mesh_bounds_single_position_test )
+		{
+			mesh_bounds testBounds;
+			const float position[] = { 3.f, -4.f, 5.f };
+
+			testBounds.add_positions( reinterpret_cast<const char*>( position ), 1, 3 * sizeof( float ) );
+
+			// Test to make sure a single position gives a box and sphere of size 0 at that position
+			Assert::AreEqual( 3.f, testBounds.get_min()[0] );
+			Assert::AreEqual( 5.f, testBounds.get_max()[2] );
+			Assert::AreEqual( -4.f, testBounds.get_center()[1] );
+			Assert::AreEqual( 0.f, testBounds.get_radius() );
+		}
+	};
+}
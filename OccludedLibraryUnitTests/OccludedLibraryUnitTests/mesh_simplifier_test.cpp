@@ -0,0 +1,122 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <set>
+
+#include <meshes/mesh_simplifier.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::meshes;
+
+namespace OccludedLibraryUnitTests
+{
+	static const unsigned int GRID_SIZE = 16;
+
+	// Creates a flat grid of quads in the xy plane, with a vertex at every integer position
+	static void create_flat_grid( std::vector<unsigned int>& indices, std::vector<float>& positions ) {
+		for( unsigned int row = 0; row <= GRID_SIZE; ++row ) {
+			for( unsigned int column = 0; column <= GRID_SIZE; ++column ) {
+				positions.push_back( static_cast<float>( column ) );
+				positions.push_back( static_cast<float>( row ) );
+				positions.push_back( 0.f );
+			}
+		}
+
+		for( unsigned int row = 0; row < GRID_SIZE; ++row ) {
+			for( unsigned int column = 0; column < GRID_SIZE; ++column ) {
+				const unsigned int corner = row * ( GRID_SIZE + 1 ) + column;
+				const unsigned int triangles[] = { corner, corner + 1, corner + GRID_SIZE + 1, corner + 1, corner + GRID_SIZE + 2, corner + GRID_SIZE + 1 };
+
+				indices.insert( indices.end(), triangles, triangles + 6 );
+			}
+		}
+	}
+
+	TEST_CLASS( mesh_simplifier_test )
+	{
+	public:
+
+		TEST_METHOD( mesh_simplifier_generate_lod_chain_test )
+		{
+			std::vector<unsigned int> indices;
+			std::vector<float> positions, ratios;
+
+			create_flat_grid( indices, positions );
+
+			ratios.push_back( 0.5f );
+			ratios.push_back( 0.1f );
+
+			const std::vector<mesh_lod> lods = mesh_simplifier::generate_lod_chain( indices, positions, ratios );
+			const std::set<unsigned int> used( lods[1].indices.begin(), lods[1].indices.end() );
+
+			// Test to make sure each level reaches its ratio without any error, since the grid is flat
+			Assert::AreEqual( static_cast<std::size_t>( 2 ), lods.size() );
+			Assert::IsTrue( lods[0].indices.size() <= indices.size() / 2 && lods[0].indices.size() > indices.size() / 4 );
+			Assert::IsTrue( lods[1].indices.size() <= 3 * static_cast<std::size_t>( 0.1f * indices.size() / 3 ) );
+			Assert::AreEqual( 0.f, lods[1].error );
+
+			// Test to make sure the corners of the border are kept
+			Assert::AreEqual( static_cast<std::size_t>( 1 ), used.count( 0 ) );
+			Assert::AreEqual( static_cast<std::size_t>( 1 ), used.count( GRID_SIZE ) );
+			Assert::AreEqual( static_cast<std::size_t>( 1 ), used.count( GRID_SIZE * ( GRID_SIZE + 1 ) ) );
+			Assert::AreEqual( static_cast<std::size_t>( 1 ), used.count( ( GRID_SIZE + 1 ) * ( GRID_SIZE + 1 ) - 1 ) );
+
+			ratios.push_back( 0.2f );
+
+			try {
+				mesh_simplifier::generate_lod_chain( indices, positions, ratios );
+
+				// Test to make sure an exception is thrown when the ratios are not in decreasing order
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( mesh_simplifier_simplify_test )
+		{
+			std::vector<unsigned int> indices;
+			std::vector<float> positions, attributes, weights( 1, 1.f );
+
+			create_flat_grid( indices, positions );
+
+			// An attribute that steps from 0 to 1 halfway across the grid
+			for( unsigned int i = 0; i < positions.size(); i += 3 ) {
+				attributes.push_back( positions[i] < GRID_SIZE / 2 ? 0.f : 1.f );
+			}
+
+			const mesh_lod lod = mesh_simplifier::simplify( indices, positions, static_cast<unsigned int>( indices.size() / 8 ), attributes, weights );
+
+			// Test to make sure no triangle is stretched across the step in the attribute
+			for( unsigned int i = 0; i < lod.indices.size(); i += 3 ) {
+				const float a = attributes[lod.indices[i]], b = attributes[lod.indices[i + 1]], c = attributes[lod.indices[i + 2]];
+				const float first = positions[3 * lod.indices[i]], second = positions[3 * lod.indices[i + 1]], third = positions[3 * lod.indices[i + 2]];
+
+				if( a != b || b != c )
+					Assert::IsTrue( std::max( first, std::max( second, third ) ) - std::min( first, std::min( second, third ) ) <= 1.f );
+			}
+
+			Assert::IsTrue( lod.indices.size() < indices.size() );
+
+			weights[0] = -1.f;
+
+			try {
+				mesh_simplifier::simplify( indices, positions, 0, attributes, weights );
+
+				// Test to make sure an exception is thrown when a weight is negative
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			attributes.pop_back();
+			weights[0] = 1.f;
+
+			try {
+				mesh_simplifier::simplify( indices, positions, 0, attributes, weights );
+
+				// Test to make sure an exception is thrown when a vertex is missing an attribute value
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+	};
+}
@@ -0,0 +1,98 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include <meshes/meshlet_builder.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::meshes;
+
+namespace OccludedLibraryUnitTests
+{
+	static const unsigned int GRID_SIZE = 12;
+
+	// Creates a flat grid of quads in the xy plane facing +z, with a vertex at every integer position
+	static void create_meshlet_grid( std::vector<unsigned int>& indices, std::vector<float>& positions ) {
+		for( unsigned int row = 0; row <= GRID_SIZE; ++row ) {
+			for( unsigned int column = 0; column <= GRID_SIZE; ++column ) {
+				positions.push_back( static_cast<float>( column ) );
+				positions.push_back( static_cast<float>( row ) );
+				positions.push_back( 0.f );
+			}
+		}
+
+		for( unsigned int row = 0; row < GRID_SIZE; ++row ) {
+			for( unsigned int column = 0; column < GRID_SIZE; ++column ) {
+				const unsigned int corner = row * ( GRID_SIZE + 1 ) + column;
+				const unsigned int triangles[] = { corner, corner + 1, corner + GRID_SIZE + 1, corner + 1, corner + GRID_SIZE + 2, corner + GRID_SIZE + 1 };
+
+				indices.insert( indices.end(), triangles, triangles + 6 );
+			}
+		}
+	}
+
+	TEST_CLASS( meshlet_builder_test )
+	{
+	public:
+
+		TEST_METHOD( meshlet_builder_build_test )
+		{
+			std::vector<unsigned int> indices;
+			std::vector<float> positions;
+
+			create_meshlet_grid( indices, positions );
+
+			const meshlet_table table = meshlet_builder::build( indices, positions, 16, 20 );
+			std::vector<unsigned int> sortedIndices( indices ), sortedTable( table.indices );
+
+			std::sort( sortedIndices.begin(), sortedIndices.end() );
+			std::sort( sortedTable.begin(), sortedTable.end() );
+
+			// Test to make sure every face is in a meshlet
+			Assert::IsTrue( sortedIndices == sortedTable );
+			Assert::IsTrue( table.meshlets.size() >= indices.size() / 3 / 20 );
+
+			for( std::vector<meshlet>::const_iterator it = table.meshlets.begin(); it != table.meshlets.end(); ++it ) {
+				// Test to make sure the meshlet is within its limits and its local indices refer to the same vertices as its indices
+				Assert::IsTrue( it->vertexCount <= 16 && it->triangleCount <= 20 );
+
+				for( unsigned int i = 0; i < 3 * it->triangleCount; ++i ) {
+					const unsigned int vertex = table.indices[3 * it->triangleOffset + i];
+
+					Assert::AreEqual( vertex, table.vertices[it->vertexOffset + table.triangles[3 * it->triangleOffset + i]] );
+
+					// Test to make sure the vertex is inside the bounding box and sphere
+					Assert::IsTrue( positions[3 * vertex] >= it->boundsMin[0] && positions[3 * vertex] <= it->boundsMax[0] );
+					Assert::IsTrue( positions[3 * vertex + 1] >= it->boundsMin[1] && positions[3 * vertex + 1] <= it->boundsMax[1] );
+					Assert::IsTrue( std::sqrt( std::pow( positions[3 * vertex] - it->center[0], 2 ) + std::pow( positions[3 * vertex + 1] - it->center[1], 2 )
+						+ std::pow( positions[3 * vertex + 2] - it->center[2], 2 ) ) <= it->radius * 1.0001f );
+				}
+			}
+
+			try {
+				meshlet_builder::build( indices, positions, 300 );
+
+				// Test to make sure an exception is thrown when the local indices cannot hold the number of vertices
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( meshlet_builder_is_backfacing_test )
+		{
+			std::vector<unsigned int> indices;
+			std::vector<float> positions;
+
+			create_meshlet_grid( indices, positions );
+
+			const meshlet_table table = meshlet_builder::build( indices, positions );
+			const float behind[] = { 6.f, 6.f, -10.f }, inFront[] = { 6.f, 6.f, 10.f };
+
+			// Test to make sure a flat meshlet is culled from behind but not from in front
+			Assert::IsTrue( meshlet_builder::is_backfacing( table.meshlets[0], behind ) );
+			Assert::IsFalse( meshlet_builder::is_backfacing( table.meshlets[0], inFront ) );
+		}
+	};
+}
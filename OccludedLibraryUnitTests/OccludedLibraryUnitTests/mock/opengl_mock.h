@@ -35,6 +35,7 @@
 #define GLvoid void
 #define GLfloat float
 #define GLsizeiptr GLsizei
+#define GLintptr GLsizei
 
 #define GL_TRUE 1
 #define GL_FALSE 2
@@ -50,14 +51,33 @@
 #define GL_UNSIGNED_BYTE 0
 #define GL_UNSIGNED_SHORT 1
 #define GL_UNSIGNED_INT 2
+#define GL_BYTE 3
+#define GL_SHORT 4
+#define GL_INT 5
+#define GL_FLOAT 6
+#define GL_HALF_FLOAT 7
+#define GL_INT_2_10_10_10_REV 8
+
+#define GL_DEPTH_TEST 0
+#define GL_LESS 1
+#define GL_DEPTH_BUFFER_BIT 0x100
+#define GL_SAMPLES_PASSED 0
+#define GL_QUERY_RESULT 1
 
 extern bool errorState; // If true, the mock should mimic OpenGL functions returning errors
 extern bool programLinkError; // If true, the mock will return GL_FALSE when glGetProgramiv is called
 extern bool shaderCompileError; // If true, the mock will return GL_FALSE when glGetProrgramiv is called
+extern unsigned int bufferDataCalls; // The number of times glBufferData has been called
+extern unsigned int bufferSubDataCalls; // The number of times glBufferSubData has been called
+extern unsigned int samplesPassed; // The result returned by glGetQueryObjectuiv
+extern bool queryActive; // True between a glBeginQuery call and the glEndQuery call that ends it
+extern GLsizeiptr bufferDataSize; // The size passed to the last glBufferData call
+extern GLenum drawElementsType; // The index type passed to the last glDrawElements call
 static GLuint currVAOID = 1;
 static GLuint currVBOID = 1;
 static GLuint currShaderProgID = 1;
 static GLuint currShaderID = 1;
+static GLuint currQueryID = 1;
 
 inline GLuint glCreateShader( GLenum shaderType ) {
 	if( errorState )
@@ -135,6 +155,19 @@ inline void glGenBuffers( GLsizei n, GLuint* buffers ) {
 	}
 }
 
+inline void glGenQueries( GLsizei n, GLuint* ids ) {
+	if( errorState )
+		*ids = 0;
+	else {
+		*ids = currQueryID;
+		currQueryID++;
+	}
+}
+
+inline void glGetQueryObjectuiv( GLuint id, GLenum pname, GLuint* params ) {
+	*params = samplesPassed;
+}
+
 inline GLint glGetUniformLocation( GLuint program, const GLchar* name ) {
 	if( errorState )
 		return -1;
@@ -142,7 +175,15 @@ inline GLint glGetUniformLocation( GLuint program, const GLchar* name ) {
 		return 0;
 }
 
-inline void glBufferData( GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage) {}
+inline void glBufferData( GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage) {
+	bufferDataCalls++;
+	bufferDataSize = size;
+}
+
+inline void glBufferSubData( GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data ) {
+	bufferSubDataCalls++;
+}
+
 inline void glBindVertexArray( GLuint array ) {}
 inline void glBindBuffer( GLenum target, GLuint buffer) {}
 inline void glEnableVertexAttribArray( GLuint index ) {}
@@ -159,7 +200,19 @@ inline void glDeleteVertexArrays( GLsizei n, const GLuint* arrays ) {}
 inline void glDeleteBuffers( GLsizei n, const GLuint* buffers ) {}
 inline void glUniform3fv( GLint location, GLsizei count, const GLfloat *value ) {}
 inline void glUniformMatrix4fv( GLint location, GLsizei count, GLboolean transpose, const GLfloat *value ) {}
-inline void glDrawElements( GLenum mode, GLsizei count, GLenum type, const GLvoid* indices ) {}
+inline void glDrawElements( GLenum mode, GLsizei count, GLenum type, const GLvoid* indices ) {
+	drawElementsType = type;
+}
+inline void glDeleteQueries( GLsizei n, const GLuint* ids ) {}
+inline void glBeginQuery( GLenum target, GLuint id ) {
+	queryActive = true;
+}
+inline void glEndQuery( GLenum target ) {
+	queryActive = false;
+}
+inline void glClear( GLuint mask ) {}
+inline void glEnable( GLenum cap ) {}
+inline void glDepthFunc( GLenum func ) {}
 
 inline void resetVBOIDs() {
 	currVBOID = 1;
@@ -0,0 +1,51 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <meshes/overdraw_optimizer.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::meshes;
+
+namespace OccludedLibraryUnitTests
+{
+	TEST_CLASS( overdraw_optimizer_test )
+	{
+	public:
+
+		TEST_METHOD( overdraw_optimizer_optimize_overdraw_test )
+		{
+			// Two triangles facing +z, the second one in front of the first
+			const float positionVals[] = { 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 1.f, 0.f, 1.f, 0.f, 1.f, 1.f };
+			const unsigned int indexVals[] = { 0, 1, 2, 3, 4, 5 };
+			const std::vector<float> positions( positionVals, positionVals + 18 );
+			std::vector<unsigned int> indices( indexVals, indexVals + 6 );
+
+			overdraw_optimizer::optimize_overdraw( indices, positions );
+
+			// Test to make sure the triangle in front is moved first and the winding of both triangles is kept
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), indices[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 4 ), indices[1] );
+			Assert::AreEqual( static_cast<unsigned int>( 5 ), indices[2] );
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), indices[3] );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), indices[5] );
+
+			try {
+				overdraw_optimizer::optimize_overdraw( indices, positions, vertex_cache_optimizer::DEFAULT_CACHE_SIZE, 0.5f );
+
+				// Test to make sure an exception is thrown when the threshold is less than 1
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			indices[0] = 6;
+
+			try {
+				overdraw_optimizer::optimize_overdraw( indices, positions );
+
+				// Test to make sure an exception is thrown when an index does not correspond to a position
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+	};
+}
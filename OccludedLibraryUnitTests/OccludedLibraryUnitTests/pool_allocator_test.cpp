@@ -0,0 +1,80 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <buffers/segregated_attr_buffer.h>
+#include <buffers/storage/pool_allocator.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+using namespace occluded::buffers::attributes;
+using namespace occluded::buffers::storage;
+
+namespace OccludedLibraryUnitTests
+{
+	TEST_CLASS( pool_allocator_test )
+	{
+	public:
+
+		TEST_METHOD( pool_allocator_get_class_size_test )
+		{
+			pool_allocator testPool( 1000 );
+
+			// Test to make sure allocations are rounded up to a power of two size class
+			Assert::AreEqual( static_cast<std::size_t>( 16 ), testPool.get_class_size( 1 ) );
+			Assert::AreEqual( static_cast<std::size_t>( 64 ), testPool.get_class_size( 64 ) );
+			Assert::AreEqual( static_cast<std::size_t>( 128 ), testPool.get_class_size( 65 ) );
+
+			// Test to make sure the largest size class is rounded up to a power of two and larger allocations are not rounded
+			Assert::AreEqual( static_cast<std::size_t>( 1024 ), testPool.get_class_size( 1000 ) );
+			Assert::AreEqual( static_cast<std::size_t>( 1025 ), testPool.get_class_size( 1025 ) );
+		}
+
+		TEST_METHOD( pool_allocator_allocate_test )
+		{
+			pool_allocator testPool;
+
+			void* first = testPool.allocate( 100 );
+			void* second = testPool.allocate( 120 );
+
+			// Test to make sure allocations of the same size class are carved from the same slab
+			Assert::AreEqual( static_cast<std::size_t>( 1 ), testPool.get_num_slabs() );
+			Assert::IsTrue( static_cast<char*>( second ) == static_cast<char*>( first ) + 128 );
+
+			testPool.deallocate( first, 100 );
+
+			// Test to make sure memory given back is reused by the next allocation of the same size class
+			Assert::IsTrue( testPool.allocate( 128 ) == first );
+
+			testPool.allocate( 20 );
+
+			// Test to make sure each size class has its own slabs
+			Assert::AreEqual( static_cast<std::size_t>( 2 ), testPool.get_num_slabs() );
+
+			void* large = testPool.allocate( pool_allocator::DEFAULT_MAX_CLASS_SIZE + 1 );
+			testPool.deallocate( large, pool_allocator::DEFAULT_MAX_CLASS_SIZE + 1 );
+
+			// Test to make sure allocations larger than every size class do not use a slab
+			Assert::AreEqual( static_cast<std::size_t>( 2 ), testPool.get_num_slabs() );
+		}
+
+		TEST_METHOD( pool_allocator_attribute_buffer_test )
+		{
+			pool_allocator testPool;
+			attribute_map testMap( false );
+			testMap.add_attribute( attribute( "test1", 1, attrib_float ) );
+			testMap.add_attribute( attribute( "test2", 2, attrib_float ) );
+			testMap.end_definition();
+
+			std::vector<float> values( 3 * 100, 1.f );
+
+			for( unsigned int i = 0; i < 10; ++i ) {
+				segregated_attr_buffer testBuffer( testMap, testPool );
+
+				testBuffer.insert_values( static_cast<const void*>( &values[0] ), 100 );
+			}
+
+			// Test to make sure buffers that are created and destroyed repeatedly reuse the same memory
+			Assert::IsTrue( testPool.get_num_slabs() <= static_cast<std::size_t>( 8 ) );
+		}
+	};
+}
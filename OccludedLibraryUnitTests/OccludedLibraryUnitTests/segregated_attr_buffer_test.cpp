@@ -1,6 +1,9 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
 
+#include <list>
+#include <limits>
+
 #include <buffers/segregated_attr_buffer.h>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -77,7 +80,7 @@ namespace OccludedLibraryUnitTests
 
 			testBuffer.insert_values( data );
 
-			const std::vector<char>& testData = testBuffer.get_all_data();
+			const attribute_buffer::data_vector& testData = testBuffer.get_all_data();
 			float testFloatVal1 = *( reinterpret_cast<const float*>( &testData[0] ) );
 			float testFloatVal2 = *( reinterpret_cast<const float*>( &testData[sizeof( float )] ) );
 			int testIntVal1 = *( reinterpret_cast<const int*>( &testData[2 * sizeof( float )] ) );
@@ -214,5 +217,316 @@ namespace OccludedLibraryUnitTests
 			
 			Assert::AreEqual( static_cast<unsigned int>( 0 ), testBuffer.get_attribute_data_offsets()[1] );
 		}
+
+		TEST_METHOD( segregated_attr_buffer_reserve_test )
+		{
+			testMap->add_attribute( attribute( "test2", 2, attrib_int ) );
+			testMap->end_definition();
+
+			segregated_attr_buffer testBuffer( *testMap );
+			std::vector<char> data( sizeof( float ) + 2 * sizeof( int ) );
+
+			testBuffer.reserve( 100 );
+
+			// Test to make sure reserving room places the second section after room for 100 values of the first attribute
+			Assert::AreEqual( static_cast<unsigned int>( 100 ), testBuffer.get_capacity() );
+			Assert::AreEqual( static_cast<unsigned int>( 100 * sizeof( float ) ), testBuffer.get_attribute_data_offsets()[1] );
+
+			for( unsigned int i = 0; i < 100; ++i ) {
+				testBuffer.insert_values( data );
+			}
+
+			// Test to make sure the offsets do not change while the buffer is within its reserved capacity
+			Assert::AreEqual( static_cast<unsigned int>( 100 ), testBuffer.get_num_values() );
+			Assert::AreEqual( static_cast<unsigned int>( 100 ), testBuffer.get_capacity() );
+			Assert::AreEqual( static_cast<unsigned int>( 100 * sizeof( float ) ), testBuffer.get_attribute_data_offsets()[1] );
+
+			testBuffer.reserve( 10 );
+
+			// Test to make sure reserving less than the current capacity does nothing
+			Assert::AreEqual( static_cast<unsigned int>( 100 ), testBuffer.get_capacity() );
+
+			testBuffer.clear_buffer();
+
+			// Test to make sure the capacity is reset when the buffer is cleared
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testBuffer.get_capacity() );
+		}
+
+		TEST_METHOD( segregated_attr_buffer_geometric_growth_test )
+		{
+			testMap->add_attribute( attribute( "test2", 2, attrib_int ) );
+			testMap->end_definition();
+
+			segregated_attr_buffer testBuffer( *testMap );
+			std::vector<char> data( sizeof( float ) + 2 * sizeof( int ) );
+			unsigned int numMoves = 0, lastOffset = 0;
+			const unsigned int numInserts = 10000;
+
+			for( unsigned int i = 0; i < numInserts; ++i ) {
+				const float value = static_cast<float>( i );
+				const int intVal = static_cast<int>( i );
+
+				memcpy( &data[0], &value, sizeof( float ) );
+				memcpy( &data[sizeof( float )], &intVal, sizeof( int ) );
+				memcpy( &data[sizeof( float ) + sizeof( int )], &intVal, sizeof( int ) );
+
+				testBuffer.insert_values( data );
+
+				if( testBuffer.get_attribute_data_offsets()[1] != lastOffset ) {
+					lastOffset = testBuffer.get_attribute_data_offsets()[1];
+					++numMoves;
+				}
+			}
+
+			// Test to make sure the sections are only moved a logarithmic number of times when values are appended one at a time
+			Assert::IsTrue( numMoves <= 15 );
+			Assert::IsTrue( testBuffer.get_capacity() >= numInserts && testBuffer.get_capacity() < 2 * numInserts );
+
+			const attribute_buffer::data_vector& testData = testBuffer.get_all_data();
+			const unsigned int intOffset = testBuffer.get_attribute_data_offsets()[1];
+
+			// Test to make sure the values survived the sections being moved
+			for( unsigned int i = 0; i < numInserts; ++i ) {
+				const float testFloat = *( reinterpret_cast<const float*>( &testData[i * sizeof( float )] ) );
+				const int testInt = *( reinterpret_cast<const int*>( &testData[intOffset + 2 * i * sizeof( int ) + sizeof( int )] ) );
+
+				Assert::IsTrue( testFloat >= static_cast<float>( i ) - MAX_ERR && testFloat <= static_cast<float>( i ) + MAX_ERR );
+				Assert::AreEqual( static_cast<int>( i ), testInt );
+			}
+		}
+
+		TEST_METHOD( segregated_attr_buffer_grow_past_offset_range_test )
+		{
+			testMap->add_attribute( attribute( "test2", 2, attrib_int ) );
+			testMap->end_definition();
+
+			segregated_attr_buffer testBuffer( *testMap );
+
+			try {
+				testBuffer.reserve( 0x40000000 );
+
+				// Test to make sure an exception is thrown instead of wrapping the offsets when the sections would end past their range
+				Assert::Fail();
+			} catch( const std::runtime_error& ) {
+
+			}
+
+			// Test to make sure the buffer was left empty and can still be used
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testBuffer.get_capacity() );
+			Assert::IsTrue( testBuffer.get_all_data().empty() );
+		}
+
+		TEST_METHOD( segregated_attr_buffer_failed_insert_test )
+		{
+			testMap->add_attribute( attribute( "test2", 2, attrib_int ) );
+			testMap->end_definition();
+
+			segregated_attr_buffer testBuffer( *testMap );
+			// The first attribute of each value, followed by the second attribute of each value
+			const float initialVals[] = { 0.f, 1.f, 2.f, 3.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+
+			testBuffer.insert_values( static_cast<const void*>( initialVals ), 4 );
+			testBuffer.erase_values( 1, 2 );
+
+			try {
+				testBuffer.insert_values( static_cast<const void*>( initialVals ), std::numeric_limits<unsigned int>::max() - 2 );
+
+				// Test to make sure an exception is thrown if the values that do not fit in the erased values can not be appended
+				Assert::Fail();
+			} catch( const std::runtime_error& ) {
+
+			}
+
+			// Test to make sure the erased values were not consumed by the insert that failed
+			Assert::AreEqual( static_cast<unsigned int>( 4 ), testBuffer.get_num_values() );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testBuffer.get_num_free_values() );
+			Assert::IsTrue( testBuffer.is_value_erased( 1 ) );
+			Assert::IsTrue( testBuffer.is_value_erased( 2 ) );
+		}
+
+		TEST_METHOD( segregated_attr_buffer_insert_range_test )
+		{
+			struct test_vertex {
+				float value;
+				int other[2];
+			};
+
+			testMap->add_attribute( attribute( "test2", 2, attrib_int ) );
+			testMap->end_definition();
+
+			segregated_attr_buffer testBuffer( *testMap );
+			test_vertex vertices[4];
+
+			for( unsigned int i = 0; i < 4; ++i ) {
+				vertices[i].value = static_cast<float>( i ) * 2.f;
+				vertices[i].other[0] = static_cast<int>( i );
+				vertices[i].other[1] = static_cast<int>( i ) + 10;
+			}
+
+			testBuffer.insert_values( vertices, vertices + 4 );
+
+			const attribute_buffer::data_vector& testData = testBuffer.get_all_data();
+			const unsigned int intOffset = testBuffer.get_attribute_data_offsets()[1];
+
+			// Test to make sure the interleaved vertex structures were split into the sections of the buffer
+			Assert::AreEqual( static_cast<unsigned int>( 4 ), testBuffer.get_num_values() );
+
+			for( unsigned int i = 0; i < 4; ++i ) {
+				const float testFloat = *( reinterpret_cast<const float*>( &testData[i * sizeof( float )] ) );
+				const int testInt = *( reinterpret_cast<const int*>( &testData[intOffset + ( 2 * i + 1 ) * sizeof( int )] ) );
+
+				Assert::IsTrue( testFloat >= vertices[i].value - MAX_ERR && testFloat <= vertices[i].value + MAX_ERR );
+				Assert::AreEqual( vertices[i].other[1], testInt );
+			}
+
+			const std::list<test_vertex> vertexList( vertices, vertices + 4 );
+
+			testBuffer.insert_values( vertexList.begin(), vertexList.end() );
+
+			const attribute_buffer::data_vector& listData = testBuffer.get_all_data();
+			const unsigned int listIntOffset = testBuffer.get_attribute_data_offsets()[1];
+
+			// Test to make sure a range that is not contiguous is split into the sections of the buffer after the values already there
+			Assert::AreEqual( static_cast<unsigned int>( 8 ), testBuffer.get_num_values() );
+
+			for( unsigned int i = 0; i < 4; ++i ) {
+				const float testFloat = *( reinterpret_cast<const float*>( &listData[( i + 4 ) * sizeof( float )] ) );
+				const int testInt = *( reinterpret_cast<const int*>( &listData[listIntOffset + ( 2 * ( i + 4 ) ) * sizeof( int )] ) );
+
+				Assert::IsTrue( testFloat >= vertices[i].value - MAX_ERR && testFloat <= vertices[i].value + MAX_ERR );
+				Assert::AreEqual( vertices[i].other[0], testInt );
+			}
+
+			testBuffer.erase_values( 1, 2 );
+			testBuffer.insert_values( vertexList.begin(), --vertexList.end() );
+
+			const attribute_buffer::data_vector& reusedData = testBuffer.get_all_data();
+			const unsigned int reusedIntOffset = testBuffer.get_attribute_data_offsets()[1];
+			const int lastInt = *( reinterpret_cast<const int*>( &reusedData[reusedIntOffset + 2 * 8 * sizeof( int )] ) );
+
+			// Test to make sure a range fills the erased values first and appends the rest
+			Assert::AreEqual( static_cast<unsigned int>( 9 ), testBuffer.get_num_values() );
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testBuffer.get_num_free_values() );
+			Assert::AreEqual( vertices[1].value, *( reinterpret_cast<const float*>( &reusedData[2 * sizeof( float )] ) ) );
+			Assert::AreEqual( vertices[2].other[0], lastInt );
+		}
+
+		TEST_METHOD( segregated_attr_buffer_update_values_test )
+		{
+			testMap->add_attribute( attribute( "test2", 2, attrib_float ) );
+			testMap->end_definition();
+
+			segregated_attr_buffer testBuffer( *testMap );
+			std::vector<float> values( 4 * 3, 0.f );
+			// The first attribute of both values, followed by the second attribute of both values
+			const float newVals[] = { 1.f, 2.f, 3.f, 4.f, 5.f, 6.f };
+
+			testBuffer.reserve( 8 );
+			testBuffer.insert_values( static_cast<const void*>( &values[0] ), 4 );
+			testBuffer.clear_dirty_ranges();
+			testBuffer.update_values( 1, 2, newVals );
+
+			const float* testFirst = reinterpret_cast<const float*>( &testBuffer.get_all_data()[testBuffer.get_attribute_data_offsets()[0]] );
+			const float* testSecond = reinterpret_cast<const float*>( &testBuffer.get_all_data()[testBuffer.get_attribute_data_offsets()[1]] );
+
+			// Test to make sure each attribute was overwritten in its own section
+			Assert::AreEqual( 0.f, testFirst[0] );
+			Assert::AreEqual( 1.f, testFirst[1] );
+			Assert::AreEqual( 2.f, testFirst[2] );
+			Assert::AreEqual( 0.f, testFirst[3] );
+			Assert::AreEqual( 3.f, testSecond[2] );
+			Assert::AreEqual( 6.f, testSecond[5] );
+			Assert::AreEqual( 0.f, testSecond[6] );
+
+			// Test to make sure a dirty range was recorded for each section
+			Assert::IsFalse( testBuffer.is_all_dirty() );
+			Assert::AreEqual( static_cast<std::size_t>( 2 ), testBuffer.get_dirty_ranges().size() );
+			Assert::AreEqual( testBuffer.get_attribute_data_offsets()[0] + sizeof( float ), testBuffer.get_dirty_ranges()[0].first );
+			Assert::AreEqual( testBuffer.get_attribute_data_offsets()[1] + 2 * sizeof( float ), testBuffer.get_dirty_ranges()[1].first );
+			Assert::AreEqual( 4 * sizeof( float ), testBuffer.get_dirty_ranges()[1].second );
+
+			testBuffer.reserve( 16 );
+
+			// Test to make sure moving the sections makes the whole buffer dirty
+			Assert::IsTrue( testBuffer.is_all_dirty() );
+			Assert::AreEqual( static_cast<std::size_t>( 0 ), testBuffer.get_dirty_ranges().size() );
+		}
+
+
+		TEST_METHOD( segregated_attr_buffer_erase_compact_test )
+		{
+			testMap->add_attribute( attribute( "test2", 2, attrib_float ) );
+			testMap->end_definition();
+
+			segregated_attr_buffer testBuffer( *testMap );
+			// The first attribute of each value, followed by the second attribute of each value
+			const float initialVals[] = { 0.f, 1.f, 2.f, 3.f, 10.f, 10.f, 11.f, 11.f, 12.f, 12.f, 13.f, 13.f };
+			const float newVals[] = { 4.f, 14.f, 14.f };
+
+			testBuffer.insert_values( static_cast<const void*>( initialVals ), 4 );
+			testBuffer.erase_values( 1, 2 );
+			testBuffer.insert_values( static_cast<const void*>( newVals ), 1 );
+
+			const float* testFirst = reinterpret_cast<const float*>( &testBuffer.get_all_data()[testBuffer.get_attribute_data_offsets()[0]] );
+			const float* testSecond = reinterpret_cast<const float*>( &testBuffer.get_all_data()[testBuffer.get_attribute_data_offsets()[1]] );
+
+			// Test to make sure the erased value was reused in each section
+			Assert::AreEqual( static_cast<unsigned int>( 4 ), testBuffer.get_num_values() );
+			Assert::AreEqual( 4.f, testFirst[1] );
+			Assert::AreEqual( 14.f, testSecond[3] );
+			Assert::IsTrue( testBuffer.is_value_erased( 2 ) );
+
+			std::vector<unsigned int> remap = testBuffer.compact();
+
+			testFirst = reinterpret_cast<const float*>( &testBuffer.get_all_data()[testBuffer.get_attribute_data_offsets()[0]] );
+			testSecond = reinterpret_cast<const float*>( &testBuffer.get_all_data()[testBuffer.get_attribute_data_offsets()[1]] );
+
+			// Test to make sure the values after the erased value were moved down in each section
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), testBuffer.get_num_values() );
+			Assert::AreEqual( 3.f, testFirst[2] );
+			Assert::AreEqual( 13.f, testSecond[4] );
+			Assert::AreEqual( 13.f, testSecond[5] );
+			Assert::AreEqual( attribute_buffer::ERASED_VALUE, remap[2] );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), remap[3] );
+		}
+
+		TEST_METHOD( segregated_attr_buffer_reorder_values_test )
+		{
+			testMap->add_attribute( attribute( "test2", 1, attrib_float ) );
+			testMap->end_definition();
+
+			segregated_attr_buffer testBuffer( *testMap );
+			const float initialVals[] = { 0.f, 1.f, 2.f, 10.f, 11.f, 12.f };
+			std::vector<unsigned int> remap( 3 );
+
+			testBuffer.insert_values( static_cast<const void*>( initialVals ), 3 );
+			testBuffer.clear_dirty_ranges();
+
+			remap[0] = 2;
+			remap[1] = 0;
+			remap[2] = 1;
+
+			testBuffer.reorder_values( remap );
+
+			const float* testFirst = reinterpret_cast<const float*>( &testBuffer.get_all_data()[testBuffer.get_attribute_data_offsets()[0]] );
+			const float* testSecond = reinterpret_cast<const float*>( &testBuffer.get_all_data()[testBuffer.get_attribute_data_offsets()[1]] );
+
+			// Test to make sure each value was moved to its new index in every section
+			Assert::AreEqual( 1.f, testFirst[0] );
+			Assert::AreEqual( 0.f, testFirst[2] );
+			Assert::AreEqual( 11.f, testSecond[0] );
+			Assert::AreEqual( 10.f, testSecond[2] );
+			Assert::IsTrue( testBuffer.is_all_dirty() );
+
+			remap[2] = 0;
+
+			try {
+				testBuffer.reorder_values( remap );
+
+				// Test to make sure an exception is thrown when remap is not a permutation
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
 	};
 }
\ No newline at end of file
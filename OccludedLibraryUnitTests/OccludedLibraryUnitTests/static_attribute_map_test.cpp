@@ -0,0 +1,150 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <buffers/attributes/static_attribute_map.h>
+#include <buffers/attribute_buffer_factory.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+using namespace occluded::buffers::attributes;
+
+namespace OccludedLibraryUnitTests
+{
+	struct static_test_vertex {
+		float position[3];
+		unsigned int id;
+		int color[2];
+	};
+
+	typedef static_attribute_map< static_test_vertex,
+		field<static_test_vertex, float[3], &static_test_vertex::position>,
+		field<static_test_vertex, unsigned int, &static_test_vertex::id>,
+		field<static_test_vertex, int[2], &static_test_vertex::color, true> > static_test_layout;
+
+	typedef static_attribute_map< static_test_vertex,
+		field<static_test_vertex, unsigned int, &static_test_vertex::id>,
+		field<static_test_vertex, float[3], &static_test_vertex::position>,
+		field<static_test_vertex, int[2], &static_test_vertex::color> > static_test_out_of_order_layout;
+
+	TEST_CLASS( static_attribute_map_test )
+	{
+	public:
+
+		TEST_METHOD( static_attribute_map_layout_test )
+		{
+			// Test to make sure the stride and offsets are the ones of the vertex structure
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), static_test_layout::ATTRIB_COUNT );
+			Assert::AreEqual( sizeof( static_test_vertex ), static_test_layout::STRIDE );
+			Assert::AreEqual( static_cast<std::size_t>( 0 ), static_test_layout::offset<0>::VALUE );
+			Assert::AreEqual( static_cast<std::size_t>( 3 * sizeof( float ) ), static_test_layout::offset<1>::VALUE );
+			Assert::AreEqual( static_cast<std::size_t>( 3 * sizeof( float ) + sizeof( unsigned int ) ), static_test_layout::offset<2>::VALUE );
+		}
+
+		TEST_METHOD( static_attribute_map_create_attribute_map_test )
+		{
+			attribute_map expectedMap( true );
+			expectedMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			expectedMap.add_attribute( attribute( "id", 1, attrib_uint ) );
+			expectedMap.add_attribute( attribute( "color", 2, attrib_int, true ) );
+			expectedMap.end_definition();
+
+			attribute_map testMap = static_test_layout::create_attribute_map( true, "position", "id", "color" );
+
+			// Test to make sure the attribute map created matches one defined at runtime
+			Assert::IsFalse( testMap.being_defined() );
+			Assert::IsTrue( expectedMap == testMap );
+			Assert::AreEqual( sizeof( static_test_vertex ), testMap.get_byte_size() );
+			Assert::IsTrue( testMap.get_attributes()[2].is_normalized() );
+
+			try {
+				static_test_out_of_order_layout::create_attribute_map( true, "id", "position", "color" );
+
+				// Test to make sure an exception is thrown if the fields are not in the same order as the members
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( static_attribute_map_insert_vertices_test )
+		{
+			static_test_vertex vertices[3];
+
+			for( unsigned int i = 0; i < 3; ++i ) {
+				vertices[i].position[0] = static_cast<float>( i );
+				vertices[i].position[1] = 1.f;
+				vertices[i].position[2] = -1.f;
+				vertices[i].id = i;
+				vertices[i].color[0] = -static_cast<int>( i );
+				vertices[i].color[1] = 4;
+			}
+
+			std::auto_ptr<attribute_buffer> interleavedBuffer = attribute_buffer_factory::create_attribute_buffer(
+				static_test_layout::create_attribute_map( true, "position", "id", "color" ) );
+			std::auto_ptr<attribute_buffer> segregatedBuffer = attribute_buffer_factory::create_attribute_buffer(
+				static_test_layout::create_attribute_map( false, "position", "id", "color" ) );
+
+			static_test_layout::insert_vertices( *interleavedBuffer, vertices, 3 );
+			static_test_layout::insert_vertices( *segregatedBuffer, vertices, 3 );
+
+			// Test to make sure the interleaved buffer contains an exact copy of the vertex array
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), interleavedBuffer->get_num_values() );
+			Assert::AreEqual( 0, memcmp( vertices, &interleavedBuffer->get_all_data()[0], sizeof( vertices ) ) );
+
+			// Test to make sure the segregated buffer split the vertices into its sections
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), segregatedBuffer->get_num_values() );
+
+			for( unsigned int i = 0; i < 3; ++i ) {
+				const unsigned int testId = *( reinterpret_cast<const unsigned int*>(
+					&segregatedBuffer->get_all_data()[segregatedBuffer->get_attribute_data_offsets()[1] + i * sizeof( unsigned int )] ) );
+
+				Assert::AreEqual( i, testId );
+			}
+
+			attribute_map otherMap( true );
+			otherMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			otherMap.end_definition();
+
+			std::auto_ptr<attribute_buffer> otherBuffer = attribute_buffer_factory::create_attribute_buffer( otherMap );
+
+			try {
+				static_test_layout::insert_vertices( *otherBuffer, vertices, 3 );
+
+				// Test to make sure an exception is thrown if the buffer's attribute map does not match the vertex structure
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			attribute_map reorderedMap( true );
+			reorderedMap.add_attribute( attribute( "id", 1, attrib_uint ) );
+			reorderedMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			reorderedMap.add_attribute( attribute( "color", 2, attrib_int, true ) );
+			reorderedMap.end_definition();
+
+			std::auto_ptr<attribute_buffer> reorderedBuffer = attribute_buffer_factory::create_attribute_buffer( reorderedMap );
+
+			try {
+				static_test_layout::insert_vertices( *reorderedBuffer, vertices, 3 );
+
+				// Test to make sure an exception is thrown if the buffer's attributes are the same size as the structure but in a different order
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+
+			attribute_map unnormalizedMap( true );
+			unnormalizedMap.add_attribute( attribute( "position", 3, attrib_float ) );
+			unnormalizedMap.add_attribute( attribute( "id", 1, attrib_uint ) );
+			unnormalizedMap.add_attribute( attribute( "color", 2, attrib_int ) );
+			unnormalizedMap.end_definition();
+
+			std::auto_ptr<attribute_buffer> unnormalizedBuffer = attribute_buffer_factory::create_attribute_buffer( unnormalizedMap );
+
+			try {
+				static_test_layout::insert_vertices( *unnormalizedBuffer, vertices, 3 );
+
+				// Test to make sure an exception is thrown if an attribute of the buffer is not normalized the same way as its field
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+	};
+}
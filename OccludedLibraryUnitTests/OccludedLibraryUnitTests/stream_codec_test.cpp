@@ -0,0 +1,108 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <buffers/stream_codec.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+
+namespace OccludedLibraryUnitTests
+{
+	TEST_CLASS( stream_codec_test )
+	{
+	public:
+
+		TEST_METHOD( stream_codec_values_test )
+		{
+			std::vector<float> values;
+
+			// A grid of positions, like the vertices of a terrain, which neighbouring values differ little from each other
+			for( unsigned int i = 0; i < 1000; ++i ) {
+				values.push_back( static_cast<float>( i % 40 ) * 0.25f );
+				values.push_back( static_cast<float>( i / 40 ) * 0.25f );
+				values.push_back( -1.5f );
+			}
+
+			std::vector<char> encoded;
+			stream_codec::encode_values( reinterpret_cast<const char*>( &values[0] ), 1000, 3 * sizeof( float ), encoded );
+
+			std::vector<float> decoded( values.size() );
+			const std::size_t bytesRead = stream_codec::decode_values( &encoded[0], encoded.size(), 1000, 3 * sizeof( float ),
+				reinterpret_cast<char*>( &decoded[0] ) );
+
+			// Test to make sure the values are decoded exactly and every encoded byte is read
+			Assert::IsTrue( decoded == values );
+			Assert::AreEqual( encoded.size(), bytesRead );
+
+			// Test to make sure values that change smoothly are compressed
+			Assert::IsTrue( encoded.size() < values.size() * sizeof( float ) / 2 );
+
+			std::vector<char> bytes;
+
+			for( unsigned int i = 0; i < 75; ++i ) {
+				bytes.push_back( static_cast<char>( i * 97 + 13 ) );
+			}
+
+			encoded.clear();
+			stream_codec::encode_values( &bytes[0], 25, 3, encoded );
+
+			std::vector<char> decodedBytes( bytes.size() );
+			stream_codec::decode_values( &encoded[0], encoded.size(), 25, 3, &decodedBytes[0] );
+
+			// Test to make sure values that do not compress and do not fill the last group are still decoded exactly
+			Assert::IsTrue( decodedBytes == bytes );
+
+			// Test to make sure the encoded size is within the smallest and largest sizes 75 bytes can be compressed into
+			Assert::IsTrue( encoded.size() >= stream_codec::get_min_encoded_size( 75 ) );
+			Assert::IsTrue( encoded.size() <= stream_codec::get_max_encoded_size( 75 ) );
+			Assert::IsTrue( stream_codec::get_min_encoded_size( 75 ) == 2 );
+			Assert::IsTrue( stream_codec::get_max_encoded_size( 75 ) == 82 );
+
+			try {
+				stream_codec::decode_values( &encoded[0], encoded.size() - 1, 25, 3, &decodedBytes[0] );
+
+				// Test to make sure an exception is thrown if the encoded values end early
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( stream_codec_indices_test )
+		{
+			std::vector<unsigned int> indices;
+
+			// A strip of triangles, whose indices only ever move a few vertices at a time
+			for( unsigned int i = 0; i < 500; ++i ) {
+				indices.push_back( i );
+				indices.push_back( i + 1 );
+				indices.push_back( i + 2 );
+			}
+
+			// Indices that jump the whole range of an unsigned int in both directions
+			indices.push_back( 0xffffffff );
+			indices.push_back( 0 );
+			indices.push_back( 0x80000000 );
+
+			std::vector<char> encoded;
+			stream_codec::encode_indices( indices, encoded );
+
+			std::vector<unsigned int> decoded;
+			const std::size_t bytesRead = stream_codec::decode_indices( &encoded[0], encoded.size(), indices.size(), decoded );
+
+			// Test to make sure the indices are decoded exactly and every encoded byte is read
+			Assert::IsTrue( decoded == indices );
+			Assert::AreEqual( encoded.size(), bytesRead );
+
+			// Test to make sure indices that are close together take much less than a byte each
+			Assert::IsTrue( encoded.size() < indices.size() );
+
+			try {
+				stream_codec::decode_indices( &encoded[0], encoded.size() - 1, indices.size(), decoded );
+
+				// Test to make sure an exception is thrown if the encoded indices end early
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+	};
+}
@@ -0,0 +1,120 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <algorithm>
+
+#include <meshes/vertex_cache_optimizer.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::meshes;
+
+namespace OccludedLibraryUnitTests
+{
+	static const unsigned int GRID_SIZE = 32;
+
+	// Creates the triangles of a grid of quads a row at a time, which reuses few vertices from the previous row in a small cache
+	static std::vector<unsigned int> create_grid() {
+		std::vector<unsigned int> indices;
+
+		for( unsigned int row = 0; row < GRID_SIZE; ++row ) {
+			for( unsigned int i = 0; i < GRID_SIZE; ++i ) {
+				const unsigned int column = row % 2 == 0 ? i : GRID_SIZE - 1 - i;
+				const unsigned int corner = row * ( GRID_SIZE + 1 ) + column;
+				const unsigned int triangles[] = { corner, corner + 1, corner + GRID_SIZE + 1, corner + 1, corner + GRID_SIZE + 2, corner + GRID_SIZE + 1 };
+
+				indices.insert( indices.end(), triangles, triangles + 6 );
+			}
+		}
+
+		return indices;
+	}
+
+	// Sorts the triangles of a triangle list, so that two lists containing the same triangles can be compared
+	static std::vector< std::vector<unsigned int> > sort_triangles( const std::vector<unsigned int>& indices ) {
+		std::vector< std::vector<unsigned int> > triangles;
+
+		for( unsigned int i = 0; i < indices.size(); i += 3 ) {
+			triangles.push_back( std::vector<unsigned int>( indices.begin() + i, indices.begin() + i + 3 ) );
+		}
+
+		std::sort( triangles.begin(), triangles.end() );
+
+		return triangles;
+	}
+
+	TEST_CLASS( vertex_cache_optimizer_test )
+	{
+	public:
+
+		TEST_METHOD( vertex_cache_optimizer_optimize_vertex_cache_test )
+		{
+			const unsigned int numVertices = ( GRID_SIZE + 1 ) * ( GRID_SIZE + 1 );
+			std::vector<unsigned int> indices = create_grid();
+			const std::vector<unsigned int> original = indices;
+
+			const vertex_cache_statistics before = vertex_cache_optimizer::compute_statistics( indices, numVertices, 8 );
+			vertex_cache_optimizer::optimize_vertex_cache( indices, numVertices, 8 );
+			const vertex_cache_statistics after = vertex_cache_optimizer::compute_statistics( indices, numVertices, 8 );
+
+			// Test to make sure the same triangles, with the same winding, are kept and fewer vertices are transformed
+			Assert::IsTrue( sort_triangles( original ) == sort_triangles( indices ) );
+			Assert::IsTrue( after.acmr < before.acmr );
+			Assert::IsTrue( after.atvr >= 1.f );
+
+			indices.push_back( 0 );
+
+			try {
+				vertex_cache_optimizer::optimize_vertex_cache( indices, numVertices );
+
+				// Test to make sure an exception is thrown when the indices do not make up whole triangles
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( vertex_cache_optimizer_optimize_vertex_fetch_test )
+		{
+			std::vector<unsigned int> indices( 3 );
+
+			indices[0] = 3;
+			indices[1] = 1;
+			indices[2] = 3;
+
+			std::vector<unsigned int> remap = vertex_cache_optimizer::optimize_vertex_fetch( indices, 4 );
+
+			// Test to make sure vertices are numbered in the order they are first used, followed by the unused vertices
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), indices[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), indices[1] );
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), indices[2] );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), remap[0] );
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), remap[2] );
+
+			try {
+				vertex_cache_optimizer::optimize_vertex_fetch( indices, 1 );
+
+				// Test to make sure an exception is thrown when an index does not correspond to a vertex
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( vertex_cache_optimizer_compute_statistics_test )
+		{
+			std::vector<unsigned int> indices( 6 );
+
+			indices[0] = 0;
+			indices[1] = 1;
+			indices[2] = 2;
+			indices[3] = 2;
+			indices[4] = 1;
+			indices[5] = 3;
+
+			const vertex_cache_statistics statistics = vertex_cache_optimizer::compute_statistics( indices, 4 );
+
+			// Test to make sure vertices shared by the two triangles are only transformed once
+			Assert::AreEqual( static_cast<unsigned int>( 4 ), statistics.numTransformed );
+			Assert::AreEqual( 2.f, statistics.acmr );
+			Assert::AreEqual( 1.f, statistics.atvr );
+		}
+	};
+}
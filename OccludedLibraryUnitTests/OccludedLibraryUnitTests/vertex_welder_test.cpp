@@ -0,0 +1,108 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <buffers/vertex_welder.h>
+#include <buffers/attribute_buffer.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace occluded::buffers;
+using namespace occluded::buffers::attributes;
+
+namespace OccludedLibraryUnitTests
+{
+	TEST_CLASS( vertex_welder_test )
+	{
+	public:
+
+		TEST_METHOD( vertex_welder_weld_test )
+		{
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "position", 2, attrib_float ) );
+			testMap.add_attribute( attribute( "index", 4, attrib_ubyte ) );
+			testMap.end_definition();
+
+			vertex_welder testWelder( testMap );
+			const struct { float position[2]; unsigned char index[4]; } vertices[] = {
+				{ { 0.f, 1.f }, { 1, 2, 3, 4 } }, { { 0.f, 1.f }, { 1, 2, 3, 5 } }, { { 0.f, 1.f }, { 1, 2, 3, 4 } }, { { 0.f, 1.0001f }, { 1, 2, 3, 4 } }
+			};
+
+			// Test to make sure the first vertex and a vertex that differs in any byte get the new index
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testWelder.weld( reinterpret_cast<const char*>( &vertices[0] ), 0 ) );
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), testWelder.weld( reinterpret_cast<const char*>( &vertices[1] ), 1 ) );
+
+			// Test to make sure a bit-identical vertex gets the index of the first vertex equal to it
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testWelder.weld( reinterpret_cast<const char*>( &vertices[2] ), 2 ) );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), testWelder.weld( reinterpret_cast<const char*>( &vertices[3] ), 2 ) );
+			Assert::AreEqual( static_cast<unsigned int>( 3 ), testWelder.get_num_vertices() );
+
+			vertex_welder epsilonWelder( testMap, 0.01f );
+
+			epsilonWelder.weld( reinterpret_cast<const char*>( &vertices[0] ), 0 );
+
+			// Test to make sure float components within the epsilon are equal, but other components must still be bit-identical
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), epsilonWelder.weld( reinterpret_cast<const char*>( &vertices[3] ), 1 ) );
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), epsilonWelder.weld( reinterpret_cast<const char*>( &vertices[1] ), 1 ) );
+
+			vertex_welder boundaryWelder( testMap, 0.01f );
+			const struct { float position[2]; unsigned char index[4]; } boundaryVertices[] = {
+				{ { 0.0049f, 1.f }, { 1, 2, 3, 4 } }, { { 0.0051f, 1.f }, { 1, 2, 3, 4 } }, { { 0.0199f, 0.0199f }, { 1, 2, 3, 4 } },
+				{ { 0.0201f, 0.0201f }, { 1, 2, 3, 4 } }, { { 0.0051f, 1.02f }, { 1, 2, 3, 4 } }
+			};
+
+			boundaryWelder.weld( reinterpret_cast<const char*>( &boundaryVertices[0] ), 0 );
+			boundaryWelder.weld( reinterpret_cast<const char*>( &boundaryVertices[2] ), 1 );
+
+			// Test to make sure vertices within the epsilon are welded even when they lie on either side of a cell boundary
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), boundaryWelder.weld( reinterpret_cast<const char*>( &boundaryVertices[1] ), 2 ) );
+			Assert::AreEqual( static_cast<unsigned int>( 1 ), boundaryWelder.weld( reinterpret_cast<const char*>( &boundaryVertices[3] ), 2 ) );
+			Assert::AreEqual( static_cast<unsigned int>( 2 ), boundaryWelder.weld( reinterpret_cast<const char*>( &boundaryVertices[4] ), 2 ) );
+
+			try {
+				vertex_welder invalidWelder( testMap, -1.f );
+
+				// Test to make sure an exception is thrown when the epsilon is negative
+				Assert::Fail();
+			} catch( const std::exception& ) {
+			}
+		}
+
+		TEST_METHOD( vertex_welder_grow_remap_test )
+		{
+			attribute_map testMap( true );
+			testMap.add_attribute( attribute( "test", 1, attrib_uint ) );
+			testMap.end_definition();
+
+			vertex_welder testWelder( testMap );
+			unsigned int i = 0;
+
+			// Add enough vertices for the table to grow several times
+			for( i = 0; i < 1000; ++i ) {
+				Assert::AreEqual( i, testWelder.weld( reinterpret_cast<const char*>( &i ), i ) );
+			}
+
+			// Test to make sure every vertex can still be found after the table has grown
+			for( i = 0; i < 1000; ++i ) {
+				Assert::AreEqual( i, testWelder.weld( reinterpret_cast<const char*>( &i ), 1000 ) );
+			}
+
+			std::vector<unsigned int> remap( 1000 );
+
+			for( i = 0; i < remap.size(); ++i ) {
+				remap[i] = i % 2 == 0 ? i / 2 : attribute_buffer::ERASED_VALUE;
+			}
+
+			testWelder.remap_indices( remap );
+
+			// Test to make sure remapping changes the indices of the kept vertices and removes the erased vertices
+			Assert::AreEqual( static_cast<unsigned int>( 500 ), testWelder.get_num_vertices() );
+			i = 10;
+			Assert::AreEqual( static_cast<unsigned int>( 5 ), testWelder.weld( reinterpret_cast<const char*>( &i ), 500 ) );
+			i = 11;
+			Assert::AreEqual( static_cast<unsigned int>( 500 ), testWelder.weld( reinterpret_cast<const char*>( &i ), 500 ) );
+
+			testWelder.clear();
+
+			Assert::AreEqual( static_cast<unsigned int>( 0 ), testWelder.get_num_vertices() );
+		}
+	};
+}